@@ -4,30 +4,42 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+TEMPLATE = subdirs
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+# Qt-free driver and script libraries, calibration GUI and tools (all linked against the library)
+SUBDIRS += \
+    driver \
+    script \
+    app \
+    tracereplay \
+    alloccheck \
+    calibscript \
+    c4tbroker \
+    loadgen \
+    waveform
 
-TARGET = ServoDriverCalibration
-TEMPLATE = app
+driver.file = lib/c4tdriver.pro
 
+script.file = lib/c4tscript.pro
+script.depends = driver
 
-SOURCES += \
-    source/main.cpp \
-    source/mainwindow.cpp \
-    source/pca9685.cpp \
-    source/i2cdevice.cpp
+app.file = app/app.pro
+app.depends = driver
 
-HEADERS  += \
-    include/mainwindow.hpp \
-    include/pca9685.hpp \
-    include/i2cdevice.hpp \
-    include/pca9685defines.hpp
+tracereplay.subdir = tools/tracereplay
+tracereplay.depends = driver
 
-FORMS    += \
-    resource/mainwindow.ui
+alloccheck.subdir = tools/alloccheck
+alloccheck.depends = driver
 
-CONFIG += c++14
+calibscript.subdir = tools/calibscript
+calibscript.depends = script
 
-RESOURCES += \
-    resource/images.qrc
+c4tbroker.subdir = tools/c4tbroker
+c4tbroker.depends = driver
+
+loadgen.subdir = tools/loadgen
+loadgen.depends = driver
+
+waveform.subdir = tools/waveform
+waveform.depends = driver
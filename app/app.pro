@@ -0,0 +1,38 @@
+#-------------------------------------------------
+#
+# Servo driver calibration GUI
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = ServoDriverCalibration
+TEMPLATE = app
+
+
+SOURCES += \
+    ../source/main.cpp \
+    ../source/mainwindow.cpp \
+    ../source/logsink.cpp \
+    ../source/telemetryplot.cpp \
+    ../source/channelmodel.cpp \
+    ../source/channeldelegate.cpp
+
+HEADERS  += \
+    ../include/mainwindow.hpp \
+    ../include/logsink.hpp \
+    ../include/telemetryplot.hpp \
+    ../include/channelmodel.hpp \
+    ../include/channeldelegate.hpp
+
+FORMS    += \
+    ../resource/mainwindow.ui
+
+CONFIG += c++14
+
+include(../lib/c4tdriver.pri)
+
+RESOURCES += \
+    ../resource/images.qrc
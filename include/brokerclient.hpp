@@ -0,0 +1,320 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file brokerclient.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class BrokerClient at namespace CAR4TEGRA
+ *
+ * @details
+ * The BrokerClient class connects a process (GUI, control process, script) to the bus broker
+ * instead of opening the I2C bus itself.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef BROKERCLIENT_H
+#define BROKERCLIENT_H
+
+
+// std includes
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/busbroker.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class BrokerClient brokerclient.hpp "include/brokerclient.hpp"
+    * @brief The BrokerClient class sends setpoints to the devices of a bus broker
+    *
+    * Setpoints are sent without waiting for the broker, they are written with the next frame.
+    * Channels are owned after claim() or after the first setpoint for a free channel, setpoints
+    * for channels owned by other clients are dropped by the broker. Ownership changes are
+    * received with every call and with poll(); an event loop can watch fd() for them (e.g. with
+    * a QSocketNotifier).
+    *
+    * All functions are thread-safe.
+    */
+   class BrokerClient
+   {
+   public:
+      /// Callback for ownership changes (called from the thread receiving the change, must not call the client)
+      typedef std::function<void(int aDevice, uint16_t aOwnedMask)> OwnershipCallback;
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      BrokerClient();
+
+
+      /**
+       * @brief Destructor, disconnects from the broker
+       */
+      ~BrokerClient();
+
+
+      /** @{ @name Connection functions */
+
+      /**
+       * @brief Connects to the broker and waits for the device list
+       *
+       * @param[in]  acrName        Client name (shown in broker messages)
+       * @param[in]  aPriority      Priority, claims take channels from lower priority clients
+       * @param[in]  acrPath        Socket path of the broker
+       */
+      void connect(const std::string& acrName, int aPriority = 0, const std::string& acrPath = BROKER_SOCKET_DEFAULT);
+
+
+      /**
+       * @brief Disconnects from the broker, the broker releases the channels of the client
+       */
+      void close();
+
+
+      /**
+       * @brief Returns if the client is connected
+       *
+       * @return `true` if connected, `false` otherwise
+       */
+      bool isConnected();
+
+
+      /**
+       * @brief Returns the socket for event loops (readable when broker messages are pending)
+       *
+       * @return Socket (`-1` if not connected)
+       */
+      int fd();
+
+
+      /**
+       * @brief Sets the callback for ownership changes
+       *
+       * @param[in]  aCallback      Ownership callback
+       */
+      void setOwnershipCallback(OwnershipCallback aCallback);
+
+      /** @} */
+
+
+      /** @{ @name Device functions */
+
+      /**
+       * @brief Returns the number of devices of the broker
+       *
+       * @return Number of devices
+       */
+      int deviceCount();
+
+
+      /**
+       * @brief Returns the bus name of a device
+       *
+       * @param[in]  aDevice        Device index
+       *
+       * @return Bus name (format: "/dev/i2c-0")
+       */
+      std::string busName(int aDevice);
+
+
+      /**
+       * @brief Returns the address of a device
+       *
+       * @param[in]  aDevice        Device index
+       *
+       * @return Address of the PCA9685 device
+       */
+      int address(int aDevice);
+
+
+      /**
+       * @brief Returns the client id assigned by the broker
+       *
+       * @return Client id
+       */
+      uint32_t clientId();
+
+      /** @} */
+
+
+      /** @{ @name Channel functions */
+
+      /**
+       * @brief Claims channels and waits for the answer of the broker
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannelMask   Bit n selects channel n
+       *
+       * @return Channels of the device owned afterwards
+       */
+      uint16_t claim(int aDevice, uint16_t aChannelMask);
+
+
+      /**
+       * @brief Releases channels and waits for the answer of the broker
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannelMask   Bit n selects channel n
+       *
+       * @return Channels of the device owned afterwards
+       */
+      uint16_t release(int aDevice, uint16_t aChannelMask);
+
+
+      /**
+       * @brief Returns the owned channels of a device as last reported by the broker
+       *
+       * @param[in]  aDevice        Device index
+       *
+       * @return Owned channels
+       */
+      uint16_t ownedChannels(int aDevice);
+
+
+      /**
+       * @brief Sends the PWM settings of a channel for the next frame
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannel       Channel number (0 - 15)
+       * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+       * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+       */
+      void setPWM(int aDevice, int aChannel, int aOnValue, int aOffValue);
+
+
+      /**
+       * @brief Sends the PWM settings of several channels for the next frame
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannelMask   Bit n selects channel n
+       * @param[in]  apOnValues     Values for PWM ON, indexed by channel (0 - 4095)
+       * @param[in]  apOffValues    Values for PWM OFF, indexed by channel (0 - 4095)
+       */
+      void setPWMBatch(int aDevice, uint16_t aChannelMask, const uint16_t* apOnValues, const uint16_t* apOffValues);
+
+
+      /**
+       * @brief Enables stopped outputs of owned channels (e.g. after an emergency stop)
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannelMask   Bit n selects channel n
+       */
+      void enableOutputs(int aDevice, uint16_t aChannelMask);
+
+
+      /**
+       * @brief Switches all outputs of all devices of the broker off immediately
+       */
+      void emergencyStop();
+
+
+      /**
+       * @brief Receives pending broker messages
+       *
+       * @param[in]  aTimeoutMs     Maximum time to wait for a message (ms)
+       *
+       * @return Number of received messages
+       */
+      int poll(int aTimeoutMs);
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Device of the broker
+       */
+      struct Device
+      {
+         std::string mBusName;      ///< Bus name
+         int mAddress;              ///< Address
+         uint16_t mOwned;           ///< Owned channels
+      };
+
+
+      /**
+       * @brief Sends a message (mutex held)
+       *
+       * @param[in]  acrMessage     Message
+       */
+      void send(const BrokerMessage& acrMessage);
+
+
+      /**
+       * @brief Receives one message and applies ownership changes (mutex held)
+       *
+       * @param[in]  aTimeoutMs     Maximum time to wait (ms)
+       * @param[out] arMessage      Received message
+       *
+       * @return `true` if a message was received, `false` on timeout
+       */
+      bool receive(int aTimeoutMs, BrokerMessage& arMessage);
+
+
+      /**
+       * @brief Sends a claim or release and waits for the ownership answer (mutex held)
+       *
+       * @param[in]  aType          BROKER_CLAIM or BROKER_RELEASE
+       * @param[in]  aDevice        Device index
+       * @param[in]  aChannelMask   Bit n selects channel n
+       *
+       * @return Owned channels
+       */
+      uint16_t request(BrokerMessageType aType, int aDevice, uint16_t aChannelMask);
+
+
+      /**
+       * @brief Checks the connection and a device index (mutex held)
+       *
+       * @param[in]  aDevice        Device index
+       */
+      void checkDevice(int aDevice) const;
+
+
+      /**
+       * @brief Closes the socket (mutex held)
+       */
+      void closeSocket();
+
+
+   private:
+      std::mutex mMutex;            ///< Protects socket and device list
+      int mSocket;                  ///< Socket
+      uint32_t mClientId;           ///< Client id
+      uint32_t mRequest;            ///< Number of the last claim or release request
+      std::vector<Device> mDevices; ///< Devices of the broker
+      OwnershipCallback mOwnershipCallback;   ///< Callback for ownership changes
+   }; // class BrokerClient
+} // namespace CAR4TEGRA
+
+#endif // BROKERCLIENT_H
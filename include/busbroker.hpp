@@ -0,0 +1,399 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busbroker.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class BusBroker at namespace CAR4TEGRA
+ *
+ * @details
+ * The BusBroker class exclusively owns the PCA9685 devices of one or more I2C buses and accepts
+ * setpoint streams from several local clients over a Unix-domain SEQPACKET socket. Updates of
+ * all clients are merged into one batched frame per period, so processes no longer interleave
+ * their register writes on a shared bus.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef BUSBROKER_H
+#define BUSBROKER_H
+
+
+// std includes
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/busexecutor.hpp"
+#include "include/pca9685.hpp"
+
+
+#define BROKER_MESSAGE_MAGIC        0x42543443u    ///< Message magic "C4TB" (little endian)
+#define BROKER_MESSAGE_SIZE         112            ///< Size of a broker message (bytes)
+#define BROKER_NAME_SIZE            32             ///< Size of the name field (bytes, zero terminated)
+#define BROKER_SOCKET_DEFAULT       "/tmp/c4tbroker.sock"   ///< Default socket path
+#define BROKER_FRAME_RATE_DEFAULT   100.0f         ///< Default frame rate (Hz)
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief Broker message types
+    */
+   enum BrokerMessageType
+   {
+      BROKER_HELLO = 1,             ///< Client: name and priority (first message)
+      BROKER_WELCOME = 2,           ///< Broker: client id, device count and frame rate
+      BROKER_DEVICE = 3,            ///< Broker: bus name and address of a device (after welcome)
+      BROKER_CLAIM = 4,             ///< Client: claims channels, answered by ownership
+      BROKER_RELEASE = 5,           ///< Client: releases channels, answered by ownership
+      BROKER_OWNERSHIP = 6,         ///< Broker: channels of a device owned by the client (on every change)
+      BROKER_SETPOINTS = 7,         ///< Client: values for the next frame
+      BROKER_ENABLE = 8,            ///< Client: enables stopped outputs of owned channels
+      BROKER_STOP = 9               ///< Client: emergency stop of all devices
+   };
+
+
+   /**
+    * @brief Broker message, one message per SEQPACKET record, host byte order, no padding
+    *
+    * | Type      | mDevice      | mChannelMask   | mPriority | mValue        | Values / name    |
+    * |-----------|--------------|----------------|-----------|---------------|------------------|
+    * | HELLO     | -            | -              | priority  | -             | client name      |
+    * | WELCOME   | device count | -              | -         | client id     | -                |
+    * | DEVICE    | device       | -              | -         | address       | bus name         |
+    * | CLAIM     | device       | channels       | -         | request       | -                |
+    * | RELEASE   | device       | channels       | -         | request       | -                |
+    * | OWNERSHIP | device       | owned channels | -         | request / `0` | -                |
+    * | SETPOINTS | device       | channels       | -         | -             | ON / OFF values  |
+    * | ENABLE    | device       | channels       | -         | -             | -                |
+    * | STOP      | -            | -              | -         | -             | -                |
+    */
+   struct BrokerMessage
+   {
+      uint32_t mMagic;              ///< BROKER_MESSAGE_MAGIC
+      uint16_t mType;               ///< BrokerMessageType
+      uint16_t mDevice;             ///< Device index
+      uint16_t mChannelMask;        ///< Bit n selects channel n
+      uint16_t mPriority;           ///< Client priority (higher preempts lower)
+      uint32_t mValue;              ///< Type specific value
+      uint16_t mOnValues[PCA9685_CHANNEL_COUNT];    ///< PWM ON values (0 - 4095)
+      uint16_t mOffValues[PCA9685_CHANNEL_COUNT];   ///< PWM OFF values (0 - 4095)
+      char mName[BROKER_NAME_SIZE]; ///< Client or bus name
+   } __attribute__((packed));
+
+
+   /**
+    * @class BusBroker busbroker.hpp "include/busbroker.hpp"
+    * @brief The BusBroker class merges the setpoints of several local clients into batched frames
+    *
+    * Every channel is owned by at most one client. A client owns a channel after claiming it
+    * or after the first setpoint for a free channel. A claim takes a channel from its owner if
+    * the claiming client has a higher priority, the previous owner is told by an ownership
+    * message. Setpoints for channels owned by other clients are dropped. The channels of a
+    * disconnected client are released and (by default) switched off.
+    *
+    * Setpoints are staged in a BusExecutor as they arrive (newest value wins), each frame
+    * writes the changed channels with one batched transfer per device and one worker per bus.
+    * Emergency stops are executed immediately, not at the next frame.
+    */
+   class BusBroker
+   {
+   public:
+      /**
+       * @brief Broker statistics
+       */
+      struct Statistics
+      {
+         uint64_t mConnections;     ///< Accepted client connections
+         uint64_t mClients;         ///< Connected clients
+         uint64_t mMessages;        ///< Received messages
+         uint64_t mMalformed;       ///< Dropped: wrong size, magic, type, device or values
+         uint64_t mRejected;        ///< Setpoints dropped for channels owned by other clients
+         uint64_t mPreemptions;     ///< Channels taken from a lower priority client
+         uint64_t mFrames;          ///< Frames with written channels
+         uint64_t mWritten;         ///< Written channels
+      };
+
+
+      /// Callback for client and write errors (called from the broker thread)
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      BusBroker();
+
+
+      /**
+       * @brief Destructor, stops the broker thread and closes the socket
+       */
+      ~BusBroker();
+
+
+      /** @{ @name Setup functions (only while stopped) */
+
+      /**
+       * @brief Adds a connected device, clients address it by the returned index
+       *
+       * @param[in]  arDriver       Device driver (has to outlive the broker)
+       *
+       * @return Device index
+       */
+      int addDevice(PCA9685& arDriver);
+
+
+      /**
+       * @brief Sets the frame rate
+       *
+       * @param[in]  aFrameRate     Frames per second (1 - 2000)
+       */
+      void setFrameRate(float aFrameRate);
+
+
+      /**
+       * @brief Sets if the channels of a disconnected client are switched off
+       *
+       * @param[in]  aStop          `true`: switch off (default), `false`: keep the last values
+       */
+      void setReleaseStop(bool aStop);
+
+
+      /**
+       * @brief Sets the callback for client and write errors
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Opens the listening socket, a stale socket file is replaced
+       *
+       * @param[in]  acrPath        Socket path
+       */
+      void open(const std::string& acrPath = BROKER_SOCKET_DEFAULT);
+
+
+      /**
+       * @brief Disconnects all clients and closes the socket
+       */
+      void close();
+
+      /** @} */
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Starts the broker thread and the bus workers
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the broker thread and the bus workers
+       */
+      void stop();
+
+
+      /**
+       * @brief Handles client messages and due frames in the calling thread
+       *
+       * @param[in]  aTimeoutMs     Maximum time to wait for an event (ms)
+       *
+       * @return Number of handled events
+       */
+      int poll(int aTimeoutMs);
+
+      /** @} */
+
+
+      /** @{ @name Status functions */
+
+      /**
+       * @brief Returns the socket path
+       *
+       * @return Socket path (empty if closed)
+       */
+      const std::string& path() const;
+
+
+      /**
+       * @brief Returns the broker statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      Statistics statistics();
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Connected client
+       */
+      struct Client
+      {
+         std::string mName;         ///< Client name
+         uint32_t mId;              ///< Client id
+         int mPriority;             ///< Priority
+         bool mWelcomed;            ///< Hello was received
+      };
+
+
+      /**
+       * @brief Accepts pending connections
+       */
+      void accept();
+
+
+      /**
+       * @brief Receives and handles all pending messages of a client
+       *
+       * @param[in]  aSocket        Client socket
+       *
+       * @return `false` if the client has to be disconnected
+       */
+      bool receive(int aSocket);
+
+
+      /**
+       * @brief Handles one message of a client
+       *
+       * @param[in]  aSocket        Client socket
+       * @param[in]  arClient       Client
+       * @param[in]  acrMessage     Message
+       *
+       * @return `false` if the client has to be disconnected
+       */
+      bool handle(int aSocket, Client& arClient, const BrokerMessage& acrMessage);
+
+
+      /**
+       * @brief Assigns free channels and channels of lower priority clients to a client
+       *
+       * @param[in]  aSocket        Client socket
+       * @param[in]  aDevice        Device index
+       * @param[in]  aMask          Requested channels
+       * @param[in]  aPreempt       Take channels from lower priority clients
+       *
+       * @return Channels owned by the client afterwards
+       */
+      uint16_t claim(int aSocket, int aDevice, uint16_t aMask, bool aPreempt);
+
+
+      /**
+       * @brief Returns the channels of a device owned by a client
+       *
+       * @param[in]  aSocket        Client socket
+       * @param[in]  aDevice        Device index
+       *
+       * @return Owned channels
+       */
+      uint16_t owned(int aSocket, int aDevice) const;
+
+
+      /**
+       * @brief Sends a message to a client
+       *
+       * @param[in]  aSocket        Client socket
+       * @param[in]  acrMessage     Message
+       *
+       * @return `false` if the client does not take messages anymore
+       */
+      bool send(int aSocket, const BrokerMessage& acrMessage);
+
+
+      /**
+       * @brief Sends the ownership of a device to a client
+       *
+       * @param[in]  aSocket        Client socket
+       * @param[in]  aDevice        Device index
+       * @param[in]  aRequest       Answered claim or release request (`0`: changed by another client)
+       *
+       * @return `false` if the client does not take messages anymore
+       */
+      bool sendOwnership(int aSocket, int aDevice, uint32_t aRequest = 0);
+
+
+      /**
+       * @brief Disconnects a client and releases its channels
+       *
+       * @param[in]  aSocket        Client socket
+       */
+      void disconnect(int aSocket);
+
+
+      /**
+       * @brief Writes the staged values
+       */
+      void runFrame();
+
+
+      /**
+       * @brief Reports an error to the callback
+       *
+       * @param[in]  acrMessage     Error message
+       */
+      void report(const std::string& acrMessage);
+
+
+      /**
+       * @brief Thread function, handles events until stopped
+       */
+      void run();
+
+
+   private:
+      BusExecutor mExecutor;        ///< Writes the frames, one worker per bus
+      std::vector<PCA9685*> mDevices;        ///< Devices by index
+      std::vector<int> mOwners;     ///< Owner socket of each global channel (`-1`: free)
+      std::map<int, Client> mClients;        ///< Connected clients by socket
+      std::vector<int> mDisconnects;         ///< Sockets to disconnect after the current event
+      std::string mPath;            ///< Socket path
+      int mSocket;                  ///< Listening socket
+      int mEpoll;                   ///< Event poll of socket, clients and frame timer
+      int mTimer;                   ///< Frame timer
+      float mFrameRate;             ///< Frame rate (Hz)
+      bool mReleaseStop;            ///< Switch off channels of disconnected clients
+      uint32_t mNextId;             ///< Id of the next client
+      bool mStaged;                 ///< Values were staged since the last frame
+      std::thread mThread;          ///< Broker thread
+      std::atomic<bool> mRunning;   ///< Broker thread is running
+      ErrorCallback mErrorCallback; ///< Callback for errors
+      std::mutex mStatisticsMutex;  ///< Protects the statistics
+      Statistics mStatistics;       ///< Broker statistics
+   }; // class BusBroker
+} // namespace CAR4TEGRA
+
+#endif // BUSBROKER_H
@@ -0,0 +1,296 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busexecutor.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class BusExecutor at namespace CAR4TEGRA
+ *
+ * @details
+ * The BusExecutor class writes output frames to PCA9685 devices on several I2C buses. Each
+ * bus is served by its own worker thread, so the transfers on different buses run in parallel.
+ * A frame is finished when all bus workers have written their part of it.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef BUSEXECUTOR_H
+#define BUSEXECUTOR_H
+
+
+// std includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class BusExecutor busexecutor.hpp "include/busexecutor.hpp"
+    * @brief The BusExecutor class writes output frames with one worker thread per I2C bus
+    *
+    * Devices are grouped by their bus name when added. Channels are addressed by a global index
+    * (`device index * 16 + channel`). Values set for the next frame are split by bus in
+    * runFrame(), every bus worker writes the changed channels of its devices with one batched
+    * transfer per device. runFrame() returns when all buses are done (frame barrier).
+    * All buffers are allocated by addDevice(), setting values and running frames does not allocate.
+    */
+   class BusExecutor
+   {
+   public:
+      typedef std::chrono::steady_clock Clock;     ///< Clock used for the frame timing
+
+      /**
+       * @brief Statistics of one bus
+       */
+      struct BusStatistics
+      {
+         uint64_t mFrames;          ///< Number of frames with transfers on the bus
+         uint64_t mWritten;         ///< Number of channels written
+         uint64_t mTransfers;       ///< Number of batched device transfers
+         uint64_t mErrors;          ///< Number of failed device transfers
+         double mLastFrameUs;       ///< Bus time of the last frame (us)
+         double mMaxFrameUs;        ///< Worst bus time of a frame (us)
+         double mBusyUs;            ///< Total bus time (us)
+      };
+
+
+      /**
+       * @brief Statistics of the frames
+       */
+      struct Statistics
+      {
+         uint64_t mFrames;          ///< Number of frames run
+         double mLastFrameUs;       ///< Time from dispatch to barrier of the last frame (us)
+         double mMaxFrameUs;        ///< Worst time from dispatch to barrier (us)
+      };
+
+
+      /// Callback for failed transfers (called from the bus worker threads)
+      typedef std::function<void(int aDevice, const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      BusExecutor();
+
+
+      /**
+       * @brief Destructor, stops the bus workers
+       */
+      ~BusExecutor();
+
+
+      /** @{ @name Setup functions (only while stopped) */
+
+      /**
+       * @brief Adds a connected device, the bus is taken from the device
+       *
+       * @param[in]  arDriver       Device driver (has to outlive the executor)
+       *
+       * @return Device index
+       */
+      int addDevice(PCA9685& arDriver);
+
+
+      /**
+       * @brief Pins the worker of a bus to a CPU
+       *
+       * @param[in]  acrBusName     Name of the bus (format: "/dev/i2c-0")
+       * @param[in]  aCpu           CPU index, `-1` to allow all CPUs
+       */
+      void setAffinity(const std::string& acrBusName, int aCpu);
+
+
+      /**
+       * @brief Sets the callback for failed transfers
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+      /** @} */
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Starts one worker thread per bus
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the worker threads
+       */
+      void stop();
+
+
+      /**
+       * @brief Sets the value of a channel for the next frame (thread-safe)
+       *
+       * @param[in]  aChannel       Global channel index
+       * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+       * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+       */
+      void set(int aChannel, int aOnValue, int aOffValue);
+
+
+      /**
+       * @brief Writes the values set since the last frame and waits until all buses are done
+       *
+       * Without started workers the buses are written one after another by the calling thread.
+       *
+       * @return Number of channels written
+       */
+      int runFrame();
+
+
+      /**
+       * @brief Switches all outputs off with one byte per device and drops the staged values
+       *
+       * Runs in the calling thread without waiting for a frame, see PCA9685::emergencyStop().
+       * Outputs stay off until PCA9685::enableOutputs().
+       */
+      void emergencyStop();
+
+      /** @} */
+
+
+      /** @{ @name Status functions */
+
+      /**
+       * @brief Returns the number of buses
+       *
+       * @return Number of buses
+       */
+      size_t busCount() const;
+
+
+      /**
+       * @brief Returns the name of a bus
+       *
+       * @param[in]  aBus           Bus index (0 - busCount() - 1)
+       *
+       * @return Bus name
+       */
+      const std::string& busName(size_t aBus) const;
+
+
+      /**
+       * @brief Returns the statistics of a bus (thread-safe)
+       *
+       * @param[in]  aBus           Bus index (0 - busCount() - 1)
+       *
+       * @return Statistics of the bus
+       */
+      BusStatistics busStatistics(size_t aBus);
+
+
+      /**
+       * @brief Returns the frame statistics (thread-safe)
+       *
+       * @return Frame statistics
+       */
+      Statistics statistics();
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Channel values of one device for one frame
+       */
+      struct DeviceFrame
+      {
+         uint16_t mMask;                              ///< Channels set in the frame
+         uint16_t mOnValues[PCA9685_CHANNEL_COUNT];   ///< PWM ON values
+         uint16_t mOffValues[PCA9685_CHANNEL_COUNT];  ///< PWM OFF values
+      };
+
+
+      /**
+       * @brief One bus with its devices and worker
+       */
+      struct Bus
+      {
+         std::string mName;         ///< Name of the bus
+         std::vector<int> mDevices; ///< Indices of the devices on the bus
+         int mCpu;                  ///< CPU the worker is pinned to (`-1` for all)
+         BusStatistics mStatistics; ///< Statistics of the bus (protected by mFrameMutex)
+         std::thread mThread;       ///< Worker thread
+      };
+
+
+      /**
+       * @brief Writes the current frame of one bus
+       *
+       * @param[in]  arBus          Bus to write
+       *
+       * @return Number of channels written
+       */
+      int writeBus(Bus& arBus);
+
+
+      /**
+       * @brief Worker thread function, writes one bus per frame until stopped
+       *
+       * @param[in]  apBus          Bus served by the worker
+       * @param[in]  aGeneration    Number of the last frame before the start
+       */
+      void run(Bus* apBus, uint64_t aGeneration);
+
+
+   private:
+      std::vector<PCA9685*> mDevices;        ///< Devices on all buses
+      std::vector<std::unique_ptr<Bus>> mBuses;    ///< Buses with their workers
+      std::vector<DeviceFrame> mStaged;      ///< Values set for the next frame
+      std::vector<DeviceFrame> mFrame;       ///< Values of the frame being written
+      std::mutex mStageMutex;                ///< Protects the staged values
+      std::mutex mFrameMutex;                ///< Protects the frame barrier and the statistics
+      std::condition_variable mFrameStart;   ///< Signals a new frame to the workers
+      std::condition_variable mFrameDone;    ///< Signals the last finished bus of a frame
+      uint64_t mGeneration;                  ///< Number of the current frame
+      size_t mRemaining;                     ///< Buses not yet done with the current frame
+      int mWritten;                          ///< Channels written in the current frame
+      Statistics mStatistics;                ///< Frame statistics
+      ErrorCallback mErrorCallback;          ///< Callback for failed transfers
+      std::atomic<bool> mRunning;            ///< Workers are running
+   }; // class BusExecutor
+} // namespace CAR4TEGRA
+
+#endif // BUSEXECUTOR_H
@@ -0,0 +1,321 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busscheduler.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class BusScheduler at namespace CAR4TEGRA
+ *
+ * @details
+ * The BusScheduler class distributes the I2C bus bandwidth of one PWM frame over the pending
+ * channel updates of all PCA9685 devices on a bus. Updates are written by channel priority
+ * and deadline, updates which do not fit into the frame budget are deferred to the next frame.
+ * An update whose deadline would pass before the next frame is raised by one priority level,
+ * so it overtakes updates of the next level without delaying more important channels.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef BUSSCHEDULER_H
+#define BUSSCHEDULER_H
+
+
+// std includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/driverclock.hpp"
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class BusScheduler busscheduler.hpp "include/busscheduler.hpp"
+    * @brief The BusScheduler class writes channel updates within the bus budget of a PWM frame
+    *
+    * Channels are addressed by a global index (`device index * 16 + channel`). Multiple
+    * updates of a channel within one frame are coalesced, only the last value is written.
+    * All buffers are allocated by addDevice(), submitting and writing updates does not allocate.
+    */
+   class BusScheduler
+   {
+   public:
+      typedef std::chrono::steady_clock Clock;     ///< Clock used for deadlines and latencies
+
+      /**
+       * @brief Scheduling statistics
+       */
+      struct Statistics
+      {
+         uint64_t mFrames;          ///< Number of frames run
+         uint64_t mWritten;         ///< Number of updates written
+         uint64_t mCoalesced;       ///< Number of updates replaced by a newer value before writing
+         uint64_t mDeferred;        ///< Number of times an update was moved to the next frame
+         uint64_t mDeadlineMisses;  ///< Number of updates written after their deadline
+         uint64_t mPromoted;        ///< Number of updates written ahead of their priority because of their deadline
+         uint64_t mErrors;          ///< Number of failed updates
+         double mBudgetUs;          ///< Bus time budget of one frame (us)
+         double mLastUsedUs;        ///< Bus time used by the last frame (us)
+      };
+
+
+      /// Callback for failed updates (called from the thread running the frames)
+      typedef std::function<void(int aChannel, const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz)
+       * @param[in]  aFrequency     PWM frequency (Hz), defines the frame period
+       */
+      BusScheduler(uint32_t aBusClock = 100000, float aFrequency = 60.0f);
+
+
+      /**
+       * @brief Destructor, stops the frame thread
+       */
+      ~BusScheduler();
+
+
+      /** @{ @name Setup functions (only while stopped) */
+
+      /**
+       * @brief Adds a device on the scheduled bus
+       *
+       * @param[in]  arDriver       Device driver (has to outlive the scheduler)
+       *
+       * @return Device index
+       */
+      int addDevice(PCA9685& arDriver);
+
+
+      /**
+       * @brief Sets the bus clock
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz)
+       */
+      void setBusClock(uint32_t aBusClock);
+
+
+      /**
+       * @brief Sets the PWM frequency, one frame is one PWM period
+       *
+       * @param[in]  aFrequency     PWM frequency (Hz)
+       */
+      void setPWMFrequency(float aFrequency);
+
+
+      /**
+       * @brief Sets the fixed cost of one transaction (syscall, driver and start / stop overhead)
+       *
+       * @param[in]  aOverheadUs    Overhead per transaction (us)
+       */
+      void setTransactionOverhead(double aOverheadUs);
+
+
+      /**
+       * @brief Sets the fraction of the frame period which may be used for bus transfers
+       *
+       * @param[in]  aUtilization   Fraction of the frame period (0.0 - 1.0)
+       */
+      void setUtilization(double aUtilization);
+
+
+      /**
+       * @brief Sets priority and deadline of a channel
+       *
+       * @param[in]  aChannel       Global channel index
+       * @param[in]  aPriority      Priority (higher values are written first)
+       * @param[in]  aDeadline      Maximum time from submit to write (due updates gain one priority level)
+       */
+      void setChannelPriority(int aChannel, int aPriority, std::chrono::microseconds aDeadline);
+
+      /** @} */
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Submits a channel update (thread-safe)
+       *
+       * @param[in]  aChannel       Global channel index
+       * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+       * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+       */
+      void submit(int aChannel, int aOnValue, int aOffValue);
+
+
+      /**
+       * @brief Writes the pending updates which fit into one frame budget
+       *
+       * @return Number of updates written
+       */
+      int runFrame();
+
+
+      /**
+       * @brief Switches all outputs off with one byte per device and drops the pending updates
+       *
+       * Runs in the calling thread without waiting for a frame, see PCA9685::emergencyStop().
+       * Outputs stay off until PCA9685::enableOutputs().
+       */
+      void emergencyStop();
+
+
+      /**
+       * @brief Starts a thread which runs one frame per PWM period
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the frame thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Returns the scheduling statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      Statistics statistics();
+
+
+      /**
+       * @brief Returns the worst submit-to-write latency of a channel (thread-safe)
+       *
+       * @param[in]  aChannel       Global channel index
+       *
+       * @return Latency (us)
+       */
+      double maxLatency(int aChannel);
+
+
+      /**
+       * @brief Sets the callback for failed updates (only while stopped)
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Sets the clock used for the frame pacing (only while stopped)
+       *
+       * @param[in]  arClock        Clock (has to outlive the scheduler, default: DriverClock::monotonic())
+       */
+      void setClock(DriverClock& arClock);
+
+      /** @} */
+
+
+      /**
+       * @brief Returns the bus time of one transaction
+       *
+       * @param[in]  aDataBytes     Number of data bytes (without address and register byte)
+       *
+       * @return Bus time (us)
+       */
+      double transactionCost(size_t aDataBytes) const;
+
+
+   private:
+      /**
+       * @brief State of one channel
+       */
+      struct Channel
+      {
+         int mPriority;             ///< Scheduling priority
+         std::chrono::microseconds mDeadline;   ///< Maximum time from submit to write
+         bool mPending;             ///< Update is waiting to be written
+         int mOnValue;              ///< Pending PWM ON value
+         int mOffValue;             ///< Pending PWM OFF value
+         Clock::time_point mSubmitted;  ///< Submit time of the first not yet written update
+         double mMaxLatencyUs;      ///< Worst submit-to-write latency
+      };
+
+
+      /**
+       * @brief Update taken over for writing
+       */
+      struct Update
+      {
+         int mChannel;              ///< Global channel index
+         int mOnValue;              ///< PWM ON value
+         int mOffValue;             ///< PWM OFF value
+         Clock::time_point mSubmitted;  ///< Submit time
+         std::chrono::microseconds mDeadline;   ///< Maximum time from submit to write
+      };
+
+
+      /**
+       * @brief Checks a global channel index
+       *
+       * @param[in]  aChannel       Global channel index
+       */
+      void checkChannel(int aChannel) const;
+
+
+      /**
+       * @brief Recalculates the frame budget
+       */
+      void updateBudget();
+
+
+      /**
+       * @brief Thread function, runs frames until stopped
+       */
+      void run();
+
+
+   private:
+      std::vector<PCA9685*> mDevices;  ///< Devices on the bus
+      std::vector<Channel> mChannels;  ///< Channel states (16 per device)
+      std::vector<int> mOrder;         ///< Scratch buffer for the write order of a frame
+      std::vector<Update> mBatch;      ///< Scratch buffer for the updates written in a frame
+      std::mutex mMutex;               ///< Protects the channel states and statistics
+      uint32_t mBusClock;              ///< I2C bus clock (Hz)
+      Clock::duration mPeriod;         ///< Frame period
+      double mOverheadUs;              ///< Fixed cost of one transaction (us)
+      double mUtilization;             ///< Usable fraction of the frame period
+      Statistics mStatistics;          ///< Scheduling statistics
+      ErrorCallback mErrorCallback;    ///< Callback for failed updates
+      DriverClock* mpClock;            ///< Clock for deadlines, latencies and the frame pacing
+      std::thread mThread;             ///< Frame thread
+      std::atomic<bool> mRunning;      ///< Frame thread is running
+   }; // class BusScheduler
+} // namespace CAR4TEGRA
+
+#endif // BUSSCHEDULER_H
@@ -0,0 +1,288 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file c4tdriver.h
+ * @date 19.10.2026
+ *
+ * @brief This file contains the C API of the Car4Tegra driver library
+ *
+ * @details
+ * The C API wraps a PCA9685 driver behind an opaque handle, so control processes can embed the
+ * driver library without C++ or Qt. Functions return C4T_OK or a negative error code, the
+ * message of the last error of the calling thread is returned by c4t_last_error(). No C++
+ * exception leaves the API.
+ *
+ * The API is stable within one C4T_API_VERSION: functions are only added, never changed.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef C4TDRIVER_H
+#define C4TDRIVER_H
+
+
+// std includes
+#include <stdint.h>
+
+
+#define C4T_API_VERSION       1        ///< Version of the C API
+
+#define C4T_OK                0        ///< Success
+#define C4T_ERROR_IO          (-1)     ///< Bus or device error
+#define C4T_ERROR_RANGE       (-2)     ///< Argument out of range (e.g. channel number)
+#define C4T_ERROR_ARGUMENT    (-3)     ///< Invalid handle or pointer
+#define C4T_ERROR_MEMORY      (-4)     ///< Out of memory
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Opaque handle of one PCA9685 device
+typedef struct c4t_device c4t_device;
+
+
+/** @{ @name Library functions */
+
+/**
+ * @brief Returns the version of the C API the library was built with
+ *
+ * @return C4T_API_VERSION of the library
+ */
+unsigned c4t_api_version(void);
+
+
+/**
+ * @brief Returns the message of the last failed call of the calling thread
+ *
+ * @return Error message (empty if no call failed), valid until the next failing call
+ */
+const char* c4t_last_error(void);
+
+/** @} */
+
+
+/** @{ @name Device functions */
+
+/**
+ * @brief Opens a PCA9685 device
+ *
+ * @param[in]  apBusName      Name of the I2C bus (format: "/dev/i2c-0")
+ * @param[in]  aAddress       Address of the PCA9685 device (8 bit format, e.g. 0x80)
+ * @param[out] appDevice      Device handle, to be released with c4t_close()
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_open(const char* apBusName, int aAddress, c4t_device** appDevice);
+
+
+/**
+ * @brief Opens a simulated PCA9685 device (register file in memory, for tests without hardware)
+ *
+ * @param[in]  apBusName      Name reported for the bus
+ * @param[in]  aAddress       Address of the simulated device
+ * @param[out] appDevice      Device handle, to be released with c4t_close()
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_open_simulated(const char* apBusName, int aAddress, c4t_device** appDevice);
+
+
+/**
+ * @brief Closes a device and releases its handle (`NULL` is ignored)
+ *
+ * @param[in]  apDevice       Device handle
+ */
+void c4t_close(c4t_device* apDevice);
+
+
+/**
+ * @brief Configures the device unless it is already running with the requested configuration
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aFrequency     PWM frequency (24 - 1526 Hz)
+ * @param[out] apAdopted      Set to 1 if the running configuration was adopted, 0 otherwise (may be `NULL`)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_connect(c4t_device* apDevice, float aFrequency, int* apAdopted);
+
+
+/**
+ * @brief Reopens the bus and restores the last commanded device state
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[out] apKept         Set to 1 if the device kept its configuration, 0 otherwise (may be `NULL`)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_reconnect(c4t_device* apDevice, int* apKept);
+
+
+/**
+ * @brief Sets the PWM frequency
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aFrequency     PWM frequency (24 - 1526 Hz)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_set_frequency(c4t_device* apDevice, float aFrequency);
+
+
+/**
+ * @brief Sets the bus timing used to plan write transactions
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aBusClock      I2C bus clock (Hz)
+ * @param[in]  aOverheadUs    Fixed cost of one transaction (us)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_set_bus_timing(c4t_device* apDevice, uint32_t aBusClock, double aOverheadUs);
+
+/** @} */
+
+
+/** @{ @name Output functions */
+
+/**
+ * @brief Writes the PWM settings of one channel
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aChannel       Channel number (0 - 15)
+ * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+ * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_set_pwm(c4t_device* apDevice, int aChannel, int aOnValue, int aOffValue);
+
+
+/**
+ * @brief Writes the PWM settings of several channels with the cheapest transaction set
+ *
+ * This is the steady-state update path, it does not allocate.
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aChannelMask   Bit n selects channel n
+ * @param[in]  apOnValues     16 values for PWM ON, indexed by channel (0 - 4095)
+ * @param[in]  apOffValues    16 values for PWM OFF, indexed by channel (0 - 4095)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_set_pwm_batch(c4t_device* apDevice, uint16_t aChannelMask, const uint16_t* apOnValues,
+                      const uint16_t* apOffValues);
+
+
+/**
+ * @brief Writes the PWM settings of all channels
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+ * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_set_all_pwm(c4t_device* apDevice, int aOnValue, int aOffValue);
+
+
+/**
+ * @brief Switches channels off (FULL_OFF) and keeps their PWM values
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aChannelMask   Bit n selects channel n
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_stop_outputs(c4t_device* apDevice, uint16_t aChannelMask);
+
+
+/**
+ * @brief Switches stopped channels back on with their last commanded PWM values
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aChannelMask   Bit n selects channel n
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_enable_outputs(c4t_device* apDevice, uint16_t aChannelMask);
+
+
+/**
+ * @brief Switches all channels off with one byte, without waiting for other bus users
+ *
+ * @param[in]  apDevice       Device handle
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_emergency_stop(c4t_device* apDevice);
+
+
+/**
+ * @brief Returns the stopped channels
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[out] apChannelMask  Bit n is set if channel n is stopped
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_stopped_outputs(c4t_device* apDevice, uint16_t* apChannelMask);
+
+/** @} */
+
+
+/** @{ @name Register functions */
+
+/**
+ * @brief Reads a register byte
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aRegister      Register to read from
+ * @param[out] apValue        Register value
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_read_register(c4t_device* apDevice, int aRegister, int* apValue);
+
+
+/**
+ * @brief Writes a register byte
+ *
+ * @param[in]  apDevice       Device handle
+ * @param[in]  aRegister      Register to write to
+ * @param[in]  aValue         Value to write
+ *
+ * @return C4T_OK or error code
+ */
+int c4t_write_register(c4t_device* apDevice, int aRegister, int aValue);
+
+/** @} */
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // C4TDRIVER_H
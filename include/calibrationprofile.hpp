@@ -0,0 +1,183 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file calibrationprofile.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class CalibrationProfile at namespace CAR4TEGRA
+ *
+ * @details
+ * The CalibrationProfile class holds the PWM frequency and the channel ranges of one PCA9685
+ * device. Profiles are plain text files, so calibrations can be changed without recompiling
+ * and rolled out to running processes (see ProfileWatcher and ProfileApplier):
+ *
+ *     # PWM frequency of the device (Hz, optional)
+ *     frequency 60
+ *     # channel <index> <PWM value at -1> <PWM value at 1> [inverted]
+ *     channel 0 160 715
+ *     channel 1 300 500 inverted
+ *
+ * Channels not listed are not managed by the profile.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef CALIBRATIONPROFILE_H
+#define CALIBRATIONPROFILE_H
+
+
+// std includes
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Car4Tegra includes
+#include "include/pca9685defines.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief Calibration of one channel
+    */
+   struct ChannelCalibration
+   {
+      bool mUsed;                   ///< Channel is part of the profile
+      int mMin;                     ///< PWM value at position -1 (0 - 4095)
+      int mMax;                     ///< PWM value at position 1 (above mMin)
+      bool mInverted;               ///< Position -1 gives mMax and 1 gives mMin
+   };
+
+
+   /**
+    * @class CalibrationProfile calibrationprofile.hpp "include/calibrationprofile.hpp"
+    * @brief The CalibrationProfile class holds the frequency and the channel calibrations of a device
+    */
+   class CalibrationProfile
+   {
+   public:
+      /**
+       * @brief Standard constructor, creates an empty profile (no frequency, no channels)
+       */
+      CalibrationProfile();
+
+
+      /**
+       * @brief Reads a profile file
+       *
+       * @param[in]  acrFileName    Profile file
+       *
+       * @return Profile
+       */
+      static CalibrationProfile load(const std::string& acrFileName);
+
+
+      /**
+       * @brief Parses the text of a profile
+       *
+       * @param[in]  acrText        Profile text
+       * @param[in]  acrSource      Name of the source used in error messages
+       *
+       * @return Profile
+       */
+      static CalibrationProfile parse(const std::string& acrText, const std::string& acrSource);
+
+
+      /** @{ @name Profile functions */
+
+      /**
+       * @brief Sets the PWM frequency
+       *
+       * @param[in]  aFrequency     PWM frequency (24 - 1526 Hz, `0`: not part of the profile)
+       */
+      void setFrequency(float aFrequency);
+
+
+      /**
+       * @brief Returns the PWM frequency
+       *
+       * @return PWM frequency (Hz, `0`: not part of the profile)
+       */
+      float frequency() const;
+
+
+      /**
+       * @brief Sets the calibration of a channel
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       * @param[in]  acrCalibration Calibration (`mUsed == false` removes the channel from the profile)
+       */
+      void setChannel(int aChannel, const ChannelCalibration& acrCalibration);
+
+
+      /**
+       * @brief Returns the calibration of a channel
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       *
+       * @return Calibration
+       */
+      const ChannelCalibration& channel(int aChannel) const;
+
+
+      /**
+       * @brief Returns the PWM value of a channel position
+       *
+       * @param[in]  aChannel       Channel of the profile (0 - 15)
+       * @param[in]  aPosition      Position (-1.0 - 1.0, limited to this range)
+       *
+       * @return PWM value (0 - 4095)
+       */
+      int toPWM(int aChannel, double aPosition) const;
+
+
+      /**
+       * @brief Returns the channels whose calibration differs from another profile
+       *
+       * @param[in]  acrOther       Other profile
+       *
+       * @return Bit n is set if channel n was added, removed or changed
+       */
+      uint16_t changedChannels(const CalibrationProfile& acrOther) const;
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Checks the channel index
+       *
+       * @param[in]  aChannel       Channel
+       */
+      static void checkChannel(int aChannel);
+
+
+   private:
+      float mFrequency;             ///< PWM frequency (Hz, `0`: not part of the profile)
+      std::array<ChannelCalibration, PCA9685_CHANNEL_COUNT> mChannels;  ///< Channel calibrations
+   }; // class CalibrationProfile
+} // namespace CAR4TEGRA
+
+#endif // CALIBRATIONPROFILE_H
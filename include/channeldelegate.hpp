@@ -0,0 +1,78 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file channeldelegate.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class ChannelDelegate
+ *
+ * @details
+ * The ChannelDelegate class paints and edits the cells of the ChannelModel table: spin boxes
+ * for the calibration range and the value, a bar for the value within its range and a colored
+ * marker for the write status.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef CHANNELDELEGATE_H
+#define CHANNELDELEGATE_H
+
+
+// QT includes
+#include <QStyledItemDelegate>
+
+
+/**
+ * @class ChannelDelegate channeldelegate.hpp "include/channeldelegate.hpp"
+ * @brief The ChannelDelegate class paints and edits the channel dashboard cells
+ *
+ * Only the cell being edited owns an editor widget, all other cells are painted, so the
+ * dashboard scales to any number of channels.
+ */
+class ChannelDelegate : public QStyledItemDelegate
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Constructor
+    *
+    * @param[in]  apParent       QT parent
+    */
+   explicit ChannelDelegate(QObject* apParent = 0);
+
+
+   /** @{ @name QStyledItemDelegate interface */
+
+   void paint(QPainter* apPainter, const QStyleOptionViewItem& acrOption, const QModelIndex& acrIndex) const override;
+   QWidget* createEditor(QWidget* apParent, const QStyleOptionViewItem& acrOption,
+                         const QModelIndex& acrIndex) const override;
+   void setEditorData(QWidget* apEditor, const QModelIndex& acrIndex) const override;
+   void setModelData(QWidget* apEditor, QAbstractItemModel* apModel, const QModelIndex& acrIndex) const override;
+
+   /** @} */
+}; // class ChannelDelegate
+
+#endif // CHANNELDELEGATE_H
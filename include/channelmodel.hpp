@@ -0,0 +1,261 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file channelmodel.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class ChannelModel
+ *
+ * @details
+ * The ChannelModel class is a table model over all PWM channels of all added PCA9685 boards
+ * (one row per channel) with calibration range, invert flag, current value and write status.
+ * Value and status updates are buffered and published as one coalesced dataChanged range per
+ * UI frame. Edits of range and invert flag rewrite the channel through the calibration mapping
+ * of CalibrationProfile.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef CHANNELMODEL_H
+#define CHANNELMODEL_H
+
+
+// QT includes
+#include <QAbstractTableModel>
+#include <QTimer>
+
+// std includes
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+#include "include/calibrationprofile.hpp"
+
+
+/**
+ * @class ChannelModel channelmodel.hpp "include/channelmodel.hpp"
+ * @brief The ChannelModel class provides the channels of all boards to a table view
+ *
+ * updateValue() can be called from any thread at any rate, it only stores the newest value of a
+ * row. The frame timer applies the stored values and emits one dataChanged() for the range of
+ * changed rows. Values edited in the view are written to the board directly or through the write
+ * callback of the board. An edited range keeps a written value inside of it, an edited invert flag
+ * mirrors a written value within the range (same position, opposite direction).
+ */
+class ChannelModel : public QAbstractTableModel
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Table columns
+    */
+   enum Column
+   {
+      COLUMN_BOARD = 0,             ///< Bus of the board (read-only)
+      COLUMN_CHANNEL,               ///< Channel of the board (read-only)
+      COLUMN_MIN,                   ///< Lower calibration bound
+      COLUMN_MAX,                   ///< Upper calibration bound
+      COLUMN_INVERT,                ///< Inverted direction (check box)
+      COLUMN_VALUE,                 ///< Current PWM value
+      COLUMN_STATUS,                ///< Write status (read-only)
+      COLUMN_COUNT                  ///< Number of columns
+   };
+
+   /**
+    * @brief Write status of a channel
+    */
+   enum Status
+   {
+      STATUS_OFFLINE = 0,           ///< Board is not connected
+      STATUS_OK,                    ///< Last write succeeded
+      STATUS_ERROR                  ///< Last write failed
+   };
+
+   static const int StatusRole = Qt::UserRole + 1;   ///< Role returning the Status of a row
+
+   /// Callback writing an edited value (GUI thread), reports the result with updateValue()
+   typedef std::function<void(int aChannel, int aValue)> WriteCallback;
+
+
+   /**
+    * @brief Constructor
+    *
+    * @param[in]  aFrameMs       Interval of the coalesced view updates (ms)
+    * @param[in]  apParent       QT parent
+    */
+   explicit ChannelModel(int aFrameMs, QObject* apParent = 0);
+
+
+   /**
+    * @brief Adds the 16 channels of a board (GUI thread)
+    *
+    * @param[in]  arDriver       Board driver (has to outlive the model)
+    * @param[in]  aCallback      Writes edited values instead of the model (`nullptr`: model writes to arDriver)
+    *
+    * @return Board index
+    */
+   int addBoard(CAR4TEGRA::PCA9685& arDriver, WriteCallback aCallback = nullptr);
+
+
+   /**
+    * @brief Refreshes all rows of a board, e.g. after connecting or disconnecting (GUI thread)
+    *
+    * @param[in]  aBoard         Board index
+    */
+   void boardChanged(int aBoard);
+
+
+   /**
+    * @brief Stores a written value for the next view update (thread-safe)
+    *
+    * @param[in]  aBoard         Board index
+    * @param[in]  aChannel       Channel of the board (0 - 15)
+    * @param[in]  aValue         Written PWM value
+    * @param[in]  aFailed        The write failed
+    */
+   void updateValue(int aBoard, int aChannel, int aValue, bool aFailed);
+
+
+   /**
+    * @brief Takes over the calibration of a channel set outside of the view, nothing is written (GUI thread)
+    *
+    * @param[in]  aBoard         Board index
+    * @param[in]  aChannel       Channel of the board (0 - 15)
+    * @param[in]  acrCalibration Calibration (`mUsed` is ignored)
+    */
+   void setCalibration(int aBoard, int aChannel, const CAR4TEGRA::ChannelCalibration& acrCalibration);
+
+
+   /**
+    * @brief Returns the calibration of a channel (GUI thread)
+    *
+    * @param[in]  aBoard         Board index
+    * @param[in]  aChannel       Channel of the board (0 - 15)
+    *
+    * @return Calibration
+    */
+   const CAR4TEGRA::ChannelCalibration& calibration(int aBoard, int aChannel) const;
+
+
+   /** @{ @name QAbstractTableModel interface */
+
+   int rowCount(const QModelIndex& acrParent = QModelIndex()) const override;
+   int columnCount(const QModelIndex& acrParent = QModelIndex()) const override;
+   QVariant data(const QModelIndex& acrIndex, int aRole = Qt::DisplayRole) const override;
+   bool setData(const QModelIndex& acrIndex, const QVariant& acrValue, int aRole = Qt::EditRole) override;
+   QVariant headerData(int aSection, Qt::Orientation aOrientation, int aRole = Qt::DisplayRole) const override;
+   Qt::ItemFlags flags(const QModelIndex& acrIndex) const override;
+
+   /** @} */
+
+
+signals:
+   /**
+    * @brief Emitted if writing an edited value failed
+    *
+    * @param[in]  acrMessage     Error message
+    */
+   void writeFailed(const QString& acrMessage);
+
+
+   /**
+    * @brief Emitted after range, invert flag or value of a channel were edited in the view
+    *
+    * @param[in]  aBoard         Board index
+    * @param[in]  aChannel       Channel of the board
+    */
+   void channelEdited(int aBoard, int aChannel);
+
+
+private slots:
+   /**
+    * @brief Applies the stored values and emits one dataChanged() for the changed rows
+    */
+   void flush();
+
+
+private:
+   /**
+    * @brief State of one channel row
+    */
+   struct Row
+   {
+      int mBoard;                   ///< Board index
+      int mChannel;                 ///< Channel of the board
+      int mValue;                   ///< Current PWM value
+      bool mWritten;                ///< A value was written since the board was added
+      bool mFailed;                 ///< Last write failed
+      uint32_t mErrors;             ///< Number of failed writes
+   };
+
+   /**
+    * @brief Value stored by updateValue() for the next frame
+    */
+   struct Pending
+   {
+      bool mSet;                    ///< A value was stored since the last frame
+      int mValue;                   ///< Newest PWM value
+      bool mFailed;                 ///< Newest write failed
+      uint32_t mErrors;             ///< Failed writes since the last frame
+   };
+
+
+   /**
+    * @brief Writes a value to the board of a row (GUI thread)
+    *
+    * @param[in]  aRow           Row index
+    * @param[in]  aValue         PWM value
+    */
+   void writeValue(int aRow, int aValue);
+
+
+   /**
+    * @brief Changes the calibration of a row and rewrites its value through the new calibration (GUI thread)
+    *
+    * @param[in]  aRow           Row index
+    * @param[in]  acrCalibration New calibration
+    *
+    * @return `true` if the calibration is valid
+    */
+   bool editCalibration(int aRow, const CAR4TEGRA::ChannelCalibration& acrCalibration);
+
+
+private:
+   std::vector<CAR4TEGRA::PCA9685*> mBoards;    ///< Boards of the rows
+   std::vector<WriteCallback> mWriteCallbacks;  ///< Write callbacks of the boards
+   std::vector<CAR4TEGRA::CalibrationProfile> mCalibrations;   ///< Channel calibrations of the boards
+   std::vector<Row> mRows;                      ///< Row states (GUI thread)
+   std::vector<Pending> mPending;               ///< Values stored for the next frame
+   std::mutex mMutex;                           ///< Protects mPending and the dirty range
+   int mDirtyFirst;                             ///< First row with a stored value
+   int mDirtyLast;                              ///< Last row with a stored value (`-1`: none)
+   QTimer mTimer;                               ///< Frame timer
+}; // class ChannelModel
+
+#endif // CHANNELMODEL_H
@@ -0,0 +1,191 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file driverclock.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of the clock classes at namespace CAR4TEGRA
+ *
+ * @details
+ * The driver classes read the time and wait through a DriverClock instead of calling the
+ * system clock directly. MonotonicClock is the real clock used by default, VirtualClock lets
+ * tests and simulations run timing-dependent code (oscillator waits, frame pacing, sequences)
+ * without waiting for the wall clock.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef DRIVERCLOCK_H
+#define DRIVERCLOCK_H
+
+
+// std includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class DriverClock driverclock.hpp "include/driverclock.hpp"
+    * @brief The DriverClock class is the time source and sleeper of the driver classes
+    *
+    * Time points share the type of `std::chrono::steady_clock`, so a clock can replace
+    * `steady_clock::now()` and `std::this_thread::sleep_until()` one to one.
+    * Implementations are thread-safe.
+    */
+   class DriverClock
+   {
+   public:
+      typedef std::chrono::steady_clock::time_point TimePoint;    ///< Point in time
+      typedef std::chrono::steady_clock::duration Duration;       ///< Time span
+
+
+      /**
+       * @brief Destructor
+       */
+      virtual ~DriverClock();
+
+
+      /**
+       * @brief Returns the current time
+       *
+       * @return Current time
+       */
+      virtual TimePoint now() = 0;
+
+
+      /**
+       * @brief Waits for a time span
+       *
+       * @param[in]  aDuration      Time span
+       */
+      virtual void sleepFor(Duration aDuration) = 0;
+
+
+      /**
+       * @brief Waits until a point in time
+       *
+       * @param[in]  aTime          Point in time (returns at once if already passed)
+       */
+      virtual void sleepUntil(TimePoint aTime) = 0;
+
+
+      /**
+       * @brief Returns the process-wide monotonic clock (default clock of all driver classes)
+       *
+       * @return Monotonic clock
+       */
+      static DriverClock& monotonic();
+   }; // class DriverClock
+
+
+   /**
+    * @class MonotonicClock driverclock.hpp "include/driverclock.hpp"
+    * @brief The MonotonicClock class reads `std::chrono::steady_clock` and sleeps the calling thread
+    */
+   class MonotonicClock : public DriverClock
+   {
+   public:
+      /** @{ @name Clock functions */
+
+      TimePoint now() override;
+      void sleepFor(Duration aDuration) override;
+      void sleepUntil(TimePoint aTime) override;
+
+      /** @} */
+   }; // class MonotonicClock
+
+
+   /**
+    * @class VirtualClock driverclock.hpp "include/driverclock.hpp"
+    * @brief The VirtualClock class keeps its own time, sleeping advances it instantly
+    *
+    * The time only moves by sleeping or advance(). A sleep moves the time forward to the
+    * wake-up time and returns at once, so a simulated hour passes as fast as the code between
+    * the sleeps runs. With several sleeping threads the time jumps to the latest wake-up time
+    * requested, the clock is meant for one timeline (e.g. one player on simulated devices).
+    */
+   class VirtualClock : public DriverClock
+   {
+   public:
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  aStart         Start time (default: epoch of the steady clock)
+       */
+      explicit VirtualClock(TimePoint aStart = TimePoint());
+
+
+      /** @{ @name Clock functions */
+
+      TimePoint now() override;
+      void sleepFor(Duration aDuration) override;
+      void sleepUntil(TimePoint aTime) override;
+
+      /** @} */
+
+
+      /**
+       * @brief Advances the time without counting a sleep
+       *
+       * @param[in]  aDuration      Time span (not negative)
+       */
+      void advance(Duration aDuration);
+
+
+      /**
+       * @brief Returns the time passed since the start
+       *
+       * @return Elapsed virtual time
+       */
+      Duration elapsed() const;
+
+
+      /**
+       * @brief Returns the number of sleeps
+       *
+       * @return Number of sleepFor() and sleepUntil() calls
+       */
+      uint64_t sleeps() const;
+
+
+   private:
+      /**
+       * @brief Moves the time forward to a point in time (never backwards)
+       *
+       * @param[in]  aTicks         Point in time (ticks since the epoch)
+       */
+      void moveTo(Duration::rep aTicks);
+
+
+      const Duration::rep mStart;            ///< Start time (ticks since the epoch)
+      std::atomic<Duration::rep> mNow;       ///< Current time (ticks since the epoch)
+      std::atomic<uint64_t> mSleeps;         ///< Number of sleeps
+   }; // class VirtualClock
+} // namespace CAR4TEGRA
+
+#endif // DRIVERCLOCK_H
@@ -29,7 +29,8 @@
  *
  * @details
  * The I2cDevice class represents an I2C slave device. It offers functions to connect
- * to the device and to write and read data from/to it.
+ * to the device and to write and read data from/to it. The system calls are made by
+ * protected virtual functions, so derived classes can replace the bus (e.g. by a simulation).
  *
  * @version 0.1 - 07.04.2017 - File created
  */
@@ -40,11 +41,19 @@
 
 
 // std includes
+#include <linux/i2c.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 
 namespace CAR4TEGRA
 {
+   // forward declarations
+   class TraceRecorder;
+
+
    /**
     * @class I2cDevice i2cdevice.hpp "include/i2cdevice.hpp"
     * @brief The I2cDevice class represents an I2C slave device
@@ -64,7 +73,7 @@ namespace CAR4TEGRA
       /**
        * @brief Destructor
        */
-      ~I2cDevice();
+      virtual ~I2cDevice();
 
 
       /** @{ @name Control functions */
@@ -124,13 +133,173 @@ namespace CAR4TEGRA
        */
       int writeByte(int aRegister, int aValue);
 
+
+      /**
+       * @brief Writes a register byte on a second file descriptor of the currently opened I2C device
+       *
+       * Can run concurrently with all other functions, the kernel serializes the byte with a running
+       * transfer (e.g. an emergency stop overtaking a long block write). The descriptor is published
+       * only after the device was selected on it. Closing or reopening the device retires it first and
+       * waits for running calls, so the byte never reaches a closed or reused descriptor.
+       *
+       * @param[in]  aRegister      Register to write to
+       * @param[in]  aValue         Value to write to the register
+       *
+       * @return Returns the writing result
+       */
+      int writeByteConcurrent(int aRegister, int aValue);
+
+
+      /**
+       * @brief Reads a block of consecutive registers in one combined I2C transfer
+       *
+       * The device has to support register auto-increment (e.g. MODE1 AI bit of the PCA9685).
+       *
+       * @param[in]  aRegister      First register to read from
+       * @param[out] apBuffer       Buffer for the register values
+       * @param[in]  aLength        Number of registers to read (1 - BLOCK_SIZE_MAX)
+       *
+       * @return Returns the number of bytes read
+       */
+      int readBlock(int aRegister, uint8_t* apBuffer, size_t aLength);
+
+
+      /**
+       * @brief Writes a block of consecutive registers in one I2C transfer
+       *
+       * The device has to support register auto-increment (e.g. MODE1 AI bit of the PCA9685).
+       *
+       * @param[in]  aRegister      First register to write to
+       * @param[in]  apData         Register values to write
+       * @param[in]  aLength        Number of registers to write (1 - BLOCK_SIZE_MAX)
+       *
+       * @return Returns the number of bytes written
+       */
+      int writeBlock(int aRegister, const uint8_t* apData, size_t aLength);
+
+      /** @} */
+
+
+      /** @{ @name Trace functions */
+
+      /**
+       * @brief Sets a recorder which receives every transaction
+       *
+       * @param[in]  apRecorder     Trace recorder (has to outlive the device, `nullptr` to disable)
+       */
+      void setTraceRecorder(TraceRecorder* apRecorder);
+
+      /** @} */
+
+
+      static constexpr size_t BLOCK_SIZE_MAX = 256;   ///< Maximum length of a block transfer
+
+
+   protected:
+      /** @{ @name Bus access functions (set errno and return a negative value on failure) */
+
+      /**
+       * @brief Opens the bus device file
+       *
+       * @param[in]  acrBusName     Name of the bus
+       *
+       * @return File descriptor
+       */
+      virtual int busOpen(const std::string& acrBusName);
+
+
+      /**
+       * @brief Closes the bus device file
+       *
+       * @param[in]  aBus           File descriptor
+       *
+       * @return `0` on success
+       */
+      virtual int busClose(int aBus);
+
+
+      /**
+       * @brief Selects the slave device for the following transfers
+       *
+       * @param[in]  aBus           File descriptor
+       * @param[in]  aAddress       7 bit slave address
+       *
+       * @return `0` on success
+       */
+      virtual int busSelect(int aBus, int aAddress);
+
+
+      /**
+       * @brief Reads a register byte (SMBus read byte data)
+       *
+       * @param[in]  aBus           File descriptor
+       * @param[in]  aRegister      Register to read from
+       *
+       * @return Register value
+       */
+      virtual int busReadByte(int aBus, int aRegister);
+
+
+      /**
+       * @brief Writes a register byte (SMBus write byte data)
+       *
+       * @param[in]  aBus           File descriptor
+       * @param[in]  aRegister      Register to write to
+       * @param[in]  aValue         Value to write
+       *
+       * @return `0` on success
+       */
+      virtual int busWriteByte(int aBus, int aRegister, int aValue);
+
+
+      /**
+       * @brief Runs a combined transfer (I2C_RDWR)
+       *
+       * @param[in]  aBus           File descriptor
+       * @param[in]  apMsgs         Transfer messages
+       * @param[in]  aCount         Number of messages
+       *
+       * @return Number of messages transferred
+       */
+      virtual int busTransfer(int aBus, struct i2c_msg* apMsgs, int aCount);
+
       /** @} */
 
 
+   private:
+      /**
+       * @brief Opens and publishes the second file descriptor of the device (failures leave it unpublished)
+       */
+      void openConcurrent();
+
+
+      /**
+       * @brief Retires the second file descriptor, waits for running writeByteConcurrent() calls and closes it
+       */
+      void closeConcurrent();
+
+
+      /**
+       * @brief Passes a finished transaction to the trace recorder
+       *
+       * @param[in]  aOperation     Operation (see TraceRecorder::Operation)
+       * @param[in]  aRegister      First register
+       * @param[in]  apData         Payload (written or read bytes)
+       * @param[in]  aLength        Payload length
+       * @param[in]  aResult        Result of the bus access
+       * @param[in]  aErrno         errno after the bus access
+       */
+      void trace(int aOperation, int aRegister, const uint8_t* apData, size_t aLength, int aResult, int aErrno);
+
+
    private:
       std::string mI2CBusName;   ///< Name of the currently opened I2C bus
       int mI2CBus;               ///< File pointer to the currently opened I2C bus
       int mDevAddress;           ///< Address of the currently opened I2C device
+      int mBusNumber;            ///< Number of the currently opened I2C bus (for tracing)
+      TraceRecorder* mpRecorder; ///< Trace recorder (`nullptr` if disabled)
+      std::atomic<int> mConcurrentBus;    ///< Second file descriptor of the device (`-1`: none)
+      std::atomic<int> mConcurrentUsers;  ///< Running writeByteConcurrent() calls
    }; // class I2cDevice
 }  // namespace CAR4TEGRA
 
@@ -0,0 +1,264 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file inputconditioner.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class InputConditioner at namespace CAR4TEGRA
+ *
+ * @details
+ * The InputConditioner class sits between noisy command sources (input axes, slider drags,
+ * planners) and the PCA9685 driver. It removes sub-perceptible jitter per channel before it
+ * becomes bus traffic.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef INPUTCONDITIONER_H
+#define INPUTCONDITIONER_H
+
+
+// std includes
+#include <array>
+#include <cstdint>
+
+// Car4Tegra includes
+#include "include/pca9685defines.hpp"
+
+
+#define CONDITIONER_MEDIAN_TAPS_MAX 5      ///< Maximum window of the median filter
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class InputConditioner inputconditioner.hpp "include/inputconditioner.hpp"
+    * @brief The InputConditioner class filters channel setpoints and suppresses irrelevant changes
+    *
+    * Every sample passes median filter, first-order low-pass filter and deadband, then the
+    * conditioned value is only forwarded if it passes hysteresis and minimum-change threshold.
+    * Each stage runs in constant time without allocation. Values held back by the gates or
+    * still moving in the filters are written by settle() once the source comes to rest.
+    *
+    * An instance is not thread-safe, each command source uses its own one.
+    */
+   class InputConditioner
+   {
+   public:
+      /**
+       * @brief Filters
+       */
+      enum Filter
+      {
+         FILTER_NONE = 0,           ///< No filter
+         FILTER_LOWPASS = 1,        ///< First-order low-pass filter
+         FILTER_MEDIAN = 2,         ///< Median filter (removes single spikes)
+         FILTER_MEDIAN_LOWPASS = 3  ///< Median filter followed by low-pass filter
+      };
+
+
+      /**
+       * @brief Conditioning settings of one channel
+       */
+      struct Settings
+      {
+         Filter mFilter;            ///< Filter
+         double mTimeConstantMs;    ///< Time constant of the low-pass filter (ms)
+         int mMedianTaps;           ///< Window of the median filter (1, 3 or 5 samples)
+         int mCenter;               ///< Center of the deadband (e.g. neutral PWM value)
+         int mDeadband;             ///< Values within center +/- deadband give the center (`0`: off)
+         int mHysteresis;           ///< Change against the last direction has to exceed this (`0`: off)
+         int mMinChange;            ///< Minimum change of the forwarded value (`0`, `1`: every change)
+      };
+
+
+      /**
+       * @brief Conditioner statistics
+       */
+      struct Statistics
+      {
+         uint64_t mSamples;         ///< Processed samples
+         uint64_t mForwarded;       ///< Forwarded values (including settled values)
+         uint64_t mSuppressed;      ///< Samples held back by the gates
+      };
+
+
+      /**
+       * @brief Standard constructor with no input, all channels pass through unchanged
+       */
+      InputConditioner();
+
+
+      /**
+       * @brief Returns settings which pass every sample through unchanged
+       *
+       * @return Settings
+       */
+      static Settings passThrough();
+
+
+      /**
+       * @brief Sets the settings of a channel and resets its state
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       * @param[in]  acrSettings    Settings
+       */
+      void setSettings(int aChannel, const Settings& acrSettings);
+
+
+      /**
+       * @brief Returns the settings of a channel
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       *
+       * @return Settings
+       */
+      const Settings& settings(int aChannel) const;
+
+
+      /**
+       * @brief Resets the state of all channels (e.g. after the outputs were written elsewhere)
+       */
+      void reset();
+
+
+      /**
+       * @brief Resets the state of a channel, the next sample is always forwarded
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       */
+      void reset(int aChannel);
+
+
+      /**
+       * @brief Conditions a new sample of a channel
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       * @param[in]  aValue         Raw value
+       * @param[in]  aTimeNs        Sample time (monotonic clock, ns)
+       * @param[out] arOutput       Value to write (only if forwarded)
+       *
+       * @return `true` if the value has to be written, `false` if it is suppressed
+       */
+      bool process(int aChannel, int aValue, int64_t aTimeNs, int& arOutput);
+
+
+      /**
+       * @brief Advances the filters of a resting channel and forwards the value without gates
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       * @param[in]  aTimeNs        Current time (monotonic clock, ns)
+       * @param[out] arOutput       Value to write (only if forwarded)
+       *
+       * @return `true` if the value has to be written, `false` if nothing changed
+       */
+      bool settle(int aChannel, int64_t aTimeNs, int& arOutput);
+
+
+      /**
+       * @brief Returns if a channel holds back a value which settle() would write
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       *
+       * @return `true` if pending, `false` otherwise
+       */
+      bool isPending(int aChannel) const;
+
+
+      /**
+       * @brief Returns the conditioner statistics
+       *
+       * @return Statistics
+       */
+      Statistics statistics() const;
+
+
+   private:
+      /**
+       * @brief State of one channel
+       */
+      struct Channel
+      {
+         Settings mSettings;        ///< Settings
+         int mMedian[CONDITIONER_MEDIAN_TAPS_MAX];   ///< Median window
+         int mMedianCount;          ///< Samples in the median window
+         int mMedianNext;           ///< Next slot of the median window
+         double mFiltered;          ///< Low-pass filter state
+         int64_t mTimeNs;           ///< Time of the last filter update
+         bool mStarted;             ///< Filters received a sample
+         int mRaw;                  ///< Last raw value
+         int mOutput;               ///< Last forwarded value
+         bool mHasOutput;           ///< A value was forwarded
+         int mDirection;            ///< Direction of the last forwarded change (-1, 0, 1)
+         bool mPending;             ///< A held back value is waiting for settle()
+      };
+
+
+      /**
+       * @brief Runs a sample through median filter, low-pass filter and deadband
+       *
+       * @param[in]  arChannel      Channel state
+       * @param[in]  aValue         Raw value
+       * @param[in]  aTimeNs        Sample time (ns)
+       *
+       * @return Conditioned value
+       */
+      static int filter(Channel& arChannel, int aValue, int64_t aTimeNs);
+
+
+      /**
+       * @brief Applies the deadband
+       *
+       * @param[in]  acrSettings    Settings
+       * @param[in]  aValue         Value
+       *
+       * @return Value, center within the deadband
+       */
+      static int deadband(const Settings& acrSettings, int aValue);
+
+
+      /**
+       * @brief Forwards a value and updates the gate state
+       *
+       * @param[in]  arChannel      Channel state
+       * @param[in]  aValue         Conditioned value
+       */
+      void forward(Channel& arChannel, int aValue);
+
+
+      /**
+       * @brief Checks a channel index
+       *
+       * @param[in]  aChannel       Channel
+       */
+      static void checkChannel(int aChannel);
+
+
+      std::array<Channel, PCA9685_CHANNEL_COUNT> mChannels;   ///< Channel states
+      Statistics mStatistics;       ///< Statistics
+   }; // class InputConditioner
+} // namespace CAR4TEGRA
+
+#endif // INPUTCONDITIONER_H
@@ -0,0 +1,349 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file inputreader.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class InputReader at namespace CAR4TEGRA
+ *
+ * @details
+ * The InputReader class reads Linux evdev input devices (e.g. gamepads at /dev/input/event*)
+ * on its own epoll thread and maps absolute axes directly to PWM channel setpoints, without
+ * passing through the GUI event loop.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef INPUTREADER_H
+#define INPUTREADER_H
+
+
+// std includes
+#include <linux/input.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/inputconditioner.hpp"
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class InputReader inputreader.hpp "include/inputreader.hpp"
+    * @brief The InputReader class maps evdev axes to PWM channels of a PCA9685 device
+    *
+    * Axis events are collected until the next SYN_REPORT, then all changed channels pass the
+    * input conditioning and the forwarded values are written. Values held back by the
+    * conditioning are written once the axis rests for INPUT_SETTLE_MS. The time from the kernel event timestamp to the finished register write is
+    * measured for every written setpoint.
+    */
+   class InputReader
+   {
+   public:
+      /**
+       * @brief Mapping of an input axis to a PWM channel
+       */
+      struct AxisMapping
+      {
+         int mChannel;              ///< PWM channel (0 - 15)
+         int mPwmMin;               ///< PWM value at the minimum axis position
+         int mPwmMax;               ///< PWM value at the maximum axis position
+         bool mInvert;              ///< Axis is inverted
+      };
+
+
+      /**
+       * @brief Input-to-register latency statistics
+       */
+      struct LatencyStatistics
+      {
+         uint64_t mCount;           ///< Number of written setpoints
+         double mMinUs;             ///< Minimum latency (us)
+         double mMeanUs;            ///< Mean latency (us)
+         double mMaxUs;             ///< Maximum latency (us)
+         double mP50Us;             ///< Median latency (us, 10 us resolution)
+         double mP99Us;             ///< 99th percentile latency (us, 10 us resolution)
+      };
+
+
+      /// Callback for read and write errors (called from the input thread)
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arDriver       Driver receiving the setpoints (has to outlive the reader)
+       */
+      explicit InputReader(PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor, stops the input thread and closes all devices
+       */
+      ~InputReader();
+
+
+      /** @{ @name Setup functions (only while stopped) */
+
+      /**
+       * @brief Opens an evdev input device
+       *
+       * @param[in]  acrPath        Device path (format: "/dev/input/event0")
+       *
+       * @return Device index
+       */
+      int openDevice(const std::string& acrPath);
+
+
+      /**
+       * @brief Adds a device without file (for replaying recorded events)
+       *
+       * @return Device index
+       */
+      int addVirtualDevice();
+
+
+      /**
+       * @brief Closes all input devices
+       */
+      void closeDevices();
+
+
+      /**
+       * @brief Overrides the value range of an axis (default: range reported by the device)
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aAxis          Axis code (ABS_X, ABS_Y, ...)
+       * @param[in]  aMin           Minimum axis value
+       * @param[in]  aMax           Maximum axis value
+       */
+      void setAxisRange(int aDevice, int aAxis, int aMin, int aMax);
+
+      /** @} */
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Maps an axis to a PWM channel (thread-safe, e.g. after recalibration)
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aAxis          Axis code (ABS_X, ABS_Y, ...)
+       * @param[in]  acrMapping     Mapping
+       */
+      void mapAxis(int aDevice, int aAxis, const AxisMapping& acrMapping);
+
+
+      /**
+       * @brief Removes the mapping of an axis (thread-safe)
+       *
+       * @param[in]  aDevice        Device index
+       * @param[in]  aAxis          Axis code (ABS_X, ABS_Y, ...)
+       */
+      void unmapAxis(int aDevice, int aAxis);
+
+
+      /**
+       * @brief Sets the input conditioning of a PWM channel (thread-safe)
+       *
+       * @param[in]  aChannel       PWM channel (0 - 15)
+       * @param[in]  acrSettings    Conditioning settings
+       */
+      void setConditioning(int aChannel, const InputConditioner::Settings& acrSettings);
+
+
+      /**
+       * @brief Returns the input conditioning statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      InputConditioner::Statistics conditioning();
+
+
+      /**
+       * @brief Starts the input thread
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the input thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Replays a file of recorded `struct input_event` records in the calling thread
+       *
+       * A recording is made e.g. with `cat /dev/input/event0 > recording.bin`.
+       *
+       * @param[in]  acrPath        Recording file
+       * @param[in]  aDevice        Device index whose mappings are used
+       * @param[in]  aRealTime      Pace to the recorded timestamps (`false`: as fast as possible)
+       *
+       * @return Number of events replayed
+       */
+      uint64_t replay(const std::string& acrPath, int aDevice, bool aRealTime);
+
+
+      /**
+       * @brief Returns the input-to-register latency statistics (thread-safe)
+       *
+       * @return Latency statistics
+       */
+      LatencyStatistics latency();
+
+
+      /**
+       * @brief Resets the latency statistics (thread-safe)
+       */
+      void resetLatency();
+
+
+      /**
+       * @brief Sets the callback for read and write errors (only while stopped)
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+      /** @} */
+
+
+   private:
+      static const size_t LATENCY_BUCKETS = 1000;     ///< Histogram buckets of 10 us (last bucket: overflow)
+
+      /**
+       * @brief State of one axis
+       */
+      struct Axis
+      {
+         bool mMapped;              ///< Axis is mapped to a channel
+         AxisMapping mMapping;      ///< Channel mapping
+         int mMin;                  ///< Minimum axis value
+         int mMax;                  ///< Maximum axis value
+         int mValue;                ///< Last axis value
+         bool mChanged;             ///< Axis changed since the last SYN_REPORT
+         int64_t mEventTimeNs;      ///< Timestamp of the last change (CLOCK_MONOTONIC)
+      };
+
+
+      /**
+       * @brief State of one input device
+       */
+      struct Device
+      {
+         int mFile;                 ///< File descriptor (`-1` for virtual devices)
+         std::string mPath;         ///< Device path
+         std::array<Axis, ABS_CNT> mAxes;   ///< Axis states
+      };
+
+
+      /**
+       * @brief Processes one input event
+       *
+       * @param[in]  arDevice       Device the event belongs to
+       * @param[in]  acrEvent       Input event
+       * @param[in]  aEventTimeNs   Event time (CLOCK_MONOTONIC)
+       */
+      void process(Device& arDevice, const struct input_event& acrEvent, int64_t aEventTimeNs);
+
+
+      /**
+       * @brief Initializes all axes of a device (no mapping, range reported by the device)
+       *
+       * @param[in]  arDevice       Device
+       */
+      void initAxes(Device& arDevice);
+
+
+      /**
+       * @brief Reads the current value of all axes of a device after lost events
+       *
+       * @param[in]  arDevice       Device
+       */
+      void syncAxes(Device& arDevice);
+
+
+      /**
+       * @brief Writes the values held back by the input conditioning (with locked mappings)
+       *
+       * @return `true` if values are still pending, `false` otherwise
+       */
+      bool settleChannels();
+
+
+      /**
+       * @brief Adds a latency sample
+       *
+       * @param[in]  aLatencyNs     Latency (ns)
+       */
+      void addLatency(int64_t aLatencyNs);
+
+
+      /**
+       * @brief Thread function, waits for input events until stopped
+       */
+      void run();
+
+
+      /**
+       * @brief Checks a device index
+       *
+       * @param[in]  aDevice        Device index
+       */
+      void checkDevice(int aDevice) const;
+
+
+   private:
+      PCA9685& mrDriver;            ///< Driver receiving the setpoints
+      std::vector<std::unique_ptr<Device>> mDevices;   ///< Input devices
+      std::mutex mMappingMutex;     ///< Protects the axis mappings and the conditioning
+      InputConditioner mConditioner;   ///< Input conditioning of the PWM channels
+      std::thread mThread;          ///< Input thread
+      std::atomic<bool> mRunning;   ///< Input thread is running
+      int mEpoll;                   ///< epoll instance of the input thread
+      int mStopEvent;               ///< eventfd to wake up the input thread
+      ErrorCallback mErrorCallback; ///< Callback for errors
+      std::mutex mLatencyMutex;     ///< Protects the latency statistics
+      uint64_t mLatencyCount;       ///< Number of latency samples
+      int64_t mLatencyMinNs;        ///< Minimum latency (ns)
+      int64_t mLatencyMaxNs;        ///< Maximum latency (ns)
+      int64_t mLatencySumNs;        ///< Sum of all latencies (ns)
+      std::array<uint32_t, LATENCY_BUCKETS> mLatencyHistogram;  ///< Latency histogram
+   }; // class InputReader
+} // namespace CAR4TEGRA
+
+#endif // INPUTREADER_H
@@ -0,0 +1,140 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file logsink.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class LogSink
+ *
+ * @details
+ * The LogSink class buffers log messages in a bounded ring buffer, merges repeated messages
+ * and flushes them in batches to a QTextBrowser and to a log file at a fixed refresh rate.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+
+// QT includes
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTextBrowser>
+#include <QTextStream>
+#include <QTimer>
+
+// std includes
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * @class LogSink logsink.hpp "include/logsink.hpp"
+ * @brief The LogSink class is a rate-limited log pipeline in front of a QTextBrowser
+ *
+ * append() is thread-safe and costs O(1) per message whatever the message rate. A message equal
+ * to the previous one only increments its repeat count. The view is fed from a ring buffer: if
+ * it is full, the oldest messages are dropped from the view and the number of dropped messages
+ * is shown with the next flush. The log file is fed from a fixed-capacity queue: if it is full,
+ * new messages are dropped from the file and their number is written with the next flush.
+ */
+class LogSink : public QObject
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Constructor
+    *
+    * @param[in]  apView         Text browser showing the log (the view keeps aMaxLines lines)
+    * @param[in]  acrFileName    File receiving the log history (empty: no file)
+    * @param[in]  aCapacity      Capacity of the view ring buffer (messages shown per flush interval)
+    * @param[in]  aFileCapacity  Capacity of the file queue (messages written per flush interval)
+    * @param[in]  aIntervalMs    Flush interval (ms)
+    * @param[in]  aMaxLines      Maximum number of lines kept by the view
+    * @param[in]  apParent       QT parent
+    */
+   LogSink(QTextBrowser* apView, const QString& acrFileName, int aCapacity, int aFileCapacity,
+           int aIntervalMs, int aMaxLines, QObject* apParent = 0);
+
+
+   /**
+    * @brief Destructor, flushes the remaining messages
+    */
+   ~LogSink();
+
+
+   /**
+    * @brief Adds a message to the log (thread-safe)
+    *
+    * @param[in]  acrMessage     Log message
+    */
+   void append(const QString& acrMessage);
+
+
+public slots:
+   /**
+    * @brief Writes the buffered messages to the view and the log file (GUI thread)
+    */
+   void flush();
+
+
+private:
+   typedef std::chrono::system_clock Clock;  ///< Clock for message time stamps
+
+   /**
+    * @brief Buffered log message
+    */
+   struct Entry
+   {
+      QString mMessage;             ///< Message text
+      uint32_t mCount;              ///< Number of repeats
+      Clock::time_point mFirst;     ///< Time of the first occurrence
+      Clock::time_point mLast;      ///< Time of the last occurrence
+   };
+
+
+private:
+   QTextBrowser* mpView;            ///< Log view
+   QFile mFile;                     ///< Log file
+   QTextStream mStream;             ///< Stream on the log file
+   QTimer mTimer;                   ///< Flush timer
+   std::mutex mMutex;               ///< Protects the ring buffer
+   std::vector<Entry> mRing;        ///< Ring buffer of the producer side
+   std::vector<Entry> mFlushBuffer; ///< Entries taken over by flush()
+   std::vector<Entry> mFileQueue;   ///< Fixed-capacity queue of the producer side for the log file
+   std::vector<Entry> mFileBuffer;  ///< File entries taken over by flush()
+   size_t mHead;                    ///< Index of the oldest entry
+   size_t mSize;                    ///< Number of buffered entries
+   size_t mFileSize;                ///< Number of queued file entries
+   uint64_t mDropped;               ///< Messages dropped from the view since the last flush
+   uint64_t mFileDropped;           ///< Messages dropped from the file since the last flush
+}; // class LogSink
+
+#endif // LOGSINK_H
@@ -57,17 +57,51 @@
 #define PWM_STEER_MAX_DEFAULT       500      ///< Default maximum PWM value for steering control
 #define PWM_SPEED_INV_DEFAULT       false    ///< Speed PWM values inverted by default or not
 #define PWM_STEER_INV_DEFAULT       true     ///< Steer PWM values inverted by default or not
+#define SCRUB_INTERVAL_MS           1000     ///< Pause between two register read back passes (ms)
+#define SCRUB_REPAIR_DEFAULT        true     ///< Repair register drifts by default or not
+#define LOG_FILE_DEFAULT            "ServoDriverCalibration.log"  ///< File receiving the log history
+#define LOG_CAPACITY                256      ///< Log messages shown per flush interval
+#define LOG_FILE_CAPACITY           4096     ///< Log messages written to the file per flush interval
+#define LOG_FLUSH_INTERVAL_MS       100      ///< Log view refresh interval (ms)
+#define LOG_VIEW_LINES              1000     ///< Maximum number of lines kept by the log view
+#define TRACE_FILE_ENV              "C4T_I2C_TRACE"  ///< Environment variable naming the I2C trace file (unset: no trace)
+#define INPUT_DEVICE_ENV            "C4T_INPUT_DEVICE"  ///< Environment variable naming the evdev input device (unset: no input)
+#define PROFILE_FILE_ENV            "C4T_PROFILE"  ///< Environment variable naming the calibration profile (unset: no profile)
+#define BOARDS_ENV                  "C4T_BOARDS"   ///< Environment variable listing additional dashboard boards (`/dev/i2c-N:HEX,...`, unset: none)
+#define INPUT_AXIS_SPEED            ABS_Y    ///< Input axis mapped to the speed channel
+#define INPUT_AXIS_STEER            ABS_X    ///< Input axis mapped to the steering channel
+#define INPUT_DEADBAND_DEFAULT      4        ///< Deadband of the input axes around the channel center (PWM LSB)
+#define INPUT_HYSTERESIS_DEFAULT    2        ///< Change against the last direction needed by sliders and input axes (PWM LSB)
+#define INPUT_MIN_CHANGE_DEFAULT    2        ///< Minimum change written by sliders and input axes (PWM LSB)
+#define INPUT_MEDIAN_TAPS_DEFAULT   3        ///< Median filter window of the input axes (samples)
+#define CHANNEL_FRAME_MS            16       ///< Refresh interval of the channel dashboard (ms)
+#define CHANNEL_ROW_HEIGHT          22       ///< Row height of the channel dashboard (px)
+#define SPAN_TRACE_FILE_DEFAULT     "ServoDriverCalibration.trace.json"  ///< File receiving the span trace export
+#define SPAN_TRACE_SHORTCUT         "Ctrl+Shift+T"   ///< Key sequence exporting the span trace (span tracing builds only)
+#define OUTPUT_STOP_SHORTCUT        "Esc"    ///< Key sequence toggling the emergency stop of all outputs
 
 
 // QT includes
+#include <QAction>
 #include <QMainWindow>
+#include <QPixmap>
+#include <QTableView>
 
 // std includes
 #include <string>
 #include <memory>
+#include <vector>
 
 // CAR4TEGRA includes
 #include "include/pca9685.hpp"
+#include "include/registerscrubber.hpp"
+#include "include/logsink.hpp"
+#include "include/tracerecorder.hpp"
+#include "include/inputconditioner.hpp"
+#include "include/inputreader.hpp"
+#include "include/profilewatcher.hpp"
+#include "include/spantracer.hpp"
+#include "include/channelmodel.hpp"
 
 
 namespace Ui {
@@ -151,10 +185,83 @@ private:
    /**
     * @brief Writes PWM value to the selected channel
     *
+    * @param[in]  aChannel       Device Channel (0 - 15)
+    * @param[in]  aValue         PWM value (0 - 4095)
+    * @param[in]  aConditioned   Value passed the input conditioning (`false`: exact value, e.g. a border)
+    */
+   void setPWMValue(int aChannel, int aValue, bool aConditioned = false);
+
+
+   /**
+    * @brief Writes a slider value to the selected channel if it passes the input conditioning
+    *
     * @param[in]  aChannel    Device Channel (0 - 15)
     * @param[in]  aValue      PWM value (0 - 4095)
     */
-   void setPWMValue(int aChannel, int aValue);
+   void setConditionedValue(int aChannel, int aValue);
+
+
+   /**
+    * @brief Writes the value held back by the input conditioning after a slider was released
+    *
+    * @param[in]  aChannel    Device Channel (0 - 15)
+    */
+   void settleValue(int aChannel);
+
+
+   /**
+    * @brief Reopens the device after a failed transfer and restores the last commanded outputs
+    */
+   void recoverDevice();
+
+
+   /**
+    * @brief Maps the input device axes to the channels with the current calibration
+    */
+   void updateInputMapping();
+
+
+   /**
+    * @brief Takes over frequency, borders and inversion of the speed and steering channel from the profile
+    */
+   void applyProfile();
+
+
+   /**
+    * @brief Takes over borders and inversion of a channel if it is the speed or steering channel
+    *
+    * Only values which differ from the GUI are changed, while connected a channel is only
+    * written if its value is outside of the new borders.
+    *
+    * @param[in]  aChannel       Device Channel (0 - 15)
+    * @param[in]  acrCalibration Calibration (ignored if not used)
+    */
+   void applyCalibration(int aChannel, const CAR4TEGRA::ChannelCalibration& acrCalibration);
+
+
+   /**
+    * @brief Passes borders and inversion of the speed and steering channel to the channel dashboard
+    */
+   void syncChannelCalibration();
+
+
+   /**
+    * @brief Connects the additional boards of the channel dashboard with the current PWM frequency
+    */
+   void connectBoards();
+
+
+   /**
+    * @brief Disables the outputs of the additional boards and closes them
+    */
+   void disconnectBoards();
+
+
+signals:
+   /**
+    * @brief The watched calibration profile changed (emitted from the profile watcher thread)
+    */
+   void profileChanged();
 
 
 private slots:
@@ -218,6 +325,12 @@ private slots:
    void on_slidSpeed_sliderMoved(int aPosition);
 
 
+   /**
+    * @brief Speed slider released
+    */
+   void on_slidSpeed_sliderReleased();
+
+
    /**
     * @brief Position of steering slider changed
     *
@@ -226,6 +339,12 @@ private slots:
    void on_slidSteer_sliderMoved(int aPosition);
 
 
+   /**
+    * @brief Steering slider released
+    */
+   void on_slidSteer_sliderReleased();
+
+
    /**
     * @brief Invert the PWM values fo steering
     *
@@ -249,12 +368,42 @@ private slots:
 
 
 private:
+   /**
+    * @brief Additional board of the channel dashboard
+    */
+   struct Board
+   {
+      std::unique_ptr<CAR4TEGRA::PCA9685> mpDriver;   ///< PCA9685 device
+      std::string mBus;             ///< I2C bus
+      int mAddress;                 ///< Device address (8 bit format)
+      int mIndex;                   ///< Board index in the channel model
+   };
+
    Ui::MainWindow* mpUi;            ///< QT UI instance
    std::unique_ptr<CAR4TEGRA::PCA9685> mpDriver;   ///< PCA9685 device
+   std::unique_ptr<CAR4TEGRA::RegisterScrubber> mpScrubber;   ///< Background register read back
+   std::unique_ptr<LogSink> mpLog;  ///< Rate-limited log pipeline in front of the log view
+   std::unique_ptr<CAR4TEGRA::TraceRecorder> mpRecorder;   ///< I2C transaction trace recorder
+   std::unique_ptr<CAR4TEGRA::InputReader> mpInput;   ///< evdev input path to the PWM outputs
+   int mInputDevice;                ///< Index of the opened input device (`-1`: none)
+   std::unique_ptr<CAR4TEGRA::ProfileWatcher> mpProfile;   ///< Hot-reloaded calibration profile
+   std::vector<Board> mBoards;      ///< Additional boards of the channel dashboard
+   std::unique_ptr<ChannelModel> mpChannels;     ///< Channels of all boards for the dashboard
+   std::unique_ptr<QTableView> mpChannelView;    ///< Channel dashboard window
+   QAction* mpStopAction;           ///< Emergency stop toggle of the toolbar (owned by the toolbar)
+   int mBoard;                      ///< Board index of mpDriver in the channel model
+   CAR4TEGRA::InputConditioner mConditioner;   ///< Input conditioning of the slider values
    QPoint mPosSteerTop;             ///< Position of steering top border GUI element (for inverting)
    QPoint mPosSteerBot;             ///< Position of steering bottom border GUI element (for inverting)
    QPoint mPosSpeedTop;             ///< Position of speed top border GUI element (for inverting)
    QPoint mPosSpeedBot;             ///< Position of speed bottom border GUI element (for inverting)
+   QPixmap mArrowLeft;              ///< Backward arrow of the speed visualization
+   QPixmap mArrowRight;             ///< Forward arrow of the speed visualization
+   QPixmap mCar;                    ///< Car image of the steering visualization (neutral)
+   QPixmap mCarLeft;                ///< Car image of the steering visualization (left)
+   QPixmap mCarRight;               ///< Car image of the steering visualization (right)
+   const QPixmap* mpSpeedPixmap;    ///< Currently shown arrow (avoids redundant repaints)
+   const QPixmap* mpSteerPixmap;    ///< Currently shown car image (avoids redundant repaints)
 }; // class MainWindow
 
 #endif // MAINWINDOW_H
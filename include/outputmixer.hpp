@@ -0,0 +1,232 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file outputmixer.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class OutputMixer at namespace CAR4TEGRA
+ *
+ * @details
+ * The OutputMixer class maps a command vector (throttle, steering, roll, ...) to the output
+ * channels with a matrix, e.g. for differential drive, elevons or steering-dependent throttle
+ * limiting. It runs once per frame in front of the calibration mapping and the register write.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef OUTPUTMIXER_H
+#define OUTPUTMIXER_H
+
+
+// std includes
+#include <array>
+#include <cstdint>
+
+
+#define MIXER_INPUTS_MAX 32         ///< Maximum number of mixer inputs
+#define MIXER_OUTPUTS_MAX 128       ///< Maximum number of mixer outputs (8 devices with 16 channels)
+#define MIXER_LANES 4               ///< Outputs per vector (128 bit: SSE on x86, NEON on Tegra)
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class OutputMixer outputmixer.hpp "include/outputmixer.hpp"
+    * @brief The OutputMixer class applies a mixing matrix with offset and clamp to a command vector
+    *
+    * Output n is `clamp(offset[n] + sum(weight[n][m] * input[m]))`, in normalized units
+    * (-1 ... 1 by default). mixToPwm() maps the outputs to PWM values with the calibration of each
+    * output, output n is channel n % 16 of device n / 16. The outputs are computed four at a time
+    * with GCC vector extensions on preallocated storage, a frame does not allocate.
+    *
+    * An instance is not thread-safe, the setters must not run concurrently with a mix.
+    */
+   class OutputMixer
+   {
+   public:
+      /**
+       * @brief Constructor, all weights and offsets are `0`, outputs are clamped to -1 ... 1
+       *        and mapped to the full PWM range
+       *
+       * @param[in]  aInputs        Number of inputs (1 - MIXER_INPUTS_MAX)
+       * @param[in]  aOutputs       Number of outputs (1 - MIXER_OUTPUTS_MAX)
+       */
+      OutputMixer(int aInputs, int aOutputs);
+
+
+      /**
+       * @brief Returns the number of inputs
+       *
+       * @return Number of inputs
+       */
+      int inputs() const;
+
+
+      /**
+       * @brief Returns the number of outputs
+       *
+       * @return Number of outputs
+       */
+      int outputs() const;
+
+
+      /** @{ @name Setup functions */
+
+      /**
+       * @brief Sets the weight of an input for an output
+       *
+       * @param[in]  aOutput        Output
+       * @param[in]  aInput         Input
+       * @param[in]  aWeight        Weight
+       */
+      void setWeight(int aOutput, int aInput, float aWeight);
+
+
+      /**
+       * @brief Returns the weight of an input for an output
+       *
+       * @param[in]  aOutput        Output
+       * @param[in]  aInput         Input
+       *
+       * @return Weight
+       */
+      float weight(int aOutput, int aInput) const;
+
+
+      /**
+       * @brief Sets the offset of an output (added before clamping)
+       *
+       * @param[in]  aOutput        Output
+       * @param[in]  aOffset        Offset
+       */
+      void setOffset(int aOutput, float aOffset);
+
+
+      /**
+       * @brief Sets the clamp range of an output
+       *
+       * @param[in]  aOutput        Output
+       * @param[in]  aMin           Lower bound
+       * @param[in]  aMax           Upper bound (not below the lower bound)
+       */
+      void setClamp(int aOutput, float aMin, float aMax);
+
+
+      /**
+       * @brief Sets the calibration of an output, -1 gives the lower and 1 the upper PWM value
+       *
+       * @param[in]  aOutput        Output
+       * @param[in]  aPwmMin        PWM value at -1 (0 - 4095)
+       * @param[in]  aPwmMax        PWM value at 1 (0 - 4095, below aPwmMin for inverted outputs)
+       */
+      void setCalibration(int aOutput, int aPwmMin, int aPwmMax);
+
+
+      /**
+       * @brief Sets all weights and offsets to `0`
+       */
+      void clear();
+
+      /** @} */
+
+
+      /** @{ @name Mixing functions */
+
+      /**
+       * @brief Mixes a command vector, non-finite inputs count as `0`
+       *
+       * @param[in]  apInputs       Inputs (inputs() values)
+       * @param[out] apOutputs      Clamped outputs (outputs() values)
+       */
+      void mix(const float* apInputs, float* apOutputs) const;
+
+
+      /**
+       * @brief Mixes a command vector and maps the outputs to PWM values, non-finite inputs count as `0`
+       *
+       * @param[in]  apInputs       Inputs (inputs() values)
+       * @param[out] apOffValues    Values for PWM OFF (outputs() values, e.g. for PCA9685::setPWMBatch())
+       */
+      void mixToPwm(const float* apInputs, uint16_t* apOffValues) const;
+
+      /** @} */
+
+
+   private:
+      /// Four outputs (16 byte alignment, guaranteed by malloc on the target platforms)
+      typedef float Lanes __attribute__((vector_size(MIXER_LANES * sizeof(float))));
+
+      static const int VECTORS_MAX = MIXER_OUTPUTS_MAX / MIXER_LANES;   ///< Vectors of all outputs
+
+      /// One value per output
+      typedef std::array<Lanes, VECTORS_MAX> OutputVector;
+
+
+      /**
+       * @brief Computes the clamped outputs
+       *
+       * @param[in]  apInputs       Inputs
+       * @param[out] arOutputs      Clamped outputs
+       */
+      void compute(const float* apInputs, OutputVector& arOutputs) const;
+
+
+      /**
+       * @brief Checks an output index
+       *
+       * @param[in]  aOutput        Output
+       */
+      void checkOutput(int aOutput) const;
+
+
+      /**
+       * @brief Checks an input index
+       *
+       * @param[in]  aInput         Input
+       */
+      void checkInput(int aInput) const;
+
+
+      /**
+       * @brief Checks a value of the matrix
+       *
+       * @param[in]  aValue         Value
+       */
+      static void checkFinite(float aValue);
+
+
+      int mInputs;                  ///< Number of inputs
+      int mOutputs;                 ///< Number of outputs
+      int mVectors;                 ///< Vectors holding the outputs
+      std::array<OutputVector, MIXER_INPUTS_MAX> mWeights;   ///< Weights, one output vector per input
+      OutputVector mOffsets;        ///< Offsets
+      OutputVector mClampMin;       ///< Lower clamp bounds
+      OutputVector mClampMax;       ///< Upper clamp bounds
+      OutputVector mPwmCenter;      ///< PWM values at 0
+      OutputVector mPwmScale;       ///< PWM change per unit
+   }; // class OutputMixer
+} // namespace CAR4TEGRA
+
+#endif // OUTPUTMIXER_H
@@ -40,12 +40,21 @@
 
 
 // std includes
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 // Car4Tegra includes
 #include "include/pca9685defines.hpp"
 #include "include/i2cdevice.hpp"
+#include "include/writeplanner.hpp"
+#include "include/driverclock.hpp"
 
 
 namespace CAR4TEGRA
@@ -60,12 +69,34 @@ namespace CAR4TEGRA
    class PCA9685
    {
    public:
+      /// Byte image of the complete register address space
+      typedef std::array<uint8_t, PCA9685_REG_COUNT> RegisterImage;
+
+      /**
+       * @brief Difference between the last written and the read back value of a register
+       */
+      struct RegisterDrift
+      {
+         int mRegister;             ///< Register address
+         int mExpected;             ///< Value last written by the driver
+         int mActual;               ///< Value read back from the device
+      };
+
+
       /**
        * @brief Standard constructor with no input
        */
       PCA9685();
 
 
+      /**
+       * @brief Constructor with a given I2C device (e.g. a simulated bus)
+       *
+       * @param[in]  apDevice       I2C device used for all transfers
+       */
+      explicit PCA9685(std::unique_ptr<CAR4TEGRA::I2cDevice> apDevice);
+
+
       /**
        * @brief Destructor
        */
@@ -80,7 +111,7 @@ namespace CAR4TEGRA
        * @param[in]  acrBusName     Name of the I2C bus (format: "/dev/i2c-0")
        * @param[in]  aAddress       Adress of the PCA9685 device
        */
-      void openDevice(const std::string acrBusName, int aAddress);
+      void openDevice(const std::string& acrBusName, int aAddress);
 
 
       /**
@@ -89,11 +120,40 @@ namespace CAR4TEGRA
       void close();
 
 
+      /**
+       * @brief Reopens the I2C bus in place and restores the last commanded device state
+       *
+       * The shadow image is kept. If the device still holds its configuration (e.g. after a
+       * transient bus error) only registers whose last write failed are written again. Otherwise
+       * (e.g. after a power loss) MODE1 / MODE2, PRE_SCALE and all known LEDn registers are
+       * restored in one burst, so the outputs return to their last positions.
+       *
+       * @return `true` if the device kept its configuration, `false` if it was restored completely
+       */
+      bool reconnect();
+
+
       /**
        * @brief Resets the current opened PCA9685 device
        */
       void reset();
 
+
+      /**
+       * @brief Configures the device unless it is already running with the requested configuration
+       *
+       * PRE_SCALE, MODE1 / MODE2 and all LEDn registers are read with one block transfer
+       * (auto-increment rolls over from PRE_SCALE to MODE1). If MODE1 / MODE2 match the reset()
+       * settings and PRE_SCALE matches the frequency, the LEDn values are adopted as the current
+       * state and the device is not touched. Otherwise reset(), setPWMFrequency() and
+       * setAllPWM(0, 0) are run.
+       *
+       * @param[in]  aFrequency     PWM frequency (24 - 1526 Hz)
+       *
+       * @return `true` if the running configuration was adopted, `false` if the device was configured
+       */
+      bool fastConnect(float aFrequency);
+
       /** @} */
 
 
@@ -119,6 +179,18 @@ namespace CAR4TEGRA
       int writeRegister(int aRegister, int aValue);
 
 
+      /**
+       * @brief Writes a block of consecutive registers in one auto-increment transfer
+       *
+       * @param[in]  aRegister      First register to write to
+       * @param[in]  apData         Values to write
+       * @param[in]  aLength        Number of registers to write
+       *
+       * @return Returns the number of registers written
+       */
+      int writeRegisterBlock(int aRegister, const uint8_t* apData, size_t aLength);
+
+
       /**
        * @brief Writes the PWM settings for a single channel
        *
@@ -145,9 +217,185 @@ namespace CAR4TEGRA
        */
       void setAllPWM(int aOnValue, int aOffValue);
 
+
+      /**
+       * @brief Writes the PWM settings for several channels with the cheapest transaction set
+       *
+       * The WritePlanner compares the values against the shadow image and writes only changed
+       * registers. Nearby changes are merged into one block transfer and the ALL_LED registers
+       * are used if that takes less bus time. Channels not selected keep their values.
+       * This is the steady-state update path: it works on preallocated buffers only and does
+       * not allocate (checked by tools/alloccheck).
+       *
+       * @param[in]  aChannelMask   Bit n selects channel n
+       * @param[in]  apOnValues     Values for PWM ON, indexed by channel (0 - 4095)
+       * @param[in]  apOffValues    Values for PWM OFF, indexed by channel (0 - 4095)
+       */
+      void setPWMBatch(uint16_t aChannelMask, const uint16_t* apOnValues, const uint16_t* apOffValues);
+
+
+      /**
+       * @brief Brings LEDn registers to target values with the cheapest transaction set
+       *
+       * Registers whose last written value is unknown or whose write failed are always written.
+       *
+       * @param[in]  acrTarget      Target values
+       * @param[in]  acrMask        Registers to bring to their target (only LEDn registers are used)
+       *
+       * @return Estimated bus time of the written transactions (us)
+       */
+      double writeImage(const RegisterImage& acrTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask);
+
+
+      /**
+       * @brief Sets the bus timing used by the write planner
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz)
+       * @param[in]  aOverheadUs    Fixed cost of one transaction (us)
+       */
+      void setBusTiming(uint32_t aBusClock, double aOverheadUs);
+
+
+      /**
+       * @brief Returns if register auto-increment is known to be enabled (MODE1 AI bit)
+       *
+       * If enabled, the LEDn registers of a channel are written with one block transfer.
+       *
+       * @return `true` if enabled by the driver, `false` otherwise
+       */
+      bool autoIncrement() const;
+
+
+      /**
+       * @brief Returns the name of the I2C bus the device is connected to
+       *
+       * @return Bus name (format: "/dev/i2c-0"), empty if not connected
+       */
+      const std::string& busName() const;
+
+
+      /**
+       * @brief Returns the address of the device on the I2C bus
+       *
+       * @return Address of the PCA9685 device (`0` if not connected)
+       */
+      int address() const;
+
       /** @} */
 
 
+      /** @{ @name Output stop functions */
+
+      /**
+       * @brief Switches channels off with their FULL_OFF bit and keeps their PWM values
+       *
+       * Costs one byte per channel (LEDn_OFF_H) or one byte for all channels (ALL_LED_OFF_H).
+       * A stopped channel stays off until enableOutputs(): later writes still update its PWM
+       * values on the device, but FULL_OFF is kept set.
+       *
+       * @param[in]  aChannelMask   Bit n selects channel n
+       */
+      void stopOutputs(uint16_t aChannelMask);
+
+
+      /**
+       * @brief Switches stopped channels back on with their last commanded PWM values
+       *
+       * Only the LEDn_OFF_H byte of each channel is written (ALL_LED_OFF_H if that is cheaper).
+       *
+       * @param[in]  aChannelMask   Bit n selects channel n
+       */
+      void enableOutputs(uint16_t aChannelMask);
+
+
+      /**
+       * @brief Switches all channels off with one byte (FULL_OFF in ALL_LED_OFF_H)
+       *
+       * The byte is sent without waiting for the bus lock on a second descriptor of the device
+       * (I2cDevice::writeByteConcurrent()), i2c-dev serializes it with a running transfer in the
+       * kernel. Writes pending meanwhile get FULL_OFF forced, the byte is sent again under the bus
+       * lock if one of them reached the device after it or it could not be sent (e.g. while the
+       * device is reopened). The outputs stay off until enableOutputs().
+       */
+      void emergencyStop();
+
+
+      /**
+       * @brief Returns the stopped channels
+       *
+       * @return Bit n is set if channel n is stopped
+       */
+      uint16_t stoppedOutputs();
+
+      /** @} */
+
+
+      /** @{ @name Read-back functions */
+
+      /**
+       * @brief Reads a block of consecutive registers in one auto-increment transfer
+       *
+       * @param[in]  aRegister      First register to read from
+       * @param[out] apBuffer       Buffer for the register values
+       * @param[in]  aLength        Number of registers to read
+       *
+       * @return Returns the number of registers read
+       */
+      int readRegisterBlock(int aRegister, uint8_t* apBuffer, size_t aLength);
+
+
+      /**
+       * @brief Reads the MODE / LEDn window (0x00 - 0x45) and the ALL_LED / PRE_SCALE window
+       *        (0xFA - 0xFE) with one block transfer each
+       *
+       * @param[out] arImage        Register image, registers outside both windows are set to 0
+       */
+      void readRegisterImage(RegisterImage& arImage);
+
+
+      /**
+       * @brief Returns the register image last written by the driver
+       *
+       * @param[out] arImage        Register image
+       * @param[out] arValid        Registers the driver has written since opening the device
+       */
+      void shadowImage(RegisterImage& arImage, std::bitset<PCA9685_REG_COUNT>& arValid);
+
+
+      /**
+       * @brief Compares a register window against the last written state and optionally repairs it
+       *
+       * This function is meant for background checks: it gives way to every pending write
+       * and returns immediately without touching the bus if a write is pending or running.
+       *
+       * @param[in]  aRegister      First register of the window
+       * @param[in]  aLength        Number of registers of the window
+       * @param[in]  aRepair        Write the last written state back if a drift was found
+       * @param[out] arDrift        Drifted registers are appended to this list
+       *
+       * @return Returns the number of drifted registers or `-1` if the check was skipped
+       */
+      int scrubRegisters(int aRegister, size_t aLength, bool aRepair, std::vector<RegisterDrift>& arDrift);
+
+      /** @} */
+
+
+      /**
+       * @brief Sets a recorder which receives every I2C transaction of the device
+       *
+       * @param[in]  apRecorder     Trace recorder (has to outlive the device, `nullptr` to disable)
+       */
+      void setTraceRecorder(TraceRecorder* apRecorder);
+
+
+      /**
+       * @brief Sets the clock used for the oscillator waits
+       *
+       * @param[in]  arClock        Clock (has to outlive the device, default: DriverClock::monotonic())
+       */
+      void setClock(DriverClock& arClock);
+
+
    private:
 
       /**
@@ -161,11 +409,167 @@ namespace CAR4TEGRA
       int checkBit(int aValue, int aBitMask);
 
 
+      /**
+       * @brief Reads a register byte (bus lock has to be held)
+       *
+       * @param[in]  aRegister      Register to read from
+       *
+       * @return Returns the register value
+       */
+      int busRead(int aRegister);
+
+
+      /**
+       * @brief Writes a register byte and updates the shadow image (bus lock has to be held)
+       *
+       * @param[in]  aRegister      Register to write to
+       * @param[in]  aValue         Value to write to the register
+       *
+       * @return Returns the writing result
+       */
+      int busWrite(int aRegister, int aValue);
+
+
+      /**
+       * @brief Writes a register block and updates the shadow image (bus lock has to be held)
+       *
+       * @param[in]  aRegister      First register to write to
+       * @param[in]  apData         Values to write
+       * @param[in]  aLength        Number of registers to write
+       *
+       * @return Returns the number of bytes written
+       */
+      int busWriteBlock(int aRegister, const uint8_t* apData, size_t aLength);
+
+
+      /**
+       * @brief Returns the channels whose outputs are held off (bus lock has to be held)
+       *
+       * @return Stopped channels, all channels while an emergency stop is running
+       */
+      uint16_t heldOff() const;
+
+
+      /**
+       * @brief Sets FULL_OFF in a LEDn_OFF_H / ALL_LED_OFF_H value of held off channels
+       *
+       * @param[in]  aRegister      Register address
+       * @param[in]  aValue         Value to write
+       *
+       * @return Value to send
+       */
+      int holdOff(int aRegister, int aValue) const;
+
+
+      /**
+       * @brief Replaces commanded LEDn_OFF_H values of stopped channels by FULL_OFF (bus lock has to be held)
+       *
+       * The commanded values are kept for enableOutputs().
+       *
+       * @param[in,out] arTarget    Target values
+       * @param[in]  acrMask        Registers to bring to their target
+       */
+      void holdStopped(RegisterImage& arTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask);
+
+
+      /**
+       * @brief Stores written register values in the shadow image
+       *
+       * Writes to the ALL_LED registers are mirrored to the corresponding LEDn registers.
+       *
+       * @param[in]  aRegister      First register written
+       * @param[in]  apData         Values written
+       * @param[in]  aLength        Number of registers written
+       * @param[in]  aFailed        The write failed, the values are marked for reconnect()
+       */
+      void updateShadow(int aRegister, const uint8_t* apData, size_t aLength, bool aFailed = false);
+
+
+      /**
+       * @brief Returns the bits of a register which are compared against the shadow image
+       *
+       * @param[in]  aRegister      Register address
+       *
+       * @return Bit mask (`0` if the register is not compared at all)
+       */
+      int scrubMask(int aRegister) const;
+
+
+      /**
+       * @brief Returns the prescale value of a PWM frequency
+       *
+       * @param[in]  aFrequency     PWM frequency (limited to 24 - 1526 Hz)
+       *
+       * @return PRE_SCALE register value
+       */
+      static int prescale(float aFrequency);
+
+
+      /**
+       * @brief Writes MODE1, MODE2 and PRE_SCALE back from the shadow image (bus lock has to be held)
+       *
+       * MODE1 is always written, the driver default is used if its value is unknown.
+       *
+       * @param[in]  apLock         Lock of the caller, released while the oscillator settles
+       *                            (`nullptr`: the lock is held throughout)
+       */
+      void restoreConfiguration(std::unique_lock<std::mutex>* apLock = nullptr);
+
+
+      /**
+       * @brief Writes selected registers back from the shadow image (bus lock has to be held)
+       *
+       * Contiguous runs are written with one block transfer if auto-increment is enabled.
+       *
+       * @param[in]  aFirst         First register to write
+       * @param[in]  aLast          Last register to write
+       * @param[in]  acrSelect      Registers to write (only registers with known values are written)
+       */
+      void writeShadow(int aFirst, int aLast, const std::bitset<PCA9685_REG_COUNT>& acrSelect);
+
+
+      /**
+       * @brief Plans and writes LEDn registers (bus lock has to be held)
+       *
+       * @param[in]  acrTarget      Target values
+       * @param[in]  acrMask        Registers to bring to their target
+       *
+       * @return Estimated bus time of the written transactions (us)
+       */
+      double writePlanned(const RegisterImage& acrTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask);
+
+
+      /**
+       * @brief Scope guard for bus accesses of the control path
+       *
+       * Announces the access before waiting for the bus lock, so background checks give way.
+       */
+      class BusGuard
+      {
+      public:
+         explicit BusGuard(PCA9685& arDriver);
+         ~BusGuard();
+      private:
+         PCA9685& mrDriver;         ///< Guarded driver
+      };
+
+
    private:
 
       std::unique_ptr<CAR4TEGRA::I2cDevice> mpI2CDevice; ///< Instance of the used I2C device
       int mAddress;                 ///< Address of the PCA9685 device
       std::string mBusName;         ///< Name of the I2C bus the PCA9685 device is connected to
+      std::mutex mBusMutex;         ///< Serializes accesses to the I2C device
+      std::atomic<int> mPendingAccesses;  ///< Number of control path accesses waiting or running
+      RegisterImage mShadow;        ///< Register values last written by the driver
+      std::bitset<PCA9685_REG_COUNT> mShadowValid; ///< Registers written since opening the device
+      std::bitset<PCA9685_REG_COUNT> mShadowDirty; ///< Registers whose last write failed
+      WritePlanner mPlanner;        ///< Computes the cheapest write transactions
+      uint16_t mStopped;            ///< Channels held off with FULL_OFF
+      std::array<uint8_t, PCA9685_CHANNEL_COUNT> mResumeOffHigh;   ///< Commanded LEDn_OFF_H values of stopped channels
+      std::atomic<int> mEmergencyStops;   ///< Number of emergency stops not yet done under the bus lock
+      std::atomic<uint64_t> mWrites;      ///< Number of write transfers sent to the device
+      DriverClock* mpClock;         ///< Clock for the oscillator waits
    }; // class PCA9685
 } // namespace CAR4TEGRA
 
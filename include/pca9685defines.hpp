@@ -137,6 +137,17 @@
 #define PCA9685_REG_TESTMODE        0xFF     ///< defines the test mode to be entered
 
 
+// register windows used for block transfers (auto-increment, MODE1 AI bit has to be set)
+
+#define PCA9685_REG_COUNT           256      ///< Size of the register address space
+#define PCA9685_CHANNEL_COUNT       16       ///< Number of PWM output channels
+#define PCA9685_BLOCK_LOW_FIRST     0x00     ///< First register of the MODE / LEDn window
+#define PCA9685_BLOCK_LOW_LAST      0x45     ///< Last register of the MODE / LEDn window
+#define PCA9685_BLOCK_HIGH_FIRST    0xFA     ///< First register of the ALL_LED / PRE_SCALE window
+#define PCA9685_BLOCK_HIGH_LAST     0xFE     ///< Last register of the ALL_LED / PRE_SCALE window (rolls over to MODE1)
+#define PCA9685_STATE_LENGTH        (1 + PCA9685_BLOCK_LOW_LAST - PCA9685_BLOCK_LOW_FIRST + 1)   ///< PRE_SCALE followed by MODE / LEDn window
+
+
 // MODE1 register bit masks (table 5 in NXP datasheet)
 
 #define PCA9685_MODE1_RESTART       0b10000000     ///< Bit 7
@@ -158,5 +169,11 @@
 #define PCA9685_MODE2_OUTNE_0       0b00000001     ///< Bit 0
 
 
+// LEDn_ON_H / LEDn_OFF_H register bit masks (tables 7 and 8 in NXP datasheet)
+
+#define PCA9685_LED_FULL            0b00010000     ///< Bit 4, FULL_ON in LEDn_ON_H / FULL_OFF in LEDn_OFF_H (FULL_OFF wins)
+#define PCA9685_LED_COUNT_H         0b00001111     ///< Bits 3 - 0, upper bits of the ON / OFF count
+
+
 #endif // PCA9685DEFINES_HPP
 
@@ -0,0 +1,131 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file profileapplier.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class ProfileApplier at namespace CAR4TEGRA
+ *
+ * @details
+ * The ProfileApplier class drives the channels of a device by position (-1.0 - 1.0) through
+ * a CalibrationProfile. A new profile is applied incrementally: only channels whose
+ * calibration changed are rewritten, all of them with one batched update, without
+ * reconnecting the device.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef PROFILEAPPLIER_H
+#define PROFILEAPPLIER_H
+
+
+// std includes
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+// Car4Tegra includes
+#include "include/calibrationprofile.hpp"
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class ProfileApplier profileapplier.hpp "include/profileapplier.hpp"
+    * @brief The ProfileApplier class maps channel positions to PWM values with a hot-swappable profile
+    *
+    * Only channels which have been given a position are written, the profile alone never
+    * moves an output. All functions are thread-safe, e.g. apply() can be called from the
+    * ProfileWatcher thread while the application sets positions.
+    */
+   class ProfileApplier
+   {
+   public:
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arDriver       Connected device (has to outlive the applier)
+       */
+      explicit ProfileApplier(PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor
+       */
+      ~ProfileApplier();
+
+
+      /**
+       * @brief Applies a new profile
+       *
+       * A changed frequency is written first. Then the positioned channels with a changed
+       * calibration are written with one PCA9685::setPWMBatch(), all other channels are not
+       * touched. Channels removed from the profile keep their last value.
+       *
+       * @param[in]  acrProfile     New profile
+       *
+       * @return Mask of the rewritten channels
+       */
+      uint16_t apply(const CalibrationProfile& acrProfile);
+
+
+      /**
+       * @brief Moves a channel of the profile to a position
+       *
+       * @param[in]  aChannel       Channel of the profile (0 - 15)
+       * @param[in]  aPosition      Position (-1.0 - 1.0)
+       */
+      void setPosition(int aChannel, double aPosition);
+
+
+      /**
+       * @brief Returns the position of a channel
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       *
+       * @return Position (`0.0` if the channel has not been positioned)
+       */
+      double position(int aChannel);
+
+
+      /**
+       * @brief Returns the applied profile
+       *
+       * @return Profile
+       */
+      CalibrationProfile profile();
+
+
+   private:
+      std::mutex mMutex;            ///< Protects profile and positions
+      PCA9685& mrDriver;            ///< Device driver
+      CalibrationProfile mProfile;  ///< Applied profile
+      std::array<double, PCA9685_CHANNEL_COUNT> mPositions;   ///< Last position of each channel
+      uint16_t mPositioned;         ///< Channels which have been given a position
+   }; // class ProfileApplier
+} // namespace CAR4TEGRA
+
+#endif // PROFILEAPPLIER_H
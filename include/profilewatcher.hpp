@@ -0,0 +1,202 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file profilewatcher.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class ProfileWatcher at namespace CAR4TEGRA
+ *
+ * @details
+ * The ProfileWatcher class watches a calibration profile file with inotify and reloads it
+ * when it is rewritten or replaced, so recalibrations reach running processes without a
+ * restart. A profile which fails to parse is reported and the last valid profile is kept.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef PROFILEWATCHER_H
+#define PROFILEWATCHER_H
+
+
+// std includes
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Car4Tegra includes
+#include "include/calibrationprofile.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class ProfileWatcher profilewatcher.hpp "include/profilewatcher.hpp"
+    * @brief The ProfileWatcher class reloads a calibration profile when the file changes
+    *
+    * The directory of the file is watched, so both editing in place (IN_CLOSE_WRITE) and
+    * atomic replacement by rename (IN_MOVED_TO) are seen. A reload which gives the same
+    * profile does not call the change callback.
+    */
+   class ProfileWatcher
+   {
+   public:
+      /// Callback for a changed profile (called from the thread running poll())
+      typedef std::function<void(const CalibrationProfile& acrProfile)> ChangeCallback;
+
+      /// Callback for profiles which could not be loaded (called from the thread running poll())
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      ProfileWatcher();
+
+
+      /**
+       * @brief Destructor, stops the watcher thread and closes the watch
+       */
+      ~ProfileWatcher();
+
+
+      /** @{ @name Setup functions (only while stopped) */
+
+      /**
+       * @brief Sets the callback for changed profiles
+       *
+       * @param[in]  aCallback      Change callback
+       */
+      void setChangeCallback(ChangeCallback aCallback);
+
+
+      /**
+       * @brief Sets the callback for profiles which could not be loaded
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Loads a profile file and starts watching it
+       *
+       * @param[in]  acrFileName    Profile file (has to be valid when opening)
+       */
+      void open(const std::string& acrFileName);
+
+
+      /**
+       * @brief Stops watching the file
+       */
+      void close();
+
+      /** @} */
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Starts a thread which reloads the profile on changes
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the watcher thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Reloads the profile in the calling thread if the file changed
+       *
+       * @param[in]  aTimeoutMs     Maximum time to wait for a change (ms)
+       *
+       * @return `true` if a changed profile was loaded
+       */
+      bool poll(int aTimeoutMs);
+
+      /** @} */
+
+
+      /** @{ @name Status functions */
+
+      /**
+       * @brief Returns the watched file
+       *
+       * @return File name (empty if closed)
+       */
+      const std::string& fileName() const;
+
+
+      /**
+       * @brief Returns the inotify file descriptor, e.g. for an external event loop
+       *
+       * @return File descriptor (`-1` if closed)
+       */
+      int fd() const;
+
+
+      /**
+       * @brief Returns the last valid profile (thread-safe)
+       *
+       * @return Profile
+       */
+      CalibrationProfile profile();
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Thread function, reloads the profile until stopped
+       */
+      void run();
+
+
+      /**
+       * @brief Reports an error to the error callback
+       *
+       * @param[in]  acrMessage     Error message
+       */
+      void report(const std::string& acrMessage);
+
+
+   private:
+      std::string mFileName;        ///< Watched file
+      std::string mBaseName;        ///< File name without directory (compared against the events)
+      int mNotify;                  ///< inotify file descriptor
+      ChangeCallback mChangeCallback;     ///< Callback for changed profiles
+      ErrorCallback mErrorCallback; ///< Callback for load errors
+      std::mutex mProfileMutex;     ///< Protects the profile
+      CalibrationProfile mProfile;  ///< Last valid profile
+      std::thread mThread;          ///< Watcher thread
+      std::atomic<bool> mRunning;   ///< Watcher thread is running
+   }; // class ProfileWatcher
+} // namespace CAR4TEGRA
+
+#endif // PROFILEWATCHER_H
@@ -0,0 +1,188 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file registerscrubber.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class RegisterScrubber at namespace CAR4TEGRA
+ *
+ * @details
+ * The RegisterScrubber class periodically reads back the register file of a PCA9685 device
+ * on a low priority thread and compares it against the state last written by the driver.
+ * Drifts (e.g. caused by brownouts or external resets) are reported and optionally repaired.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef REGISTERSCRUBBER_H
+#define REGISTERSCRUBBER_H
+
+
+// std includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class RegisterScrubber registerscrubber.hpp "include/registerscrubber.hpp"
+    * @brief The RegisterScrubber class checks a PCA9685 device for register drifts
+    *
+    * The register file is checked in small windows, so the bus is never blocked for longer
+    * than one short block read. Every window gives way to pending writes of the control path.
+    */
+   class RegisterScrubber
+   {
+   public:
+      /// Callback for detected drifts (called from the scrubber thread)
+      typedef std::function<void(const PCA9685::RegisterDrift& acrDrift, bool aRepaired)> DriftCallback;
+
+      /// Callback for errors during read back (called from the scrubber thread)
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arDriver       Driver to check (has to outlive the scrubber)
+       */
+      explicit RegisterScrubber(PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor, stops the scrubber thread
+       */
+      ~RegisterScrubber();
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Starts the scrubber thread
+       *
+       * @param[in]  aInterval      Pause between two complete passes over the register file
+       * @param[in]  aRepair        Write the last written state back if a drift was found
+       */
+      void start(std::chrono::milliseconds aInterval, bool aRepair);
+
+
+      /**
+       * @brief Stops the scrubber thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Returns if the scrubber thread is running
+       *
+       * @return `true` if running, `false` otherwise
+       */
+      bool isRunning() const;
+
+      /** @} */
+
+
+      /** @{ @name Settings */
+
+      /**
+       * @brief Sets the callback for detected drifts (only while stopped)
+       *
+       * @param[in]  aCallback      Drift callback
+       */
+      void setDriftCallback(DriftCallback aCallback);
+
+
+      /**
+       * @brief Sets the callback for read back errors (only while stopped)
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Sets the number of registers read with one block transfer (only while stopped)
+       *
+       * @param[in]  aLength        Window length (1 - 16), default is one LEDn register set
+       */
+      void setWindowLength(size_t aLength);
+
+      /** @} */
+
+
+   private:
+
+      /**
+       * @brief Thread function, runs passes over the register file until stopped
+       */
+      void run();
+
+
+      /**
+       * @brief Checks a register window, retries while the control path is busy
+       *
+       * @param[in]  aRegister      First register of the window
+       * @param[in]  aLength        Number of registers of the window
+       *
+       * @return `true` if the window was checked, `false` if the scrubber was stopped meanwhile
+       */
+      bool checkWindow(int aRegister, size_t aLength);
+
+
+      /**
+       * @brief Waits for a given time or until the scrubber is stopped
+       *
+       * @param[in]  aTime          Time to wait
+       *
+       * @return `true` if the scrubber is still running
+       */
+      bool waitFor(std::chrono::microseconds aTime);
+
+
+   private:
+      PCA9685& mrDriver;                  ///< Checked driver
+      std::thread mThread;                ///< Scrubber thread
+      std::atomic<bool> mRunning;         ///< Scrubber thread is running
+      std::mutex mWaitMutex;              ///< Mutex for interruptible waits
+      std::condition_variable mWaitCond;  ///< Condition for interruptible waits
+      std::chrono::milliseconds mInterval;   ///< Pause between two passes
+      bool mRepair;                       ///< Repair detected drifts
+      size_t mWindowLength;               ///< Registers per block read
+      DriftCallback mDriftCallback;       ///< Callback for detected drifts
+      ErrorCallback mErrorCallback;       ///< Callback for read back errors
+      std::vector<PCA9685::RegisterDrift> mDrift;  ///< Drift buffer of the current window
+   }; // class RegisterScrubber
+} // namespace CAR4TEGRA
+
+#endif // REGISTERSCRUBBER_H
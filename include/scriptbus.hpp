@@ -0,0 +1,194 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file scriptbus.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class ScriptBus at namespace CAR4TEGRA
+ *
+ * @details
+ * The ScriptBus class runs the blocking driver calls of scripts on one worker thread per
+ * device and resumes the scripts on their ScriptRuntime when the transfer is done. Channel
+ * updates of many scripts which are waiting at the same time are written with one
+ * PCA9685::setPWMBatch() call.
+ *
+ * Requires C++20 (library c4tscript).
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SCRIPTBUS_H
+#define SCRIPTBUS_H
+
+
+// std includes
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+#include "include/scriptruntime.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class ScriptBus scriptbus.hpp "include/scriptbus.hpp"
+    * @brief Awaitable driver calls for scripts, executed by a worker thread
+    */
+   class ScriptBus
+   {
+   public:
+      /// Driver call executed on the worker thread
+      typedef std::function<void(PCA9685& arDriver)> Operation;
+
+      /**
+       * @brief Transfer statistics
+       */
+      struct Statistics
+      {
+         uint64_t mOperations;      ///< Driver calls of run()
+         uint64_t mUpdates;         ///< Channel updates of setPWM()
+         uint64_t mBatches;         ///< setPWMBatch() calls writing the channel updates
+         uint64_t mErrors;          ///< Failed driver calls
+      };
+
+      /**
+       * @brief Awaitable driver call, rethrows the exception of the call
+       */
+      class Awaiter
+      {
+      public:
+         Awaiter(ScriptBus& arBus, Operation aOperation);
+         Awaiter(ScriptBus& arBus, int aChannel, int aOnValue, int aOffValue);
+         bool await_ready() const noexcept { return false; }
+         void await_suspend(std::coroutine_handle<> aHandle);
+         void await_resume() const;
+      private:
+         friend class ScriptBus;
+         ScriptBus& mrBus;          ///< Executing bus
+         Operation mOperation;      ///< Driver call (empty for channel updates)
+         int mChannel;              ///< Channel of an update
+         int mOnValue;              ///< PWM ON value of an update
+         int mOffValue;             ///< PWM OFF value of an update
+         std::exception_ptr mException;   ///< Exception of the call
+         std::coroutine_handle<> mHandle; ///< Waiting script
+      };
+
+
+      /**
+       * @brief Constructor, starts the worker thread
+       *
+       * @param[in]  arRuntime      Runtime the scripts run on (has to outlive the bus)
+       * @param[in]  arDriver       Connected device (has to outlive the bus)
+       */
+      ScriptBus(ScriptRuntime& arRuntime, PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor, executes the queued calls and stops the worker thread
+       */
+      ~ScriptBus();
+
+      ScriptBus(const ScriptBus&) = delete;
+      ScriptBus& operator=(const ScriptBus&) = delete;
+
+
+      /**
+       * @brief Returns an awaitable driver call (`co_await bus.run(...)`)
+       *
+       * @param[in]  aOperation     Driver call
+       *
+       * @return Awaitable
+       */
+      Awaiter run(Operation aOperation);
+
+
+      /**
+       * @brief Returns an awaitable channel update, merged with the updates of other scripts
+       *
+       * @param[in]  aChannel       Channel number (0 - 15)
+       * @param[in]  aOnValue       Value for PWM ON (0 - 4095)
+       * @param[in]  aOffValue      Value for PWM OFF (0 - 4095)
+       *
+       * @return Awaitable
+       */
+      Awaiter setPWM(int aChannel, int aOnValue, int aOffValue);
+
+
+      /**
+       * @brief Returns the transfer statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      Statistics statistics();
+
+
+   private:
+      /**
+       * @brief Queues a waiting call for the worker
+       *
+       * @param[in]  apAwaiter      Call (lives in the frame of the waiting script)
+       */
+      void enqueue(Awaiter* apAwaiter);
+
+
+      /**
+       * @brief Executes a queued call or a run of channel updates, then resumes the scripts
+       *
+       * @param[in]  aFirst         First call in mBatch
+       *
+       * @return First call not executed
+       */
+      size_t execute(size_t aFirst);
+
+
+      /**
+       * @brief Worker thread function, executes calls until stopped
+       */
+      void worker();
+
+
+   private:
+      ScriptRuntime& mrRuntime;     ///< Runtime of the waiting scripts
+      PCA9685& mrDriver;            ///< Device
+      std::mutex mMutex;            ///< Protects the queue and the statistics
+      std::condition_variable mWake;   ///< Signals queued calls
+      std::deque<Awaiter*> mQueue;  ///< Queued calls
+      std::vector<Awaiter*> mBatch; ///< Calls taken over by the worker
+      Statistics mStatistics;       ///< Transfer statistics
+      bool mRunning;                ///< Worker keeps running
+      std::thread mThread;          ///< Worker thread
+   }; // class ScriptBus
+} // namespace CAR4TEGRA
+
+#endif // SCRIPTBUS_H
@@ -0,0 +1,449 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file scriptruntime.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of the classes ScriptRuntime, ScriptTask and
+ *        ScriptEvent at namespace CAR4TEGRA
+ *
+ * @details
+ * The ScriptRuntime class runs calibration and test scripts written as C++20 coroutines on one
+ * thread. Scripts `co_await` delays, bus completions (see ScriptBus) and operator input
+ * (ScriptEvent) instead of blocking a thread each. The scheduler waits on a timerfd for the
+ * earliest delay and on an eventfd for resumptions posted by other threads, both through one
+ * epoll descriptor which can also be added to another event loop (e.g. a QSocketNotifier).
+ *
+ * Requires C++20 (library c4tscript).
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SCRIPTRUNTIME_H
+#define SCRIPTRUNTIME_H
+
+
+// std includes
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace CAR4TEGRA
+{
+   class ScriptRuntime;
+
+
+   /**
+    * @class ScriptTask scriptruntime.hpp "include/scriptruntime.hpp"
+    * @brief Coroutine type of a script or script step
+    *
+    * A task starts suspended. It is either started with ScriptRuntime::spawn() or awaited by
+    * another task (`co_await step()`), which then continues when the step is done and receives
+    * its exception.
+    */
+   class ScriptTask
+   {
+   public:
+      struct promise_type;
+
+      /**
+       * @brief Continues the awaiting task or reports a spawned task as finished
+       */
+      struct FinalAwaiter
+      {
+         bool await_ready() const noexcept { return false; }
+         std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> aHandle) noexcept;
+         void await_resume() const noexcept {}
+      };
+
+      /**
+       * @brief Coroutine promise
+       */
+      struct promise_type
+      {
+         std::coroutine_handle<> mContinuation;   ///< Awaiting task (steps only)
+         std::exception_ptr mException;           ///< Exception thrown by the task
+         ScriptRuntime* mpRuntime = nullptr;       ///< Runtime of a spawned task
+
+         ScriptTask get_return_object() noexcept;
+         std::suspend_always initial_suspend() const noexcept { return {}; }
+         FinalAwaiter final_suspend() const noexcept { return {}; }
+         void return_void() const noexcept {}
+         void unhandled_exception() noexcept { mException = std::current_exception(); }
+      };
+
+
+      /**
+       * @brief Move constructor
+       *
+       * @param[in]  arOther        Task to take over
+       */
+      ScriptTask(ScriptTask&& arOther) noexcept;
+
+
+      /**
+       * @brief Destructor, destroys the coroutine if it was neither spawned nor is running
+       */
+      ~ScriptTask();
+
+      ScriptTask(const ScriptTask&) = delete;
+      ScriptTask& operator=(const ScriptTask&) = delete;
+
+
+      /** @{ @name Awaitable functions (`co_await step()`) */
+
+      bool await_ready() const noexcept;
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> aParent) noexcept;
+      void await_resume() const;
+
+      /** @} */
+
+
+   private:
+      friend class ScriptRuntime;
+
+      explicit ScriptTask(std::coroutine_handle<promise_type> aHandle);
+
+      std::coroutine_handle<promise_type> mHandle;   ///< Owned coroutine
+   }; // class ScriptTask
+
+
+   /**
+    * @class ScriptRuntime scriptruntime.hpp "include/scriptruntime.hpp"
+    * @brief Single-threaded scheduler of script coroutines
+    *
+    * All scripts run on the thread calling run() or poll(). Only post(), stop() and
+    * ScriptEvent::set() may be called from other threads.
+    */
+   class ScriptRuntime
+   {
+   public:
+      typedef std::chrono::steady_clock Clock;
+
+      /// Callback for scripts which ended with an exception
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+      /**
+       * @brief Runtime statistics
+       */
+      struct Statistics
+      {
+         uint64_t mSpawned;         ///< Spawned scripts
+         uint64_t mCompleted;       ///< Scripts finished without exception
+         uint64_t mFailed;          ///< Scripts finished with an exception
+         uint64_t mResumes;         ///< Coroutine resumptions
+         uint64_t mWakeups;         ///< Wakeups of the event loop
+         size_t mMaxTimers;         ///< Maximum number of pending delays
+      };
+
+      /**
+       * @brief Awaitable delay
+       */
+      class SleepAwaiter
+      {
+      public:
+         SleepAwaiter(ScriptRuntime& arRuntime, Clock::time_point aDeadline);
+         bool await_ready() const noexcept;
+         void await_suspend(std::coroutine_handle<> aHandle);
+         void await_resume() const noexcept {}
+      private:
+         ScriptRuntime& mrRuntime;  ///< Runtime owning the timer
+         Clock::time_point mDeadline;   ///< Resumption time
+      };
+
+
+      /**
+       * @brief Standard constructor, creates the epoll, timer and event descriptors
+       */
+      ScriptRuntime();
+
+
+      /**
+       * @brief Destructor, destroys all scripts not yet finished
+       */
+      ~ScriptRuntime();
+
+      ScriptRuntime(const ScriptRuntime&) = delete;
+      ScriptRuntime& operator=(const ScriptRuntime&) = delete;
+
+
+      /** @{ @name Script functions (runtime thread) */
+
+      /**
+       * @brief Starts a script, it runs with the next pass of the event loop
+       *
+       * @param[in]  aTask          Script coroutine
+       * @param[in]  acrName        Name used in error messages
+       */
+      void spawn(ScriptTask aTask, const std::string& acrName = "");
+
+
+      /**
+       * @brief Returns an awaitable delay (`co_await runtime.sleep(...)`)
+       *
+       * @param[in]  aDuration      Delay
+       *
+       * @return Awaitable
+       */
+      SleepAwaiter sleep(Clock::duration aDuration);
+
+
+      /**
+       * @brief Returns an awaitable delay until a point in time
+       *
+       * @param[in]  aDeadline      Resumption time
+       *
+       * @return Awaitable
+       */
+      SleepAwaiter sleepUntil(Clock::time_point aDeadline);
+
+
+      /**
+       * @brief Returns the number of scripts not yet finished
+       *
+       * @return Number of scripts
+       */
+      size_t activeScripts() const;
+
+
+      /**
+       * @brief Returns the runtime statistics
+       *
+       * @return Statistics
+       */
+      Statistics statistics() const;
+
+
+      /**
+       * @brief Sets the callback for failed scripts
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+      /** @} */
+
+
+      /** @{ @name Event loop functions */
+
+      /**
+       * @brief Runs the event loop until all scripts are finished or stop() is called
+       */
+      void run();
+
+
+      /**
+       * @brief Runs one pass of the event loop (for embedding into another event loop)
+       *
+       * @param[in]  aTimeoutMs     Maximum wait for an event if nothing is ready (`-1`: no limit)
+       *
+       * @return Number of resumed coroutines
+       */
+      size_t poll(int aTimeoutMs);
+
+
+      /**
+       * @brief Makes run() return after the current pass (thread-safe)
+       */
+      void stop();
+
+
+      /**
+       * @brief Resumes a coroutine on the runtime thread (thread-safe)
+       *
+       * @param[in]  aHandle        Suspended coroutine
+       */
+      void post(std::coroutine_handle<> aHandle);
+
+
+      /**
+       * @brief Returns the epoll descriptor, readable while the runtime has work
+       *
+       * @return File descriptor
+       */
+      int fd() const;
+
+      /** @} */
+
+
+   private:
+      friend struct ScriptTask::FinalAwaiter;
+
+      /**
+       * @brief Pending delay
+       */
+      struct Timer
+      {
+         Clock::time_point mDeadline;  ///< Resumption time
+         uint64_t mSequence;           ///< Insertion order (FIFO for equal deadlines)
+         std::coroutine_handle<> mHandle;  ///< Suspended coroutine
+
+         bool operator>(const Timer& acrOther) const
+         {
+            return (mDeadline != acrOther.mDeadline) ? mDeadline > acrOther.mDeadline : mSequence > acrOther.mSequence;
+         }
+      };
+
+
+      /**
+       * @brief Adds a delay and rearms the timer if it is the earliest one
+       *
+       * @param[in]  aDeadline      Resumption time
+       * @param[in]  aHandle        Suspended coroutine
+       */
+      void addTimer(Clock::time_point aDeadline, std::coroutine_handle<> aHandle);
+
+
+      /**
+       * @brief Arms the timerfd for the earliest delay (or disarms it)
+       */
+      void armTimer();
+
+
+      /**
+       * @brief Moves posted coroutines and expired delays to the ready queue
+       */
+      void collectReady();
+
+
+      /**
+       * @brief Marks a spawned script as finished, it is destroyed after the current resumption
+       *
+       * @param[in]  aHandle        Finished script
+       */
+      void finish(std::coroutine_handle<ScriptTask::promise_type> aHandle);
+
+
+      /**
+       * @brief Reports and destroys finished scripts
+       */
+      void destroyFinished();
+
+
+   private:
+      int mEpoll;                   ///< epoll descriptor
+      int mTimerFd;                 ///< timerfd of the earliest delay
+      int mEventFd;                 ///< eventfd signalling posted coroutines
+      std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> mTimers;   ///< Pending delays
+      Clock::time_point mArmed;     ///< Deadline the timerfd is armed for (epoch: disarmed)
+      uint64_t mTimerSequence;      ///< Insertion counter of the delays
+      std::deque<std::coroutine_handle<>> mReady;   ///< Coroutines to resume
+      std::mutex mPostMutex;        ///< Protects the posted coroutines
+      std::vector<std::coroutine_handle<>> mPosted;     ///< Coroutines posted by other threads
+      std::vector<std::coroutine_handle<>> mTakeOver;   ///< Scratch buffer for the posted coroutines
+      std::unordered_map<void*, std::string> mScripts;  ///< Names of the spawned scripts by frame address
+      std::vector<std::coroutine_handle<ScriptTask::promise_type>> mFinished;   ///< Scripts to destroy
+      std::atomic<bool> mStopRequested;   ///< stop() was called
+      ErrorCallback mErrorCallback; ///< Callback for failed scripts
+      Statistics mStatistics;       ///< Runtime statistics
+   }; // class ScriptRuntime
+
+
+   /**
+    * @class ScriptEvent scriptruntime.hpp "include/scriptruntime.hpp"
+    * @brief Manual-reset event for operator input, awaited by scripts and set from any thread
+    *
+    * `co_await event` returns the value passed to set(). While the event is set, awaiting it
+    * does not suspend.
+    */
+   class ScriptEvent
+   {
+   public:
+      /**
+       * @brief Awaitable of the event
+       */
+      class Awaiter
+      {
+      public:
+         explicit Awaiter(ScriptEvent& arEvent);
+         bool await_ready();
+         bool await_suspend(std::coroutine_handle<> aHandle);
+         int await_resume() const noexcept { return mValue; }
+      private:
+         friend class ScriptEvent;
+         ScriptEvent& mrEvent;      ///< Awaited event
+         int mValue;                ///< Value passed to set()
+      };
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arRuntime      Runtime the waiting scripts run on (has to outlive the event)
+       */
+      explicit ScriptEvent(ScriptRuntime& arRuntime);
+
+
+      /**
+       * @brief Sets the event and resumes all waiting scripts (thread-safe)
+       *
+       * @param[in]  aValue         Value returned to the scripts
+       */
+      void set(int aValue = 0);
+
+
+      /**
+       * @brief Resets the event, later scripts wait for the next set() (thread-safe)
+       */
+      void reset();
+
+
+      /**
+       * @brief Returns if the event is set (thread-safe)
+       *
+       * @return `true` if set
+       */
+      bool isSet();
+
+
+      /**
+       * @brief Returns the awaitable (`co_await event`)
+       *
+       * @return Awaitable
+       */
+      Awaiter operator co_await();
+
+
+   private:
+      ScriptRuntime& mrRuntime;     ///< Runtime of the waiting scripts
+      std::mutex mMutex;            ///< Protects the state and the waiting scripts
+      bool mSet;                    ///< Event is set
+      int mValue;                   ///< Value of the last set()
+      std::vector<std::pair<std::coroutine_handle<>, Awaiter*>> mWaiters;   ///< Waiting scripts
+   }; // class ScriptEvent
+} // namespace CAR4TEGRA
+
+#endif // SCRIPTRUNTIME_H
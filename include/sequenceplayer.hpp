@@ -0,0 +1,404 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file sequenceplayer.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of the classes SequenceWriter and SequencePlayer
+ *        at namespace CAR4TEGRA
+ *
+ * @details
+ * The SequenceWriter class creates binary keyframe files for repeatable motion sequences
+ * (steering sweeps, throttle steps, ...). The SequencePlayer class memory-maps such a file and
+ * streams it to a PCA9685 device frame by frame.
+ *
+ * File layout: one 32 byte header followed by 48 byte keyframes sorted by time.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SEQUENCEPLAYER_H
+#define SEQUENCEPLAYER_H
+
+
+// std includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/driverclock.hpp"
+#include "include/pca9685.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief One keyframe of a motion sequence
+    *
+    * The interpolation mode describes how each selected channel moves from its previous
+    * keyframe to this one.
+    */
+   struct SequenceKeyframe
+   {
+      uint64_t mTimeUs;             ///< Time since sequence start (us)
+      uint16_t mChannelMask;        ///< Bit n selects channel n
+      uint8_t mInterpolation;       ///< Interpolation mode (see SequencePlayer::Interpolation)
+      uint8_t mReserved[5];         ///< Reserved, has to be `0`
+      uint16_t mValues[PCA9685_CHANNEL_COUNT];   ///< PWM OFF values (0 - 4095), indexed by channel
+   };
+
+
+   /**
+    * @brief Keyframe file header
+    */
+   struct SequenceHeader
+   {
+      char mMagic[8];               ///< File magic "C4TSEQNC"
+      uint32_t mVersion;            ///< File format version
+      uint16_t mKeyframeSize;       ///< Size of one keyframe (bytes)
+      uint16_t mChannelMask;        ///< Channels used by any keyframe
+      uint64_t mCount;              ///< Number of keyframes
+      uint64_t mDurationUs;         ///< Time of the last keyframe (us)
+   };
+
+
+   /**
+    * @class SequenceWriter sequenceplayer.hpp "include/sequenceplayer.hpp"
+    * @brief The SequenceWriter class creates keyframe files
+    */
+   class SequenceWriter
+   {
+   public:
+      /**
+       * @brief Standard constructor with no input
+       */
+      SequenceWriter();
+
+
+      /**
+       * @brief Destructor, closes the keyframe file
+       */
+      ~SequenceWriter();
+
+
+      /**
+       * @brief Creates a keyframe file (an existing file is overwritten)
+       *
+       * @param[in]  acrFileName    Name of the keyframe file
+       */
+      void open(const std::string& acrFileName);
+
+
+      /**
+       * @brief Appends a keyframe
+       *
+       * @param[in]  acrKeyframe    Keyframe, not earlier than the last appended one
+       */
+      void append(const SequenceKeyframe& acrKeyframe);
+
+
+      /**
+       * @brief Writes pending keyframes and the header, closes the keyframe file
+       */
+      void close();
+
+
+   private:
+      /**
+       * @brief Writes the buffered keyframes to the file
+       *
+       * @return `true` if written, `false` otherwise (errno is set)
+       */
+      bool flush();
+
+
+      std::string mFileName;        ///< Name of the keyframe file
+      int mFile;                    ///< File descriptor of the keyframe file
+      std::vector<uint8_t> mBuffer; ///< Keyframes not yet written
+      SequenceHeader mHeader;       ///< Header, written on close
+   }; // class SequenceWriter
+
+
+   /**
+    * @class SequencePlayer sequenceplayer.hpp "include/sequenceplayer.hpp"
+    * @brief The SequencePlayer class streams a memory-mapped keyframe file to a PCA9685 device
+    *
+    * Every channel follows its own keyframes, the player keeps one cursor per channel into the
+    * mapping. Nothing is parsed ahead and pages already played are released, so files with
+    * millions of keyframes play with constant memory. Each frame only writes the channels
+    * which changed, with one batched write.
+    */
+   class SequencePlayer
+   {
+   public:
+      /**
+       * @brief Interpolation modes
+       */
+      enum Interpolation
+      {
+         INTERPOLATION_STEP = 0,    ///< Jump at the keyframe time
+         INTERPOLATION_LINEAR = 1,  ///< Linear ramp from the previous keyframe
+         INTERPOLATION_SMOOTH = 2   ///< Ease in and out (smoothstep) from the previous keyframe
+      };
+
+
+      /**
+       * @brief Player statistics
+       */
+      struct Statistics
+      {
+         uint64_t mFrames;          ///< Played frames
+         uint64_t mBatches;         ///< Batched writes to the device
+         uint64_t mLoops;           ///< Restarts at the sequence end
+         uint64_t mLateFrames;      ///< Frames started later than one PWM period
+         uint64_t mErrors;          ///< Failed writes
+      };
+
+
+      /// Callback for write errors (called from the player thread)
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arDriver       Driver receiving the sequence (has to outlive the player)
+       */
+      explicit SequencePlayer(PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor, stops the player thread and closes the keyframe file
+       */
+      ~SequencePlayer();
+
+
+      /** @{ @name Control functions */
+
+      /**
+       * @brief Opens a keyframe file (only while stopped)
+       *
+       * @param[in]  acrFileName    Name of the keyframe file
+       */
+      void open(const std::string& acrFileName);
+
+
+      /**
+       * @brief Closes the keyframe file (stops the player thread)
+       */
+      void close();
+
+
+      /**
+       * @brief Starts the player thread at the sequence start
+       *
+       * @param[in]  aFrequency     PWM frequency (Hz), one frame per PWM period
+       */
+      void start(float aFrequency);
+
+
+      /**
+       * @brief Stops the player thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Returns if the player thread is running (stops by itself at the sequence end)
+       *
+       * @return `true` if running, `false` otherwise
+       */
+      bool isRunning() const;
+
+
+      /**
+       * @brief Restarts the sequence at the first keyframe (only while stopped)
+       */
+      void rewind();
+
+
+      /**
+       * @brief Plays the frame at a sequence time in the calling thread (only while stopped)
+       *
+       * The time must not decrease between two calls without rewind().
+       *
+       * @param[in]  aTimeUs        Time since sequence start (us)
+       *
+       * @return `true` if the sequence continues after this frame, `false` at the end
+       */
+      bool update(uint64_t aTimeUs);
+
+      /** @} */
+
+
+      /** @{ @name Settings */
+
+      /**
+       * @brief Sets if the sequence restarts at its end
+       *
+       * @param[in]  aLoop          `true`: loop, `false`: stop at the end
+       */
+      void setLoop(bool aLoop);
+
+
+      /**
+       * @brief Sets the time scaling (also while running)
+       *
+       * @param[in]  aScale         Sequence time per real time (e.g. `0.5`: half speed)
+       */
+      void setTimeScale(double aScale);
+
+
+      /**
+       * @brief Sets the callback for write errors (only while stopped)
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Sets the clock used for the frame pacing (only while stopped)
+       *
+       * @param[in]  arClock        Clock (has to outlive the player, default: DriverClock::monotonic())
+       */
+      void setClock(DriverClock& arClock);
+
+      /** @} */
+
+
+      /** @{ @name Information */
+
+      /**
+       * @brief Returns the number of keyframes of the opened file
+       *
+       * @return Keyframes
+       */
+      uint64_t keyframes() const;
+
+
+      /**
+       * @brief Returns the duration of the opened sequence
+       *
+       * @return Time of the last keyframe (us)
+       */
+      uint64_t duration() const;
+
+
+      /**
+       * @brief Returns the current sequence time (thread-safe)
+       *
+       * @return Time since sequence start (us)
+       */
+      uint64_t position() const;
+
+
+      /**
+       * @brief Returns the player statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      Statistics statistics() const;
+
+      /** @} */
+
+
+   private:
+      /**
+       * @brief Playback state of one channel
+       */
+      struct Track
+      {
+         uint64_t mCursor;          ///< Next keyframe to search for this channel
+         uint64_t mFromTime;        ///< Time of the last passed keyframe (us)
+         uint64_t mToTime;          ///< Time of the next keyframe (us)
+         uint16_t mFromValue;       ///< Value of the last passed keyframe
+         uint16_t mToValue;         ///< Value of the next keyframe
+         uint8_t mMode;             ///< Interpolation towards the next keyframe
+         bool mHasFrom;             ///< A keyframe was passed
+         bool mHasTo;               ///< A next keyframe exists
+      };
+
+
+      /**
+       * @brief Searches the next keyframe of a channel
+       *
+       * @param[in]  aChannel       Channel
+       */
+      void advance(int aChannel);
+
+
+      /**
+       * @brief Releases pages no channel will read again
+       */
+      void release();
+
+
+      /**
+       * @brief Thread function of the player thread
+       *
+       * @param[in]  aFrequency     PWM frequency (Hz)
+       */
+      void run(float aFrequency);
+
+
+      PCA9685& mrDriver;            ///< Driver receiving the sequence
+      int mFile;                    ///< File descriptor of the keyframe file
+      void* mpMap;                  ///< Mapped keyframe file
+      size_t mMapSize;              ///< Size of the mapping (bytes)
+      const SequenceKeyframe* mpKeyframes;   ///< First keyframe
+      uint64_t mCount;              ///< Number of keyframes
+      uint64_t mDuration;           ///< Time of the last keyframe (us)
+      uint16_t mChannelMask;        ///< Channels used by any keyframe
+      size_t mReleased;             ///< Released bytes at the mapping start
+
+      Track mTracks[PCA9685_CHANNEL_COUNT];       ///< Playback state per channel
+      uint16_t mOnValues[PCA9685_CHANNEL_COUNT];  ///< PWM ON values of a frame (always `0`)
+      uint16_t mOffValues[PCA9685_CHANNEL_COUNT]; ///< PWM OFF values of a frame
+      uint16_t mWritten[PCA9685_CHANNEL_COUNT];   ///< Last written PWM OFF values
+      uint16_t mWrittenMask;        ///< Channels with a valid written value
+
+      std::thread mThread;          ///< Player thread
+      std::atomic<bool> mRunning;   ///< Player thread is running
+      std::atomic<bool> mLoop;      ///< Restart at the sequence end
+      std::atomic<double> mTimeScale;        ///< Sequence time per real time
+      std::atomic<uint64_t> mPosition;       ///< Current sequence time (us)
+      ErrorCallback mErrorCallback; ///< Callback for write errors
+      DriverClock* mpClock;         ///< Clock for the sequence time and the frame pacing
+
+      std::atomic<uint64_t> mFrames;         ///< Played frames
+      std::atomic<uint64_t> mBatches;        ///< Batched writes
+      std::atomic<uint64_t> mLoops;          ///< Restarts at the sequence end
+      std::atomic<uint64_t> mLateFrames;     ///< Late frames
+      std::atomic<uint64_t> mErrors;         ///< Failed writes
+   }; // class SequencePlayer
+} // namespace CAR4TEGRA
+
+#endif // SEQUENCEPLAYER_H
@@ -0,0 +1,263 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file setpointlistener.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class SetpointListener at namespace CAR4TEGRA
+ *
+ * @details
+ * The SetpointListener class receives channel setpoints as fixed-layout binary UDP packets
+ * and forwards them to a PCA9685 device with batched writes.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SETPOINTLISTENER_H
+#define SETPOINTLISTENER_H
+
+
+// std includes
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+
+
+#define SETPOINT_PACKET_MAGIC       0x53543443u    ///< Packet magic "C4TS" (little endian)
+#define SETPOINT_PACKET_SIZE        52             ///< Size of a setpoint packet (bytes)
+#define SETPOINT_PORT_DEFAULT       9685           ///< Default UDP port
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief Setpoint packet, all fields little endian, no padding
+    *
+    * Only the channels selected by the mask are written, with PWM ON = 0 and PWM OFF = value.
+    */
+   struct SetpointPacket
+   {
+      uint32_t mMagic;              ///< SETPOINT_PACKET_MAGIC
+      uint32_t mSequence;           ///< Sequence number, increased by one per packet
+      uint64_t mTimestampNs;        ///< Send time (CLOCK_REALTIME, ns)
+      uint16_t mChannelMask;        ///< Bit n selects channel n
+      uint16_t mReserved;           ///< Reserved, has to be `0`
+      uint16_t mValues[PCA9685_CHANNEL_COUNT];   ///< PWM values (0 - 4095)
+   } __attribute__((packed));
+
+
+   /**
+    * @class SetpointListener setpointlistener.hpp "include/setpointlistener.hpp"
+    * @brief The SetpointListener class forwards UDP setpoint packets to a PCA9685 device
+    *
+    * Packets are received in batches with `recvmmsg` into preallocated buffers and decoded
+    * without allocation. Stale, out-of-order and malformed packets are dropped. All packets
+    * of one batch are merged per channel (newest value wins) and written in one batch.
+    */
+   class SetpointListener
+   {
+   public:
+      /**
+       * @brief Listener statistics
+       */
+      struct Statistics
+      {
+         uint64_t mReceived;        ///< Received datagrams
+         uint64_t mAccepted;        ///< Accepted packets
+         uint64_t mMalformed;       ///< Dropped: wrong size, magic or channel values
+         uint64_t mStale;           ///< Dropped: older than the maximum age
+         uint64_t mOutOfOrder;      ///< Dropped: sequence not newer than the last accepted one
+         uint64_t mBatches;         ///< Batched writes to the device
+         uint64_t mErrors;          ///< Failed writes
+         double mMaxLatencyUs;      ///< Worst time from kernel receive to finished write (us)
+         double mMeanLatencyUs;     ///< Mean time from kernel receive to finished write (us)
+      };
+
+
+      /// Callback for receive and write errors (called from the listener thread)
+      typedef std::function<void(const std::string& acrMessage)> ErrorCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arDriver       Driver receiving the setpoints (has to outlive the listener)
+       */
+      explicit SetpointListener(PCA9685& arDriver);
+
+
+      /**
+       * @brief Destructor, stops the listener thread and closes the socket
+       */
+      ~SetpointListener();
+
+
+      /**
+       * @brief Opens the UDP socket
+       *
+       * @param[in]  aPort          UDP port
+       * @param[in]  acrAddress     Local address to bind to (default: loopback only)
+       */
+      void open(uint16_t aPort = SETPOINT_PORT_DEFAULT, const std::string& acrAddress = "127.0.0.1");
+
+
+      /**
+       * @brief Closes the UDP socket
+       */
+      void close();
+
+
+      /**
+       * @brief Returns the bound UDP port (e.g. after opening port `0`)
+       *
+       * @return Port
+       */
+      uint16_t port() const;
+
+
+      /**
+       * @brief Sets the maximum age of a packet (only while stopped)
+       *
+       * @param[in]  aMaxAgeUs      Maximum time from send to receive (us, `0`: no check)
+       */
+      void setMaxAge(uint64_t aMaxAgeUs);
+
+
+      /**
+       * @brief Starts the listener thread
+       */
+      void start();
+
+
+      /**
+       * @brief Stops the listener thread
+       */
+      void stop();
+
+
+      /**
+       * @brief Receives and forwards one batch of packets in the calling thread
+       *
+       * @param[in]  aTimeoutMs     Maximum time to wait for the first packet (ms)
+       *
+       * @return Number of accepted packets
+       */
+      int poll(int aTimeoutMs);
+
+
+      /**
+       * @brief Returns the listener statistics (thread-safe)
+       *
+       * @return Statistics
+       */
+      Statistics statistics();
+
+
+      /**
+       * @brief Sets the callback for receive and write errors (only while stopped)
+       *
+       * @param[in]  aCallback      Error callback
+       */
+      void setErrorCallback(ErrorCallback aCallback);
+
+
+      /**
+       * @brief Encodes a setpoint packet (for senders)
+       *
+       * @param[in]  aSequence      Sequence number
+       * @param[in]  aTimestampNs   Send time (CLOCK_REALTIME, ns)
+       * @param[in]  aChannelMask   Bit n selects channel n
+       * @param[in]  apValues       PWM values, indexed by channel
+       * @param[out] apBuffer       Buffer of SETPOINT_PACKET_SIZE bytes
+       */
+      static void encode(uint32_t aSequence, uint64_t aTimestampNs, uint16_t aChannelMask,
+                         const uint16_t* apValues, uint8_t* apBuffer);
+
+
+   private:
+      static const int BATCH_SIZE = 64;     ///< Datagrams received with one system call
+
+      /**
+       * @brief Result of decoding a datagram
+       */
+      enum DecodeResult
+      {
+         DECODE_ACCEPTED,           ///< Packet is valid and newer than the last one
+         DECODE_MALFORMED,          ///< Wrong size, magic or channel values
+         DECODE_STALE,              ///< Older than the maximum age
+         DECODE_OUT_OF_ORDER        ///< Sequence not newer than the last accepted one
+      };
+
+
+      /**
+       * @brief Decodes and checks one datagram
+       *
+       * @param[in]  apData         Datagram
+       * @param[in]  aLength        Datagram length
+       * @param[in]  aReceiveNs     Kernel receive time (CLOCK_REALTIME, ns)
+       * @param[out] arPacket       Decoded packet
+       *
+       * @return Decode result
+       */
+      DecodeResult decode(const uint8_t* apData, size_t aLength, uint64_t aReceiveNs, SetpointPacket& arPacket);
+
+
+      /**
+       * @brief Thread function, forwards packets until stopped
+       */
+      void run();
+
+
+   private:
+      PCA9685& mrDriver;            ///< Driver receiving the setpoints
+      int mSocket;                  ///< UDP socket
+      uint16_t mPort;               ///< Bound UDP port
+      uint64_t mMaxAgeNs;           ///< Maximum packet age (ns, `0`: no check)
+      bool mHaveSequence;           ///< A packet was accepted before
+      uint32_t mLastSequence;       ///< Sequence of the last accepted packet
+      uint64_t mLastAcceptNs;       ///< Receive time of the last accepted packet
+      std::thread mThread;          ///< Listener thread
+      std::atomic<bool> mRunning;   ///< Listener thread is running
+      ErrorCallback mErrorCallback; ///< Callback for errors
+      std::mutex mStatisticsMutex;  ///< Protects the statistics
+      Statistics mStatistics;       ///< Listener statistics
+      double mLatencySumUs;         ///< Sum of all write latencies (us)
+
+      uint8_t mBuffers[BATCH_SIZE][SETPOINT_PACKET_SIZE + 1];  ///< Datagram buffers (one spare byte detects oversize)
+      uint8_t mControl[BATCH_SIZE][64];                        ///< Control message buffers (receive timestamps)
+      struct iovec mVectors[BATCH_SIZE];                       ///< I/O vectors of the datagram buffers
+      struct mmsghdr mMessages[BATCH_SIZE];                    ///< Message headers for recvmmsg
+   }; // class SetpointListener
+} // namespace CAR4TEGRA
+
+#endif // SETPOINTLISTENER_H
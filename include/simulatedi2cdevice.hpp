@@ -0,0 +1,223 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file simulatedi2cdevice.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class SimulatedI2cDevice at namespace CAR4TEGRA
+ *
+ * @details
+ * The SimulatedI2cDevice class replaces the I2C bus by an in-memory model of the PCA9685
+ * register file. It is used to replay traces, to generate load and to test driver code
+ * without hardware.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SIMULATEDI2CDEVICE_H
+#define SIMULATEDI2CDEVICE_H
+
+
+// std includes
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Car4Tegra includes
+#include "include/driverclock.hpp"
+#include "include/i2cdevice.hpp"
+#include "include/pca9685defines.hpp"
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class SimulatedI2cDevice simulatedi2cdevice.hpp "include/simulatedi2cdevice.hpp"
+    * @brief The SimulatedI2cDevice class simulates a PCA9685 device behind the I2cDevice interface
+    *
+    * The model covers register auto-increment, the ALL_LED registers, the write protection of
+    * PRE_SCALE while not sleeping and the self-clearing RESTART bit. Bus errors and power
+    * cycles can be injected. With setBusTiming() the transactions take the time of a real bus.
+    */
+   class SimulatedI2cDevice : public I2cDevice
+   {
+   public:
+      /**
+       * @brief Transfer statistics
+       */
+      struct Statistics
+      {
+         uint64_t mTransactions;    ///< Number of bus transactions
+         uint64_t mBytes;           ///< Number of bytes on the bus (without START / STOP)
+         uint64_t mErrors;          ///< Number of injected errors
+         double mBusyUs;            ///< Bus time of the transactions (us, only with bus timing)
+      };
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      SimulatedI2cDevice();
+
+
+      /**
+       * @brief Destructor
+       */
+      ~SimulatedI2cDevice();
+
+
+      /** @{ @name Simulation functions */
+
+      /**
+       * @brief Sets all registers to their power-on values (simulates a brownout)
+       */
+      void powerCycle();
+
+
+      /**
+       * @brief Lets the next transactions fail
+       *
+       * @param[in]  aCount         Number of failing transactions
+       * @param[in]  aErrno         errno of the failing transactions (e.g. EREMOTEIO)
+       */
+      void injectErrors(int aCount, int aErrno);
+
+
+      /**
+       * @brief Lets every transaction occupy the bus for the time it takes on a real bus
+       *
+       * All simulated devices opened on the same bus name share one bus, a transaction waits
+       * until the bus is free and then for its transfer time (overhead, 9 bits per byte,
+       * START and STOP at the bus clock). Set before opening the device.
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz, `0`: transactions take no time)
+       * @param[in]  aOverheadUs    Fixed cost of one transaction (us)
+       * @param[in]  arClock        Clock used to wait (has to outlive the device)
+       */
+      void setBusTiming(uint32_t aBusClock, double aOverheadUs, DriverClock& arClock = DriverClock::monotonic());
+
+
+      /**
+       * @brief Returns the value of a register without a bus transaction
+       *
+       * @param[in]  aRegister      Register address
+       *
+       * @return Register value
+       */
+      int peekRegister(int aRegister);
+
+
+      /**
+       * @brief Returns the transfer statistics
+       *
+       * @return Statistics
+       */
+      Statistics statistics();
+
+      /** @} */
+
+
+   protected:
+      /** @{ @name Bus access functions */
+
+      int busOpen(const std::string& acrBusName) override;
+      int busClose(int aBus) override;
+      int busSelect(int aBus, int aAddress) override;
+      int busReadByte(int aBus, int aRegister) override;
+      int busWriteByte(int aBus, int aRegister, int aValue) override;
+      int busTransfer(int aBus, struct i2c_msg* apMsgs, int aCount) override;
+
+      /** @} */
+
+
+   private:
+      struct BusTimeline;
+
+
+      /**
+       * @brief Returns the timeline shared by the simulated devices of a bus
+       *
+       * @param[in]  acrBusName     Name of the bus
+       *
+       * @return Bus timeline (valid until the end of the process)
+       */
+      static BusTimeline& timeline(const std::string& acrBusName);
+
+
+      /**
+       * @brief Checks for an injected error, counts the transaction and waits for its bus time
+       *
+       * @param[in]  aBytes         Number of bytes of the transaction
+       *
+       * @return `true` if the transaction has to fail
+       */
+      bool beginTransaction(size_t aBytes);
+
+
+      /**
+       * @brief Writes a register with the device semantics
+       *
+       * @param[in]  aRegister      Register address
+       * @param[in]  aValue         Value
+       */
+      void store(int aRegister, uint8_t aValue);
+
+
+      /**
+       * @brief Reads a register with the device semantics
+       *
+       * @param[in]  aRegister      Register address
+       *
+       * @return Value
+       */
+      uint8_t load(int aRegister) const;
+
+
+      /**
+       * @brief Returns the register following a register with auto-increment
+       *
+       * @param[in]  aRegister      Register address
+       *
+       * @return Next register address
+       */
+      int nextRegister(int aRegister) const;
+
+
+   private:
+      std::mutex mMutex;            ///< Protects the register file
+      std::array<uint8_t, PCA9685_REG_COUNT> mRegisters;   ///< Register file
+      int mAddress;                 ///< Selected slave address (7 bit)
+      int mErrorCount;              ///< Number of transactions still to fail
+      int mErrno;                   ///< errno of failing transactions
+      Statistics mStatistics;       ///< Transfer statistics
+      uint32_t mBusClock;           ///< Simulated bus clock (Hz, `0`: no bus timing)
+      double mOverheadUs;           ///< Fixed cost of one transaction (us)
+      DriverClock* mpClock;         ///< Clock used to wait for the bus
+      BusTimeline* mpTimeline;      ///< Timeline of the opened bus
+   }; // class SimulatedI2cDevice
+} // namespace CAR4TEGRA
+
+#endif // SIMULATEDI2CDEVICE_H
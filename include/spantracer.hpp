@@ -0,0 +1,184 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file spantracer.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class SpanTracer at namespace CAR4TEGRA
+ *
+ * @details
+ * The SpanTracer class records timed spans (e.g. GUI event, driver call, bus lock wait, I2C
+ * syscall) into one lock-free ring buffer per thread and exports them as Chrome / Perfetto
+ * trace JSON. Spans are placed with the C4T_TRACE_SPAN macros, which compile to nothing
+ * unless C4T_SPAN_TRACING is defined (qmake: `CONFIG += span_tracing`).
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef SPANTRACER_H
+#define SPANTRACER_H
+
+
+// std includes
+#include <time.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+#define SPAN_RING_CAPACITY          8192     ///< Spans kept per thread (power of two, oldest are overwritten)
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class SpanTracer spantracer.hpp "include/spantracer.hpp"
+    * @brief The SpanTracer class records spans per thread and exports them as Chrome trace
+    *
+    * Every thread writes into its own ring buffer (single writer, no locks), the buffer is
+    * allocated on the first span of a thread. At thread exit the buffer is handed to the next
+    * new thread, so restarting threads do not add memory; the spans of the finished thread stay
+    * exportable until the new owner overwrites them. Category and name have to be string
+    * literals (only the pointers are stored).
+    */
+   class SpanTracer
+   {
+   public:
+      /**
+       * @brief Returns the current time of the span clock (CLOCK_MONOTONIC)
+       *
+       * @return Time (ns)
+       */
+      static uint64_t now()
+      {
+         struct timespec lTime;
+         clock_gettime(CLOCK_MONOTONIC, &lTime);
+         return static_cast<uint64_t>(lTime.tv_sec) * 1000000000ull + static_cast<uint64_t>(lTime.tv_nsec);
+      }
+
+
+      /**
+       * @brief Records a finished span into the ring buffer of the calling thread
+       *
+       * @param[in]  apCategory     Category (string literal, e.g. "queue", "syscall")
+       * @param[in]  apName         Name (string literal)
+       * @param[in]  aStartNs       Start time (ns, see now())
+       * @param[in]  aEndNs         End time (ns, see now())
+       * @param[in]  aBytes         Bytes transferred on the bus (`0`: no bus transfer)
+       */
+      static void record(const char* apCategory, const char* apName, uint64_t aStartNs, uint64_t aEndNs,
+                         uint32_t aBytes = 0);
+
+
+      /**
+       * @brief Names the calling thread in the exported trace
+       *
+       * @param[in]  acrName        Thread name
+       */
+      static void setThreadName(const std::string& acrName);
+
+
+      /**
+       * @brief Writes the recorded spans of all threads as Chrome / Perfetto trace JSON
+       *
+       * Spans with bus transfers get the estimated bus time (`bus_us`) as argument, the rest of
+       * the span is syscall and driver overhead.
+       *
+       * @param[in]  acrFileName    Name of the JSON file
+       * @param[in]  aBusClock      I2C bus clock used for the bus time estimation (Hz)
+       *
+       * @return Number of spans written
+       */
+      static size_t exportChrome(const std::string& acrFileName, uint32_t aBusClock = 100000);
+
+
+      /**
+       * @brief Drops the recorded spans of all threads
+       */
+      static void clear();
+   }; // class SpanTracer
+
+
+   /**
+    * @class SpanScope spantracer.hpp "include/spantracer.hpp"
+    * @brief The SpanScope class records a span from its construction to its destruction
+    */
+   class SpanScope
+   {
+   public:
+      /**
+       * @brief Constructor, starts the span
+       *
+       * @param[in]  apCategory     Category (string literal)
+       * @param[in]  apName         Name (string literal)
+       * @param[in]  aBytes         Bytes transferred on the bus (`0`: no bus transfer)
+       */
+      SpanScope(const char* apCategory, const char* apName, uint32_t aBytes = 0)
+         : mpCategory(apCategory), mpName(apName), mBytes(aBytes), mStartNs(SpanTracer::now())
+      {
+      }
+
+
+      /**
+       * @brief Destructor, records the span
+       */
+      ~SpanScope()
+      {
+         SpanTracer::record(mpCategory, mpName, mStartNs, SpanTracer::now(), mBytes);
+      }
+
+
+      SpanScope(const SpanScope&) = delete;
+      SpanScope& operator=(const SpanScope&) = delete;
+
+
+   private:
+      const char* mpCategory;    ///< Category of the span
+      const char* mpName;        ///< Name of the span
+      uint32_t mBytes;           ///< Bytes transferred on the bus
+      uint64_t mStartNs;         ///< Start time (ns)
+   }; // class SpanScope
+} // namespace CAR4TEGRA
+
+
+#define C4T_TRACE_CONCAT_(a, b)      a##b
+#define C4T_TRACE_CONCAT(a, b)       C4T_TRACE_CONCAT_(a, b)
+
+#ifdef C4T_SPAN_TRACING
+/// Records a span until the end of the enclosing scope
+#define C4T_TRACE_SPAN(category, name) \
+   CAR4TEGRA::SpanScope C4T_TRACE_CONCAT(lSpan, __LINE__)(category, name)
+/// Records a span with a bus transfer of the given size until the end of the enclosing scope
+#define C4T_TRACE_SPAN_BYTES(category, name, bytes) \
+   CAR4TEGRA::SpanScope C4T_TRACE_CONCAT(lSpan, __LINE__)(category, name, static_cast<uint32_t>(bytes))
+/// Names the calling thread in the exported trace
+#define C4T_TRACE_THREAD(name)       CAR4TEGRA::SpanTracer::setThreadName(name)
+#else
+#define C4T_TRACE_SPAN(category, name)
+#define C4T_TRACE_SPAN_BYTES(category, name, bytes)
+#define C4T_TRACE_THREAD(name)
+#endif
+
+#endif // SPANTRACER_H
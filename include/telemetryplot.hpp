@@ -0,0 +1,176 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file telemetryplot.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class TelemetryPlot
+ *
+ * @details
+ * The TelemetryPlot widget plots the commanded PWM value, the write latency and the write
+ * errors of the PWM channels over time. Samples are aggregated into fixed time columns when
+ * they are added, so painting costs the same whatever the sample rate.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef TELEMETRYPLOT_H
+#define TELEMETRYPLOT_H
+
+
+// QT includes
+#include <QPaintEvent>
+#include <QPolygonF>
+#include <QTimer>
+#include <QWidget>
+
+// std includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+#define TELEMETRY_CHANNELS          16       ///< Number of plotted channels
+#define TELEMETRY_COLUMNS           512      ///< Time columns kept per channel (history resolution)
+#define TELEMETRY_REFRESH_MS        33       ///< Repaint interval (ms)
+
+
+/**
+ * @class TelemetryPlot telemetryplot.hpp "include/telemetryplot.hpp"
+ * @brief The TelemetryPlot class is a custom-painted live plot of the channel outputs
+ *
+ * Each channel keeps a ring of TELEMETRY_COLUMNS time columns covering the plot window. A
+ * sample only updates the min / max / last value, the worst latency and the error count of the
+ * current column (min/max downsampling at insertion). Painting maps the columns to the widget
+ * width, so the drawing cost is bounded by channels * columns.
+ */
+class TelemetryPlot : public QWidget
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Constructor
+    *
+    * @param[in]  apParent       QT parent
+    */
+   explicit TelemetryPlot(QWidget* apParent = 0);
+
+
+   /**
+    * @brief Adds a sample of a channel (thread-safe)
+    *
+    * @param[in]  aChannel       Channel (0 - TELEMETRY_CHANNELS - 1)
+    * @param[in]  aValue         Commanded PWM value (0 - 4095)
+    * @param[in]  aLatencyUs     Write latency (us)
+    * @param[in]  aError         The write failed
+    */
+   void addSample(int aChannel, int aValue, double aLatencyUs, bool aError);
+
+
+   /**
+    * @brief Sets the visible time span, clears the history
+    *
+    * @param[in]  aWindowMs      Time span (ms)
+    */
+   void setWindow(int aWindowMs);
+
+
+   /**
+    * @brief Shows or hides a channel
+    *
+    * @param[in]  aChannel       Channel (0 - TELEMETRY_CHANNELS - 1)
+    * @param[in]  aVisible       Show the channel
+    */
+   void setChannelVisible(int aChannel, bool aVisible);
+
+
+   /**
+    * @brief Drops the history of all channels
+    */
+   void clear();
+
+
+protected:
+   /**
+    * @brief Paints the PWM, latency and error lanes
+    *
+    * @param[in]  apEvent        Paint event
+    */
+   void paintEvent(QPaintEvent* apEvent) override;
+
+
+private slots:
+   /**
+    * @brief Schedules a repaint if the plot changed
+    */
+   void refresh();
+
+
+private:
+   typedef std::chrono::steady_clock Clock;  ///< Clock for the time columns
+
+   /**
+    * @brief Aggregated samples of one time column
+    */
+   struct Column
+   {
+      int64_t mIndex;               ///< Column number since the plot start (`-1`: empty)
+      uint16_t mMin;                ///< Minimum PWM value
+      uint16_t mMax;                ///< Maximum PWM value
+      uint16_t mLast;               ///< Last PWM value
+      uint16_t mErrors;             ///< Number of failed writes
+      float mMaxLatencyUs;          ///< Worst write latency (us)
+   };
+
+   /// Column ring of one channel
+   typedef std::array<Column, TELEMETRY_COLUMNS> ColumnRing;
+
+
+   /**
+    * @brief Returns the column number of the current time
+    *
+    * @return Column number since the plot start
+    */
+   int64_t currentColumn() const;
+
+
+private:
+   std::mutex mMutex;                     ///< Protects the column rings and the settings
+   std::vector<ColumnRing> mChannels;     ///< Column rings of the producer side
+   std::vector<ColumnRing> mPaintBuffer;  ///< Column rings copied for painting
+   std::array<bool, TELEMETRY_CHANNELS> mVisible;    ///< Visible channels
+   Clock::time_point mStart;              ///< Start of column 0
+   Clock::duration mColumnDuration;       ///< Time span of one column
+   int64_t mLastColumn;                   ///< Newest column with a sample
+   std::atomic<bool> mChanged;            ///< A sample arrived since the last repaint
+   QTimer mTimer;                         ///< Repaint timer
+   QPolygonF mLine;                       ///< Scratch polyline for painting
+}; // class TelemetryPlot
+
+#endif // TELEMETRYPLOT_H
@@ -0,0 +1,268 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file tracerecorder.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of the classes TraceRecorder and TraceReader
+ *        at namespace CAR4TEGRA
+ *
+ * @details
+ * The TraceRecorder class appends every I2C transaction to a memory-mapped binary trace file.
+ * The TraceReader class reads such a file back, e.g. for replaying it against a bus.
+ *
+ * File layout: one 64 byte header followed by 32 byte slots. A transaction takes one record
+ * slot holding the first 10 payload bytes, longer payloads continue in raw 32 byte slots.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+
+// std includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief One recorded I2C transaction (first slot)
+    */
+   struct TraceRecord
+   {
+      uint64_t mTimestampNs;        ///< CLOCK_MONOTONIC time after the transaction (ns)
+      uint32_t mSequence;           ///< Slot index of the record
+      uint8_t mBus;                 ///< I2C bus number
+      uint8_t mAddress;             ///< Device address (8 bit format)
+      uint8_t mRegister;            ///< First register
+      uint8_t mOperation;           ///< Operation (see TraceRecorder::Operation)
+      int16_t mResult;              ///< Result of the bus access
+      int16_t mErrno;               ///< errno after the bus access (`0` on success)
+      uint16_t mLength;             ///< Payload length
+      uint8_t mPayload[10];         ///< First payload bytes
+   };
+
+
+   /**
+    * @class TraceRecorder tracerecorder.hpp "include/tracerecorder.hpp"
+    * @brief The TraceRecorder class appends I2C transactions to a memory-mapped trace file
+    *
+    * record() is lock-free and can be called from several threads. The file is preallocated
+    * with a fixed capacity, transactions which do not fit anymore are counted as dropped.
+    */
+   class TraceRecorder
+   {
+   public:
+      /**
+       * @brief Recorded operations
+       */
+      enum Operation
+      {
+         OP_READ_BYTE = 1,          ///< Single register read
+         OP_WRITE_BYTE = 2,         ///< Single register write
+         OP_READ_BLOCK = 3,         ///< Auto-increment block read
+         OP_WRITE_BLOCK = 4         ///< Auto-increment block write
+      };
+
+
+      /**
+       * @brief Standard constructor with no input
+       */
+      TraceRecorder();
+
+
+      /**
+       * @brief Destructor, closes the trace file
+       */
+      ~TraceRecorder();
+
+
+      /**
+       * @brief Creates a trace file (an existing file is overwritten)
+       *
+       * @param[in]  acrFileName    Name of the trace file
+       * @param[in]  aCapacity      Maximum size of the trace file (bytes)
+       */
+      void open(const std::string& acrFileName, size_t aCapacity = 64 * 1024 * 1024);
+
+
+      /**
+       * @brief Closes the trace file and truncates it to the recorded size
+       */
+      void close();
+
+
+      /**
+       * @brief Returns if a trace file is open
+       *
+       * @return `true` if open, `false` otherwise
+       */
+      bool isOpen() const;
+
+
+      /**
+       * @brief Appends a transaction (lock-free)
+       *
+       * @param[in]  aBus           I2C bus number
+       * @param[in]  aAddress       Device address (8 bit format)
+       * @param[in]  aRegister      First register
+       * @param[in]  aOperation     Operation
+       * @param[in]  apData         Payload
+       * @param[in]  aLength        Payload length
+       * @param[in]  aResult        Result of the bus access
+       * @param[in]  aErrno         errno after the bus access
+       */
+      void record(int aBus, int aAddress, int aRegister, int aOperation,
+                  const uint8_t* apData, size_t aLength, int aResult, int aErrno);
+
+
+      /**
+       * @brief Returns the number of used slots
+       *
+       * @return Used slots
+       */
+      uint64_t slots() const;
+
+
+      /**
+       * @brief Returns the number of transactions dropped because the file was full
+       *
+       * @return Dropped transactions
+       */
+      uint64_t dropped() const;
+
+
+      /**
+       * @brief Trace file header
+       */
+      struct Header
+      {
+         char mMagic[8];            ///< File magic "C4TTRACE"
+         uint32_t mVersion;         ///< File format version
+         uint32_t mSlotSize;        ///< Size of one slot (bytes)
+         uint64_t mCapacity;        ///< Number of slots
+         std::atomic<uint64_t> mNext;      ///< Next free slot
+         std::atomic<uint64_t> mDropped;   ///< Dropped transactions
+         uint64_t mStartMonotonicNs;       ///< CLOCK_MONOTONIC time of file creation (ns)
+         uint64_t mStartRealtimeNs;        ///< CLOCK_REALTIME time of file creation (ns)
+         uint64_t mReserved;        ///< Reserved
+      };
+
+
+   private:
+      int mFile;                    ///< File descriptor of the trace file
+      void* mpMap;                  ///< Mapped trace file
+      size_t mMapSize;              ///< Size of the mapping (bytes)
+      Header* mpHeader;             ///< File header
+      uint8_t* mpSlots;             ///< First slot
+   }; // class TraceRecorder
+
+
+   /**
+    * @class TraceReader tracerecorder.hpp "include/tracerecorder.hpp"
+    * @brief The TraceReader class reads the transactions of a trace file in order
+    */
+   class TraceReader
+   {
+   public:
+      /**
+       * @brief Standard constructor with no input
+       */
+      TraceReader();
+
+
+      /**
+       * @brief Destructor, closes the trace file
+       */
+      ~TraceReader();
+
+
+      /**
+       * @brief Opens a trace file
+       *
+       * @param[in]  acrFileName    Name of the trace file
+       */
+      void open(const std::string& acrFileName);
+
+
+      /**
+       * @brief Closes the trace file
+       */
+      void close();
+
+
+      /**
+       * @brief Reads the next transaction
+       *
+       * Incomplete records are skipped together with their payload slots, a slot is only taken
+       * as a record if it carries its own slot index (TraceRecord::mSequence).
+       *
+       * @param[out] arRecord       Record of the transaction
+       * @param[out] apPayload      Complete payload (at least 256 bytes)
+       *
+       * @return `true` if a transaction was read, `false` at the end of the trace
+       */
+      bool next(TraceRecord& arRecord, uint8_t* apPayload);
+
+
+      /**
+       * @brief Restarts reading at the first transaction
+       */
+      void rewind();
+
+
+      /**
+       * @brief Returns the CLOCK_MONOTONIC time of file creation
+       *
+       * @return Time (ns)
+       */
+      uint64_t startTime() const;
+
+
+      /**
+       * @brief Returns the number of transactions dropped while recording
+       *
+       * @return Dropped transactions
+       */
+      uint64_t dropped() const;
+
+
+   private:
+      int mFile;                    ///< File descriptor of the trace file
+      void* mpMap;                  ///< Mapped trace file
+      size_t mMapSize;              ///< Size of the mapping (bytes)
+      const TraceRecorder::Header* mpHeader;    ///< File header
+      const uint8_t* mpSlots;       ///< First slot
+      uint64_t mSlots;              ///< Number of valid slots
+      uint64_t mPosition;           ///< Next slot to read
+   }; // class TraceReader
+} // namespace CAR4TEGRA
+
+#endif // TRACERECORDER_H
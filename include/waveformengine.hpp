@@ -0,0 +1,357 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file waveformengine.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class WaveformEngine at namespace CAR4TEGRA
+ *
+ * @details
+ * The WaveformEngine class synthesizes the 16 PWM outputs of a PCA9685 from a timestamped
+ * stream of register writes with the resolution of the PWM counter (25 MHz / (prescale + 1))
+ * and analyzes them for period, duty, runt pulses, glitches, double pulses and the latency
+ * from a register write to the first edge with the new setting. It validates driver write
+ * strategies offline, without a logic analyzer.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef WAVEFORMENGINE_H
+#define WAVEFORMENGINE_H
+
+
+// std includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Car4Tegra includes
+#include "include/pca9685defines.hpp"
+
+
+#define WAVEFORM_OSCILLATOR_HZ 25000000     ///< Internal oscillator of the PCA9685 (Hz)
+#define WAVEFORM_CYCLE_TICKS 4096           ///< Counter ticks of one PWM cycle
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @class WaveformEngine waveformengine.hpp "include/waveformengine.hpp"
+    * @brief The WaveformEngine class synthesizes and analyzes the PWM outputs of a register write stream
+    *
+    * Writes are I2C write transactions with auto-increment, the outputs see the new register
+    * values at the STOP condition (MODE2 OCH = 0). Depending on the latch mode the counters
+    * compare against them immediately or from the next PWM cycle on. An output goes high when
+    * the counter matches ON and low when it matches OFF, FULL_ON and FULL_OFF force the level.
+    * So a moved ON or OFF value the counter already passed takes effect in the next cycle only.
+    * Writes to MODE1 and PRE_SCALE are not modelled, the prescale is fixed per engine.
+    *
+    * The waveforms are kept as edges: each segment of a cycle with constant settings is
+    * evaluated for all 16 channels at once with vector instructions. Runs of cycles without
+    * register changes are accounted in one step, so millions of cycles take milliseconds.
+    *
+    * Pulse classification (rising to falling edge):
+    * - runt: the pulse was cut by a setting change and is shorter than both settings
+    * - glitch: the pulse matches neither setting it was produced by, or its setting was
+    *   overwritten within the transient window (partial update of the LEDn registers)
+    * - double pulse: a second rising edge within one PWM cycle
+    */
+   class WaveformEngine
+   {
+   public:
+      /**
+       * @brief Point in time when the counters compare against new register values
+       */
+      enum LatchMode
+      {
+         LATCH_IMMEDIATE,           ///< At the next counter tick after the write
+         LATCH_CYCLE                ///< At the start of the next PWM cycle
+      };
+
+
+      /**
+       * @brief Analysis of one output
+       */
+      struct ChannelAnalysis
+      {
+         uint64_t mPulses;          ///< Number of complete pulses
+         uint64_t mUpdates;         ///< Number of register setting changes
+         uint64_t mRunts;           ///< Number of runt pulses
+         uint64_t mGlitches;        ///< Number of glitch pulses
+         uint64_t mDoublePulses;    ///< Number of cycles with a second rising edge
+         double mPeriodMinUs;       ///< Shortest time between two rising edges (us)
+         double mPeriodMaxUs;       ///< Longest time between two rising edges (us)
+         double mPeriodMeanUs;      ///< Mean time between two rising edges (us)
+         double mDutyMin;           ///< Smallest pulse width (fraction of a cycle)
+         double mDutyMax;           ///< Largest pulse width (fraction of a cycle)
+         double mDutyMean;          ///< Mean pulse width (fraction of a cycle)
+         double mLatencyMeanUs;     ///< Mean time from a setting change to its first edge (us)
+         double mLatencyMaxUs;      ///< Worst time from a setting change to its first edge (us)
+      };
+
+
+      /// Callback for every synthesized edge (counter tick since the start)
+      typedef std::function<void(int aChannel, int64_t aTick, bool aRising)> EdgeCallback;
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  aPrescale      Value of the PRE_SCALE register (3 - 255)
+       * @param[in]  aLatch         Latch mode of the output settings
+       * @param[in]  aStartNs       Time of counter tick 0 (same clock as the writes, ns)
+       */
+      WaveformEngine(int aPrescale = 0x1E, LatchMode aLatch = LATCH_CYCLE, uint64_t aStartNs = 0);
+
+
+      /**
+       * @brief Destructor
+       */
+      ~WaveformEngine();
+
+
+      /** @{ @name Setup functions */
+
+      /**
+       * @brief Restarts the synthesis with the power-on register values (all outputs full off)
+       *
+       * @param[in]  aStartNs       Time of counter tick 0 (ns)
+       */
+      void reset(uint64_t aStartNs);
+
+
+      /**
+       * @brief Sets the time within which an overwritten setting counts as partial update
+       *
+       * @param[in]  aWindowUs      Transient window (us, `0`: off)
+       */
+      void setTransientWindow(double aWindowUs);
+
+
+      /**
+       * @brief Sets a callback which receives every edge (disables the accounting of steady runs)
+       *
+       * @param[in]  aCallback      Edge callback (empty: none)
+       */
+      void setEdgeCallback(EdgeCallback aCallback);
+
+      /** @} */
+
+
+      /** @{ @name Synthesis functions */
+
+      /**
+       * @brief Applies a write transaction, the outputs are synthesized up to its time first
+       *
+       * @param[in]  aTimeNs        Time of the STOP condition (ns, not before the previous write)
+       * @param[in]  aRegister      First register
+       * @param[in]  apData         Register values (auto-increment)
+       * @param[in]  aLength        Number of values
+       */
+      void write(uint64_t aTimeNs, int aRegister, const uint8_t* apData, size_t aLength);
+
+
+      /**
+       * @brief Synthesizes the outputs up to a point in time
+       *
+       * @param[in]  aTimeNs        End of the synthesis (ns)
+       */
+      void advance(uint64_t aTimeNs);
+
+      /** @} */
+
+
+      /** @{ @name Status functions */
+
+      /**
+       * @brief Returns the duration of one counter tick
+       *
+       * @return Tick duration (ns)
+       */
+      uint64_t tickNs() const;
+
+
+      /**
+       * @brief Returns the number of synthesized PWM cycles
+       *
+       * @return Number of cycles
+       */
+      uint64_t cycles() const;
+
+
+      /**
+       * @brief Returns the current output levels
+       *
+       * @return Bit n is set if output n is high
+       */
+      uint16_t levels() const;
+
+
+      /**
+       * @brief Returns the analysis of an output
+       *
+       * @param[in]  aChannel       Channel (0 - 15)
+       *
+       * @return Analysis
+       */
+      ChannelAnalysis analysis(int aChannel) const;
+
+      /** @} */
+
+
+   private:
+      /// One 32 bit value per channel
+      typedef int32_t ChannelLanes __attribute__((vector_size(PCA9685_CHANNEL_COUNT * sizeof(int32_t))));
+
+
+      /**
+       * @brief Setting and pulse analysis of one output
+       */
+      struct Output
+      {
+         uint64_t mSerial;          ///< Serial number of the register setting
+         int32_t mWidth;            ///< Pulse width of the register setting (ticks)
+         int64_t mCreated;          ///< Tick of the write which created the register setting
+
+         uint64_t mActiveSerial;    ///< Serial number of the setting the counters compare against
+         int32_t mActiveWidth;      ///< Pulse width of the active setting (ticks)
+         int64_t mActiveCreated;    ///< Tick of the write which created the active setting
+         int64_t mActiveReplaced;   ///< Tick at which the active setting was overwritten (INT64_MAX: not yet)
+         bool mActiveServed;        ///< Active setting produced an edge
+
+         bool mOpen;                ///< Output is high since mLastRise
+         int64_t mLastRise;         ///< Tick of the last rising edge (`-1`: none)
+         uint64_t mRiseSerial;      ///< Active setting at the last rising edge
+         int32_t mRiseWidth;        ///< Pulse width of that setting (ticks)
+
+         uint64_t mPulses;          ///< Number of complete pulses
+         uint64_t mHighTicks;       ///< Sum of the pulse widths (ticks)
+         int64_t mWidthMin;         ///< Smallest pulse width (ticks)
+         int64_t mWidthMax;         ///< Largest pulse width (ticks)
+         uint64_t mPeriods;         ///< Number of measured periods
+         uint64_t mPeriodTicks;     ///< Sum of the periods (ticks)
+         int64_t mPeriodMin;        ///< Shortest period (ticks)
+         int64_t mPeriodMax;        ///< Longest period (ticks)
+         uint64_t mUpdates;         ///< Number of register setting changes
+         uint64_t mRunts;           ///< Number of runt pulses
+         uint64_t mGlitches;        ///< Number of glitch pulses
+         uint64_t mDoublePulses;    ///< Number of double pulses
+         uint64_t mLatencies;       ///< Number of measured latencies
+         int64_t mLatencyTicks;     ///< Sum of the latencies (ticks)
+         int64_t mLatencyMax;       ///< Worst latency (ticks)
+
+         uint64_t mCyclePulses;     ///< Pulses at the start of the current cycle (steady run accounting)
+         uint64_t mCycleHighTicks;  ///< High ticks at the start of the current cycle
+         uint64_t mCyclePeriods;    ///< Periods at the start of the current cycle
+         uint64_t mStepPulses;      ///< Pulses of the last complete cycle
+         uint64_t mStepHighTicks;   ///< High ticks of the last complete cycle
+         uint64_t mStepPeriods;     ///< Periods of the last complete cycle
+      };
+
+
+      /**
+       * @brief Synthesizes the outputs up to a counter tick
+       *
+       * @param[in]  aTick          End tick (exclusive)
+       */
+      void synthesize(int64_t aTick);
+
+
+      /**
+       * @brief Evaluates a part of a cycle with constant settings for all outputs
+       *
+       * @param[in]  aCycleStart    Tick of the cycle start
+       * @param[in]  aFrom          First counter value of the segment (0 - 4095)
+       * @param[in]  aTo            Counter value after the segment (1 - 4096)
+       */
+      void evaluate(int64_t aCycleStart, int32_t aFrom, int32_t aTo);
+
+
+      /**
+       * @brief Accounts a run of cycles identical to the last one
+       *
+       * @param[in]  aCycles        Number of cycles
+       */
+      void repeatCycles(int64_t aCycles);
+
+
+      /**
+       * @brief Lets the counters compare against the register setting of an output
+       *
+       * @param[in]  aChannel       Channel
+       */
+      void latch(int aChannel);
+
+
+      /**
+       * @brief Records an edge of an output
+       *
+       * @param[in]  aChannel       Channel
+       * @param[in]  aTick          Tick of the edge
+       * @param[in]  aRising        Rising or falling edge
+       */
+      void edge(int aChannel, int64_t aTick, bool aRising);
+
+
+      /**
+       * @brief Starts the accounting of a cycle
+       */
+      void beginCycle();
+
+
+      /**
+       * @brief Finishes the accounting of a cycle
+       */
+      void endCycle();
+
+
+   private:
+      uint64_t mTickNs;             ///< Duration of one counter tick (ns)
+      LatchMode mLatch;             ///< Latch mode
+      uint64_t mStartNs;            ///< Time of tick 0 (ns)
+      int64_t mTransientTicks;      ///< Transient window (ticks)
+      EdgeCallback mEdgeCallback;   ///< Edge callback
+      std::array<uint8_t, PCA9685_REG_COUNT> mRegisters;      ///< Register file
+
+      ChannelLanes mBase;           ///< Level of each active setting before its first toggle (`-1`: high)
+      ChannelLanes mFirst;          ///< First toggle of each active setting (4096: none)
+      ChannelLanes mSecond;         ///< Second toggle of each active setting (4096: none)
+      ChannelLanes mLevel;          ///< Current output levels (`-1`: high)
+      ChannelLanes mNextBase;       ///< mBase of the register settings
+      ChannelLanes mNextFirst;      ///< mFirst of the register settings
+      ChannelLanes mNextSecond;     ///< mSecond of the register settings
+
+      std::array<Output, PCA9685_CHANNEL_COUNT> mOutputs;     ///< Per output state
+      uint64_t mNextSerial;         ///< Serial number of the next register setting
+      uint16_t mPending;            ///< Outputs with a register setting not yet latched
+      int64_t mTick;                ///< Synthesized up to this tick (exclusive)
+      uint64_t mCycles;             ///< Number of complete cycles
+      bool mCycleChanged;           ///< A setting changed in the current cycle
+      uint64_t mSteadyCycles;       ///< Number of complete cycles without setting changes in a row
+   }; // class WaveformEngine
+} // namespace CAR4TEGRA
+
+#endif // WAVEFORMENGINE_H
@@ -0,0 +1,170 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file writeplanner.hpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the declaration of class WritePlanner at namespace CAR4TEGRA
+ *
+ * @details
+ * The WritePlanner class computes the cheapest set of I2C write transactions which brings the
+ * LED registers of a PCA9685 device from their last known values to a target image.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+#ifndef WRITEPLANNER_H
+#define WRITEPLANNER_H
+
+
+// std includes
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+// Car4Tegra includes
+#include "include/pca9685defines.hpp"
+
+
+#define WRITE_PLAN_CAPACITY   (4 * PCA9685_CHANNEL_COUNT + 4)   ///< Maximum transactions of a plan
+
+
+namespace CAR4TEGRA
+{
+   /**
+    * @brief Write transactions computed by the WritePlanner
+    *
+    * The data of a transaction starting at register r is found at `mData[r]`.
+    */
+   struct WritePlan
+   {
+      /**
+       * @brief One write transaction
+       */
+      struct Transaction
+      {
+         uint8_t mRegister;         ///< First register
+         uint8_t mLength;           ///< Number of registers (`1` without auto-increment)
+      };
+
+      std::array<Transaction, WRITE_PLAN_CAPACITY> mTransactions;   ///< Transactions in write order
+      size_t mCount;                ///< Number of transactions
+      std::array<uint8_t, PCA9685_REG_COUNT> mData;   ///< Values to write, indexed by register
+      double mCostUs;               ///< Estimated bus time of the plan (us)
+      bool mAllLed;                 ///< The plan starts with an ALL_LED write
+   };
+
+
+   /**
+    * @class WritePlanner writeplanner.hpp "include/writeplanner.hpp"
+    * @brief The WritePlanner class computes cheap write transaction sets for the LED registers
+    *
+    * A transaction costs a fixed overhead (syscall, START, address and register byte, STOP)
+    * plus the time of its data bytes. Dirty runs are merged when the unchanged bytes in between
+    * are cheaper than another transaction header, each gap is decided on its own. The ALL_LED
+    * registers are only written for bytes with the same target on every channel and only if no
+    * LEDn register has to be fixed up afterwards, because the outputs latch on every STOP.
+    *
+    * Planning works on fixed-size arrays and does not allocate.
+    */
+   class WritePlanner
+   {
+   public:
+      typedef std::array<uint8_t, PCA9685_REG_COUNT> RegisterImage;   ///< Values of all registers
+      typedef std::bitset<PCA9685_REG_COUNT> RegisterMask;            ///< One bit per register
+
+
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz)
+       * @param[in]  aOverheadUs    Fixed cost of one transaction (us)
+       */
+      WritePlanner(uint32_t aBusClock = 100000, double aOverheadUs = 30.0);
+
+
+      /**
+       * @brief Sets the bus clock
+       *
+       * @param[in]  aBusClock      I2C bus clock (Hz)
+       */
+      void setBusClock(uint32_t aBusClock);
+
+
+      /**
+       * @brief Sets the fixed cost of one transaction (syscall, driver and start / stop overhead)
+       *
+       * @param[in]  aOverheadUs    Overhead per transaction (us)
+       */
+      void setTransactionOverhead(double aOverheadUs);
+
+
+      /**
+       * @brief Returns the bus time of one write transaction
+       *
+       * @param[in]  aDataBytes     Number of data bytes
+       *
+       * @return Bus time (us)
+       */
+      double transactionCost(size_t aDataBytes) const;
+
+
+      /**
+       * @brief Computes cheap transactions for the LED registers
+       *
+       * Registers outside the target mask keep their values, they are neither written nor
+       * overwritten by ALL_LED writes.
+       *
+       * @param[in]  acrTarget      Target values
+       * @param[in]  acrTargetMask  Registers with a target value
+       * @param[in]  acrDevice      Last known device values
+       * @param[in]  acrKnown       Registers whose device value is known
+       * @param[in]  aAutoIncrement Auto-increment is enabled (block writes possible)
+       * @param[out] arPlan         Computed plan
+       * @param[in]  aAllLedBytes   ALL_LED bytes which may be used (bit n: ALL_LED_ON_L + n)
+       */
+      void plan(const RegisterImage& acrTarget, const RegisterMask& acrTargetMask,
+                const RegisterImage& acrDevice, const RegisterMask& acrKnown,
+                bool aAutoIncrement, WritePlan& arPlan, unsigned aAllLedBytes = 0x0F) const;
+
+
+   private:
+      /**
+       * @brief Appends a transaction to a plan
+       *
+       * @param[in]  arPlan         Plan
+       * @param[in]  aRegister      First register
+       * @param[in]  aLength        Number of registers
+       */
+      void append(WritePlan& arPlan, int aRegister, int aLength) const;
+
+
+      uint32_t mBusClock;           ///< I2C bus clock (Hz)
+      double mOverheadUs;           ///< Fixed cost of one transaction (us)
+   }; // class WritePlanner
+} // namespace CAR4TEGRA
+
+#endif // WRITEPLANNER_H
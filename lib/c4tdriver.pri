@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Links the Car4Tegra driver library (include() from projects using it)
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD/..
+
+LIBS += -L$$shadowed($$PWD) -lc4tdriver -lpthread
+
+c4t_shared {
+    QMAKE_RPATHDIR += $$shadowed($$PWD)
+} else {
+    PRE_TARGETDEPS += $$shadowed($$PWD)/libc4tdriver.a
+}
+
+# span tracing (qmake CONFIG+=span_tracing), compiled out otherwise
+span_tracing: DEFINES += C4T_SPAN_TRACING
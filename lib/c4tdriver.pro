@@ -0,0 +1,77 @@
+#-------------------------------------------------
+#
+# Car4Tegra driver library (no Qt dependency)
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = c4tdriver
+TEMPLATE = lib
+
+CONFIG += c++14
+CONFIG -= qt
+
+# static library by default, shared library with qmake CONFIG+=c4t_shared
+c4t_shared {
+    CONFIG += shared
+} else {
+    CONFIG += staticlib
+}
+
+INCLUDEPATH += ..
+
+# span tracing (qmake CONFIG+=span_tracing), compiled out otherwise
+span_tracing: DEFINES += C4T_SPAN_TRACING
+
+
+SOURCES += \
+    ../source/brokerclient.cpp \
+    ../source/busbroker.cpp \
+    ../source/busexecutor.cpp \
+    ../source/busscheduler.cpp \
+    ../source/c4tdriver.cpp \
+    ../source/calibrationprofile.cpp \
+    ../source/driverclock.cpp \
+    ../source/i2cdevice.cpp \
+    ../source/inputconditioner.cpp \
+    ../source/inputreader.cpp \
+    ../source/outputmixer.cpp \
+    ../source/pca9685.cpp \
+    ../source/profileapplier.cpp \
+    ../source/profilewatcher.cpp \
+    ../source/registerscrubber.cpp \
+    ../source/sequenceplayer.cpp \
+    ../source/setpointlistener.cpp \
+    ../source/simulatedi2cdevice.cpp \
+    ../source/spantracer.cpp \
+    ../source/tracerecorder.cpp \
+    ../source/waveformengine.cpp \
+    ../source/writeplanner.cpp
+
+HEADERS  += \
+    ../include/brokerclient.hpp \
+    ../include/busbroker.hpp \
+    ../include/busexecutor.hpp \
+    ../include/busscheduler.hpp \
+    ../include/c4tdriver.h \
+    ../include/calibrationprofile.hpp \
+    ../include/driverclock.hpp \
+    ../include/i2cdevice.hpp \
+    ../include/inputconditioner.hpp \
+    ../include/inputreader.hpp \
+    ../include/outputmixer.hpp \
+    ../include/pca9685.hpp \
+    ../include/pca9685defines.hpp \
+    ../include/profileapplier.hpp \
+    ../include/profilewatcher.hpp \
+    ../include/registerscrubber.hpp \
+    ../include/sequenceplayer.hpp \
+    ../include/setpointlistener.hpp \
+    ../include/simulatedi2cdevice.hpp \
+    ../include/spantracer.hpp \
+    ../include/tracerecorder.hpp \
+    ../include/waveformengine.hpp \
+    ../include/writeplanner.hpp
+
+LIBS += -lpthread
@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# Links the Car4Tegra script runtime library (include() from projects using it)
+#
+#-------------------------------------------------
+
+CONFIG += c++2a
+
+LIBS += -L$$shadowed($$PWD) -lc4tscript
+
+PRE_TARGETDEPS += $$shadowed($$PWD)/libc4tscript.a
+
+# the script runtime uses the driver library, so it is linked after it
+include(c4tdriver.pri)
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Car4Tegra script runtime library (C++20 coroutines, no Qt dependency)
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = c4tscript
+TEMPLATE = lib
+
+CONFIG += c++2a staticlib
+CONFIG -= qt
+
+INCLUDEPATH += ..
+
+# span tracing (qmake CONFIG+=span_tracing), compiled out otherwise
+span_tracing: DEFINES += C4T_SPAN_TRACING
+
+
+SOURCES += \
+    ../source/scriptbus.cpp \
+    ../source/scriptruntime.cpp
+
+HEADERS  += \
+    ../include/scriptbus.hpp \
+    ../include/scriptruntime.hpp
+
+LIBS += -lpthread
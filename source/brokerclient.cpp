@@ -0,0 +1,435 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file brokerclient.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class BrokerClient at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/brokerclient.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const int REPLY_TIMEOUT_MS = 1000;    ///< Maximum time to wait for an answer of the broker (ms)
+
+
+      /**
+       * @brief Returns an empty message of a type
+       *
+       * @param[in]  aType          Message type
+       * @param[in]  aDevice        Device index
+       *
+       * @return Message
+       */
+      BrokerMessage message(BrokerMessageType aType, int aDevice)
+      {
+         BrokerMessage lMessage;
+         memset(&lMessage, 0, sizeof(lMessage));
+         lMessage.mMagic = BROKER_MESSAGE_MAGIC;
+         lMessage.mType = static_cast<uint16_t>(aType);
+         lMessage.mDevice = static_cast<uint16_t>(aDevice);
+         return lMessage;
+      }
+   } // namespace
+
+
+   BrokerClient::BrokerClient()
+      : mSocket(-1), mClientId(0), mRequest(0)
+   {
+   }
+
+
+   BrokerClient::~BrokerClient()
+   {
+      this->close();
+   }
+
+
+   void BrokerClient::connect(const std::string& acrName, int aPriority, const std::string& acrPath)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->closeSocket();
+
+      struct sockaddr_un lAddress;
+      memset(&lAddress, 0, sizeof(lAddress));
+      lAddress.sun_family = AF_UNIX;
+      if(acrPath.empty() || acrPath.size() >= sizeof(lAddress.sun_path))
+      {
+         throw std::runtime_error("Invalid broker socket path \"" + acrPath + "\"");
+      }
+      memcpy(lAddress.sun_path, acrPath.c_str(), acrPath.size());
+
+      if(aPriority < 0 || aPriority > 0xFFFF)
+      {
+         throw std::range_error("Invalid broker priority \"" + std::to_string(aPriority) + "\" (has to be between 0 and 65535)");
+      }
+
+      if((mSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)) < 0 ||
+         ::connect(mSocket, reinterpret_cast<struct sockaddr*>(&lAddress), sizeof(lAddress)) < 0)
+      {
+         int lErrno = errno;
+         this->closeSocket();
+         throw std::runtime_error("Failed to connect to broker \"" + acrPath + "\" (Error " +
+                                  std::to_string(lErrno) + ": " + strerror(lErrno) + ")");
+      }
+
+      try
+      {
+         // hello, then welcome with the device count and one message per device
+         BrokerMessage lHello = message(BROKER_HELLO, 0);
+         lHello.mPriority = static_cast<uint16_t>(aPriority);
+         strncpy(lHello.mName, acrName.c_str(), BROKER_NAME_SIZE - 1);
+         this->send(lHello);
+
+         BrokerMessage lMessage;
+         if(!this->receive(REPLY_TIMEOUT_MS, lMessage) || lMessage.mType != BROKER_WELCOME)
+         {
+            throw std::runtime_error("Failed to connect to broker \"" + acrPath + "\" (no welcome)");
+         }
+
+         mClientId = lMessage.mValue;
+         std::vector<Device> lDevices(lMessage.mDevice, Device{ "", 0, 0 });
+
+         for(size_t d = 0; d < lDevices.size(); d++)
+         {
+            if(!this->receive(REPLY_TIMEOUT_MS, lMessage) || lMessage.mType != BROKER_DEVICE || lMessage.mDevice != d)
+            {
+               throw std::runtime_error("Failed to connect to broker \"" + acrPath + "\" (incomplete device list)");
+            }
+
+            lDevices[d].mBusName = std::string(lMessage.mName, strnlen(lMessage.mName, BROKER_NAME_SIZE));
+            lDevices[d].mAddress = static_cast<int>(lMessage.mValue);
+         }
+
+         mDevices.swap(lDevices);
+      }
+      catch(...)
+      {
+         this->closeSocket();
+         throw;
+      }
+   }
+
+
+   void BrokerClient::close()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->closeSocket();
+   }
+
+
+   bool BrokerClient::isConnected()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mSocket >= 0;
+   }
+
+
+   int BrokerClient::fd()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mSocket;
+   }
+
+
+   void BrokerClient::setOwnershipCallback(OwnershipCallback aCallback)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mOwnershipCallback = aCallback;
+   }
+
+
+   int BrokerClient::deviceCount()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return static_cast<int>(mDevices.size());
+   }
+
+
+   std::string BrokerClient::busName(int aDevice)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->checkDevice(aDevice);
+      return mDevices[aDevice].mBusName;
+   }
+
+
+   int BrokerClient::address(int aDevice)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->checkDevice(aDevice);
+      return mDevices[aDevice].mAddress;
+   }
+
+
+   uint32_t BrokerClient::clientId()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mClientId;
+   }
+
+
+   uint16_t BrokerClient::claim(int aDevice, uint16_t aChannelMask)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return this->request(BROKER_CLAIM, aDevice, aChannelMask);
+   }
+
+
+   uint16_t BrokerClient::release(int aDevice, uint16_t aChannelMask)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return this->request(BROKER_RELEASE, aDevice, aChannelMask);
+   }
+
+
+   uint16_t BrokerClient::ownedChannels(int aDevice)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->checkDevice(aDevice);
+
+      BrokerMessage lMessage;
+      while(this->receive(0, lMessage))
+      {
+      }
+
+      return mDevices[aDevice].mOwned;
+   }
+
+
+   void BrokerClient::setPWM(int aDevice, int aChannel, int aOnValue, int aOffValue)
+   {
+      if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                                "\" (has to be between 0 and " + std::to_string(PCA9685_CHANNEL_COUNT - 1) + ")");
+      }
+
+      uint16_t lOnValues[PCA9685_CHANNEL_COUNT] = { 0 };
+      uint16_t lOffValues[PCA9685_CHANNEL_COUNT] = { 0 };
+      lOnValues[aChannel] = static_cast<uint16_t>(std::min(std::max(aOnValue, 0), 4095));
+      lOffValues[aChannel] = static_cast<uint16_t>(std::min(std::max(aOffValue, 0), 4095));
+
+      this->setPWMBatch(aDevice, static_cast<uint16_t>(1u << aChannel), lOnValues, lOffValues);
+   }
+
+
+   void BrokerClient::setPWMBatch(int aDevice, uint16_t aChannelMask, const uint16_t* apOnValues, const uint16_t* apOffValues)
+   {
+      BrokerMessage lMessage = message(BROKER_SETPOINTS, aDevice);
+      lMessage.mChannelMask = aChannelMask;
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         if(aChannelMask & (1u << i))
+         {
+            lMessage.mOnValues[i] = std::min<uint16_t>(apOnValues[i], 4095);
+            lMessage.mOffValues[i] = std::min<uint16_t>(apOffValues[i], 4095);
+         }
+      }
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->checkDevice(aDevice);
+
+      // take pending ownership changes, the broker does not wait for clients which do not read
+      BrokerMessage lReceived;
+      while(this->receive(0, lReceived))
+      {
+      }
+
+      this->send(lMessage);
+   }
+
+
+   void BrokerClient::enableOutputs(int aDevice, uint16_t aChannelMask)
+   {
+      BrokerMessage lMessage = message(BROKER_ENABLE, aDevice);
+      lMessage.mChannelMask = aChannelMask;
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      this->checkDevice(aDevice);
+      this->send(lMessage);
+   }
+
+
+   void BrokerClient::emergencyStop()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      if(mSocket < 0)
+      {
+         throw std::runtime_error("Failed to access broker: not connected");
+      }
+
+      this->send(message(BROKER_STOP, 0));
+   }
+
+
+   int BrokerClient::poll(int aTimeoutMs)
+   {
+      // wait without the mutex, senders are not blocked meanwhile
+      int lSocket = this->fd();
+      if(lSocket < 0)
+      {
+         throw std::runtime_error("Failed to receive from broker: not connected");
+      }
+
+      struct pollfd lPoll = { lSocket, POLLIN, 0 };
+      if(::poll(&lPoll, 1, aTimeoutMs) <= 0)
+         return 0;
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      int lCount = 0;
+      BrokerMessage lMessage;
+      while(mSocket >= 0 && this->receive(0, lMessage))
+      {
+         lCount++;
+      }
+
+      return lCount;
+   }
+
+
+   void BrokerClient::send(const BrokerMessage& acrMessage)
+   {
+      if(::send(mSocket, &acrMessage, sizeof(acrMessage), MSG_NOSIGNAL) != sizeof(acrMessage))
+      {
+         int lErrno = errno;
+         if(lErrno == EPIPE || lErrno == ECONNRESET)
+            this->closeSocket();
+
+         throw std::runtime_error("Failed to send to broker (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+   }
+
+
+   bool BrokerClient::receive(int aTimeoutMs, BrokerMessage& arMessage)
+   {
+      if(aTimeoutMs > 0)
+      {
+         struct pollfd lPoll = { mSocket, POLLIN, 0 };
+         if(::poll(&lPoll, 1, aTimeoutMs) <= 0)
+            return false;
+      }
+
+      // one spare byte detects oversized messages
+      uint8_t lBuffer[BROKER_MESSAGE_SIZE + 1];
+      ssize_t lLength = recv(mSocket, lBuffer, sizeof(lBuffer), MSG_DONTWAIT);
+      if(lLength < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+         return false;
+
+      if(lLength <= 0)
+      {
+         this->closeSocket();
+         throw std::runtime_error("Failed to receive from broker (connection closed)");
+      }
+
+      memcpy(&arMessage, lBuffer, sizeof(arMessage));
+      if(lLength != BROKER_MESSAGE_SIZE || arMessage.mMagic != BROKER_MESSAGE_MAGIC)
+      {
+         this->closeSocket();
+         throw std::runtime_error("Failed to receive from broker (invalid message)");
+      }
+
+      if(arMessage.mType == BROKER_OWNERSHIP && arMessage.mDevice < mDevices.size())
+      {
+         uint16_t& lrOwned = mDevices[arMessage.mDevice].mOwned;
+         if(lrOwned != arMessage.mChannelMask)
+         {
+            lrOwned = arMessage.mChannelMask;
+            if(mOwnershipCallback)
+               mOwnershipCallback(arMessage.mDevice, lrOwned);
+         }
+      }
+
+      return true;
+   }
+
+
+   uint16_t BrokerClient::request(BrokerMessageType aType, int aDevice, uint16_t aChannelMask)
+   {
+      this->checkDevice(aDevice);
+
+      BrokerMessage lMessage = message(aType, aDevice);
+      lMessage.mChannelMask = aChannelMask;
+      lMessage.mValue = ++mRequest == 0 ? ++mRequest : mRequest;
+      this->send(lMessage);
+
+      // changes by other clients may arrive before the answer
+      BrokerMessage lAnswer;
+      while(this->receive(REPLY_TIMEOUT_MS, lAnswer))
+      {
+         if(lAnswer.mType == BROKER_OWNERSHIP && lAnswer.mValue == mRequest)
+            return lAnswer.mChannelMask;
+      }
+
+      throw std::runtime_error("Failed to " + std::string(aType == BROKER_CLAIM ? "claim" : "release") +
+                               " channels (no answer from broker)");
+   }
+
+
+   void BrokerClient::checkDevice(int aDevice) const
+   {
+      if(mSocket < 0)
+      {
+         throw std::runtime_error("Failed to access broker: not connected");
+      }
+
+      if(aDevice < 0 || aDevice >= static_cast<int>(mDevices.size()))
+      {
+         throw std::range_error("Invalid broker device \"" + std::to_string(aDevice) + "\" (has to be between 0 and " +
+                                std::to_string(static_cast<int>(mDevices.size()) - 1) + ")");
+      }
+   }
+
+
+   void BrokerClient::closeSocket()
+   {
+      if(mSocket >= 0)
+      {
+         ::close(mSocket);
+      }
+
+      mSocket = -1;
+      mClientId = 0;
+      mDevices.clear();
+   }
+} // namespace CAR4TEGRA
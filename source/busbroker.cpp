@@ -0,0 +1,643 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busbroker.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class BusBroker at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/busbroker.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const int LISTEN_BACKLOG = 16;        ///< Pending connections of the listening socket
+      const int EVENT_BATCH = 32;           ///< Events handled per epoll_wait
+      const int MESSAGE_BATCH = 64;         ///< Messages of one client handled per event (fairness)
+      const int THREAD_POLL_MS = 100;       ///< Poll timeout of the broker thread (ms)
+
+      static_assert(sizeof(BrokerMessage) == BROKER_MESSAGE_SIZE, "BrokerMessage layout has changed");
+
+
+      /**
+       * @brief Returns an empty message of a type
+       *
+       * @param[in]  aType          Message type
+       * @param[in]  aDevice        Device index
+       *
+       * @return Message
+       */
+      BrokerMessage message(BrokerMessageType aType, int aDevice)
+      {
+         BrokerMessage lMessage;
+         memset(&lMessage, 0, sizeof(lMessage));
+         lMessage.mMagic = BROKER_MESSAGE_MAGIC;
+         lMessage.mType = static_cast<uint16_t>(aType);
+         lMessage.mDevice = static_cast<uint16_t>(aDevice);
+         return lMessage;
+      }
+   } // namespace
+
+
+   BusBroker::BusBroker()
+      : mSocket(-1), mEpoll(-1), mTimer(-1), mFrameRate(BROKER_FRAME_RATE_DEFAULT), mReleaseStop(true),
+        mNextId(1), mStaged(false), mRunning(false), mStatistics()
+   {
+      mExecutor.setErrorCallback([this](int aDevice, const std::string& acrMessage)
+      {
+         this->report("Failed to write device " + std::to_string(aDevice) + ": " + acrMessage);
+      });
+   }
+
+
+   BusBroker::~BusBroker()
+   {
+      this->stop();
+      this->close();
+   }
+
+
+   int BusBroker::addDevice(PCA9685& arDriver)
+   {
+      int lDevice = mExecutor.addDevice(arDriver);
+      mDevices.push_back(&arDriver);
+      mOwners.resize(mDevices.size() * PCA9685_CHANNEL_COUNT, -1);
+
+      return lDevice;
+   }
+
+
+   void BusBroker::setFrameRate(float aFrameRate)
+   {
+      if(!(aFrameRate >= 1.0f && aFrameRate <= 2000.0f))
+      {
+         throw std::range_error("Invalid frame rate \"" + std::to_string(aFrameRate) + "\" (has to be between 1 and 2000)");
+      }
+
+      mFrameRate = aFrameRate;
+
+      if(mTimer >= 0)
+      {
+         long lPeriodNs = std::lround(1e9 / mFrameRate);
+         struct itimerspec lSpec;
+         lSpec.it_interval.tv_sec = lPeriodNs / 1000000000l;
+         lSpec.it_interval.tv_nsec = lPeriodNs % 1000000000l;
+         lSpec.it_value = lSpec.it_interval;
+         timerfd_settime(mTimer, 0, &lSpec, nullptr);
+      }
+   }
+
+
+   void BusBroker::setReleaseStop(bool aStop)
+   {
+      mReleaseStop = aStop;
+   }
+
+
+   void BusBroker::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void BusBroker::open(const std::string& acrPath)
+   {
+      this->close();
+
+      struct sockaddr_un lAddress;
+      memset(&lAddress, 0, sizeof(lAddress));
+      lAddress.sun_family = AF_UNIX;
+      if(acrPath.empty() || acrPath.size() >= sizeof(lAddress.sun_path))
+      {
+         throw std::runtime_error("Invalid broker socket path \"" + acrPath + "\"");
+      }
+      memcpy(lAddress.sun_path, acrPath.c_str(), acrPath.size());
+
+      // a socket file nobody accepts on is left over from a crashed broker
+      int lProbe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+      if(lProbe >= 0)
+      {
+         if(connect(lProbe, reinterpret_cast<struct sockaddr*>(&lAddress), sizeof(lAddress)) == 0)
+         {
+            ::close(lProbe);
+            throw std::runtime_error("Failed to open broker socket \"" + acrPath + "\" (another broker is running)");
+         }
+
+         if(errno == ECONNREFUSED)
+            unlink(acrPath.c_str());
+         ::close(lProbe);
+      }
+
+      struct epoll_event lEvent;
+      memset(&lEvent, 0, sizeof(lEvent));
+      lEvent.events = EPOLLIN;
+
+      if((mSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0 ||
+         bind(mSocket, reinterpret_cast<struct sockaddr*>(&lAddress), sizeof(lAddress)) < 0 ||
+         listen(mSocket, LISTEN_BACKLOG) < 0 ||
+         (mEpoll = epoll_create1(EPOLL_CLOEXEC)) < 0 ||
+         (mTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0 ||
+         (lEvent.data.fd = mSocket, epoll_ctl(mEpoll, EPOLL_CTL_ADD, mSocket, &lEvent)) < 0 ||
+         (lEvent.data.fd = mTimer, epoll_ctl(mEpoll, EPOLL_CTL_ADD, mTimer, &lEvent)) < 0)
+      {
+         int lErrno = errno;
+         bool lBound = (mSocket >= 0 && mEpoll >= 0);
+         this->close();
+         if(lBound)
+            unlink(acrPath.c_str());
+
+         throw std::runtime_error("Failed to open broker socket \"" + acrPath + "\" (Error " +
+                                  std::to_string(lErrno) + ": " + strerror(lErrno) + ")");
+      }
+
+      mPath = acrPath;
+      this->setFrameRate(mFrameRate);
+   }
+
+
+   void BusBroker::close()
+   {
+      while(!mClients.empty())
+      {
+         this->disconnect(mClients.begin()->first);
+      }
+      mDisconnects.clear();
+
+      if(mSocket >= 0)
+      {
+         ::close(mSocket);
+         if(!mPath.empty())
+            unlink(mPath.c_str());
+      }
+
+      if(mTimer >= 0)
+         ::close(mTimer);
+
+      if(mEpoll >= 0)
+         ::close(mEpoll);
+
+      mSocket = -1;
+      mTimer = -1;
+      mEpoll = -1;
+      mPath.clear();
+   }
+
+
+   void BusBroker::start()
+   {
+      this->stop();
+
+      if(mEpoll < 0)
+      {
+         throw std::runtime_error("Failed to start broker: socket is not open");
+      }
+
+      mExecutor.start();
+      mRunning = true;
+      mThread = std::thread(&BusBroker::run, this);
+   }
+
+
+   void BusBroker::stop()
+   {
+      mRunning = false;
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+
+      mExecutor.stop();
+   }
+
+
+   int BusBroker::poll(int aTimeoutMs)
+   {
+      if(mEpoll < 0)
+      {
+         throw std::runtime_error("Failed to run broker: socket is not open");
+      }
+
+      struct epoll_event lEvents[EVENT_BATCH];
+      int lCount = epoll_wait(mEpoll, lEvents, EVENT_BATCH, aTimeoutMs);
+      if(lCount < 0)
+      {
+         if(errno != EINTR)
+         {
+            throw std::runtime_error("Failed to wait for broker events (Error " + std::to_string(errno) +
+                                     ": " + strerror(errno) + ")");
+         }
+         return 0;
+      }
+
+      for(int i = 0; i < lCount; i++)
+      {
+         int lFd = lEvents[i].data.fd;
+
+         if(lFd == mTimer)
+         {
+            uint64_t lExpirations = 0;
+            if(read(mTimer, &lExpirations, sizeof(lExpirations)) == sizeof(lExpirations))
+               this->runFrame();
+         }
+         else if(lFd == mSocket)
+         {
+            this->accept();
+         }
+         else if(!this->receive(lFd) || (lEvents[i].events & (EPOLLHUP | EPOLLERR)) != 0)
+         {
+            mDisconnects.push_back(lFd);
+         }
+      }
+
+      // disconnect after the batch, the sockets of this batch must not be reused meanwhile
+      for(int lFd : mDisconnects)
+      {
+         this->disconnect(lFd);
+      }
+      mDisconnects.clear();
+
+      return lCount;
+   }
+
+
+   const std::string& BusBroker::path() const
+   {
+      return mPath;
+   }
+
+
+   BusBroker::Statistics BusBroker::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+      return mStatistics;
+   }
+
+
+   void BusBroker::accept()
+   {
+      int lFd;
+      while((lFd = accept4(mSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+      {
+         struct epoll_event lEvent;
+         memset(&lEvent, 0, sizeof(lEvent));
+         lEvent.events = EPOLLIN;
+         lEvent.data.fd = lFd;
+         if(epoll_ctl(mEpoll, EPOLL_CTL_ADD, lFd, &lEvent) < 0)
+         {
+            this->report("Failed to add broker client (Error " + std::to_string(errno) + ": " + strerror(errno) + ")");
+            ::close(lFd);
+            continue;
+         }
+
+         mClients[lFd] = Client{ "", mNextId++, 0, false };
+
+         std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+         mStatistics.mConnections++;
+         mStatistics.mClients = mClients.size();
+      }
+   }
+
+
+   bool BusBroker::receive(int aSocket)
+   {
+      auto lClient = mClients.find(aSocket);
+      if(lClient == mClients.end())
+         return false;
+
+      // one spare byte detects oversized messages
+      uint8_t lBuffer[BROKER_MESSAGE_SIZE + 1];
+      for(int i = 0; i < MESSAGE_BATCH; i++)
+      {
+         ssize_t lLength = recv(aSocket, lBuffer, sizeof(lBuffer), MSG_DONTWAIT);
+         if(lLength < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+         // orderly shutdown of the client
+         if(lLength == 0)
+            return false;
+
+         BrokerMessage lMessage;
+         memcpy(&lMessage, lBuffer, sizeof(lMessage));
+
+         {
+            std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+            mStatistics.mMessages++;
+         }
+
+         if(lLength != BROKER_MESSAGE_SIZE || !this->handle(aSocket, lClient->second, lMessage))
+            return false;
+      }
+
+      return true;
+   }
+
+
+   bool BusBroker::handle(int aSocket, Client& arClient, const BrokerMessage& acrMessage)
+   {
+      bool lValid = acrMessage.mMagic == BROKER_MESSAGE_MAGIC &&
+                    (acrMessage.mType == BROKER_HELLO) != arClient.mWelcomed &&
+                    (acrMessage.mType == BROKER_HELLO || acrMessage.mType == BROKER_STOP ||
+                     acrMessage.mDevice < mDevices.size());
+
+      if(lValid && acrMessage.mType == BROKER_SETPOINTS)
+      {
+         for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+         {
+            lValid = lValid && acrMessage.mOnValues[i] <= 4095 && acrMessage.mOffValues[i] <= 4095;
+         }
+      }
+
+      if(lValid)
+      {
+         int lDevice = acrMessage.mDevice;
+
+         switch(acrMessage.mType)
+         {
+            case BROKER_HELLO:
+            {
+               arClient.mName = std::string(acrMessage.mName, strnlen(acrMessage.mName, BROKER_NAME_SIZE));
+               arClient.mPriority = acrMessage.mPriority;
+               arClient.mWelcomed = true;
+
+               BrokerMessage lWelcome = message(BROKER_WELCOME, static_cast<int>(mDevices.size()));
+               lWelcome.mValue = arClient.mId;
+               bool lSent = this->send(aSocket, lWelcome);
+
+               for(size_t d = 0; d < mDevices.size() && lSent; d++)
+               {
+                  BrokerMessage lInfo = message(BROKER_DEVICE, static_cast<int>(d));
+                  lInfo.mValue = static_cast<uint32_t>(mDevices[d]->address());
+                  strncpy(lInfo.mName, mDevices[d]->busName().c_str(), BROKER_NAME_SIZE - 1);
+                  lSent = this->send(aSocket, lInfo);
+               }
+               return lSent;
+            }
+
+            case BROKER_CLAIM:
+               this->claim(aSocket, lDevice, acrMessage.mChannelMask, true);
+               return this->sendOwnership(aSocket, lDevice, acrMessage.mValue);
+
+            case BROKER_RELEASE:
+               for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+               {
+                  int& lrOwner = mOwners[lDevice * PCA9685_CHANNEL_COUNT + lChannel];
+                  if((acrMessage.mChannelMask & (1u << lChannel)) && lrOwner == aSocket)
+                     lrOwner = -1;
+               }
+               return this->sendOwnership(aSocket, lDevice, acrMessage.mValue);
+
+            case BROKER_SETPOINTS:
+            {
+               // free channels are claimed by the first setpoint
+               uint16_t lBefore = this->owned(aSocket, lDevice);
+               uint16_t lOwned = this->claim(aSocket, lDevice, acrMessage.mChannelMask, false);
+               uint16_t lMask = acrMessage.mChannelMask & lOwned;
+
+               for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+               {
+                  if(lMask & (1u << lChannel))
+                  {
+                     mExecutor.set(lDevice * PCA9685_CHANNEL_COUNT + lChannel,
+                                   acrMessage.mOnValues[lChannel], acrMessage.mOffValues[lChannel]);
+                  }
+               }
+               mStaged = mStaged || lMask != 0;
+
+               if(lMask != acrMessage.mChannelMask)
+               {
+                  std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+                  mStatistics.mRejected += __builtin_popcount(acrMessage.mChannelMask & ~lMask);
+               }
+
+               return lOwned == lBefore || this->sendOwnership(aSocket, lDevice);
+            }
+
+            case BROKER_ENABLE:
+               try
+               {
+                  mDevices[lDevice]->enableOutputs(acrMessage.mChannelMask & this->owned(aSocket, lDevice));
+               }
+               catch(const std::exception& e)
+               {
+                  this->report(e.what());
+               }
+               return true;
+
+            case BROKER_STOP:
+               try
+               {
+                  mExecutor.emergencyStop();
+               }
+               catch(const std::exception& e)
+               {
+                  this->report(e.what());
+               }
+               mStaged = false;
+               return true;
+
+            default:
+               break;
+         }
+      }
+
+      {
+         std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+         mStatistics.mMalformed++;
+      }
+      this->report("Invalid message from broker client \"" + arClient.mName + "\" (disconnected)");
+      return false;
+   }
+
+
+   uint16_t BusBroker::claim(int aSocket, int aDevice, uint16_t aMask, bool aPreempt)
+   {
+      int lPriority = mClients[aSocket].mPriority;
+      std::vector<int> lPreempted;
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         int& lrOwner = mOwners[aDevice * PCA9685_CHANNEL_COUNT + lChannel];
+         if(!(aMask & (1u << lChannel)) || lrOwner == aSocket)
+            continue;
+
+         if(lrOwner < 0)
+         {
+            lrOwner = aSocket;
+         }
+         else if(aPreempt && mClients[lrOwner].mPriority < lPriority)
+         {
+            if(std::find(lPreempted.begin(), lPreempted.end(), lrOwner) == lPreempted.end())
+               lPreempted.push_back(lrOwner);
+            lrOwner = aSocket;
+
+            std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+            mStatistics.mPreemptions++;
+         }
+      }
+
+      for(int lOwner : lPreempted)
+      {
+         if(!this->sendOwnership(lOwner, aDevice))
+            mDisconnects.push_back(lOwner);
+      }
+
+      return this->owned(aSocket, aDevice);
+   }
+
+
+   uint16_t BusBroker::owned(int aSocket, int aDevice) const
+   {
+      uint16_t lMask = 0;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(mOwners[aDevice * PCA9685_CHANNEL_COUNT + lChannel] == aSocket)
+            lMask |= static_cast<uint16_t>(1u << lChannel);
+      }
+
+      return lMask;
+   }
+
+
+   bool BusBroker::send(int aSocket, const BrokerMessage& acrMessage)
+   {
+      // a client which does not read its messages is not waited for
+      if(::send(aSocket, &acrMessage, sizeof(acrMessage), MSG_DONTWAIT | MSG_NOSIGNAL) != sizeof(acrMessage))
+      {
+         auto lClient = mClients.find(aSocket);
+         this->report("Failed to send to broker client \"" + (lClient != mClients.end() ? lClient->second.mName : "") +
+                      "\" (Error " + std::to_string(errno) + ": " + strerror(errno) + ")");
+         return false;
+      }
+
+      return true;
+   }
+
+
+   bool BusBroker::sendOwnership(int aSocket, int aDevice, uint32_t aRequest)
+   {
+      BrokerMessage lOwnership = message(BROKER_OWNERSHIP, aDevice);
+      lOwnership.mChannelMask = this->owned(aSocket, aDevice);
+      lOwnership.mValue = aRequest;
+      return this->send(aSocket, lOwnership);
+   }
+
+
+   void BusBroker::disconnect(int aSocket)
+   {
+      if(mClients.erase(aSocket) == 0)
+         return;
+
+      epoll_ctl(mEpoll, EPOLL_CTL_DEL, aSocket, nullptr);
+      ::close(aSocket);
+
+      // release the channels, a crashed client must not leave its outputs running
+      for(size_t d = 0; d < mDevices.size(); d++)
+      {
+         uint16_t lMask = this->owned(aSocket, static_cast<int>(d));
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            if(lMask & (1u << lChannel))
+               mOwners[d * PCA9685_CHANNEL_COUNT + lChannel] = -1;
+         }
+
+         if(lMask != 0 && mReleaseStop)
+         {
+            try
+            {
+               mDevices[d]->stopOutputs(lMask);
+            }
+            catch(const std::exception& e)
+            {
+               this->report(e.what());
+            }
+         }
+      }
+
+      std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+      mStatistics.mClients = mClients.size();
+   }
+
+
+   void BusBroker::runFrame()
+   {
+      if(!mStaged)
+         return;
+
+      mStaged = false;
+      int lWritten = mExecutor.runFrame();
+
+      std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+      mStatistics.mFrames++;
+      mStatistics.mWritten += lWritten;
+   }
+
+
+   void BusBroker::report(const std::string& acrMessage)
+   {
+      if(mErrorCallback)
+         mErrorCallback(acrMessage);
+   }
+
+
+   void BusBroker::run()
+   {
+      C4T_TRACE_THREAD("broker");
+
+      while(mRunning)
+      {
+         try
+         {
+            this->poll(THREAD_POLL_MS);
+         }
+         catch(const std::exception& e)
+         {
+            this->report(e.what());
+            std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_POLL_MS));
+         }
+      }
+   }
+} // namespace CAR4TEGRA
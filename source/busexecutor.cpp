@@ -0,0 +1,377 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busexecutor.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class BusExecutor at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/busexecutor.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const size_t THREAD_NAME_MAX = 15;     ///< Maximum length of a thread name (without terminator)
+   } // namespace
+
+
+   BusExecutor::BusExecutor()
+      : mGeneration(0), mRemaining(0), mWritten(0), mStatistics(), mRunning(false)
+   {
+   }
+
+
+   BusExecutor::~BusExecutor()
+   {
+      this->stop();
+   }
+
+
+   int BusExecutor::addDevice(PCA9685& arDriver)
+   {
+      const std::string& lBusName = arDriver.busName();
+      if(lBusName.empty())
+      {
+         throw std::runtime_error("Failed to add device (device is not connected)");
+      }
+
+      auto lBus = std::find_if(mBuses.begin(), mBuses.end(),
+                               [&lBusName](const std::unique_ptr<Bus>& acrBus) { return acrBus->mName == lBusName; });
+      if(lBus == mBuses.end())
+      {
+         std::unique_ptr<Bus> lpBus(new Bus());
+         lpBus->mName = lBusName;
+         lpBus->mCpu = -1;
+         lpBus->mStatistics = BusStatistics();
+         mBuses.push_back(std::move(lpBus));
+         lBus = mBuses.end() - 1;
+      }
+
+      int lDevice = static_cast<int>(mDevices.size());
+      mDevices.push_back(&arDriver);
+      (*lBus)->mDevices.push_back(lDevice);
+
+      DeviceFrame lFrame = {};
+      mStaged.resize(mDevices.size(), lFrame);
+      mFrame.resize(mDevices.size(), lFrame);
+
+      return lDevice;
+   }
+
+
+   void BusExecutor::setAffinity(const std::string& acrBusName, int aCpu)
+   {
+      for(std::unique_ptr<Bus>& lpBus : mBuses)
+      {
+         if(lpBus->mName == acrBusName)
+         {
+            lpBus->mCpu = aCpu;
+            return;
+         }
+      }
+
+      throw std::range_error("Invalid bus \"" + acrBusName + "\" (no device added on this bus)");
+   }
+
+
+   void BusExecutor::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void BusExecutor::start()
+   {
+      this->stop();
+
+      uint64_t lGeneration = 0;
+      {
+         std::lock_guard<std::mutex> lLock(mFrameMutex);
+         lGeneration = mGeneration;
+         mRunning = true;
+      }
+
+      for(std::unique_ptr<Bus>& lpBus : mBuses)
+      {
+         lpBus->mThread = std::thread(&BusExecutor::run, this, lpBus.get(), lGeneration);
+
+         // name the worker after the bus (e.g. "i2c-1") for top / perf
+         std::string lName = lpBus->mName.substr(lpBus->mName.find_last_of('/') + 1).substr(0, THREAD_NAME_MAX);
+         pthread_setname_np(lpBus->mThread.native_handle(), lName.c_str());
+
+         if(lpBus->mCpu >= 0)
+         {
+            cpu_set_t lCpuSet;
+            CPU_ZERO(&lCpuSet);
+            CPU_SET(lpBus->mCpu, &lCpuSet);
+
+            int lResult = pthread_setaffinity_np(lpBus->mThread.native_handle(), sizeof(lCpuSet), &lCpuSet);
+            if(lResult != 0)
+            {
+               this->stop();
+               throw std::runtime_error("Failed to pin worker of bus \"" + lpBus->mName + "\" to CPU " +
+                                        std::to_string(lpBus->mCpu) + " (Error " + std::to_string(lResult) +
+                                        ": " + strerror(lResult) + ")");
+            }
+         }
+      }
+   }
+
+
+   void BusExecutor::stop()
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mFrameMutex);
+         mRunning = false;
+      }
+      mFrameStart.notify_all();
+
+      for(std::unique_ptr<Bus>& lpBus : mBuses)
+      {
+         if(lpBus->mThread.joinable())
+         {
+            lpBus->mThread.join();
+         }
+      }
+   }
+
+
+   void BusExecutor::set(int aChannel, int aOnValue, int aOffValue)
+   {
+      if(aChannel < 0 || aChannel >= static_cast<int>(mDevices.size() * PCA9685_CHANNEL_COUNT))
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) + "\" (has to be between 0 and " +
+                                std::to_string(mDevices.size() * PCA9685_CHANNEL_COUNT) + ")");
+      }
+
+      // limit arguments to allowed range (see PCA9685::setPWM)
+      aOnValue = std::min(std::max(aOnValue, 0), 4095);
+      aOffValue = std::min(std::max(aOffValue, 0), 4095);
+
+      int lChannel = aChannel % PCA9685_CHANNEL_COUNT;
+
+      std::lock_guard<std::mutex> lLock(mStageMutex);
+      DeviceFrame& lFrame = mStaged[aChannel / PCA9685_CHANNEL_COUNT];
+      lFrame.mMask |= static_cast<uint16_t>(1u << lChannel);
+      lFrame.mOnValues[lChannel] = static_cast<uint16_t>(aOnValue);
+      lFrame.mOffValues[lChannel] = static_cast<uint16_t>(aOffValue);
+   }
+
+
+   int BusExecutor::runFrame()
+   {
+      // take over the staged values, values for the next frame can be set while writing
+      {
+         std::lock_guard<std::mutex> lLock(mStageMutex);
+         mStaged.swap(mFrame);
+         for(DeviceFrame& lFrame : mStaged)
+         {
+            lFrame.mMask = 0;
+         }
+      }
+
+      Clock::time_point lStart = Clock::now();
+      int lWritten = 0;
+
+      std::unique_lock<std::mutex> lLock(mFrameMutex);
+      if(mRunning)
+      {
+         // dispatch to the bus workers and wait at the frame barrier
+         mWritten = 0;
+         mRemaining = mBuses.size();
+         mGeneration++;
+         mFrameStart.notify_all();
+
+         mFrameDone.wait(lLock, [this]() { return mRemaining == 0; });
+         lWritten = mWritten;
+      }
+      else
+      {
+         lLock.unlock();
+         for(std::unique_ptr<Bus>& lpBus : mBuses)
+         {
+            lWritten += this->writeBus(*lpBus);
+         }
+         lLock.lock();
+      }
+
+      double lFrameUs = std::chrono::duration<double, std::micro>(Clock::now() - lStart).count();
+      mStatistics.mFrames++;
+      mStatistics.mLastFrameUs = lFrameUs;
+      mStatistics.mMaxFrameUs = std::max(mStatistics.mMaxFrameUs, lFrameUs);
+
+      return lWritten;
+   }
+
+
+   void BusExecutor::emergencyStop()
+   {
+      // stop bytes first, a failing device must not delay the others
+      std::string lErrors;
+      for(PCA9685* lpDevice : mDevices)
+      {
+         try
+         {
+            lpDevice->emergencyStop();
+         }
+         catch(const std::runtime_error& e)
+         {
+            lErrors += (lErrors.empty() ? "" : "; ") + std::string(e.what());
+         }
+      }
+
+      {
+         std::lock_guard<std::mutex> lLock(mStageMutex);
+         for(DeviceFrame& lFrame : mStaged)
+         {
+            lFrame.mMask = 0;
+         }
+      }
+
+      if(!lErrors.empty())
+      {
+         throw std::runtime_error("Emergency stop failed: " + lErrors);
+      }
+   }
+
+
+   size_t BusExecutor::busCount() const
+   {
+      return mBuses.size();
+   }
+
+
+   const std::string& BusExecutor::busName(size_t aBus) const
+   {
+      return mBuses.at(aBus)->mName;
+   }
+
+
+   BusExecutor::BusStatistics BusExecutor::busStatistics(size_t aBus)
+   {
+      std::lock_guard<std::mutex> lLock(mFrameMutex);
+      return mBuses.at(aBus)->mStatistics;
+   }
+
+
+   BusExecutor::Statistics BusExecutor::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mFrameMutex);
+      return mStatistics;
+   }
+
+
+   int BusExecutor::writeBus(Bus& arBus)
+   {
+      Clock::time_point lStart = Clock::now();
+      int lWritten = 0;
+      uint64_t lTransfers = 0;
+      uint64_t lErrors = 0;
+
+      for(int lDevice : arBus.mDevices)
+      {
+         const DeviceFrame& lFrame = mFrame[lDevice];
+         if(lFrame.mMask == 0)
+            continue;
+
+         try
+         {
+            mDevices[lDevice]->setPWMBatch(lFrame.mMask, lFrame.mOnValues, lFrame.mOffValues);
+            lWritten += __builtin_popcount(lFrame.mMask);
+            lTransfers++;
+         }
+         catch(const std::exception& e)
+         {
+            lErrors++;
+            if(mErrorCallback)
+               mErrorCallback(lDevice, e.what());
+         }
+      }
+
+      if(lTransfers + lErrors == 0)
+         return 0;
+
+      double lBusUs = std::chrono::duration<double, std::micro>(Clock::now() - lStart).count();
+
+      std::lock_guard<std::mutex> lLock(mFrameMutex);
+      BusStatistics& lStats = arBus.mStatistics;
+      lStats.mFrames++;
+      lStats.mWritten += lWritten;
+      lStats.mTransfers += lTransfers;
+      lStats.mErrors += lErrors;
+      lStats.mLastFrameUs = lBusUs;
+      lStats.mMaxFrameUs = std::max(lStats.mMaxFrameUs, lBusUs);
+      lStats.mBusyUs += lBusUs;
+
+      return lWritten;
+   }
+
+
+   void BusExecutor::run(Bus* apBus, uint64_t aGeneration)
+   {
+      C4T_TRACE_THREAD(apBus->mName);
+
+      std::unique_lock<std::mutex> lLock(mFrameMutex);
+
+      while(true)
+      {
+         mFrameStart.wait(lLock, [this, aGeneration]() { return mGeneration != aGeneration || !mRunning; });
+
+         // a dispatched frame is always finished, otherwise runFrame() would wait forever
+         if(mGeneration == aGeneration)
+            break;
+
+         aGeneration = mGeneration;
+         lLock.unlock();
+
+         int lWritten = 0;
+         {
+            C4T_TRACE_SPAN("driver", "BusExecutor::writeBus");
+            lWritten = this->writeBus(*apBus);
+         }
+
+         lLock.lock();
+         mWritten += lWritten;
+         if(--mRemaining == 0)
+            mFrameDone.notify_one();
+      }
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,394 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file busscheduler.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class BusScheduler at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <math.h>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/busscheduler.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const double BITS_PER_BYTE = 9.0;            ///< 8 data bits and ACK
+      const double BITS_START_STOP = 2.0;          ///< START and STOP condition
+      const size_t HEADER_BYTES = 2;               ///< Slave address and register byte
+      const int DEFAULT_PRIORITY = 0;              ///< Priority of channels without setting
+      const int DUE_AGING = 1;                     ///< Priority raise of updates due before the next frame
+      const std::chrono::microseconds DEFAULT_DEADLINE(100000);   ///< Deadline of channels without setting
+   } // namespace
+
+
+   BusScheduler::BusScheduler(uint32_t aBusClock, float aFrequency)
+      : mBusClock(aBusClock), mOverheadUs(30.0), mUtilization(0.8), mStatistics(),
+        mpClock(&DriverClock::monotonic()), mRunning(false)
+   {
+      this->setPWMFrequency(aFrequency);
+   }
+
+
+   BusScheduler::~BusScheduler()
+   {
+      this->stop();
+   }
+
+
+   int BusScheduler::addDevice(PCA9685& arDriver)
+   {
+      mDevices.push_back(&arDriver);
+      arDriver.setBusTiming(mBusClock, mOverheadUs);
+
+      Channel lChannel = { DEFAULT_PRIORITY, DEFAULT_DEADLINE, false, 0, 0, Clock::time_point(), 0.0 };
+      mChannels.resize(mDevices.size() * PCA9685_CHANNEL_COUNT, lChannel);
+      mOrder.resize(mChannels.size());
+      mBatch.resize(mChannels.size());
+
+      return static_cast<int>(mDevices.size()) - 1;
+   }
+
+
+   void BusScheduler::setBusClock(uint32_t aBusClock)
+   {
+      if(aBusClock == 0)
+      {
+         throw std::range_error("Invalid bus clock \"0\"");
+      }
+
+      mBusClock = aBusClock;
+      for(PCA9685* lpDevice : mDevices)
+         lpDevice->setBusTiming(mBusClock, mOverheadUs);
+      this->updateBudget();
+   }
+
+
+   void BusScheduler::setPWMFrequency(float aFrequency)
+   {
+      // limit argument to allowed range (see PCA9685::setPWMFrequency)
+      double lFreq = fmin(fmax(aFrequency, 24), 1526);
+
+      mPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / lFreq));
+      this->updateBudget();
+   }
+
+
+   void BusScheduler::setTransactionOverhead(double aOverheadUs)
+   {
+      mOverheadUs = fmax(aOverheadUs, 0.0);
+      for(PCA9685* lpDevice : mDevices)
+         lpDevice->setBusTiming(mBusClock, mOverheadUs);
+      this->updateBudget();
+   }
+
+
+   void BusScheduler::setUtilization(double aUtilization)
+   {
+      mUtilization = fmin(fmax(aUtilization, 0.0), 1.0);
+      this->updateBudget();
+   }
+
+
+   void BusScheduler::setChannelPriority(int aChannel, int aPriority, std::chrono::microseconds aDeadline)
+   {
+      this->checkChannel(aChannel);
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mChannels[aChannel].mPriority = aPriority;
+      mChannels[aChannel].mDeadline = aDeadline;
+   }
+
+
+   void BusScheduler::submit(int aChannel, int aOnValue, int aOffValue)
+   {
+      this->checkChannel(aChannel);
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      Channel& lChannel = mChannels[aChannel];
+
+      if(lChannel.mPending)
+      {
+         // keep submit time of the first update, the latency counts from there
+         mStatistics.mCoalesced++;
+      }
+      else
+      {
+         lChannel.mPending = true;
+         lChannel.mSubmitted = mpClock->now();
+      }
+
+      lChannel.mOnValue = aOnValue;
+      lChannel.mOffValue = aOffValue;
+   }
+
+
+   int BusScheduler::runFrame()
+   {
+      std::unique_lock<std::mutex> lLock(mMutex);
+
+      // collect pending updates
+      size_t lCount = 0;
+      for(size_t i = 0; i < mChannels.size(); i++)
+      {
+         if(mChannels[i].mPending)
+            mOrder[lCount++] = static_cast<int>(i);
+      }
+
+      // highest priority first, earliest deadline first within a priority. Updates due before
+      // the next frame are raised by one priority level only, so they overtake updates of the
+      // next level but never delay more important channels
+      Clock::time_point lHorizon = mpClock->now() + mPeriod;
+      std::sort(mOrder.begin(), mOrder.begin() + lCount, [this, lHorizon](int aA, int aB)
+      {
+         const Channel& lA = mChannels[aA];
+         const Channel& lB = mChannels[aB];
+         Clock::time_point lDueA = lA.mSubmitted + lA.mDeadline;
+         Clock::time_point lDueB = lB.mSubmitted + lB.mDeadline;
+         int lPriorityA = lA.mPriority + (lDueA <= lHorizon ? DUE_AGING : 0);
+         int lPriorityB = lB.mPriority + (lDueB <= lHorizon ? DUE_AGING : 0);
+
+         if(lPriorityA != lPriorityB)
+            return lPriorityA > lPriorityB;
+         return lDueA < lDueB;
+      });
+
+
+      // fill frame budget, the most important update is always written
+      double lUsedUs = 0.0;
+      size_t lSelected = 0;
+      for(; lSelected < lCount; lSelected++)
+      {
+         const PCA9685* lpDevice = mDevices[mOrder[lSelected] / PCA9685_CHANNEL_COUNT];
+         double lCost = lpDevice->autoIncrement() ? this->transactionCost(4) : 4.0 * this->transactionCost(1);
+
+         if(lSelected > 0 && lUsedUs + lCost > mStatistics.mBudgetUs)
+            break;
+
+         lUsedUs += lCost;
+      }
+
+      // take over selected updates, new submits may arrive while writing
+      bool lDeferredAny = false;
+      int lDeferredPriority = 0;
+      for(size_t i = lSelected; i < lCount; i++)
+      {
+         if(!lDeferredAny || mChannels[mOrder[i]].mPriority > lDeferredPriority)
+            lDeferredPriority = mChannels[mOrder[i]].mPriority;
+         lDeferredAny = true;
+      }
+
+      for(size_t i = 0; i < lSelected; i++)
+      {
+         Channel& lChannel = mChannels[mOrder[i]];
+
+         // due update which overtook a higher priority
+         if(lDeferredAny && lChannel.mPriority < lDeferredPriority)
+            mStatistics.mPromoted++;
+
+         mBatch[i] = Update{ mOrder[i], lChannel.mOnValue, lChannel.mOffValue, lChannel.mSubmitted, lChannel.mDeadline };
+         lChannel.mPending = false;
+      }
+
+      mStatistics.mFrames++;
+      mStatistics.mDeferred += lCount - lSelected;
+      mStatistics.mLastUsedUs = lUsedUs;
+      lLock.unlock();
+
+
+      // write updates
+      int lWritten = 0;
+      for(size_t i = 0; i < lSelected; i++)
+      {
+         const Update& lUpdate = mBatch[i];
+
+         try
+         {
+            mDevices[lUpdate.mChannel / PCA9685_CHANNEL_COUNT]->setPWM(lUpdate.mChannel % PCA9685_CHANNEL_COUNT,
+                                                                     lUpdate.mOnValue, lUpdate.mOffValue);
+         }
+         catch(const std::exception& e)
+         {
+            lLock.lock();
+            mStatistics.mErrors++;
+            lLock.unlock();
+
+            if(mErrorCallback)
+               mErrorCallback(lUpdate.mChannel, e.what());
+            continue;
+         }
+
+         Clock::duration lLatency = mpClock->now() - lUpdate.mSubmitted;
+         double lLatencyUs = std::chrono::duration<double, std::micro>(lLatency).count();
+
+         lLock.lock();
+         Channel& lChannel = mChannels[lUpdate.mChannel];
+         lChannel.mMaxLatencyUs = fmax(lChannel.mMaxLatencyUs, lLatencyUs);
+         mStatistics.mWritten++;
+         if(lLatency > lUpdate.mDeadline)
+            mStatistics.mDeadlineMisses++;
+         lLock.unlock();
+
+         lWritten++;
+      }
+
+      return lWritten;
+   }
+
+
+   void BusScheduler::emergencyStop()
+   {
+      // stop bytes first, a failing device must not delay the others
+      std::string lErrors;
+      for(PCA9685* lpDevice : mDevices)
+      {
+         try
+         {
+            lpDevice->emergencyStop();
+         }
+         catch(const std::runtime_error& e)
+         {
+            lErrors += (lErrors.empty() ? "" : "; ") + std::string(e.what());
+         }
+      }
+
+      {
+         std::lock_guard<std::mutex> lLock(mMutex);
+         for(Channel& lChannel : mChannels)
+         {
+            lChannel.mPending = false;
+         }
+      }
+
+      if(!lErrors.empty())
+      {
+         throw std::runtime_error("Emergency stop failed: " + lErrors);
+      }
+   }
+
+
+   void BusScheduler::start()
+   {
+      this->stop();
+
+      mRunning = true;
+      mThread = std::thread(&BusScheduler::run, this);
+   }
+
+
+   void BusScheduler::stop()
+   {
+      mRunning = false;
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+   }
+
+
+   BusScheduler::Statistics BusScheduler::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mStatistics;
+   }
+
+
+   double BusScheduler::maxLatency(int aChannel)
+   {
+      this->checkChannel(aChannel);
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mChannels[aChannel].mMaxLatencyUs;
+   }
+
+
+   void BusScheduler::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void BusScheduler::setClock(DriverClock& arClock)
+   {
+      mpClock = &arClock;
+   }
+
+
+   double BusScheduler::transactionCost(size_t aDataBytes) const
+   {
+      double lBits = (aDataBytes + HEADER_BYTES) * BITS_PER_BYTE + BITS_START_STOP;
+      return mOverheadUs + lBits * 1000000.0 / mBusClock;
+   }
+
+
+   void BusScheduler::checkChannel(int aChannel) const
+   {
+      if(aChannel < 0 || aChannel >= static_cast<int>(mChannels.size()))
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                                "\" (has to be between 0 and " + std::to_string(mChannels.size()) + ")");
+      }
+   }
+
+
+   void BusScheduler::updateBudget()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mStatistics.mBudgetUs = std::chrono::duration<double, std::micro>(mPeriod).count() * mUtilization;
+   }
+
+
+   void BusScheduler::run()
+   {
+      C4T_TRACE_THREAD("bus scheduler");
+
+      Clock::time_point lNext = mpClock->now();
+
+      while(mRunning)
+      {
+         this->runFrame();
+
+         // pace to the PWM period, skip frames if we fell behind
+         lNext += mPeriod;
+         Clock::time_point lNow = mpClock->now();
+         if(lNext < lNow)
+            lNext = lNow;
+
+         mpClock->sleepUntil(lNext);
+      }
+   }
+} // namespace CAR4TEGRA
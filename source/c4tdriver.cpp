@@ -0,0 +1,316 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file c4tdriver.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of the C API of the Car4Tegra driver library
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/c4tdriver.h"
+#include "include/pca9685.hpp"
+#include "include/simulatedi2cdevice.hpp"
+
+
+/**
+ * @brief Device behind a C API handle
+ */
+struct c4t_device
+{
+   std::unique_ptr<CAR4TEGRA::PCA9685> mpDriver;   ///< PCA9685 driver
+};
+
+
+namespace
+{
+   thread_local std::string gLastError;   ///< Message of the last failed call of the thread
+
+
+   /**
+    * @brief Stores an error message and returns its code
+    *
+    * @param[in]  aCode          Error code
+    * @param[in]  apMessage      Error message
+    *
+    * @return Error code
+    */
+   int fail(int aCode, const char* apMessage)
+   {
+      try
+      {
+         gLastError = apMessage;
+      }
+      catch(const std::bad_alloc&)
+      {
+         gLastError.clear();
+      }
+
+      return aCode;
+   }
+
+
+   /**
+    * @brief Runs a driver call and maps its exceptions to error codes
+    *
+    * @param[in]  apDevice       Device handle
+    * @param[in]  aCall          Driver call
+    *
+    * @return C4T_OK or error code
+    */
+   template<typename Call>
+   int guarded(c4t_device* apDevice, Call aCall)
+   {
+      if(apDevice == nullptr)
+      {
+         return fail(C4T_ERROR_ARGUMENT, "Invalid device handle");
+      }
+
+      try
+      {
+         aCall(*apDevice->mpDriver);
+         return C4T_OK;
+      }
+      catch(const std::range_error& e)
+      {
+         return fail(C4T_ERROR_RANGE, e.what());
+      }
+      catch(const std::bad_alloc&)
+      {
+         return fail(C4T_ERROR_MEMORY, "Out of memory");
+      }
+      catch(const std::exception& e)
+      {
+         return fail(C4T_ERROR_IO, e.what());
+      }
+      catch(...)
+      {
+         return fail(C4T_ERROR_IO, "Unknown error");
+      }
+   }
+
+
+   /**
+    * @brief Creates a handle and opens its device
+    *
+    * @param[in]  apDevice       I2C device used for all transfers
+    * @param[in]  apBusName      Name of the I2C bus
+    * @param[in]  aAddress       Address of the PCA9685 device
+    * @param[out] appDevice      Device handle
+    *
+    * @return C4T_OK or error code
+    */
+   int open(std::unique_ptr<CAR4TEGRA::I2cDevice> apDevice, const char* apBusName, int aAddress,
+            c4t_device** appDevice)
+   {
+      if(apBusName == nullptr || appDevice == nullptr)
+      {
+         return fail(C4T_ERROR_ARGUMENT, "Invalid bus name or handle pointer");
+      }
+
+      *appDevice = nullptr;
+
+      std::unique_ptr<c4t_device> lpHandle(new c4t_device{ std::make_unique<CAR4TEGRA::PCA9685>(std::move(apDevice)) });
+      int lRes = guarded(lpHandle.get(), [apBusName, aAddress](CAR4TEGRA::PCA9685& arDriver)
+      {
+         arDriver.openDevice(apBusName, aAddress);
+      });
+
+      if(lRes == C4T_OK)
+      {
+         *appDevice = lpHandle.release();
+      }
+
+      return lRes;
+   }
+} // namespace
+
+
+unsigned c4t_api_version(void)
+{
+   return C4T_API_VERSION;
+}
+
+
+const char* c4t_last_error(void)
+{
+   return gLastError.c_str();
+}
+
+
+int c4t_open(const char* apBusName, int aAddress, c4t_device** appDevice)
+{
+   try
+   {
+      return open(std::make_unique<CAR4TEGRA::I2cDevice>(), apBusName, aAddress, appDevice);
+   }
+   catch(const std::bad_alloc&)
+   {
+      return fail(C4T_ERROR_MEMORY, "Out of memory");
+   }
+}
+
+
+int c4t_open_simulated(const char* apBusName, int aAddress, c4t_device** appDevice)
+{
+   try
+   {
+      return open(std::make_unique<CAR4TEGRA::SimulatedI2cDevice>(), apBusName, aAddress, appDevice);
+   }
+   catch(const std::bad_alloc&)
+   {
+      return fail(C4T_ERROR_MEMORY, "Out of memory");
+   }
+}
+
+
+void c4t_close(c4t_device* apDevice)
+{
+   // the driver closes its bus on destruction, a failing close must not escape
+   guarded(apDevice, [](CAR4TEGRA::PCA9685& arDriver) { arDriver.close(); });
+   delete apDevice;
+}
+
+
+int c4t_connect(c4t_device* apDevice, float aFrequency, int* apAdopted)
+{
+   return guarded(apDevice, [aFrequency, apAdopted](CAR4TEGRA::PCA9685& arDriver)
+   {
+      bool lAdopted = arDriver.fastConnect(aFrequency);
+      if(apAdopted != nullptr)
+         *apAdopted = lAdopted ? 1 : 0;
+   });
+}
+
+
+int c4t_reconnect(c4t_device* apDevice, int* apKept)
+{
+   return guarded(apDevice, [apKept](CAR4TEGRA::PCA9685& arDriver)
+   {
+      bool lKept = arDriver.reconnect();
+      if(apKept != nullptr)
+         *apKept = lKept ? 1 : 0;
+   });
+}
+
+
+int c4t_set_frequency(c4t_device* apDevice, float aFrequency)
+{
+   return guarded(apDevice, [aFrequency](CAR4TEGRA::PCA9685& arDriver) { arDriver.setPWMFrequency(aFrequency); });
+}
+
+
+int c4t_set_bus_timing(c4t_device* apDevice, uint32_t aBusClock, double aOverheadUs)
+{
+   return guarded(apDevice, [aBusClock, aOverheadUs](CAR4TEGRA::PCA9685& arDriver)
+   {
+      arDriver.setBusTiming(aBusClock, aOverheadUs);
+   });
+}
+
+
+int c4t_set_pwm(c4t_device* apDevice, int aChannel, int aOnValue, int aOffValue)
+{
+   return guarded(apDevice, [aChannel, aOnValue, aOffValue](CAR4TEGRA::PCA9685& arDriver)
+   {
+      arDriver.setPWM(aChannel, aOnValue, aOffValue);
+   });
+}
+
+
+int c4t_set_pwm_batch(c4t_device* apDevice, uint16_t aChannelMask, const uint16_t* apOnValues,
+                      const uint16_t* apOffValues)
+{
+   if(apOnValues == nullptr || apOffValues == nullptr)
+   {
+      return fail(C4T_ERROR_ARGUMENT, "Invalid value array");
+   }
+
+   return guarded(apDevice, [aChannelMask, apOnValues, apOffValues](CAR4TEGRA::PCA9685& arDriver)
+   {
+      arDriver.setPWMBatch(aChannelMask, apOnValues, apOffValues);
+   });
+}
+
+
+int c4t_set_all_pwm(c4t_device* apDevice, int aOnValue, int aOffValue)
+{
+   return guarded(apDevice, [aOnValue, aOffValue](CAR4TEGRA::PCA9685& arDriver) { arDriver.setAllPWM(aOnValue, aOffValue); });
+}
+
+
+int c4t_stop_outputs(c4t_device* apDevice, uint16_t aChannelMask)
+{
+   return guarded(apDevice, [aChannelMask](CAR4TEGRA::PCA9685& arDriver) { arDriver.stopOutputs(aChannelMask); });
+}
+
+
+int c4t_enable_outputs(c4t_device* apDevice, uint16_t aChannelMask)
+{
+   return guarded(apDevice, [aChannelMask](CAR4TEGRA::PCA9685& arDriver) { arDriver.enableOutputs(aChannelMask); });
+}
+
+
+int c4t_emergency_stop(c4t_device* apDevice)
+{
+   return guarded(apDevice, [](CAR4TEGRA::PCA9685& arDriver) { arDriver.emergencyStop(); });
+}
+
+
+int c4t_stopped_outputs(c4t_device* apDevice, uint16_t* apChannelMask)
+{
+   if(apChannelMask == nullptr)
+   {
+      return fail(C4T_ERROR_ARGUMENT, "Invalid channel mask pointer");
+   }
+
+   return guarded(apDevice, [apChannelMask](CAR4TEGRA::PCA9685& arDriver) { *apChannelMask = arDriver.stoppedOutputs(); });
+}
+
+
+int c4t_read_register(c4t_device* apDevice, int aRegister, int* apValue)
+{
+   if(apValue == nullptr)
+   {
+      return fail(C4T_ERROR_ARGUMENT, "Invalid value pointer");
+   }
+
+   return guarded(apDevice, [aRegister, apValue](CAR4TEGRA::PCA9685& arDriver) { *apValue = arDriver.readRegister(aRegister); });
+}
+
+
+int c4t_write_register(c4t_device* apDevice, int aRegister, int aValue)
+{
+   return guarded(apDevice, [aRegister, aValue](CAR4TEGRA::PCA9685& arDriver) { arDriver.writeRegister(aRegister, aValue); });
+}
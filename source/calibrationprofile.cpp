@@ -0,0 +1,252 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file calibrationprofile.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class CalibrationProfile at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/calibrationprofile.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const float FREQUENCY_MIN = 24.0f;    ///< Minimum PWM frequency (Hz)
+      const float FREQUENCY_MAX = 1526.0f;  ///< Maximum PWM frequency (Hz)
+      const int PWM_VALUE_MAX = 4095;       ///< Maximum PWM value
+
+
+      /**
+       * @brief Converts a token to an integer
+       *
+       * @param[in]  acrToken       Token
+       * @param[out] arValue        Value
+       *
+       * @return `true` if the whole token is an integer
+       */
+      bool toInteger(const std::string& acrToken, int& arValue)
+      {
+         char* lpEnd = nullptr;
+         long lValue = strtol(acrToken.c_str(), &lpEnd, 10);
+         if(acrToken.empty() || *lpEnd != '\0' || lValue < -100000 || lValue > 100000)
+            return false;
+
+         arValue = static_cast<int>(lValue);
+         return true;
+      }
+   } // namespace
+
+
+   CalibrationProfile::CalibrationProfile()
+      : mFrequency(0.0f)
+   {
+      mChannels.fill(ChannelCalibration{ false, 0, PWM_VALUE_MAX, false });
+   }
+
+
+   CalibrationProfile CalibrationProfile::load(const std::string& acrFileName)
+   {
+      std::ifstream lFile(acrFileName);
+      if(!lFile)
+      {
+         int lErrno = errno;
+         throw std::runtime_error("Failed to open profile \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      std::ostringstream lText;
+      lText << lFile.rdbuf();
+      return CalibrationProfile::parse(lText.str(), acrFileName);
+   }
+
+
+   CalibrationProfile CalibrationProfile::parse(const std::string& acrText, const std::string& acrSource)
+   {
+      CalibrationProfile lProfile;
+      std::istringstream lLines(acrText);
+      std::string lLine;
+
+      for(int lNumber = 1; std::getline(lLines, lLine); lNumber++)
+      {
+         // comments run to the end of the line
+         std::istringstream lTokens(lLine.substr(0, lLine.find('#')));
+         std::string lKeyword;
+         if(!(lTokens >> lKeyword))
+            continue;
+
+         std::string lError;
+         if(lKeyword == "frequency")
+         {
+            std::string lValue;
+            char* lpEnd = nullptr;
+            float lFrequency = (lTokens >> lValue) ? strtof(lValue.c_str(), &lpEnd) : 0.0f;
+            if(lpEnd == nullptr || *lpEnd != '\0' || !(lFrequency >= FREQUENCY_MIN && lFrequency <= FREQUENCY_MAX))
+               lError = "frequency has to be between 24 and 1526 Hz";
+            else
+               lProfile.mFrequency = lFrequency;
+         }
+         else if(lKeyword == "channel")
+         {
+            std::string lIndex, lMin, lMax, lFlag;
+            ChannelCalibration lCalibration = { true, 0, 0, false };
+            int lChannel = 0;
+
+            if(!(lTokens >> lIndex >> lMin >> lMax) || !toInteger(lIndex, lChannel) ||
+               !toInteger(lMin, lCalibration.mMin) || !toInteger(lMax, lCalibration.mMax))
+               lError = "expected \"channel <index> <min> <max> [inverted]\"";
+            else if(lChannel < 0 || lChannel >= PCA9685_CHANNEL_COUNT)
+               lError = "channel has to be between 0 and 15";
+            else if(lProfile.mChannels[lChannel].mUsed)
+               lError = "channel " + std::to_string(lChannel) + " is already defined";
+            else if(lCalibration.mMin < 0 || lCalibration.mMax > PWM_VALUE_MAX || lCalibration.mMin >= lCalibration.mMax)
+               lError = "range has to be 0 <= min < max <= 4095";
+            else if(lTokens >> lFlag && lFlag != "inverted")
+               lError = "unknown flag \"" + lFlag + "\"";
+            else
+            {
+               lCalibration.mInverted = (lFlag == "inverted");
+               lProfile.mChannels[lChannel] = lCalibration;
+            }
+         }
+         else
+         {
+            lError = "unknown keyword \"" + lKeyword + "\"";
+         }
+
+         std::string lRest;
+         if(lError.empty() && lTokens >> lRest)
+            lError = "unexpected \"" + lRest + "\"";
+
+         if(!lError.empty())
+         {
+            throw std::runtime_error("Invalid line " + std::to_string(lNumber) + " of profile \"" +
+                                     acrSource + "\": " + lError);
+         }
+      }
+
+      return lProfile;
+   }
+
+
+   void CalibrationProfile::setFrequency(float aFrequency)
+   {
+      if(aFrequency != 0.0f && !(aFrequency >= FREQUENCY_MIN && aFrequency <= FREQUENCY_MAX))
+      {
+         throw std::range_error("Invalid frequency \"" + std::to_string(aFrequency) +
+                                "\" (has to be between 24 and 1526 or 0)");
+      }
+
+      mFrequency = aFrequency;
+   }
+
+
+   float CalibrationProfile::frequency() const
+   {
+      return mFrequency;
+   }
+
+
+   void CalibrationProfile::setChannel(int aChannel, const ChannelCalibration& acrCalibration)
+   {
+      CalibrationProfile::checkChannel(aChannel);
+
+      if(acrCalibration.mUsed &&
+         (acrCalibration.mMin < 0 || acrCalibration.mMax > PWM_VALUE_MAX || acrCalibration.mMin >= acrCalibration.mMax))
+      {
+         throw std::range_error("Invalid range \"" + std::to_string(acrCalibration.mMin) + " - " +
+                                std::to_string(acrCalibration.mMax) + "\" of channel " + std::to_string(aChannel) +
+                                " (has to be 0 <= min < max <= 4095)");
+      }
+
+      mChannels[aChannel] = acrCalibration;
+   }
+
+
+   const ChannelCalibration& CalibrationProfile::channel(int aChannel) const
+   {
+      CalibrationProfile::checkChannel(aChannel);
+      return mChannels[aChannel];
+   }
+
+
+   int CalibrationProfile::toPWM(int aChannel, double aPosition) const
+   {
+      const ChannelCalibration& lcrCalibration = this->channel(aChannel);
+
+      double lPosition = std::min(std::max(aPosition, -1.0), 1.0);
+      if(lcrCalibration.mInverted)
+         lPosition = -lPosition;
+
+      double lCenter = (lcrCalibration.mMin + lcrCalibration.mMax) / 2.0;
+      double lScale = (lcrCalibration.mMax - lcrCalibration.mMin) / 2.0;
+      return static_cast<int>(std::lround(lCenter + lPosition * lScale));
+   }
+
+
+   uint16_t CalibrationProfile::changedChannels(const CalibrationProfile& acrOther) const
+   {
+      uint16_t lChanged = 0;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         const ChannelCalibration& lcrOld = mChannels[lChannel];
+         const ChannelCalibration& lcrNew = acrOther.mChannels[lChannel];
+
+         // ranges of unused channels do not matter
+         if(lcrOld.mUsed != lcrNew.mUsed ||
+            (lcrOld.mUsed && (lcrOld.mMin != lcrNew.mMin || lcrOld.mMax != lcrNew.mMax || lcrOld.mInverted != lcrNew.mInverted)))
+         {
+            lChanged |= static_cast<uint16_t>(1 << lChannel);
+         }
+      }
+
+      return lChanged;
+   }
+
+
+   void CalibrationProfile::checkChannel(int aChannel)
+   {
+      if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) + "\" (has to be between 0 and 15)");
+      }
+   }
+} // namespace CAR4TEGRA
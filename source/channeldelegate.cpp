@@ -0,0 +1,175 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file channeldelegate.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class ChannelDelegate
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// QT includes
+#include <QApplication>
+#include <QPainter>
+#include <QSpinBox>
+#include <QStyleOptionProgressBar>
+
+// std includes
+#include <algorithm>
+
+// internal includes
+#include "include/channeldelegate.hpp"
+#include "include/channelmodel.hpp"
+
+
+namespace
+{
+   const int MARKER_SIZE = 8;    ///< Size of the status marker (px)
+   const int CELL_MARGIN = 2;    ///< Margin inside the painted cells (px)
+} // namespace
+
+
+ChannelDelegate::ChannelDelegate(QObject* apParent)
+   : QStyledItemDelegate(apParent)
+{
+}
+
+
+void ChannelDelegate::paint(QPainter* apPainter, const QStyleOptionViewItem& acrOption, const QModelIndex& acrIndex) const
+{
+   switch(acrIndex.column())
+   {
+      case ChannelModel::COLUMN_VALUE:
+      {
+         // value as bar within the calibration range
+         QStyleOptionProgressBar lBar;
+         lBar.rect = acrOption.rect.adjusted(CELL_MARGIN, CELL_MARGIN, -CELL_MARGIN, -CELL_MARGIN);
+         lBar.state = acrOption.state;
+         lBar.minimum = acrIndex.sibling(acrIndex.row(), ChannelModel::COLUMN_MIN).data(Qt::EditRole).toInt();
+         lBar.maximum = acrIndex.sibling(acrIndex.row(), ChannelModel::COLUMN_MAX).data(Qt::EditRole).toInt();
+         lBar.progress = std::min(std::max(acrIndex.data(Qt::EditRole).toInt(), lBar.minimum), lBar.maximum);
+         lBar.text = acrIndex.data(Qt::DisplayRole).toString();
+         lBar.textVisible = true;
+         lBar.invertedAppearance = (acrIndex.sibling(acrIndex.row(), ChannelModel::COLUMN_INVERT)
+                                    .data(Qt::CheckStateRole).toInt() == Qt::Checked);
+
+         QApplication::style()->drawControl(QStyle::CE_ProgressBar, &lBar, apPainter);
+         return;
+      }
+
+      case ChannelModel::COLUMN_STATUS:
+      {
+         // colored marker in front of the status text
+         QColor lColor = Qt::gray;
+         switch(acrIndex.data(ChannelModel::StatusRole).toInt())
+         {
+            case ChannelModel::STATUS_OK:    lColor = Qt::darkGreen; break;
+            case ChannelModel::STATUS_ERROR: lColor = Qt::red;       break;
+            default:                         break;
+         }
+
+         QRect lMarker(acrOption.rect.left() + CELL_MARGIN, acrOption.rect.center().y() - MARKER_SIZE / 2,
+                       MARKER_SIZE, MARKER_SIZE);
+
+         apPainter->save();
+         apPainter->setRenderHint(QPainter::Antialiasing);
+         apPainter->setPen(Qt::NoPen);
+         apPainter->setBrush(lColor);
+         apPainter->drawEllipse(lMarker);
+         apPainter->restore();
+
+         QStyleOptionViewItem lText(acrOption);
+         lText.rect.setLeft(lMarker.right() + 2 * CELL_MARGIN);
+         QStyledItemDelegate::paint(apPainter, lText, acrIndex);
+         return;
+      }
+
+      default:
+         break;
+   }
+
+   QStyledItemDelegate::paint(apPainter, acrOption, acrIndex);
+}
+
+
+QWidget* ChannelDelegate::createEditor(QWidget* apParent, const QStyleOptionViewItem& acrOption,
+                                       const QModelIndex& acrIndex) const
+{
+   int lMin = acrIndex.sibling(acrIndex.row(), ChannelModel::COLUMN_MIN).data(Qt::EditRole).toInt();
+   int lMax = acrIndex.sibling(acrIndex.row(), ChannelModel::COLUMN_MAX).data(Qt::EditRole).toInt();
+
+   QSpinBox* lpSpinBox = nullptr;
+   switch(acrIndex.column())
+   {
+      case ChannelModel::COLUMN_MIN:
+         lpSpinBox = new QSpinBox(apParent);
+         lpSpinBox->setRange(0, lMax - 1);
+         break;
+
+      case ChannelModel::COLUMN_MAX:
+         lpSpinBox = new QSpinBox(apParent);
+         lpSpinBox->setRange(lMin + 1, 4095);
+         break;
+
+      case ChannelModel::COLUMN_VALUE:
+         lpSpinBox = new QSpinBox(apParent);
+         lpSpinBox->setRange(lMin, lMax);
+         break;
+
+      default:
+         return QStyledItemDelegate::createEditor(apParent, acrOption, acrIndex);
+   }
+
+   lpSpinBox->setFrame(false);
+   return lpSpinBox;
+}
+
+
+void ChannelDelegate::setEditorData(QWidget* apEditor, const QModelIndex& acrIndex) const
+{
+   QSpinBox* lpSpinBox = qobject_cast<QSpinBox*>(apEditor);
+   if(lpSpinBox == nullptr)
+   {
+      QStyledItemDelegate::setEditorData(apEditor, acrIndex);
+      return;
+   }
+
+   lpSpinBox->setValue(acrIndex.data(Qt::EditRole).toInt());
+}
+
+
+void ChannelDelegate::setModelData(QWidget* apEditor, QAbstractItemModel* apModel, const QModelIndex& acrIndex) const
+{
+   QSpinBox* lpSpinBox = qobject_cast<QSpinBox*>(apEditor);
+   if(lpSpinBox == nullptr)
+   {
+      QStyledItemDelegate::setModelData(apEditor, apModel, acrIndex);
+      return;
+   }
+
+   lpSpinBox->interpretText();
+   apModel->setData(acrIndex, lpSpinBox->value(), Qt::EditRole);
+}
@@ -0,0 +1,398 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file channelmodel.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class ChannelModel
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+// internal includes
+#include "include/channelmodel.hpp"
+
+
+ChannelModel::ChannelModel(int aFrameMs, QObject* apParent)
+   : QAbstractTableModel(apParent), mDirtyFirst(0), mDirtyLast(-1)
+{
+   connect(&mTimer, &QTimer::timeout, this, &ChannelModel::flush);
+   mTimer.start(aFrameMs);
+}
+
+
+int ChannelModel::addBoard(CAR4TEGRA::PCA9685& arDriver, WriteCallback aCallback)
+{
+   int lBoard = static_cast<int>(mBoards.size());
+   int lFirst = static_cast<int>(mRows.size());
+
+   this->beginInsertRows(QModelIndex(), lFirst, lFirst + PCA9685_CHANNEL_COUNT - 1);
+
+   // full range, not inverted
+   mBoards.push_back(&arDriver);
+   mWriteCallbacks.push_back(aCallback);
+   mCalibrations.push_back(CAR4TEGRA::CalibrationProfile());
+   for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+   {
+      mRows.push_back(Row{ lBoard, lChannel, 0, false, false, 0 });
+   }
+
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mPending.resize(mRows.size(), Pending{ false, 0, false, 0 });
+   }
+
+   this->endInsertRows();
+
+   return lBoard;
+}
+
+
+void ChannelModel::boardChanged(int aBoard)
+{
+   int lFirst = aBoard * PCA9685_CHANNEL_COUNT;
+   if(aBoard < 0 || lFirst >= static_cast<int>(mRows.size()))
+      return;
+
+   emit dataChanged(this->index(lFirst, 0), this->index(lFirst + PCA9685_CHANNEL_COUNT - 1, COLUMN_COUNT - 1));
+}
+
+
+void ChannelModel::updateValue(int aBoard, int aChannel, int aValue, bool aFailed)
+{
+   int lRow = aBoard * PCA9685_CHANNEL_COUNT + aChannel;
+
+   std::lock_guard<std::mutex> lLock(mMutex);
+   if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT || lRow < 0 || lRow >= static_cast<int>(mPending.size()))
+      return;
+
+   // only the newest value of a frame is shown
+   Pending& lPending = mPending[lRow];
+   lPending.mSet = true;
+   lPending.mValue = aValue;
+   lPending.mFailed = aFailed;
+   lPending.mErrors += aFailed ? 1 : 0;
+
+   mDirtyFirst = (mDirtyLast < 0) ? lRow : std::min(mDirtyFirst, lRow);
+   mDirtyLast = std::max(mDirtyLast, lRow);
+}
+
+
+void ChannelModel::setCalibration(int aBoard, int aChannel, const CAR4TEGRA::ChannelCalibration& acrCalibration)
+{
+   int lRow = aBoard * PCA9685_CHANNEL_COUNT + aChannel;
+   if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT || lRow < 0 || lRow >= static_cast<int>(mRows.size()))
+      return;
+
+   CAR4TEGRA::ChannelCalibration lCalibration = acrCalibration;
+   lCalibration.mUsed = true;
+   mCalibrations[aBoard].setChannel(aChannel, lCalibration);
+
+   emit dataChanged(this->index(lRow, COLUMN_MIN), this->index(lRow, COLUMN_VALUE));
+}
+
+
+const CAR4TEGRA::ChannelCalibration& ChannelModel::calibration(int aBoard, int aChannel) const
+{
+   return mCalibrations.at(aBoard).channel(aChannel);
+}
+
+
+int ChannelModel::rowCount(const QModelIndex& acrParent) const
+{
+   return acrParent.isValid() ? 0 : static_cast<int>(mRows.size());
+}
+
+
+int ChannelModel::columnCount(const QModelIndex& acrParent) const
+{
+   return acrParent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+
+QVariant ChannelModel::data(const QModelIndex& acrIndex, int aRole) const
+{
+   if(!acrIndex.isValid() || acrIndex.row() >= static_cast<int>(mRows.size()))
+      return QVariant();
+
+   const Row& lRow = mRows[acrIndex.row()];
+   const CAR4TEGRA::ChannelCalibration& lcrCalibration = mCalibrations[lRow.mBoard].channel(lRow.mChannel);
+   bool lOnline = !mBoards[lRow.mBoard]->busName().empty();
+
+   if(aRole == StatusRole)
+   {
+      return static_cast<int>(!lOnline ? STATUS_OFFLINE : (lRow.mFailed ? STATUS_ERROR : STATUS_OK));
+   }
+
+   if(aRole == Qt::CheckStateRole && acrIndex.column() == COLUMN_INVERT)
+   {
+      return static_cast<int>(lcrCalibration.mInverted ? Qt::Checked : Qt::Unchecked);
+   }
+
+   if(aRole != Qt::DisplayRole && aRole != Qt::EditRole)
+      return QVariant();
+
+   switch(acrIndex.column())
+   {
+      case COLUMN_BOARD:
+         return lOnline ? QString::fromStdString(mBoards[lRow.mBoard]->busName()) : QString("Board %1").arg(lRow.mBoard);
+
+      case COLUMN_CHANNEL:
+         return lRow.mChannel;
+
+      case COLUMN_MIN:
+         return lcrCalibration.mMin;
+
+      case COLUMN_MAX:
+         return lcrCalibration.mMax;
+
+      case COLUMN_VALUE:
+         return lRow.mValue;
+
+      case COLUMN_STATUS:
+         if(!lOnline)
+            return QString("offline");
+         return lRow.mErrors > 0 ? QString("%1 (%2 errors)").arg(lRow.mFailed ? "error" : "ok").arg(lRow.mErrors)
+                                 : QString("ok");
+
+      default:
+         break;
+   }
+
+   return QVariant();
+}
+
+
+bool ChannelModel::setData(const QModelIndex& acrIndex, const QVariant& acrValue, int aRole)
+{
+   if(!acrIndex.isValid() || acrIndex.row() >= static_cast<int>(mRows.size()))
+      return false;
+
+   const Row& lcrRow = mRows[acrIndex.row()];
+   CAR4TEGRA::ChannelCalibration lCalibration = mCalibrations[lcrRow.mBoard].channel(lcrRow.mChannel);
+   lCalibration.mUsed = true;
+
+   if(aRole == Qt::CheckStateRole && acrIndex.column() == COLUMN_INVERT)
+   {
+      lCalibration.mInverted = (acrValue.toInt() == Qt::Checked);
+      if(!this->editCalibration(acrIndex.row(), lCalibration))
+         return false;
+   }
+   else if(aRole == Qt::EditRole)
+   {
+      int lValue = std::min(std::max(acrValue.toInt(), 0), 4095);
+
+      switch(acrIndex.column())
+      {
+         case COLUMN_MIN:
+            lCalibration.mMin = std::min(lValue, lCalibration.mMax - 1);
+            if(!this->editCalibration(acrIndex.row(), lCalibration))
+               return false;
+            break;
+
+         case COLUMN_MAX:
+            lCalibration.mMax = std::max(lValue, lCalibration.mMin + 1);
+            if(!this->editCalibration(acrIndex.row(), lCalibration))
+               return false;
+            break;
+
+         case COLUMN_VALUE:
+            this->writeValue(acrIndex.row(), std::min(std::max(lValue, lCalibration.mMin), lCalibration.mMax));
+            break;
+
+         default:
+            return false;
+      }
+   }
+   else
+   {
+      return false;
+   }
+
+   emit dataChanged(this->index(acrIndex.row(), COLUMN_MIN), this->index(acrIndex.row(), COLUMN_STATUS));
+   emit channelEdited(lcrRow.mBoard, lcrRow.mChannel);
+   return true;
+}
+
+
+QVariant ChannelModel::headerData(int aSection, Qt::Orientation aOrientation, int aRole) const
+{
+   if(aOrientation != Qt::Horizontal || aRole != Qt::DisplayRole)
+      return QVariant();
+
+   switch(aSection)
+   {
+      case COLUMN_BOARD:   return QString("Board");
+      case COLUMN_CHANNEL: return QString("Channel");
+      case COLUMN_MIN:     return QString("Min");
+      case COLUMN_MAX:     return QString("Max");
+      case COLUMN_INVERT:  return QString("Invert");
+      case COLUMN_VALUE:   return QString("Value");
+      case COLUMN_STATUS:  return QString("Status");
+      default:             break;
+   }
+
+   return QVariant();
+}
+
+
+Qt::ItemFlags ChannelModel::flags(const QModelIndex& acrIndex) const
+{
+   if(!acrIndex.isValid())
+      return Qt::NoItemFlags;
+
+   switch(acrIndex.column())
+   {
+      case COLUMN_MIN:
+      case COLUMN_MAX:
+         return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+
+      case COLUMN_INVERT:
+         return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+
+      case COLUMN_VALUE:
+      {
+         // values can only be written to connected boards
+         bool lOnline = !mBoards[mRows[acrIndex.row()].mBoard]->busName().empty();
+         return Qt::ItemIsEnabled | Qt::ItemIsSelectable | (lOnline ? Qt::ItemIsEditable : Qt::NoItemFlags);
+      }
+
+      default:
+         break;
+   }
+
+   return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+
+void ChannelModel::flush()
+{
+   int lFirst = 0;
+   int lLast = -1;
+
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      lFirst = mDirtyFirst;
+      lLast = mDirtyLast;
+
+      for(int i = lFirst; i <= lLast; i++)
+      {
+         Pending& lPending = mPending[i];
+         if(!lPending.mSet)
+            continue;
+
+         mRows[i].mValue = lPending.mValue;
+         mRows[i].mWritten = true;
+         mRows[i].mFailed = lPending.mFailed;
+         mRows[i].mErrors += lPending.mErrors;
+         lPending = Pending{ false, 0, false, 0 };
+      }
+
+      mDirtyLast = -1;
+   }
+
+   // one notification for all rows changed in this frame
+   if(lLast >= lFirst)
+   {
+      emit dataChanged(this->index(lFirst, COLUMN_VALUE), this->index(lLast, COLUMN_STATUS));
+   }
+}
+
+
+void ChannelModel::writeValue(int aRow, int aValue)
+{
+   Row& lRow = mRows[aRow];
+
+   // the owner of the board writes the value and reports it with updateValue()
+   if(mWriteCallbacks[lRow.mBoard])
+   {
+      mWriteCallbacks[lRow.mBoard](lRow.mChannel, aValue);
+      return;
+   }
+
+   try
+   {
+      mBoards[lRow.mBoard]->setPWM(lRow.mChannel, 0, aValue);
+      lRow.mValue = aValue;
+      lRow.mWritten = true;
+      lRow.mFailed = false;
+   }
+   catch(const std::runtime_error e)
+   {
+      lRow.mFailed = true;
+      lRow.mErrors++;
+      emit writeFailed(QLatin1String(e.what()));
+   }
+   catch(const std::exception e)
+   {
+      lRow.mFailed = true;
+      lRow.mErrors++;
+      emit writeFailed(QLatin1String(e.what()));
+   }
+}
+
+
+bool ChannelModel::editCalibration(int aRow, const CAR4TEGRA::ChannelCalibration& acrCalibration)
+{
+   const Row& lcrRow = mRows[aRow];
+   CAR4TEGRA::CalibrationProfile& lrProfile = mCalibrations[lcrRow.mBoard];
+   const CAR4TEGRA::ChannelCalibration lOld = lrProfile.channel(lcrRow.mChannel);
+
+   // position of the current value with the old calibration
+   double lPosition = (2.0 * lcrRow.mValue - lOld.mMin - lOld.mMax) / (lOld.mMax - lOld.mMin);
+   if(lOld.mInverted)
+      lPosition = -lPosition;
+
+   try
+   {
+      lrProfile.setChannel(lcrRow.mChannel, acrCalibration);
+   }
+   catch(const std::range_error e)
+   {
+      emit writeFailed(QLatin1String(e.what()));
+      return false;
+   }
+
+   // only values written before are rewritten, only to connected boards
+   if(!lcrRow.mWritten || mBoards[lcrRow.mBoard]->busName().empty())
+      return true;
+
+   // a changed direction keeps the position, a changed range only limits the value
+   int lValue = (acrCalibration.mInverted != lOld.mInverted)
+                ? lrProfile.toPWM(lcrRow.mChannel, lPosition)
+                : std::min(std::max(lcrRow.mValue, acrCalibration.mMin), acrCalibration.mMax);
+
+   if(lValue != lcrRow.mValue)
+   {
+      this->writeValue(aRow, lValue);
+   }
+
+   return true;
+}
@@ -0,0 +1,131 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file driverclock.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of the clock classes at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <stdexcept>
+#include <thread>
+
+// Car4Tegra includes
+#include "include/driverclock.hpp"
+
+
+namespace CAR4TEGRA
+{
+   DriverClock::~DriverClock()
+   {
+   }
+
+
+   DriverClock& DriverClock::monotonic()
+   {
+      static MonotonicClock lsClock;
+      return lsClock;
+   }
+
+
+   DriverClock::TimePoint MonotonicClock::now()
+   {
+      return std::chrono::steady_clock::now();
+   }
+
+
+   void MonotonicClock::sleepFor(Duration aDuration)
+   {
+      std::this_thread::sleep_for(aDuration);
+   }
+
+
+   void MonotonicClock::sleepUntil(TimePoint aTime)
+   {
+      std::this_thread::sleep_until(aTime);
+   }
+
+
+   VirtualClock::VirtualClock(TimePoint aStart)
+      : mStart(aStart.time_since_epoch().count()), mNow(mStart), mSleeps(0)
+   {
+   }
+
+
+   DriverClock::TimePoint VirtualClock::now()
+   {
+      return TimePoint(Duration(mNow.load()));
+   }
+
+
+   void VirtualClock::sleepFor(Duration aDuration)
+   {
+      mSleeps++;
+      if(aDuration > Duration::zero())
+         mNow += aDuration.count();
+   }
+
+
+   void VirtualClock::sleepUntil(TimePoint aTime)
+   {
+      mSleeps++;
+      this->moveTo(aTime.time_since_epoch().count());
+   }
+
+
+   void VirtualClock::advance(Duration aDuration)
+   {
+      if(aDuration < Duration::zero())
+      {
+         throw std::range_error("Invalid time span (virtual time can not go backwards)");
+      }
+
+      mNow += aDuration.count();
+   }
+
+
+   DriverClock::Duration VirtualClock::elapsed() const
+   {
+      return Duration(mNow.load() - mStart);
+   }
+
+
+   uint64_t VirtualClock::sleeps() const
+   {
+      return mSleeps;
+   }
+
+
+   void VirtualClock::moveTo(Duration::rep aTicks)
+   {
+      Duration::rep lNow = mNow.load();
+      while(lNow < aTicks && !mNow.compare_exchange_weak(lNow, aTicks))
+      {
+      }
+   }
+} // namespace CAR4TEGRA
@@ -33,7 +33,9 @@
 
 // std includes
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -41,15 +43,18 @@
 #include <stdexcept>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <thread>
 
 // Car4Tegra includes
 #include "include/i2cdevice.hpp"
+#include "include/tracerecorder.hpp"
+#include "include/spantracer.hpp"
 
 
 namespace CAR4TEGRA
 {
    I2cDevice::I2cDevice()
-      : mI2CBus(-1), mDevAddress(0x00)
+      : mI2CBus(-1), mDevAddress(0x00), mBusNumber(0), mpRecorder(nullptr), mConcurrentBus(-1), mConcurrentUsers(0)
    {
       // nothing to do
    }
@@ -63,10 +68,15 @@ namespace CAR4TEGRA
 
    void I2cDevice::openBus(const std::string& acrBusName)
    {
+      this->closeConcurrent();
       mI2CBusName = acrBusName;
 
+      // bus number for tracing (format: "/dev/i2c-0")
+      size_t lPos = mI2CBusName.find_last_of('-');
+      mBusNumber = (lPos != std::string::npos) ? atoi(mI2CBusName.c_str() + lPos + 1) : 0;
+
       // try to open bus
-      if((mI2CBus = open(mI2CBusName.c_str(), O_RDWR)) < 0)
+      if((mI2CBus = this->busOpen(mI2CBusName)) < 0)
       {
          throw std::runtime_error("Failed to open I2C bus \"" + mI2CBusName +
                                   "\" (Error " + std::to_string(errno) +
@@ -77,7 +87,7 @@ namespace CAR4TEGRA
 
    void I2cDevice::openDevice(int aAddress)
    {
-      mDevAddress = aAddress;
+      this->closeConcurrent();
 
       // check if bus is open
       if(mI2CBus < 0)
@@ -86,12 +96,16 @@ namespace CAR4TEGRA
       }
 
       // try to open (address has to be shifted by 1 to remove r/w bit
-      if(ioctl(mI2CBus, I2C_SLAVE, mDevAddress / 2) < 0)
+      if(this->busSelect(mI2CBus, aAddress / 2) < 0)
       {
-         throw std::runtime_error("Failed to open I2C device \"" + std::to_string(mDevAddress) +
+         mDevAddress = 0x00;
+         throw std::runtime_error("Failed to open I2C device \"" + std::to_string(aAddress) +
                                   "\" (Error " + std::to_string(errno) +
                                   ": " + strerror(errno) + ")");
       }
+
+      mDevAddress = aAddress;
+      this->openConcurrent();
    }
 
 
@@ -104,9 +118,11 @@ namespace CAR4TEGRA
 
    void I2cDevice::closeBus()
    {
+      this->closeConcurrent();
+
       if(mI2CBus > 0)
       {
-         if(close(mI2CBus) < 0)
+         if(this->busClose(mI2CBus) < 0)
          {
             throw std::runtime_error("Failed to close I2C bus \"" + mI2CBusName +
                                      "\" (Error " + std::to_string(errno) +
@@ -135,15 +151,24 @@ namespace CAR4TEGRA
 
 
       // try to read
-      int lRes = i2c_smbus_read_byte_data(mI2CBus, aRegister);
+      int lRes = -1;
+      {
+         // register byte, repeated start with address, data byte
+         C4T_TRACE_SPAN_BYTES("syscall", "i2c read byte", 3);
+         lRes = this->busReadByte(mI2CBus, aRegister);
+      }
+      int lErrno = (lRes < 0) ? errno : 0;
+
+      uint8_t lValue = static_cast<uint8_t>(lRes);
+      this->trace(TraceRecorder::OP_READ_BYTE, aRegister, &lValue, (lRes < 0) ? 0 : 1, lRes, lErrno);
 
       // check if reading was succesfully
       if(lRes < 0)
       {
          throw std::runtime_error("Failed to read register \"" + std::to_string(aRegister) +
                                   "\" from I2C device \"" + std::to_string(mDevAddress) +
-                                  "\" (Error " + std::to_string(errno) +
-                                  ": " + strerror(errno) + ")");
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
       }
 
       return lRes;
@@ -166,7 +191,15 @@ namespace CAR4TEGRA
 
 
       // try to write
-      int lRes = i2c_smbus_write_byte_data(mI2CBus, aRegister, aValue);
+      int lRes = -1;
+      {
+         C4T_TRACE_SPAN_BYTES("syscall", "i2c write byte", 2);
+         lRes = this->busWriteByte(mI2CBus, aRegister, aValue);
+      }
+      int lErrno = (lRes < 0) ? errno : 0;
+
+      uint8_t lValue = static_cast<uint8_t>(aValue);
+      this->trace(TraceRecorder::OP_WRITE_BYTE, aRegister, &lValue, 1, lRes, lErrno);
 
       // check if writing was succesfully
       if(lRes < 0)
@@ -174,10 +207,252 @@ namespace CAR4TEGRA
          throw std::runtime_error("Failed to write register \"" + std::to_string(aRegister) +
                                   "\" from I2C device \"" + std::to_string(mDevAddress) +
                                   "\" with value \"" + std::to_string(aValue) +
-                                  "\" (Error " + std::to_string(errno) +
-                                  ": " + strerror(errno) + ")");
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      return lRes;
+   }
+
+
+   int I2cDevice::writeByteConcurrent(int aRegister, int aValue)
+   {
+      // announce the call before taking the descriptor, closeConcurrent() waits for it
+      mConcurrentUsers.fetch_add(1);
+      int lBus = mConcurrentBus.load();
+      if(lBus < 0)
+      {
+         mConcurrentUsers.fetch_sub(1);
+         throw std::runtime_error("Failed to write to I2C device: I2C device is not open");
+      }
+
+
+      // try to write (name, number and address of the bus do not change while the descriptor is published)
+      int lRes = -1;
+      {
+         C4T_TRACE_SPAN_BYTES("syscall", "i2c write byte", 2);
+         lRes = this->busWriteByte(lBus, aRegister, aValue);
+      }
+      int lErrno = (lRes < 0) ? errno : 0;
+
+      uint8_t lValue = static_cast<uint8_t>(aValue);
+      this->trace(TraceRecorder::OP_WRITE_BYTE, aRegister, &lValue, 1, lRes, lErrno);
+
+      int lAddress = mDevAddress;
+      mConcurrentUsers.fetch_sub(1);
+
+      // check if writing was succesfully
+      if(lRes < 0)
+      {
+         throw std::runtime_error("Failed to write register \"" + std::to_string(aRegister) +
+                                  "\" from I2C device \"" + std::to_string(lAddress) +
+                                  "\" with value \"" + std::to_string(aValue) +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
       }
 
       return lRes;
    }
+
+
+   int I2cDevice::readBlock(int aRegister, uint8_t* apBuffer, size_t aLength)
+   {
+      // check if bus is open
+      if(mI2CBus < 0)
+      {
+         throw std::runtime_error("Failed to read from I2C device: I2C bus is not open");
+      }
+
+      // check if device is open
+      if(mDevAddress == 0x00)
+      {
+         throw std::runtime_error("Failed to read from I2C device: I2C device is not open");
+      }
+
+      // check block length
+      if(aLength == 0 || aLength > BLOCK_SIZE_MAX)
+      {
+         throw std::range_error("Invalid block length \"" + std::to_string(aLength) +
+                                "\" (has to be between 1 and " + std::to_string(BLOCK_SIZE_MAX) + ")");
+      }
+
+
+      // combined transfer: write register pointer, repeated start, read data
+      uint8_t lRegister = static_cast<uint8_t>(aRegister);
+      struct i2c_msg lMsgs[2];
+      lMsgs[0].addr = static_cast<__u16>(mDevAddress / 2);
+      lMsgs[0].flags = 0;
+      lMsgs[0].len = 1;
+      lMsgs[0].buf = &lRegister;
+      lMsgs[1].addr = static_cast<__u16>(mDevAddress / 2);
+      lMsgs[1].flags = I2C_M_RD;
+      lMsgs[1].len = static_cast<__u16>(aLength);
+      lMsgs[1].buf = apBuffer;
+
+      int lRes = -1;
+      {
+         C4T_TRACE_SPAN_BYTES("syscall", "i2c read block", aLength + 2);
+         lRes = this->busTransfer(mI2CBus, lMsgs, 2);
+      }
+      int lErrno = (lRes < 0) ? errno : 0;
+
+      this->trace(TraceRecorder::OP_READ_BLOCK, aRegister, apBuffer, (lRes < 0) ? 0 : aLength, lRes, lErrno);
+
+      // check if reading was succesfully
+      if(lRes < 0)
+      {
+         throw std::runtime_error("Failed to read block of " + std::to_string(aLength) +
+                                  " registers at \"" + std::to_string(aRegister) +
+                                  "\" from I2C device \"" + std::to_string(mDevAddress) +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      return static_cast<int>(aLength);
+   }
+
+
+   int I2cDevice::writeBlock(int aRegister, const uint8_t* apData, size_t aLength)
+   {
+      // check if bus is open
+      if(mI2CBus < 0)
+      {
+         throw std::runtime_error("Failed to write to I2C device: I2C bus is not open");
+      }
+
+      // check if device is open
+      if(mDevAddress == 0x00)
+      {
+         throw std::runtime_error("Failed to write to I2C device: I2C device is not open");
+      }
+
+      // check block length
+      if(aLength == 0 || aLength > BLOCK_SIZE_MAX)
+      {
+         throw std::range_error("Invalid block length \"" + std::to_string(aLength) +
+                                "\" (has to be between 1 and " + std::to_string(BLOCK_SIZE_MAX) + ")");
+      }
+
+
+      // single message: register pointer followed by the data bytes
+      uint8_t lBuffer[BLOCK_SIZE_MAX + 1];
+      lBuffer[0] = static_cast<uint8_t>(aRegister);
+      memcpy(&lBuffer[1], apData, aLength);
+
+      struct i2c_msg lMsg;
+      lMsg.addr = static_cast<__u16>(mDevAddress / 2);
+      lMsg.flags = 0;
+      lMsg.len = static_cast<__u16>(aLength + 1);
+      lMsg.buf = lBuffer;
+
+      int lRes = -1;
+      {
+         C4T_TRACE_SPAN_BYTES("syscall", "i2c write block", aLength + 1);
+         lRes = this->busTransfer(mI2CBus, &lMsg, 1);
+      }
+      int lErrno = (lRes < 0) ? errno : 0;
+
+      this->trace(TraceRecorder::OP_WRITE_BLOCK, aRegister, apData, aLength, lRes, lErrno);
+
+      // check if writing was succesfully
+      if(lRes < 0)
+      {
+         throw std::runtime_error("Failed to write block of " + std::to_string(aLength) +
+                                  " registers at \"" + std::to_string(aRegister) +
+                                  "\" to I2C device \"" + std::to_string(mDevAddress) +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      return static_cast<int>(aLength);
+   }
+
+
+   void I2cDevice::setTraceRecorder(TraceRecorder* apRecorder)
+   {
+      mpRecorder = apRecorder;
+   }
+
+
+   int I2cDevice::busOpen(const std::string& acrBusName)
+   {
+      return open(acrBusName.c_str(), O_RDWR);
+   }
+
+
+   int I2cDevice::busClose(int aBus)
+   {
+      return close(aBus);
+   }
+
+
+   int I2cDevice::busSelect(int aBus, int aAddress)
+   {
+      return ioctl(aBus, I2C_SLAVE, aAddress);
+   }
+
+
+   int I2cDevice::busReadByte(int aBus, int aRegister)
+   {
+      return i2c_smbus_read_byte_data(aBus, aRegister);
+   }
+
+
+   int I2cDevice::busWriteByte(int aBus, int aRegister, int aValue)
+   {
+      return i2c_smbus_write_byte_data(aBus, aRegister, aValue);
+   }
+
+
+   int I2cDevice::busTransfer(int aBus, struct i2c_msg* apMsgs, int aCount)
+   {
+      struct i2c_rdwr_ioctl_data lTransfer;
+      lTransfer.msgs = apMsgs;
+      lTransfer.nmsgs = static_cast<__u32>(aCount);
+
+      return ioctl(aBus, I2C_RDWR, &lTransfer);
+   }
+
+
+   void I2cDevice::openConcurrent()
+   {
+      int lBus = this->busOpen(mI2CBusName);
+      if(lBus < 0)
+         return;
+
+      // published only with the device selected, writeByteConcurrent() fails until then
+      if(this->busSelect(lBus, mDevAddress / 2) < 0)
+      {
+         this->busClose(lBus);
+         return;
+      }
+
+      mConcurrentBus.store(lBus);
+   }
+
+
+   void I2cDevice::closeConcurrent()
+   {
+      int lBus = mConcurrentBus.exchange(-1);
+
+      // a call which took the descriptor finishes its single byte first
+      while(mConcurrentUsers.load() > 0)
+      {
+         std::this_thread::yield();
+      }
+
+      if(lBus >= 0)
+      {
+         this->busClose(lBus);
+      }
+   }
+
+
+   void I2cDevice::trace(int aOperation, int aRegister, const uint8_t* apData, size_t aLength, int aResult, int aErrno)
+   {
+      if(mpRecorder != nullptr)
+      {
+         mpRecorder->record(mBusNumber, mDevAddress, aRegister, aOperation, apData, aLength, aResult, aErrno);
+      }
+   }
 } // namespace CAR4TEGRA
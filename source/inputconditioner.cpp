@@ -0,0 +1,275 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file inputconditioner.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class InputConditioner at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/inputconditioner.hpp"
+
+
+namespace CAR4TEGRA
+{
+   InputConditioner::InputConditioner()
+      : mStatistics{ 0, 0, 0 }
+   {
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         this->setSettings(i, passThrough());
+      }
+   }
+
+
+   InputConditioner::Settings InputConditioner::passThrough()
+   {
+      return Settings{ FILTER_NONE, 0.0, 1, 0, 0, 0, 0 };
+   }
+
+
+   void InputConditioner::setSettings(int aChannel, const Settings& acrSettings)
+   {
+      checkChannel(aChannel);
+
+      // check settings
+      if(acrSettings.mFilter < FILTER_NONE || acrSettings.mFilter > FILTER_MEDIAN_LOWPASS)
+      {
+         throw std::range_error("Invalid filter \"" + std::to_string(acrSettings.mFilter) + "\"");
+      }
+
+      if(acrSettings.mMedianTaps < 1 || acrSettings.mMedianTaps > CONDITIONER_MEDIAN_TAPS_MAX ||
+         acrSettings.mMedianTaps % 2 == 0)
+      {
+         throw std::range_error("Invalid median window \"" + std::to_string(acrSettings.mMedianTaps) +
+                                "\" (has to be 1, 3 or 5)");
+      }
+
+      if(acrSettings.mTimeConstantMs < 0.0 || acrSettings.mDeadband < 0 ||
+         acrSettings.mHysteresis < 0 || acrSettings.mMinChange < 0)
+      {
+         throw std::range_error("Invalid conditioning settings for channel " + std::to_string(aChannel) +
+                                " (negative value)");
+      }
+
+      Channel& lrChannel = mChannels[aChannel];
+      lrChannel = Channel();
+      lrChannel.mSettings = acrSettings;
+   }
+
+
+   const InputConditioner::Settings& InputConditioner::settings(int aChannel) const
+   {
+      checkChannel(aChannel);
+      return mChannels[aChannel].mSettings;
+   }
+
+
+   void InputConditioner::reset()
+   {
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         this->reset(i);
+      }
+   }
+
+
+   void InputConditioner::reset(int aChannel)
+   {
+      checkChannel(aChannel);
+
+      Channel& lrChannel = mChannels[aChannel];
+      Settings lSettings = lrChannel.mSettings;
+      lrChannel = Channel();
+      lrChannel.mSettings = lSettings;
+   }
+
+
+   bool InputConditioner::process(int aChannel, int aValue, int64_t aTimeNs, int& arOutput)
+   {
+      checkChannel(aChannel);
+
+      Channel& lrChannel = mChannels[aChannel];
+      const Settings& lcrSettings = lrChannel.mSettings;
+      mStatistics.mSamples++;
+
+      lrChannel.mRaw = aValue;
+      int lValue = filter(lrChannel, aValue, aTimeNs);
+
+      // the first value is always forwarded
+      bool lForward = !lrChannel.mHasOutput;
+      if(!lForward)
+      {
+         int lDelta = lValue - lrChannel.mOutput;
+         int lDirection = (lDelta > 0) ? 1 : -1;
+         bool lReversal = (lrChannel.mDirection != 0 && lDirection != lrChannel.mDirection);
+
+         lForward = (lDelta != 0) &&
+                    !(lReversal && std::abs(lDelta) <= lcrSettings.mHysteresis) &&
+                    (std::abs(lDelta) >= lcrSettings.mMinChange);
+      }
+
+      if(lForward)
+      {
+         this->forward(lrChannel, lValue);
+         arOutput = lValue;
+      }
+      else
+      {
+         mStatistics.mSuppressed++;
+      }
+
+      lrChannel.mPending = (lrChannel.mOutput != deadband(lcrSettings, lrChannel.mRaw));
+      return lForward;
+   }
+
+
+   bool InputConditioner::settle(int aChannel, int64_t aTimeNs, int& arOutput)
+   {
+      checkChannel(aChannel);
+
+      Channel& lrChannel = mChannels[aChannel];
+      if(!lrChannel.mHasOutput)
+         return false;
+
+      // feed the last raw value again, the filters move towards it
+      int lValue = filter(lrChannel, lrChannel.mRaw, aTimeNs);
+      bool lForward = (lValue != lrChannel.mOutput);
+
+      if(lForward)
+      {
+         this->forward(lrChannel, lValue);
+         arOutput = lValue;
+      }
+
+      lrChannel.mPending = (lrChannel.mOutput != deadband(lrChannel.mSettings, lrChannel.mRaw));
+      return lForward;
+   }
+
+
+   bool InputConditioner::isPending(int aChannel) const
+   {
+      checkChannel(aChannel);
+      return mChannels[aChannel].mPending;
+   }
+
+
+   InputConditioner::Statistics InputConditioner::statistics() const
+   {
+      return mStatistics;
+   }
+
+
+   int InputConditioner::filter(Channel& arChannel, int aValue, int64_t aTimeNs)
+   {
+      const Settings& lcrSettings = arChannel.mSettings;
+      int lValue = aValue;
+
+      // median of the last samples
+      if((lcrSettings.mFilter == FILTER_MEDIAN || lcrSettings.mFilter == FILTER_MEDIAN_LOWPASS) &&
+         lcrSettings.mMedianTaps > 1)
+      {
+         arChannel.mMedian[arChannel.mMedianNext] = aValue;
+         arChannel.mMedianNext = (arChannel.mMedianNext + 1) % lcrSettings.mMedianTaps;
+         arChannel.mMedianCount = std::min(arChannel.mMedianCount + 1, lcrSettings.mMedianTaps);
+
+         // insertion sort, at most 5 values
+         int lSorted[CONDITIONER_MEDIAN_TAPS_MAX];
+         for(int i = 0; i < arChannel.mMedianCount; i++)
+         {
+            int j = i;
+            for(; j > 0 && lSorted[j - 1] > arChannel.mMedian[i]; j--)
+            {
+               lSorted[j] = lSorted[j - 1];
+            }
+            lSorted[j] = arChannel.mMedian[i];
+         }
+         lValue = lSorted[arChannel.mMedianCount / 2];
+      }
+
+      // first-order low-pass filter, weighted by the time since the last sample
+      if((lcrSettings.mFilter == FILTER_LOWPASS || lcrSettings.mFilter == FILTER_MEDIAN_LOWPASS) &&
+         lcrSettings.mTimeConstantMs > 0.0)
+      {
+         if(!arChannel.mStarted)
+         {
+            arChannel.mFiltered = lValue;
+         }
+         else
+         {
+            double lDtMs = std::max<int64_t>(aTimeNs - arChannel.mTimeNs, 0) / 1e6;
+            double lAlpha = 1.0 - std::exp(-lDtMs / lcrSettings.mTimeConstantMs);
+            arChannel.mFiltered += lAlpha * (lValue - arChannel.mFiltered);
+         }
+
+         lValue = static_cast<int>(std::lround(arChannel.mFiltered));
+      }
+
+      arChannel.mTimeNs = aTimeNs;
+      arChannel.mStarted = true;
+
+      return deadband(lcrSettings, lValue);
+   }
+
+
+   int InputConditioner::deadband(const Settings& acrSettings, int aValue)
+   {
+      return (std::abs(aValue - acrSettings.mCenter) <= acrSettings.mDeadband) ? acrSettings.mCenter : aValue;
+   }
+
+
+   void InputConditioner::forward(Channel& arChannel, int aValue)
+   {
+      if(arChannel.mHasOutput && aValue != arChannel.mOutput)
+      {
+         arChannel.mDirection = (aValue > arChannel.mOutput) ? 1 : -1;
+      }
+
+      arChannel.mOutput = aValue;
+      arChannel.mHasOutput = true;
+      mStatistics.mForwarded++;
+   }
+
+
+   void InputConditioner::checkChannel(int aChannel)
+   {
+      if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                                "\" (has to be between 0 and " + std::to_string(PCA9685_CHANNEL_COUNT - 1) + ")");
+      }
+   }
+} // namespace CAR4TEGRA
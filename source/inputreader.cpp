@@ -0,0 +1,620 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file inputreader.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class InputReader at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/inputreader.hpp"
+#include "include/spantracer.hpp"
+
+
+// older kernel headers name the event time directly
+#ifndef input_event_sec
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const size_t EVENT_BATCH = 64;               ///< Events read with one system call
+      const int64_t LATENCY_BUCKET_NS = 10000;     ///< Width of one latency histogram bucket (ns)
+      const int INPUT_SETTLE_MS = 20;              ///< Rest time before held back values are written (ms)
+
+
+      /**
+       * @brief Returns the current CLOCK_MONOTONIC time
+       *
+       * @return Time (ns)
+       */
+      inline int64_t monotonicNow()
+      {
+         struct timespec lTime;
+         clock_gettime(CLOCK_MONOTONIC, &lTime);
+         return static_cast<int64_t>(lTime.tv_sec) * 1000000000ll + lTime.tv_nsec;
+      }
+
+
+      /**
+       * @brief Returns the timestamp of an input event
+       *
+       * @param[in]  acrEvent       Input event
+       *
+       * @return Time (ns)
+       */
+      inline int64_t eventTime(const struct input_event& acrEvent)
+      {
+         return static_cast<int64_t>(acrEvent.input_event_sec) * 1000000000ll +
+                static_cast<int64_t>(acrEvent.input_event_usec) * 1000ll;
+      }
+   } // namespace
+
+
+   InputReader::InputReader(PCA9685& arDriver)
+      : mrDriver(arDriver), mRunning(false), mEpoll(-1), mStopEvent(-1)
+   {
+      this->resetLatency();
+   }
+
+
+   InputReader::~InputReader()
+   {
+      this->stop();
+      this->closeDevices();
+   }
+
+
+   int InputReader::openDevice(const std::string& acrPath)
+   {
+      std::unique_ptr<Device> lpDevice = std::make_unique<Device>();
+      lpDevice->mPath = acrPath;
+
+      // try to open device
+      if((lpDevice->mFile = open(acrPath.c_str(), O_RDONLY | O_NONBLOCK)) < 0)
+      {
+         throw std::runtime_error("Failed to open input device \"" + acrPath +
+                                  "\" (Error " + std::to_string(errno) +
+                                  ": " + strerror(errno) + ")");
+      }
+
+      // event timestamps in CLOCK_MONOTONIC, comparable to the write completion time
+      int lClock = CLOCK_MONOTONIC;
+      if(ioctl(lpDevice->mFile, EVIOCSCLOCKID, &lClock) < 0)
+      {
+         int lErrno = errno;
+         close(lpDevice->mFile);
+         throw std::runtime_error("Failed to set clock of input device \"" + acrPath +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      this->initAxes(*lpDevice);
+
+      mDevices.push_back(std::move(lpDevice));
+      return static_cast<int>(mDevices.size()) - 1;
+   }
+
+
+   int InputReader::addVirtualDevice()
+   {
+      std::unique_ptr<Device> lpDevice = std::make_unique<Device>();
+      lpDevice->mFile = -1;
+      this->initAxes(*lpDevice);
+
+      mDevices.push_back(std::move(lpDevice));
+      return static_cast<int>(mDevices.size()) - 1;
+   }
+
+
+   void InputReader::closeDevices()
+   {
+      for(std::unique_ptr<Device>& lpDevice : mDevices)
+      {
+         if(lpDevice->mFile >= 0)
+            close(lpDevice->mFile);
+      }
+
+      mDevices.clear();
+   }
+
+
+   void InputReader::setAxisRange(int aDevice, int aAxis, int aMin, int aMax)
+   {
+      this->checkDevice(aDevice);
+
+      if(aAxis < 0 || aAxis >= ABS_CNT || aMin >= aMax)
+      {
+         throw std::range_error("Invalid range of axis \"" + std::to_string(aAxis) + "\"");
+      }
+
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+      mDevices[aDevice]->mAxes[aAxis].mMin = aMin;
+      mDevices[aDevice]->mAxes[aAxis].mMax = aMax;
+   }
+
+
+   void InputReader::mapAxis(int aDevice, int aAxis, const AxisMapping& acrMapping)
+   {
+      this->checkDevice(aDevice);
+
+      if(aAxis < 0 || aAxis >= ABS_CNT)
+      {
+         throw std::range_error("Invalid axis \"" + std::to_string(aAxis) + "\"");
+      }
+
+      if(acrMapping.mChannel < 0 || acrMapping.mChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(acrMapping.mChannel) +
+                                "\" (has to be between 0 and 15)");
+      }
+
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+      mDevices[aDevice]->mAxes[aAxis].mMapped = true;
+      mDevices[aDevice]->mAxes[aAxis].mMapping = acrMapping;
+   }
+
+
+   void InputReader::unmapAxis(int aDevice, int aAxis)
+   {
+      this->checkDevice(aDevice);
+
+      if(aAxis < 0 || aAxis >= ABS_CNT)
+      {
+         throw std::range_error("Invalid axis \"" + std::to_string(aAxis) + "\"");
+      }
+
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+      mDevices[aDevice]->mAxes[aAxis].mMapped = false;
+   }
+
+
+   void InputReader::setConditioning(int aChannel, const InputConditioner::Settings& acrSettings)
+   {
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+      mConditioner.setSettings(aChannel, acrSettings);
+   }
+
+
+   InputConditioner::Statistics InputReader::conditioning()
+   {
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+      return mConditioner.statistics();
+   }
+
+
+   void InputReader::start()
+   {
+      this->stop();
+
+      // epoll over all device files and a stop event
+      if((mEpoll = epoll_create1(EPOLL_CLOEXEC)) < 0 || (mStopEvent = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+      {
+         int lErrno = errno;
+         this->stop();
+         throw std::runtime_error("Failed to create input event loop (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      struct epoll_event lEvent;
+      memset(&lEvent, 0, sizeof(lEvent));
+      lEvent.events = EPOLLIN;
+      lEvent.data.u64 = mDevices.size();
+      epoll_ctl(mEpoll, EPOLL_CTL_ADD, mStopEvent, &lEvent);
+
+      for(size_t i = 0; i < mDevices.size(); i++)
+      {
+         if(mDevices[i]->mFile < 0)
+            continue;
+
+         lEvent.data.u64 = i;
+         if(epoll_ctl(mEpoll, EPOLL_CTL_ADD, mDevices[i]->mFile, &lEvent) < 0)
+         {
+            int lErrno = errno;
+            this->stop();
+            throw std::runtime_error("Failed to watch input device \"" + mDevices[i]->mPath +
+                                     "\" (Error " + std::to_string(lErrno) +
+                                     ": " + strerror(lErrno) + ")");
+         }
+      }
+
+      mRunning = true;
+      mThread = std::thread(&InputReader::run, this);
+   }
+
+
+   void InputReader::stop()
+   {
+      mRunning = false;
+
+      if(mStopEvent >= 0)
+      {
+         uint64_t lValue = 1;
+         if(write(mStopEvent, &lValue, sizeof(lValue)) < 0)
+         {
+            // thread wakes up with the next input event anyway
+         }
+      }
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+
+      if(mStopEvent >= 0)
+         close(mStopEvent);
+      if(mEpoll >= 0)
+         close(mEpoll);
+
+      mStopEvent = -1;
+      mEpoll = -1;
+   }
+
+
+   uint64_t InputReader::replay(const std::string& acrPath, int aDevice, bool aRealTime)
+   {
+      this->checkDevice(aDevice);
+
+      int lFile = open(acrPath.c_str(), O_RDONLY);
+      if(lFile < 0)
+      {
+         throw std::runtime_error("Failed to open input recording \"" + acrPath +
+                                  "\" (Error " + std::to_string(errno) +
+                                  ": " + strerror(errno) + ")");
+      }
+
+      struct input_event lEvents[EVENT_BATCH];
+      uint64_t lCount = 0;
+      int64_t lFirstEvent = 0;
+      int64_t lStart = monotonicNow();
+      ssize_t lBytes;
+
+      while((lBytes = read(lFile, lEvents, sizeof(lEvents))) > 0)
+      {
+         size_t lEventCount = static_cast<size_t>(lBytes) / sizeof(struct input_event);
+
+         for(size_t i = 0; i < lEventCount; i++)
+         {
+            int64_t lEventTime = eventTime(lEvents[i]);
+            if(lCount == 0)
+               lFirstEvent = lEventTime;
+
+            // pace to the recorded timestamps, latency counts from the replayed delivery
+            if(aRealTime)
+            {
+               int64_t lDue = lStart + (lEventTime - lFirstEvent);
+               int64_t lNow = monotonicNow();
+               if(lDue > lNow)
+                  std::this_thread::sleep_for(std::chrono::nanoseconds(lDue - lNow));
+            }
+
+            this->process(*mDevices[aDevice], lEvents[i], monotonicNow());
+            lCount++;
+         }
+      }
+
+      close(lFile);
+
+      {
+         std::lock_guard<std::mutex> lLock(mMappingMutex);
+         this->settleChannels();
+      }
+      return lCount;
+   }
+
+
+   InputReader::LatencyStatistics InputReader::latency()
+   {
+      std::lock_guard<std::mutex> lLock(mLatencyMutex);
+
+      LatencyStatistics lStats = { mLatencyCount, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      if(mLatencyCount == 0)
+         return lStats;
+
+      lStats.mMinUs = mLatencyMinNs / 1000.0;
+      lStats.mMaxUs = mLatencyMaxNs / 1000.0;
+      lStats.mMeanUs = (mLatencySumNs / 1000.0) / mLatencyCount;
+
+      // percentiles from the histogram (upper bucket border)
+      uint64_t lSum = 0;
+      uint64_t lP50 = (mLatencyCount + 1) / 2;
+      uint64_t lP99 = (mLatencyCount * 99 + 99) / 100;
+      for(size_t i = 0; i < LATENCY_BUCKETS; i++)
+      {
+         uint64_t lPrev = lSum;
+         lSum += mLatencyHistogram[i];
+
+         double lBorderUs = (i + 1) * LATENCY_BUCKET_NS / 1000.0;
+         if(lPrev < lP50 && lSum >= lP50)
+            lStats.mP50Us = std::min(lBorderUs, lStats.mMaxUs);
+         if(lPrev < lP99 && lSum >= lP99)
+            lStats.mP99Us = std::min(lBorderUs, lStats.mMaxUs);
+      }
+
+      return lStats;
+   }
+
+
+   void InputReader::resetLatency()
+   {
+      std::lock_guard<std::mutex> lLock(mLatencyMutex);
+
+      mLatencyCount = 0;
+      mLatencyMinNs = INT64_MAX;
+      mLatencyMaxNs = 0;
+      mLatencySumNs = 0;
+      mLatencyHistogram.fill(0);
+   }
+
+
+   void InputReader::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void InputReader::process(Device& arDevice, const struct input_event& acrEvent, int64_t aEventTimeNs)
+   {
+      // collect axis changes until the end of the report
+      if(acrEvent.type == EV_ABS && acrEvent.code < ABS_CNT)
+      {
+         Axis& lAxis = arDevice.mAxes[acrEvent.code];
+         lAxis.mValue = acrEvent.value;
+         if(!lAxis.mChanged)
+         {
+            lAxis.mChanged = true;
+            lAxis.mEventTimeNs = aEventTimeNs;
+         }
+         return;
+      }
+
+      if(acrEvent.type != EV_SYN)
+         return;
+
+      // events lost in the kernel buffer: read current state
+      if(acrEvent.code == SYN_DROPPED)
+      {
+         this->syncAxes(arDevice);
+         return;
+      }
+
+      if(acrEvent.code != SYN_REPORT)
+         return;
+
+
+      // write all changed channels of the report
+      std::lock_guard<std::mutex> lLock(mMappingMutex);
+
+      for(Axis& lAxis : arDevice.mAxes)
+      {
+         if(!lAxis.mChanged)
+            continue;
+
+         lAxis.mChanged = false;
+         if(!lAxis.mMapped)
+            continue;
+
+         const AxisMapping& lMap = lAxis.mMapping;
+         int lValue = std::min(std::max(lAxis.mValue, lAxis.mMin), lAxis.mMax);
+         int64_t lPos = lMap.mInvert ? (lAxis.mMax - lValue) : (lValue - lAxis.mMin);
+         int lPwm = lMap.mPwmMin + static_cast<int>((lPos * (lMap.mPwmMax - lMap.mPwmMin)) / (lAxis.mMax - lAxis.mMin));
+
+         // sub-perceptible changes never reach the bus
+         if(!mConditioner.process(lMap.mChannel, lPwm, aEventTimeNs, lPwm))
+            continue;
+
+         try
+         {
+            mrDriver.setPWM(lMap.mChannel, 0, lPwm);
+         }
+         catch(const std::exception& e)
+         {
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+            continue;
+         }
+
+         this->addLatency(monotonicNow() - lAxis.mEventTimeNs);
+      }
+   }
+
+
+   void InputReader::initAxes(Device& arDevice)
+   {
+      for(int i = 0; i < ABS_CNT; i++)
+      {
+         Axis& lAxis = arDevice.mAxes[i];
+         lAxis = Axis{ false, AxisMapping{ 0, 0, 0, false }, -32768, 32767, 0, false, 0 };
+
+         // range reported by the device
+         struct input_absinfo lInfo;
+         if(arDevice.mFile >= 0 && ioctl(arDevice.mFile, EVIOCGABS(i), &lInfo) == 0 && lInfo.minimum < lInfo.maximum)
+         {
+            lAxis.mMin = lInfo.minimum;
+            lAxis.mMax = lInfo.maximum;
+            lAxis.mValue = lInfo.value;
+         }
+      }
+   }
+
+
+   void InputReader::syncAxes(Device& arDevice)
+   {
+      if(arDevice.mFile < 0)
+         return;
+
+      // values read after a drop are written with the next report
+      int64_t lNow = monotonicNow();
+      for(int i = 0; i < ABS_CNT; i++)
+      {
+         struct input_absinfo lInfo;
+         if(ioctl(arDevice.mFile, EVIOCGABS(i), &lInfo) < 0)
+            continue;
+
+         Axis& lAxis = arDevice.mAxes[i];
+         lAxis.mValue = lInfo.value;
+         lAxis.mChanged = true;
+         lAxis.mEventTimeNs = lNow;
+      }
+   }
+
+
+   bool InputReader::settleChannels()
+   {
+      bool lPending = false;
+      int64_t lNow = monotonicNow();
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         int lPwm;
+         if(!mConditioner.isPending(lChannel))
+            continue;
+
+         try
+         {
+            if(mConditioner.settle(lChannel, lNow, lPwm))
+               mrDriver.setPWM(lChannel, 0, lPwm);
+         }
+         catch(const std::exception& e)
+         {
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+         }
+
+         lPending = lPending || mConditioner.isPending(lChannel);
+      }
+
+      return lPending;
+   }
+
+
+   void InputReader::addLatency(int64_t aLatencyNs)
+   {
+      std::lock_guard<std::mutex> lLock(mLatencyMutex);
+
+      aLatencyNs = std::max<int64_t>(aLatencyNs, 0);
+      mLatencyCount++;
+      mLatencyMinNs = std::min(mLatencyMinNs, aLatencyNs);
+      mLatencyMaxNs = std::max(mLatencyMaxNs, aLatencyNs);
+      mLatencySumNs += aLatencyNs;
+      mLatencyHistogram[std::min<size_t>(static_cast<size_t>(aLatencyNs / LATENCY_BUCKET_NS), LATENCY_BUCKETS - 1)]++;
+   }
+
+
+   void InputReader::run()
+   {
+      C4T_TRACE_THREAD("input");
+
+      struct epoll_event lReady[8];
+      struct input_event lEvents[EVENT_BATCH];
+
+      bool lPending = false;
+
+      while(mRunning)
+      {
+         // wake up to write held back values once the axes rest
+         int lCount = epoll_wait(mEpoll, lReady, 8, lPending ? INPUT_SETTLE_MS : -1);
+         if(lCount < 0 && errno != EINTR)
+         {
+            if(mErrorCallback)
+               mErrorCallback(std::string("Failed to wait for input events (Error ") + std::to_string(errno) +
+                              ": " + strerror(errno) + ")");
+            break;
+         }
+
+         if(lCount <= 0)
+         {
+            std::lock_guard<std::mutex> lLock(mMappingMutex);
+            lPending = this->settleChannels();
+            continue;
+         }
+
+         for(int i = 0; i < lCount && mRunning; i++)
+         {
+            size_t lIndex = lReady[i].data.u64;
+            if(lIndex >= mDevices.size())
+               continue;
+
+            // device unplugged
+            Device& lDevice = *mDevices[lIndex];
+            if(lReady[i].events & (EPOLLHUP | EPOLLERR))
+            {
+               epoll_ctl(mEpoll, EPOLL_CTL_DEL, lDevice.mFile, nullptr);
+               if(mErrorCallback)
+                  mErrorCallback("Input device \"" + lDevice.mPath + "\" removed");
+               continue;
+            }
+
+            // drain the device
+            ssize_t lBytes;
+            while((lBytes = read(lDevice.mFile, lEvents, sizeof(lEvents))) > 0)
+            {
+               size_t lEventCount = static_cast<size_t>(lBytes) / sizeof(struct input_event);
+               for(size_t j = 0; j < lEventCount; j++)
+               {
+                  this->process(lDevice, lEvents[j], eventTime(lEvents[j]));
+               }
+            }
+         }
+
+         std::lock_guard<std::mutex> lLock(mMappingMutex);
+         lPending = false;
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            lPending = lPending || mConditioner.isPending(lChannel);
+         }
+      }
+   }
+
+
+   void InputReader::checkDevice(int aDevice) const
+   {
+      if(aDevice < 0 || aDevice >= static_cast<int>(mDevices.size()))
+      {
+         throw std::range_error("Invalid input device \"" + std::to_string(aDevice) + "\"");
+      }
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,210 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file logsink.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class LogSink
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// QT includes
+#include <QDateTime>
+#include <QStringList>
+#include <QTextDocument>
+
+// internal includes
+#include "include/logsink.hpp"
+
+
+LogSink::LogSink(QTextBrowser* apView, const QString& acrFileName, int aCapacity, int aFileCapacity,
+                 int aIntervalMs, int aMaxLines, QObject* apParent)
+   : QObject(apParent),
+     mpView(apView),
+     mFile(acrFileName),
+     mRing(aCapacity > 0 ? aCapacity : 1),
+     mFlushBuffer(mRing.size()),
+     mHead(0),
+     mSize(0),
+     mFileSize(0),
+     mDropped(0),
+     mFileDropped(0)
+{
+   // bound the layout cost of the view
+   mpView->document()->setMaximumBlockCount(aMaxLines);
+
+   if(!acrFileName.isEmpty() && mFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+   {
+      mStream.setDevice(&mFile);
+      mFileQueue.resize(aFileCapacity > 0 ? aFileCapacity : 1);
+      mFileBuffer.resize(mFileQueue.size());
+   }
+
+   connect(&mTimer, &QTimer::timeout, this, &LogSink::flush);
+   mTimer.start(aIntervalMs);
+}
+
+
+LogSink::~LogSink()
+{
+   mTimer.stop();
+   this->flush();
+}
+
+
+void LogSink::append(const QString& acrMessage)
+{
+   Clock::time_point lNow = Clock::now();
+   std::lock_guard<std::mutex> lLock(mMutex);
+
+   // the file keeps the history up to the queue capacity, repeats are merged
+   if(mStream.device())
+   {
+      if(mFileSize > 0 && mFileQueue[mFileSize - 1].mMessage == acrMessage)
+      {
+         mFileQueue[mFileSize - 1].mCount++;
+         mFileQueue[mFileSize - 1].mLast = lNow;
+      }
+      else if(mFileSize == mFileQueue.size())
+      {
+         mFileDropped++;
+      }
+      else
+      {
+         Entry& lEntry = mFileQueue[mFileSize++];
+         lEntry.mMessage = acrMessage;
+         lEntry.mCount = 1;
+         lEntry.mFirst = lNow;
+         lEntry.mLast = lNow;
+      }
+   }
+
+   // repeated message: count only
+   if(mSize > 0)
+   {
+      Entry& lLast = mRing[(mHead + mSize - 1) % mRing.size()];
+      if(lLast.mMessage == acrMessage)
+      {
+         lLast.mCount++;
+         lLast.mLast = lNow;
+         return;
+      }
+   }
+
+   // ring buffer full: drop oldest message from the view
+   if(mSize == mRing.size())
+   {
+      mHead = (mHead + 1) % mRing.size();
+      mSize--;
+      mDropped++;
+   }
+
+   Entry& lEntry = mRing[(mHead + mSize) % mRing.size()];
+   lEntry.mMessage = acrMessage;
+   lEntry.mCount = 1;
+   lEntry.mFirst = lNow;
+   lEntry.mLast = lNow;
+   mSize++;
+}
+
+
+void LogSink::flush()
+{
+   // take over buffered messages, producers are blocked only for the swap
+   size_t lCount = 0;
+   size_t lFileCount = 0;
+   uint64_t lDropped = 0;
+   uint64_t lFileDropped = 0;
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      for(; lCount < mSize; lCount++)
+      {
+         std::swap(mFlushBuffer[lCount], mRing[(mHead + lCount) % mRing.size()]);
+      }
+
+      lDropped = mDropped;
+      mHead = 0;
+      mSize = 0;
+      mDropped = 0;
+
+      lFileCount = mFileSize;
+      lFileDropped = mFileDropped;
+      mFileSize = 0;
+      mFileDropped = 0;
+      mFileBuffer.swap(mFileQueue);
+   }
+
+
+   // one line per message for the file
+   if(mStream.device() && (lFileCount > 0 || lFileDropped > 0))
+   {
+      for(size_t i = 0; i < lFileCount; i++)
+      {
+         Entry& lEntry = mFileBuffer[i];
+         QDateTime lFirst = QDateTime::fromMSecsSinceEpoch(
+                  std::chrono::duration_cast<std::chrono::milliseconds>(lEntry.mFirst.time_since_epoch()).count());
+         QDateTime lLast = QDateTime::fromMSecsSinceEpoch(
+                  std::chrono::duration_cast<std::chrono::milliseconds>(lEntry.mLast.time_since_epoch()).count());
+
+         mStream << lFirst.toString(Qt::ISODate);
+         if(lEntry.mCount > 1)
+            mStream << " - " << lLast.toString(Qt::ISODate) << " " << lEntry.mMessage << " (x" << lEntry.mCount << ")\n";
+         else
+            mStream << " " << lEntry.mMessage << "\n";
+         lEntry.mMessage.clear();
+      }
+
+      if(lFileDropped > 0)
+      {
+         mStream << QDateTime::currentDateTime().toString(Qt::ISODate) << " "
+                 << QString("%1 log messages dropped from the file").arg(lFileDropped) << "\n";
+      }
+
+      mStream.flush();
+   }
+
+   if(lCount == 0 && lDropped == 0)
+      return;
+
+
+   // build one block of text for the view
+   QStringList lLines;
+   if(lDropped > 0)
+   {
+      lLines.append(QString("%1 log messages dropped from the view").arg(lDropped));
+   }
+
+   for(size_t i = 0; i < lCount; i++)
+   {
+      Entry& lEntry = mFlushBuffer[i];
+      lLines.append((lEntry.mCount > 1) ? QString("%1 (x%2)").arg(lEntry.mMessage).arg(lEntry.mCount)
+                                        : lEntry.mMessage);
+      lEntry.mMessage.clear();
+   }
+
+   mpView->append(lLines.join("\n"));
+}
@@ -28,7 +28,14 @@
  * @brief This file contains the main function
  *
  * @details
- * The main function starts the application and loads the GUI main window
+ * The main function starts the application and loads the GUI main window. With `--udp` the
+ * application runs without GUI and forwards UDP setpoint packets to the PCA9685 device:
+ *
+ * ServoDriverCalibration --udp [PORT] [--bus /dev/i2c-N] [--address HEX] [--freq HZ] [--listen ADDRESS]
+ *
+ * With `--play` a keyframe file is played to the PCA9685 device without GUI:
+ *
+ * ServoDriverCalibration --play FILE [--loop] [--scale FACTOR] [--bus /dev/i2c-N] [--address HEX] [--freq HZ]
  *
  * @version 0.1 - 09.04.2017 - File created
  */
@@ -37,8 +44,204 @@
 // QT includes
 #include <QApplication>
 
+// std includes
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <exception>
+#include <iostream>
+#include <string>
+
 // internal includes
 #include "include/mainwindow.hpp"
+#include "include/sequenceplayer.hpp"
+#include "include/setpointlistener.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace
+{
+    volatile sig_atomic_t gStop = 0;    ///< Set by SIGINT / SIGTERM in headless modes
+
+
+    /**
+     * @brief Signal handler for SIGINT / SIGTERM
+     *
+     * @param[in]  aSignal  Signal number
+     */
+    void onStopSignal(int aSignal)
+    {
+        (void)aSignal;
+        gStop = 1;
+    }
+
+
+    /**
+     * @brief Runs the headless UDP setpoint listener until SIGINT / SIGTERM
+     *
+     * @param[in]  aArgc    Number of arguments
+     * @param[in]  apArgv   Value of arguments
+     *
+     * @return `0` if the listener worked fine, `non zero` otherwise
+     */
+    int runUdpListener(int aArgc, char* apArgv[])
+    {
+        uint16_t lPort = SETPOINT_PORT_DEFAULT;
+        std::string lBus = "/dev/i2c-" + std::to_string(I2C_BUS_FIRST + I2C_BUS_DEFAULT);
+        std::string lListen = "127.0.0.1";
+        int lAddress = static_cast<int>(strtol(I2C_DEVICE_DEFAULT, nullptr, 16));
+        float lFreq = PWM_FREQ_DEFAULT;
+
+        for(int i = 2; i < aArgc; i++)
+        {
+            std::string lArg(apArgv[i]);
+
+            if(lArg == "--bus" && i + 1 < aArgc)
+                lBus = apArgv[++i];
+            else if(lArg == "--address" && i + 1 < aArgc)
+                lAddress = static_cast<int>(strtol(apArgv[++i], nullptr, 16));
+            else if(lArg == "--freq" && i + 1 < aArgc)
+                lFreq = static_cast<float>(atof(apArgv[++i]));
+            else if(lArg == "--listen" && i + 1 < aArgc)
+                lListen = apArgv[++i];
+            else if(i == 2 && lArg[0] != '-')
+                lPort = static_cast<uint16_t>(atoi(apArgv[i]));
+            else
+            {
+                std::cerr << "Unknown argument \"" << lArg << "\"" << std::endl;
+                return 2;
+            }
+        }
+
+        try
+        {
+            CAR4TEGRA::PCA9685 lDriver;
+            lDriver.openDevice(lBus, lAddress);
+            lDriver.fastConnect(lFreq);
+
+            CAR4TEGRA::SetpointListener lListener(lDriver);
+            lListener.setErrorCallback([](const std::string& acrMessage) { std::cerr << acrMessage << std::endl; });
+            lListener.open(lPort, lListen);
+
+            std::cout << "Listening for setpoints on " << lListen << ":" << lListener.port() << std::endl;
+
+            signal(SIGINT, onStopSignal);
+            signal(SIGTERM, onStopSignal);
+            while(!gStop)
+            {
+                lListener.poll(100);
+            }
+
+            CAR4TEGRA::SetpointListener::Statistics lStats = lListener.statistics();
+            std::cout << "Received " << lStats.mReceived << ", accepted " << lStats.mAccepted
+                         << ", malformed " << lStats.mMalformed << ", stale " << lStats.mStale
+                         << ", out of order " << lStats.mOutOfOrder << ", write errors " << lStats.mErrors
+                         << ", latency mean " << lStats.mMeanLatencyUs << " us / max " << lStats.mMaxLatencyUs
+                         << " us" << std::endl;
+
+            // switch outputs off (FULL_OFF, one byte)
+            lDriver.stopOutputs(0xFFFF);
+
+#ifdef C4T_SPAN_TRACING
+            size_t lSpans = CAR4TEGRA::SpanTracer::exportChrome(SPAN_TRACE_FILE_DEFAULT);
+            std::cout << "Exported " << lSpans << " spans to " << SPAN_TRACE_FILE_DEFAULT << std::endl;
+#endif
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+
+    /**
+     * @brief Plays a keyframe file until its end or SIGINT / SIGTERM
+     *
+     * @param[in]  aArgc    Number of arguments
+     * @param[in]  apArgv   Value of arguments
+     *
+     * @return `0` if the sequence was played, `non zero` otherwise
+     */
+    int runSequencePlayer(int aArgc, char* apArgv[])
+    {
+        if(aArgc < 3)
+        {
+            std::cerr << "Missing keyframe file" << std::endl;
+            return 2;
+        }
+
+        std::string lFile(apArgv[2]);
+        std::string lBus = "/dev/i2c-" + std::to_string(I2C_BUS_FIRST + I2C_BUS_DEFAULT);
+        int lAddress = static_cast<int>(strtol(I2C_DEVICE_DEFAULT, nullptr, 16));
+        float lFreq = PWM_FREQ_DEFAULT;
+        bool lLoop = false;
+        double lScale = 1.0;
+
+        for(int i = 3; i < aArgc; i++)
+        {
+            std::string lArg(apArgv[i]);
+
+            if(lArg == "--bus" && i + 1 < aArgc)
+                lBus = apArgv[++i];
+            else if(lArg == "--address" && i + 1 < aArgc)
+                lAddress = static_cast<int>(strtol(apArgv[++i], nullptr, 16));
+            else if(lArg == "--freq" && i + 1 < aArgc)
+                lFreq = static_cast<float>(atof(apArgv[++i]));
+            else if(lArg == "--scale" && i + 1 < aArgc)
+                lScale = atof(apArgv[++i]);
+            else if(lArg == "--loop")
+                lLoop = true;
+            else
+            {
+                std::cerr << "Unknown argument \"" << lArg << "\"" << std::endl;
+                return 2;
+            }
+        }
+
+        try
+        {
+            CAR4TEGRA::PCA9685 lDriver;
+            lDriver.openDevice(lBus, lAddress);
+            lDriver.fastConnect(lFreq);
+
+            CAR4TEGRA::SequencePlayer lPlayer(lDriver);
+            lPlayer.setErrorCallback([](const std::string& acrMessage) { std::cerr << acrMessage << std::endl; });
+            lPlayer.setLoop(lLoop);
+            lPlayer.setTimeScale(lScale);
+            lPlayer.open(lFile);
+
+            std::cout << "Playing " << lPlayer.keyframes() << " keyframes (" << lPlayer.duration() / 1000
+                      << " ms)" << std::endl;
+
+            signal(SIGINT, onStopSignal);
+            signal(SIGTERM, onStopSignal);
+            lPlayer.start(lFreq);
+            while(!gStop && lPlayer.isRunning())
+            {
+                usleep(100000);
+            }
+
+            // switch outputs off before the player thread is joined, its last frames stay off
+            lDriver.emergencyStop();
+            lPlayer.stop();
+
+            CAR4TEGRA::SequencePlayer::Statistics lStats = lPlayer.statistics();
+            std::cout << "Frames " << lStats.mFrames << ", writes " << lStats.mBatches
+                      << ", loops " << lStats.mLoops << ", late frames " << lStats.mLateFrames
+                      << ", write errors " << lStats.mErrors << std::endl;
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+} // namespace
 
 
 /**
@@ -51,6 +254,18 @@
  */
 int main(int aArgc, char* apArgv[])
 {
+    // headless UDP listener mode
+    if(aArgc > 1 && std::string(apArgv[1]) == "--udp")
+    {
+        return runUdpListener(aArgc, apArgv);
+    }
+
+    // headless keyframe playback
+    if(aArgc > 1 && std::string(apArgv[1]) == "--play")
+    {
+        return runSequencePlayer(aArgc, apArgv);
+    }
+
     QApplication lApp(aArgc, apArgv);
     MainWindow lWindow;
     lWindow.show();
@@ -32,19 +32,42 @@
 
 
 // std includes
+#include <stdlib.h>
+#include <chrono>
 #include <exception>
 #include <stdexcept>
 
 
+// QT includes
+#include <QAction>
+#include <QHeaderView>
+#include <QShortcut>
+#include <QSignalBlocker>
+
 // internal includes
 #include "include/mainwindow.hpp"
+#include "include/channeldelegate.hpp"
 #include "ui_mainwindow.h"
 
 
 MainWindow::MainWindow(QWidget* apParent)
     : QMainWindow(apParent),
       mpUi(new Ui::MainWindow),
-      mpDriver(std::make_unique<CAR4TEGRA::PCA9685>())
+      mpDriver(std::make_unique<CAR4TEGRA::PCA9685>()),
+      mpScrubber(std::make_unique<CAR4TEGRA::RegisterScrubber>(*mpDriver)),
+      mpRecorder(std::make_unique<CAR4TEGRA::TraceRecorder>()),
+      mpInput(std::make_unique<CAR4TEGRA::InputReader>(*mpDriver)),
+      mInputDevice(-1),
+      mpProfile(std::make_unique<CAR4TEGRA::ProfileWatcher>()),
+      mpStopAction(nullptr),
+      mBoard(0),
+      mArrowLeft(":/car/images/Arrow_Left.png"),
+      mArrowRight(":/car/images/Arrow_Right.png"),
+      mCar(":/car/images/Car.png"),
+      mCarLeft(":/car/images/Car_Left.png"),
+      mCarRight(":/car/images/Car_Right.png"),
+      mpSpeedPixmap(nullptr),
+      mpSteerPixmap(nullptr)
 {
     mpUi->setupUi(this);
     this->init();
@@ -53,6 +76,12 @@ MainWindow::MainWindow(QWidget* apParent)
 
 MainWindow::~MainWindow()
 {
+    mpProfile->stop();
+    mpScrubber->stop();
+    mpInput->stop();
+    mpDriver->setTraceRecorder(nullptr);
+    mpRecorder->close();
+    mpLog.reset();
     delete mpUi;
 }
 
@@ -65,6 +94,15 @@ void MainWindow::init()
    mPosSpeedTop = mpUi->sBSpeedTop->pos();
    mPosSpeedBot = mpUi->sBSpeedBot->pos();
 
+   // sliders: drop jitter on direction reversals and single LSB steps, settled on release
+   CAR4TEGRA::InputConditioner::Settings lSliderConditioning = CAR4TEGRA::InputConditioner::passThrough();
+   lSliderConditioning.mHysteresis = INPUT_HYSTERESIS_DEFAULT;
+   lSliderConditioning.mMinChange = INPUT_MIN_CHANGE_DEFAULT;
+   for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+   {
+      mConditioner.setSettings(i, lSliderConditioning);
+   }
+
    // init GUI elements with default values
 
    this->enableI2CSettings(true);
@@ -121,6 +159,202 @@ void MainWindow::init()
    mpUi->sBFreq->setMinimum(PWM_FREQ_MIN);
    mpUi->sBFreq->setMaximum(PWM_FREQ_MAX);
    mpUi->sBFreq->setValue(PWM_FREQ_DEFAULT);
+
+   // log pipeline in front of the log view (thread-safe, used by the scrubber thread too)
+   mpLog = std::make_unique<LogSink>(mpUi->tbLog, QLatin1String(LOG_FILE_DEFAULT), LOG_CAPACITY,
+                                     LOG_FILE_CAPACITY, LOG_FLUSH_INTERVAL_MS, LOG_VIEW_LINES);
+
+   mpScrubber->setDriftCallback([this](const CAR4TEGRA::PCA9685::RegisterDrift& acrDrift, bool aRepaired)
+   {
+      mpLog->append(QString("Register 0x%1 drifted: expected 0x%2, read 0x%3%4")
+                    .arg(acrDrift.mRegister, 2, 16, QChar('0'))
+                    .arg(acrDrift.mExpected, 2, 16, QChar('0'))
+                    .arg(acrDrift.mActual, 2, 16, QChar('0'))
+                    .arg(aRepaired ? " (repaired)" : ""));
+   });
+
+   // record all I2C transactions if requested
+   const char* lpTraceFile = getenv(TRACE_FILE_ENV);
+   if(lpTraceFile != nullptr && lpTraceFile[0] != '\0')
+   {
+      try
+      {
+         mpRecorder->open(lpTraceFile);
+         mpDriver->setTraceRecorder(mpRecorder.get());
+         mpLog->append(QString("Recording I2C trace to ") + QLatin1String(lpTraceFile));
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+   }
+
+   // drive the outputs from an input device if requested
+   const char* lpInputDevice = getenv(INPUT_DEVICE_ENV);
+   if(lpInputDevice != nullptr && lpInputDevice[0] != '\0')
+   {
+      try
+      {
+         mInputDevice = mpInput->openDevice(lpInputDevice);
+         mpInput->setErrorCallback([this](const std::string& acrMessage)
+         {
+            mpLog->append(QString::fromStdString(acrMessage));
+         });
+         mpLog->append(QString("Using input device ") + QLatin1String(lpInputDevice));
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+   }
+
+   // channel dashboard over all boards (separate window, opened from the tool bar)
+   mpChannels = std::make_unique<ChannelModel>(CHANNEL_FRAME_MS);
+   mBoard = mpChannels->addBoard(*mpDriver, [this](int aChannel, int aValue)
+   {
+      // values edited in the dashboard move the speed and steering slider too
+      if(aChannel == mpUi->sbChannelSpeed->value())
+      {
+         mpUi->slidSpeed->setValue(aValue);
+         mpUi->lSpeedVal->setText(QString::number(aValue));
+         this->updateSpeedVisualization(aValue);
+      }
+      if(aChannel == mpUi->sbChannelSteer->value())
+      {
+         mpUi->slidSteer->setValue(aValue);
+         mpUi->lSteerVal->setText(QString::number(aValue));
+         this->updateSteerVisualization(aValue);
+      }
+
+      this->setPWMValue(aChannel, aValue);
+   });
+   this->syncChannelCalibration();
+
+   connect(mpChannels.get(), &ChannelModel::writeFailed, [this](const QString& acrMessage)
+   {
+      mpLog->append(acrMessage);
+   });
+   connect(mpChannels.get(), &ChannelModel::channelEdited, [this](int aBoard, int aChannel)
+   {
+      if(aBoard == mBoard)
+         this->applyCalibration(aChannel, mpChannels->calibration(aBoard, aChannel));
+   });
+
+   // additional boards, connected and disconnected together with the board of the GUI
+   const char* lpBoards = getenv(BOARDS_ENV);
+   if(lpBoards != nullptr)
+   {
+      for(const QString& lcrBoard : QString(QLatin1String(lpBoards)).split(',', QString::SkipEmptyParts))
+      {
+         int lColon = lcrBoard.lastIndexOf(':');
+         bool lCheck = false;
+         int lAddress = (lColon > 0) ? lcrBoard.mid(lColon + 1).toInt(&lCheck, 16) : 0;
+         if(!lCheck)
+         {
+            mpLog->append("Invalid board \"" + lcrBoard + "\" (has to be /dev/i2c-N:HEX)");
+            continue;
+         }
+
+         mBoards.push_back(Board{ std::make_unique<CAR4TEGRA::PCA9685>(), lcrBoard.left(lColon).toStdString(), lAddress, 0 });
+         mBoards.back().mIndex = mpChannels->addBoard(*mBoards.back().mpDriver);
+      }
+   }
+
+   mpChannelView = std::make_unique<QTableView>();
+   mpChannelView->setWindowTitle("Channels");
+   mpChannelView->setModel(mpChannels.get());
+   mpChannelView->setItemDelegate(new ChannelDelegate(mpChannelView.get()));
+   mpChannelView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+   mpChannelView->verticalHeader()->setDefaultSectionSize(CHANNEL_ROW_HEIGHT);
+   mpChannelView->verticalHeader()->hide();
+   mpChannelView->horizontalHeader()->setStretchLastSection(true);
+   mpChannelView->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+   mpChannelView->resize(640, 480);
+
+   QAction* lpChannels = mpUi->mainToolBar->addAction("Channels");
+   connect(lpChannels, &QAction::triggered, [this]()
+   {
+      mpChannelView->show();
+      mpChannelView->raise();
+   });
+
+   // emergency stop of all outputs, the PWM values are kept for enabling them again
+   mpStopAction = mpUi->mainToolBar->addAction("Stop outputs");
+   mpStopAction->setCheckable(true);
+   mpStopAction->setShortcut(QKeySequence(QLatin1String(OUTPUT_STOP_SHORTCUT)));
+   connect(mpStopAction, &QAction::toggled, [this](bool aChecked)
+   {
+      std::vector<CAR4TEGRA::PCA9685*> lDrivers(1, mpDriver.get());
+      for(Board& lrBoard : mBoards)
+      {
+         if(!lrBoard.mpDriver->busName().empty())
+            lDrivers.push_back(lrBoard.mpDriver.get());
+      }
+
+      // a failing board does not keep the others running
+      for(CAR4TEGRA::PCA9685* lpDriver : lDrivers)
+      {
+         try
+         {
+            if(aChecked)
+               lpDriver->emergencyStop();
+            else
+               lpDriver->enableOutputs(0xFFFF);
+         }
+         catch(const std::runtime_error e)
+         {
+            mpLog->append(QLatin1String(e.what()));
+         }
+      }
+
+      mpLog->append(aChecked ? "Outputs stopped" : "Outputs enabled");
+   });
+
+   // take the calibration from a profile and reload it when the file changes
+   const char* lpProfileFile = getenv(PROFILE_FILE_ENV);
+   if(lpProfileFile != nullptr && lpProfileFile[0] != '\0')
+   {
+      try
+      {
+         mpProfile->setErrorCallback([this](const std::string& acrMessage)
+         {
+            mpLog->append(QString::fromStdString(acrMessage));
+         });
+         mpProfile->setChangeCallback([this](const CAR4TEGRA::CalibrationProfile& acrProfile)
+         {
+            (void)acrProfile;
+            emit profileChanged();
+         });
+         connect(this, &MainWindow::profileChanged, this, &MainWindow::applyProfile, Qt::QueuedConnection);
+
+         mpProfile->open(lpProfileFile);
+         this->applyProfile();
+         mpProfile->start();
+         mpLog->append(QString("Watching calibration profile ") + QLatin1String(lpProfileFile));
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+   }
+
+#ifdef C4T_SPAN_TRACING
+   // export the span trace on demand (open with chrome://tracing or ui.perfetto.dev)
+   C4T_TRACE_THREAD("gui");
+   QShortcut* lpExport = new QShortcut(QKeySequence(QLatin1String(SPAN_TRACE_SHORTCUT)), this);
+   connect(lpExport, &QShortcut::activated, [this]()
+   {
+      try
+      {
+         size_t lSpans = CAR4TEGRA::SpanTracer::exportChrome(SPAN_TRACE_FILE_DEFAULT);
+         mpLog->append(QString("Exported %1 spans to %2").arg(lSpans).arg(QLatin1String(SPAN_TRACE_FILE_DEFAULT)));
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+   });
+#endif
 }
 
 
@@ -171,9 +405,14 @@ void MainWindow::updateSpeedVisualization(int aValue)
    bool lForward = ((aValue > lMid) && !lInv) ||
                    ((aValue < lMid) && lInv);
 
-   // updated GUI elements for speed visualization
-   mpUi->lDir1->setPixmap(lForward ? QPixmap(":/car/images/Arrow_Right.png") : QPixmap(":/car/images/Arrow_Left.png"));
-   mpUi->lDir2->setPixmap(lForward ? QPixmap(":/car/images/Arrow_Right.png") : QPixmap(":/car/images/Arrow_Left.png"));
+   // updated GUI elements for speed visualization (preloaded images, only on change)
+   const QPixmap* lpPixmap = lForward ? &mArrowRight : &mArrowLeft;
+   if(lpPixmap != mpSpeedPixmap)
+   {
+      mpUi->lDir1->setPixmap(*lpPixmap);
+      mpUi->lDir2->setPixmap(*lpPixmap);
+      mpSpeedPixmap = lpPixmap;
+   }
 
    // show speed visualization GUI elements only if not stopped
    mpUi->lDir1->setVisible(!lStop);
@@ -192,16 +431,29 @@ void MainWindow::updateSteerVisualization(int aValue)
    bool lLeft = ((aValue > lMid) && !lInv) ||
                    ((aValue < lMid) && lInv);
 
-   // updated GUI elements for steering visualization
-   if(lNeutral)
-      mpUi->lImage->setPixmap(QPixmap(":/car/images/Car.png"));
-   else
-      mpUi->lImage->setPixmap(lLeft ? QPixmap(":/car/images/Car_Left.png") : QPixmap(":/car/images/Car_Right.png"));
+   // updated GUI elements for steering visualization (preloaded images, only on change)
+   const QPixmap* lpPixmap = lNeutral ? &mCar : (lLeft ? &mCarLeft : &mCarRight);
+   if(lpPixmap != mpSteerPixmap)
+   {
+      mpUi->lImage->setPixmap(*lpPixmap);
+      mpSteerPixmap = lpPixmap;
+   }
 }
 
 
-void MainWindow::setPWMValue(int aChannel, int aValue)
+void MainWindow::setPWMValue(int aChannel, int aValue, bool aConditioned)
 {
+   C4T_TRACE_SPAN("ui", "MainWindow::setPWMValue");
+
+   // exact values bypass the conditioning, slider moves continue from them
+   if(!aConditioned)
+   {
+      mConditioner.reset(aChannel);
+   }
+
+   std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+   bool lFailed = false;
+
    try
    {
       // write new value to device
@@ -209,15 +461,272 @@ void MainWindow::setPWMValue(int aChannel, int aValue)
    }
    catch(const std::runtime_error e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
+      lFailed = true;
+   }
+   catch(const std::exception e)
+   {
+      mpLog->append(QLatin1String(e.what()));
+   }
+
+   // plot commanded value and write latency
+   double lUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - lStart).count();
+   mpUi->wTelemetry->addSample(aChannel, aValue, lUs, lFailed);
+   mpChannels->updateValue(mBoard, aChannel, aValue, lFailed);
+
+   if(lFailed)
+   {
+      this->recoverDevice();
+   }
+}
+
+
+void MainWindow::setConditionedValue(int aChannel, int aValue)
+{
+   int64_t lNowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count();
+
+   int lValue;
+   if(mConditioner.process(aChannel, aValue, lNowNs, lValue))
+   {
+      this->setPWMValue(aChannel, lValue, true);
+   }
+}
+
+
+void MainWindow::settleValue(int aChannel)
+{
+   int64_t lNowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count();
+
+   int lValue;
+   if(mConditioner.settle(aChannel, lNowNs, lValue))
+   {
+      this->setPWMValue(aChannel, lValue, true);
+   }
+}
+
+
+void MainWindow::recoverDevice()
+{
+   // only while connected
+   if(!mpUi->btDisconnect->isEnabled())
+      return;
+
+   try
+   {
+      std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+      bool lKept = mpDriver->reconnect();
+      double lUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - lStart).count();
+
+      mpLog->append(QString("Reconnected in %1 us (%2)")
+                    .arg(lUs, 0, 'f', 1)
+                    .arg(lKept ? "device state kept" : "device state restored"));
+   }
+   catch(const std::runtime_error e)
+   {
+      mpLog->append(QLatin1String(e.what()));
    }
    catch(const std::exception e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
 }
 
 
+void MainWindow::updateInputMapping()
+{
+   if(mInputDevice < 0)
+      return;
+
+   try
+   {
+      mpInput->mapAxis(mInputDevice, INPUT_AXIS_SPEED,
+                       CAR4TEGRA::InputReader::AxisMapping{ mpUi->sbChannelSpeed->value(),
+                                                            mpUi->sBSpeedBot->value(),
+                                                            mpUi->sBSpeedTop->value(),
+                                                            mpUi->cbInvSpeed->isChecked() });
+      mpInput->mapAxis(mInputDevice, INPUT_AXIS_STEER,
+                       CAR4TEGRA::InputReader::AxisMapping{ mpUi->sbChannelSteer->value(),
+                                                            mpUi->sBSteerBot->value(),
+                                                            mpUi->sBSteerTop->value(),
+                                                            mpUi->cbInvSteer->isChecked() });
+
+      // axes: spike removal, deadband around the neutral position, jitter gates
+      CAR4TEGRA::InputConditioner::Settings lConditioning = CAR4TEGRA::InputConditioner::passThrough();
+      lConditioning.mFilter = CAR4TEGRA::InputConditioner::FILTER_MEDIAN;
+      lConditioning.mMedianTaps = INPUT_MEDIAN_TAPS_DEFAULT;
+      lConditioning.mDeadband = INPUT_DEADBAND_DEFAULT;
+      lConditioning.mHysteresis = INPUT_HYSTERESIS_DEFAULT;
+      lConditioning.mMinChange = INPUT_MIN_CHANGE_DEFAULT;
+
+      lConditioning.mCenter = (mpUi->sBSpeedBot->value() + mpUi->sBSpeedTop->value()) / 2;
+      mpInput->setConditioning(mpUi->sbChannelSpeed->value(), lConditioning);
+      lConditioning.mCenter = (mpUi->sBSteerBot->value() + mpUi->sBSteerTop->value()) / 2;
+      mpInput->setConditioning(mpUi->sbChannelSteer->value(), lConditioning);
+   }
+   catch(const std::runtime_error e)
+   {
+      mpLog->append(QLatin1String(e.what()));
+   }
+   catch(const std::exception e)
+   {
+      mpLog->append(QLatin1String(e.what()));
+   }
+}
+
+
+void MainWindow::applyProfile()
+{
+   CAR4TEGRA::CalibrationProfile lProfile = mpProfile->profile();
+   bool lConnected = mpUi->btDisconnect->isEnabled();
+
+   if(lProfile.frequency() != 0.0f && lProfile.frequency() != (float)mpUi->sBFreq->value())
+   {
+      mpUi->sBFreq->setValue(lProfile.frequency());
+      if(lConnected)
+         this->on_sBFreq_editingFinished();
+   }
+
+   this->applyCalibration(mpUi->sbChannelSpeed->value(), lProfile.channel(mpUi->sbChannelSpeed->value()));
+   this->applyCalibration(mpUi->sbChannelSteer->value(), lProfile.channel(mpUi->sbChannelSteer->value()));
+
+   mpLog->append("Calibration profile applied from " + QString::fromStdString(mpProfile->fileName()));
+}
+
+
+void MainWindow::applyCalibration(int aChannel, const CAR4TEGRA::ChannelCalibration& acrCalibration)
+{
+   if(!acrCalibration.mUsed)
+      return;
+
+   bool lConnected = mpUi->btDisconnect->isEnabled();
+
+   if(aChannel == mpUi->sbChannelSpeed->value())
+   {
+      if(acrCalibration.mMin != mpUi->sBSpeedBot->value() || acrCalibration.mMax != mpUi->sBSpeedTop->value())
+      {
+         // the borders limit each other, so both are released first
+         mpUi->sBSpeedBot->setMaximum(PWM_MAX - 1);
+         mpUi->sBSpeedTop->setMinimum(PWM_MIN + 1);
+         mpUi->sBSpeedBot->setValue(acrCalibration.mMin);
+         mpUi->sBSpeedTop->setValue(acrCalibration.mMax);
+
+         // without device the slider only follows the borders
+         if(!lConnected)
+            mpUi->slidSpeed->setRange(acrCalibration.mMin, acrCalibration.mMax);
+
+         this->on_sBSpeedBot_editingFinished();
+         this->on_sBSpeedTop_editingFinished();
+      }
+      if(acrCalibration.mInverted != mpUi->cbInvSpeed->isChecked())
+      {
+         mpUi->cbInvSpeed->setChecked(acrCalibration.mInverted);
+         this->on_cbInvSpeed_clicked(acrCalibration.mInverted);
+      }
+   }
+
+   if(aChannel == mpUi->sbChannelSteer->value())
+   {
+      if(acrCalibration.mMin != mpUi->sBSteerBot->value() || acrCalibration.mMax != mpUi->sBSteerTop->value())
+      {
+         mpUi->sBSteerBot->setMaximum(PWM_MAX - 1);
+         mpUi->sBSteerTop->setMinimum(PWM_MIN + 1);
+         mpUi->sBSteerBot->setValue(acrCalibration.mMin);
+         mpUi->sBSteerTop->setValue(acrCalibration.mMax);
+
+         if(!lConnected)
+            mpUi->slidSteer->setRange(acrCalibration.mMin, acrCalibration.mMax);
+
+         this->on_sBSteerBot_editingFinished();
+         this->on_sBSteerTop_editingFinished();
+      }
+      if(acrCalibration.mInverted != mpUi->cbInvSteer->isChecked())
+      {
+         mpUi->cbInvSteer->setChecked(acrCalibration.mInverted);
+         this->on_cbInvSteer_clicked(acrCalibration.mInverted);
+      }
+   }
+}
+
+
+void MainWindow::syncChannelCalibration()
+{
+   mpChannels->setCalibration(mBoard, mpUi->sbChannelSpeed->value(),
+                              CAR4TEGRA::ChannelCalibration{ true, mpUi->sBSpeedBot->value(),
+                                                             mpUi->sBSpeedTop->value(),
+                                                             mpUi->cbInvSpeed->isChecked() });
+   mpChannels->setCalibration(mBoard, mpUi->sbChannelSteer->value(),
+                              CAR4TEGRA::ChannelCalibration{ true, mpUi->sBSteerBot->value(),
+                                                             mpUi->sBSteerTop->value(),
+                                                             mpUi->cbInvSteer->isChecked() });
+}
+
+
+void MainWindow::connectBoards()
+{
+   for(Board& lrBoard : mBoards)
+   {
+      try
+      {
+         lrBoard.mpDriver->openDevice(lrBoard.mBus, lrBoard.mAddress);
+         lrBoard.mpDriver->fastConnect((float)mpUi->sBFreq->value());
+
+         mpLog->append(QString("Connected to 0x%1 on bus %2")
+                       .arg(lrBoard.mAddress, 2, 16, QChar('0'))
+                       .arg(QString::fromStdString(lrBoard.mBus)));
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+      catch(const std::exception e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+
+      mpChannels->boardChanged(lrBoard.mIndex);
+   }
+}
+
+
+void MainWindow::disconnectBoards()
+{
+   for(Board& lrBoard : mBoards)
+   {
+      if(lrBoard.mpDriver->busName().empty())
+         continue;
+
+      try
+      {
+         lrBoard.mpDriver->stopOutputs(0xFFFF);
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+      catch(const std::exception e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+
+      try
+      {
+         lrBoard.mpDriver->close();
+      }
+      catch(const std::runtime_error e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+      catch(const std::exception e)
+      {
+         mpLog->append(QLatin1String(e.what()));
+      }
+
+      mpChannels->boardChanged(lrBoard.mIndex);
+   }
+}
+
 void MainWindow::on_btConnect_clicked()
 {
    try
@@ -227,60 +736,101 @@ void MainWindow::on_btConnect_clicked()
       mpDriver->openDevice(mpUi->cbBusSelect->currentText().toStdString(),
                            mpUi->leAddressHex->text().toInt(&lCheck, 16));
 
+      // a new device session starts with enabled outputs
+      QSignalBlocker lBlocker(mpStopAction);
+      mpStopAction->setChecked(false);
+
       // disable bus / device settings
       this->enableI2CSettings(false);
 
-      mpUi->tbLog->append("Connected to 0x" + mpUi->leAddressHex->text() +
-                          " on bus " + mpUi->cbBusSelect->currentText());
-
-      // set device to default values and disable PWM outputs (value: 0 / 0)
-      mpDriver->reset();
-      mpDriver->setPWMFrequency((float)mpUi->sBFreq->value());
-      mpDriver->setAllPWM(0, 0);
+      mpLog->append("Connected to 0x" + mpUi->leAddressHex->text() +
+                    " on bus " + mpUi->cbBusSelect->currentText());
+
+      // keep a device already running with this configuration, otherwise set it to default
+      // values and disable PWM outputs (value: 0 / 0)
+      if(mpDriver->fastConnect((float)mpUi->sBFreq->value()))
+      {
+         mpLog->append("Adopted running device configuration and outputs");
+      }
+
+      mpChannels->boardChanged(mBoard);
+      this->connectBoards();
+
+      // start background read back
+      mpScrubber->start(std::chrono::milliseconds(SCRUB_INTERVAL_MS), SCRUB_REPAIR_DEFAULT);
+
+      // start input path
+      if(mInputDevice >= 0)
+      {
+         this->updateInputMapping();
+         mpInput->resetLatency();
+         mpInput->start();
+      }
    }
    catch(const std::runtime_error e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
    catch(const std::exception e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
 }
 
 
 void MainWindow::on_btDisconnect_clicked()
 {
+   mpScrubber->stop();
+
+   // stop input path and report its input-to-register latency
+   if(mInputDevice >= 0)
+   {
+      mpInput->stop();
+
+      CAR4TEGRA::InputReader::LatencyStatistics lLatency = mpInput->latency();
+      mpLog->append(QString("Input latency: %1 setpoints, mean %2 us, p99 %3 us, max %4 us")
+                    .arg(lLatency.mCount)
+                    .arg(lLatency.mMeanUs, 0, 'f', 1)
+                    .arg(lLatency.mP99Us, 0, 'f', 1)
+                    .arg(lLatency.mMaxUs, 0, 'f', 1));
+   }
+
    try
    {
-      // disable PWM outputs (value: 0 / 0)
-      mpDriver->setAllPWM(0, 0);
+      // disable PWM outputs (FULL_OFF, one byte)
+      mpDriver->stopOutputs(0xFFFF);
    }
    catch(const std::runtime_error e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
    catch(const std::exception e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
 
+   this->disconnectBoards();
+
    try
    {
       mpDriver->close();
+      mpChannels->boardChanged(mBoard);
+
+      QSignalBlocker lBlocker(mpStopAction);
+      mpStopAction->setChecked(false);
 
       // enable bus / device settings
       this->enableI2CSettings(true);
 
-      mpUi->tbLog->append("Disconnected");
+      mpLog->append("Disconnected");
    }
    catch(const std::runtime_error e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
    catch(const std::exception e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
 
 }
@@ -311,6 +861,8 @@ void MainWindow::on_sBSpeedBot_editingFinished()
    }
    mpUi->slidSpeed->setMinimum(mpUi->sBSpeedBot->value());
    this->updateSpeedVisualization(mpUi->slidSpeed->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
@@ -325,6 +877,8 @@ void MainWindow::on_sBSpeedTop_editingFinished()
    }
    mpUi->slidSpeed->setMaximum(mpUi->sBSpeedTop->value());
    this->updateSpeedVisualization(mpUi->sBSpeedTop->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
@@ -339,6 +893,8 @@ void MainWindow::on_sBSteerBot_editingFinished()
    }
    mpUi->slidSteer->setMinimum(mpUi->sBSteerBot->value());
    this->updateSteerVisualization(mpUi->slidSteer->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
@@ -353,20 +909,38 @@ void MainWindow::on_sBSteerTop_editingFinished()
    }
    mpUi->slidSteer->setMaximum(mpUi->sBSteerTop->value());
    this->updateSteerVisualization(mpUi->slidSteer->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
 void MainWindow::on_slidSpeed_sliderMoved(int aPosition)
 {
+   C4T_TRACE_SPAN("ui", "slidSpeed sliderMoved");
+
    this->updateSpeedVisualization(aPosition);
-   this->setPWMValue(mpUi->sbChannelSpeed->value(), aPosition);
+   this->setConditionedValue(mpUi->sbChannelSpeed->value(), aPosition);
+}
+
+
+void MainWindow::on_slidSpeed_sliderReleased()
+{
+   this->settleValue(mpUi->sbChannelSpeed->value());
 }
 
 
 void MainWindow::on_slidSteer_sliderMoved(int aPosition)
 {
+   C4T_TRACE_SPAN("ui", "slidSteer sliderMoved");
+
    this->updateSteerVisualization(aPosition);
-   this->setPWMValue(mpUi->sbChannelSteer->value(), aPosition);
+   this->setConditionedValue(mpUi->sbChannelSteer->value(), aPosition);
+}
+
+
+void MainWindow::on_slidSteer_sliderReleased()
+{
+   this->settleValue(mpUi->sbChannelSteer->value());
 }
 
 
@@ -377,6 +951,8 @@ void MainWindow::on_cbInvSteer_clicked(bool aChecked)
    mpUi->sBSteerTop->move(aChecked ? mPosSteerBot : mPosSteerTop);
 
    this->updateSteerVisualization(mpUi->slidSteer->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
@@ -387,6 +963,8 @@ void MainWindow::on_cbInvSpeed_clicked(bool aChecked)
    mpUi->sBSpeedTop->move(aChecked ? mPosSpeedBot : mPosSpeedTop);
 
    this->updateSpeedVisualization(mpUi->sBSpeedTop->value());
+   this->updateInputMapping();
+   this->syncChannelCalibration();
 }
 
 
@@ -394,17 +972,22 @@ void MainWindow::on_sBFreq_editingFinished()
 {
    try
    {
-      // set new PWM frequency
+      // set new PWM frequency (all boards)
       mpDriver->setPWMFrequency((float)mpUi->sBFreq->value());
+      for(Board& lrBoard : mBoards)
+      {
+         if(!lrBoard.mpDriver->busName().empty())
+            lrBoard.mpDriver->setPWMFrequency((float)mpUi->sBFreq->value());
+      }
 
-      mpUi->tbLog->append("PWM frequency changed to " + QString("%1").arg(mpUi->sBFreq->value(), 0, 'f', 3) + " Hz");
+      mpLog->append("PWM frequency changed to " + QString("%1").arg(mpUi->sBFreq->value(), 0, 'f', 3) + " Hz");
    }
    catch(const std::runtime_error e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
    catch(const std::exception e)
    {
-      mpUi->tbLog->append(QLatin1String(e.what()));
+      mpLog->append(QLatin1String(e.what()));
    }
 }
@@ -0,0 +1,250 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file outputmixer.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class OutputMixer at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/outputmixer.hpp"
+
+
+namespace
+{
+   const float PWM_MAX = 4095.0f;   ///< Maximum PWM value
+} // namespace
+
+
+namespace CAR4TEGRA
+{
+   OutputMixer::OutputMixer(int aInputs, int aOutputs)
+      : mInputs(aInputs)
+      , mOutputs(aOutputs)
+      , mVectors((aOutputs + MIXER_LANES - 1) / MIXER_LANES)
+   {
+      if(aInputs < 1 || aInputs > MIXER_INPUTS_MAX)
+      {
+         throw std::range_error("Invalid number of mixer inputs \"" + std::to_string(aInputs) +
+                                "\" (has to be between 1 and " + std::to_string(MIXER_INPUTS_MAX) + ")");
+      }
+
+      if(aOutputs < 1 || aOutputs > MIXER_OUTPUTS_MAX)
+      {
+         throw std::range_error("Invalid number of mixer outputs \"" + std::to_string(aOutputs) +
+                                "\" (has to be between 1 and " + std::to_string(MIXER_OUTPUTS_MAX) + ")");
+      }
+
+      this->clear();
+
+      // padding lanes stay at 0 and are never copied out
+      for(int v = 0; v < VECTORS_MAX; v++)
+      {
+         for(int l = 0; l < MIXER_LANES; l++)
+         {
+            mClampMin[v][l] = -1.0f;
+            mClampMax[v][l] = 1.0f;
+            mPwmCenter[v][l] = PWM_MAX / 2.0f;
+            mPwmScale[v][l] = PWM_MAX / 2.0f;
+         }
+      }
+   }
+
+
+   int OutputMixer::inputs() const
+   {
+      return mInputs;
+   }
+
+
+   int OutputMixer::outputs() const
+   {
+      return mOutputs;
+   }
+
+
+   void OutputMixer::setWeight(int aOutput, int aInput, float aWeight)
+   {
+      checkOutput(aOutput);
+      checkInput(aInput);
+      checkFinite(aWeight);
+
+      mWeights[aInput][aOutput / MIXER_LANES][aOutput % MIXER_LANES] = aWeight;
+   }
+
+
+   float OutputMixer::weight(int aOutput, int aInput) const
+   {
+      checkOutput(aOutput);
+      checkInput(aInput);
+
+      return mWeights[aInput][aOutput / MIXER_LANES][aOutput % MIXER_LANES];
+   }
+
+
+   void OutputMixer::setOffset(int aOutput, float aOffset)
+   {
+      checkOutput(aOutput);
+      checkFinite(aOffset);
+
+      mOffsets[aOutput / MIXER_LANES][aOutput % MIXER_LANES] = aOffset;
+   }
+
+
+   void OutputMixer::setClamp(int aOutput, float aMin, float aMax)
+   {
+      checkOutput(aOutput);
+      checkFinite(aMin);
+      checkFinite(aMax);
+
+      if(aMin > aMax)
+      {
+         throw std::range_error("Invalid clamp range of mixer output " + std::to_string(aOutput) +
+                                " (lower bound above upper bound)");
+      }
+
+      mClampMin[aOutput / MIXER_LANES][aOutput % MIXER_LANES] = aMin;
+      mClampMax[aOutput / MIXER_LANES][aOutput % MIXER_LANES] = aMax;
+   }
+
+
+   void OutputMixer::setCalibration(int aOutput, int aPwmMin, int aPwmMax)
+   {
+      checkOutput(aOutput);
+
+      if(aPwmMin < 0 || aPwmMin > PWM_MAX || aPwmMax < 0 || aPwmMax > PWM_MAX)
+      {
+         throw std::range_error("Invalid calibration of mixer output " + std::to_string(aOutput) +
+                                " (PWM values have to be between 0 and 4095)");
+      }
+
+      mPwmCenter[aOutput / MIXER_LANES][aOutput % MIXER_LANES] = (aPwmMin + aPwmMax) / 2.0f;
+      mPwmScale[aOutput / MIXER_LANES][aOutput % MIXER_LANES] = (aPwmMax - aPwmMin) / 2.0f;
+   }
+
+
+   void OutputMixer::clear()
+   {
+      Lanes lZero = {};
+      for(OutputVector& lrWeights : mWeights)
+      {
+         lrWeights.fill(lZero);
+      }
+      mOffsets.fill(lZero);
+   }
+
+
+   void OutputMixer::mix(const float* apInputs, float* apOutputs) const
+   {
+      OutputVector lOutputs;
+      this->compute(apInputs, lOutputs);
+      memcpy(apOutputs, lOutputs.data(), mOutputs * sizeof(float));
+   }
+
+
+   void OutputMixer::mixToPwm(const float* apInputs, uint16_t* apOffValues) const
+   {
+      typedef int32_t IntLanes __attribute__((vector_size(MIXER_LANES * sizeof(int32_t))));
+      typedef uint16_t PwmLanes __attribute__((vector_size(MIXER_LANES * sizeof(uint16_t))));
+
+      OutputVector lOutputs;
+      this->compute(apInputs, lOutputs);
+
+      // calibration mapping, rounded (values are not negative after clamping)
+      PwmLanes lPwm[VECTORS_MAX];
+      for(int v = 0; v < mVectors; v++)
+      {
+         Lanes lValue = mPwmCenter[v] + lOutputs[v] * mPwmScale[v] + 0.5f;
+         lValue = lValue > 0.0f ? lValue : 0.0f;
+         lValue = lValue < PWM_MAX ? lValue : PWM_MAX;
+         lPwm[v] = __builtin_convertvector(__builtin_convertvector(lValue, IntLanes), PwmLanes);
+      }
+
+      memcpy(apOffValues, lPwm, mOutputs * sizeof(uint16_t));
+   }
+
+
+   void OutputMixer::compute(const float* apInputs, OutputVector& arOutputs) const
+   {
+      // broadcast every input to all lanes once
+      Lanes lInputs[MIXER_INPUTS_MAX];
+      for(int i = 0; i < mInputs; i++)
+      {
+         float lInput = std::isfinite(apInputs[i]) ? apInputs[i] : 0.0f;
+         lInputs[i] = Lanes{} + lInput;
+      }
+
+      // the accumulator of a vector stays in a register over all inputs
+      for(int v = 0; v < mVectors; v++)
+      {
+         Lanes lSum = mOffsets[v];
+         for(int i = 0; i < mInputs; i++)
+         {
+            lSum += lInputs[i] * mWeights[i][v];
+         }
+
+         lSum = lSum > mClampMin[v] ? lSum : mClampMin[v];
+         arOutputs[v] = lSum < mClampMax[v] ? lSum : mClampMax[v];
+      }
+   }
+
+
+   void OutputMixer::checkOutput(int aOutput) const
+   {
+      if(aOutput < 0 || aOutput >= mOutputs)
+      {
+         throw std::range_error("Invalid mixer output \"" + std::to_string(aOutput) +
+                                "\" (has to be between 0 and " + std::to_string(mOutputs - 1) + ")");
+      }
+   }
+
+
+   void OutputMixer::checkInput(int aInput) const
+   {
+      if(aInput < 0 || aInput >= mInputs)
+      {
+         throw std::range_error("Invalid mixer input \"" + std::to_string(aInput) +
+                                "\" (has to be between 0 and " + std::to_string(mInputs - 1) + ")");
+      }
+   }
+
+
+   void OutputMixer::checkFinite(float aValue)
+   {
+      if(!std::isfinite(aValue))
+      {
+         throw std::range_error("Invalid mixer value (has to be finite)");
+      }
+   }
+} // namespace CAR4TEGRA
@@ -32,22 +32,36 @@
 
 
 // std includes
-#include <unistd.h>
 #include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <stdexcept>
 
 
 // Car4Tegra includes
 #include "include/pca9685.hpp"
+#include "include/spantracer.hpp"
 
 
 namespace CAR4TEGRA
 {
    PCA9685::PCA9685()
-      : mpI2CDevice(std::make_unique<CAR4TEGRA::I2cDevice>()), mAddress(0x00), mBusName("")
+      : mpI2CDevice(std::make_unique<CAR4TEGRA::I2cDevice>()), mAddress(0x00), mBusName(""),
+        mPendingAccesses(0), mStopped(0), mEmergencyStops(0), mWrites(0), mpClock(&DriverClock::monotonic())
    {
-      // nothing to do
+      mShadow.fill(0x00);
+      mResumeOffHigh.fill(0x00);
+   }
+
+
+   PCA9685::PCA9685(std::unique_ptr<CAR4TEGRA::I2cDevice> apDevice)
+      : mpI2CDevice(std::move(apDevice)), mAddress(0x00), mBusName(""),
+        mPendingAccesses(0), mStopped(0), mEmergencyStops(0), mWrites(0), mpClock(&DriverClock::monotonic())
+   {
+      mShadow.fill(0x00);
+      mResumeOffHigh.fill(0x00);
    }
 
 
@@ -57,74 +71,172 @@ namespace CAR4TEGRA
    }
 
 
-   void PCA9685::openDevice(const std::string arBusName, int aAddress)
+   void PCA9685::openDevice(const std::string& acrBusName, int aAddress)
    {
-      mBusName = arBusName;
+      mBusName = acrBusName;
       mAddress = aAddress;
 
-      mpI2CDevice->openDevice(arBusName, aAddress);
+      BusGuard lGuard(*this);
+      mShadowValid.reset();
+      mShadowDirty.reset();
+      mStopped = 0;
+      mpI2CDevice->openDevice(acrBusName, aAddress);
    }
 
 
    void PCA9685::close()
    {
+      BusGuard lGuard(*this);
+
       mBusName = "";
       mAddress = 0x00;
+      mShadowValid.reset();
+      mShadowDirty.reset();
+      mStopped = 0;
 
       mpI2CDevice->closeBus();
    }
 
 
+   bool PCA9685::reconnect()
+   {
+      BusGuard lGuard(*this);
+
+      if(mBusName.empty())
+      {
+         throw std::runtime_error("Failed to reconnect PCA9685 device: device was not connected before");
+      }
+
+      // reopen the bus in place, a failing close of a broken descriptor is not an error here
+      try
+      {
+         mpI2CDevice->closeBus();
+      }
+      catch(const std::runtime_error&)
+      {
+      }
+      mpI2CDevice->openDevice(mBusName, mAddress);
+
+
+      // one read shows if the device kept its configuration (a power loss resets MODE1 to SLEEP)
+      std::bitset<PCA9685_REG_COUNT> lConfig;
+      lConfig.set(PCA9685_REG_MODE1).set(PCA9685_REG_MODE2).set(PCA9685_REG_PRE_SCALE);
+
+      int lMode1 = mpI2CDevice->readByte(PCA9685_REG_MODE1);
+      bool lKept = mShadowValid.test(PCA9685_REG_MODE1) && (mShadowDirty & lConfig).none() &&
+                   ((lMode1 ^ mShadow[PCA9685_REG_MODE1]) & this->scrubMask(PCA9685_REG_MODE1)) == 0;
+
+      if(lKept)
+      {
+         // only the registers whose last write failed
+         this->writeShadow(PCA9685_REG_LED0_ON_L, PCA9685_REG_LED15_OFF_H, mShadowDirty);
+         return true;
+      }
+
+      // complete restore: configuration (with oscillator start), then all known LEDn values
+      this->restoreConfiguration();
+      this->writeShadow(PCA9685_REG_LED0_ON_L, PCA9685_REG_LED15_OFF_H, mShadowValid);
+      mShadowDirty.reset();
+
+      return false;
+   }
+
+
    void PCA9685::reset()
    {
-      // write basic settings
-      this->writeRegister(PCA9685_REG_MODE1, PCA9685_MODE1_ALLCALL);
-      this->writeRegister(PCA9685_REG_MODE2, PCA9685_MODE2_OUTDRV);
+      BusGuard lGuard(*this);
+
+      // write basic settings (auto-increment is needed for block transfers)
+      this->busWrite(PCA9685_REG_MODE1, PCA9685_MODE1_ALLCALL | PCA9685_MODE1_AI);
+      this->busWrite(PCA9685_REG_MODE2, PCA9685_MODE2_OUTDRV);
 
       // wait for oscillator (at least 500us)
-      usleep(2000);
+      mpClock->sleepFor(std::chrono::microseconds(2000));
    }
 
 
    int PCA9685::readRegister(int aRegister)
    {
-      return mpI2CDevice->readByte(aRegister);
+      BusGuard lGuard(*this);
+      return this->busRead(aRegister);
    }
 
 
    int PCA9685::writeRegister(int aRegister, int aValue)
    {
-      return mpI2CDevice->writeByte(aRegister, aValue);
+      BusGuard lGuard(*this);
+      return this->busWrite(aRegister, aValue);
+   }
+
+
+   int PCA9685::writeRegisterBlock(int aRegister, const uint8_t* apData, size_t aLength)
+   {
+      BusGuard lGuard(*this);
+      return this->busWriteBlock(aRegister, apData, aLength);
+   }
+
+
+   bool PCA9685::fastConnect(float aFrequency)
+   {
+      {
+         BusGuard lGuard(*this);
+
+         // PRE_SCALE, MODE1, MODE2, SUBADRx, ALLCALLADR, LEDn in one transfer
+         uint8_t lState[PCA9685_STATE_LENGTH];
+         mpI2CDevice->readBlock(PCA9685_REG_PRE_SCALE, lState, sizeof(lState));
+
+         const uint8_t* lpLow = &lState[1];
+         int lMode1 = lpLow[PCA9685_REG_MODE1] & this->scrubMask(PCA9685_REG_MODE1);
+         int lMode2 = lpLow[PCA9685_REG_MODE2] & this->scrubMask(PCA9685_REG_MODE2);
+
+         // without auto-increment every byte would be PRE_SCALE, MODE2 does not match then
+         if(lMode1 == (PCA9685_MODE1_ALLCALL | PCA9685_MODE1_AI) && lMode2 == PCA9685_MODE2_OUTDRV &&
+            lState[0] == PCA9685::prescale(aFrequency))
+         {
+            // adopt the running state (without the self-clearing RESTART bit)
+            this->updateShadow(PCA9685_REG_PRE_SCALE, lState, 1);
+            this->updateShadow(PCA9685_BLOCK_LOW_FIRST, lpLow, PCA9685_BLOCK_LOW_LAST - PCA9685_BLOCK_LOW_FIRST + 1);
+            mShadow[PCA9685_REG_MODE1] = static_cast<uint8_t>(lMode1);
+            return true;
+         }
+      }
+
+      // set device to default values and disable PWM outputs (value: 0 / 0)
+      this->reset();
+      this->setPWMFrequency(aFrequency);
+      this->setAllPWM(0, 0);
+
+      return false;
    }
 
 
    void PCA9685::setPWMFrequency(float aFrequency)
    {
-      // limit argument to allowed range
-      float lFreq = fmin(fmax(aFrequency, 24), 1526);
+      int lPrescale = PCA9685::prescale(aFrequency);
 
-      // calculate prescale for 25 MHz internal oscillator
-      int lPrescale = (int)round((25000000.0f / (4096 * lFreq)) - 1.0f);
+      BusGuard lGuard(*this);
 
       // prepare device to change prescale (only writeable wenn SLEEP = 1)
-      int lMode1 = this->readRegister(PCA9685_REG_MODE1);
+      int lMode1 = this->busRead(PCA9685_REG_MODE1);
       int lMode1Res = (lMode1 & 0x7F) | PCA9685_MODE1_SLEEP;
-      this->writeRegister(PCA9685_REG_MODE1, lMode1Res);
+      this->busWrite(PCA9685_REG_MODE1, lMode1Res);
 
       // set new freqeuncy prescale
-      this->writeRegister(PCA9685_REG_PRE_SCALE, lPrescale);
+      this->busWrite(PCA9685_REG_PRE_SCALE, lPrescale);
 
       // reset MODE1 and wait for oscillator (at least 500us)
-      this->writeRegister(PCA9685_REG_MODE1, lMode1);
-      usleep(2000);
+      this->busWrite(PCA9685_REG_MODE1, lMode1);
+      mpClock->sleepFor(std::chrono::microseconds(2000));
 
       // restart PWM
-      this->writeRegister(PCA9685_REG_MODE1, lMode1 | PCA9685_MODE1_RESTART);
+      this->busWrite(PCA9685_REG_MODE1, lMode1 | PCA9685_MODE1_RESTART);
    }
 
 
    void PCA9685::setPWM(int aChannel, int aOnValue, int aOffValue)
    {
+      C4T_TRACE_SPAN("driver", "PCA9685::setPWM");
+
       // check if valid channel
       if(aChannel > 15 || aChannel < 0)
       {
@@ -137,25 +249,669 @@ namespace CAR4TEGRA
       int lOnValue = fmin(fmax(aOnValue, 0), 4095);
       int lOffValue = fmin(fmax(aOffValue, 0), 4095);
 
+      BusGuard lGuard(*this);
+
+      // a stopped channel takes the values but stays off
+      int lOffHigh = lOffValue >> 8;
+      if(mStopped & (1u << aChannel))
+      {
+         mResumeOffHigh[aChannel] = static_cast<uint8_t>(lOffHigh);
+         lOffHigh = PCA9685_LED_FULL;
+      }
+
+      // one auto-increment transfer if possible, single register writes otherwise
+      if(this->autoIncrement())
+      {
+         uint8_t lData[4] = { static_cast<uint8_t>(lOnValue & 0xFF), static_cast<uint8_t>(lOnValue >> 8),
+                              static_cast<uint8_t>(lOffValue & 0xFF), static_cast<uint8_t>(lOffHigh) };
+         this->busWriteBlock(PCA9685_REG_LED0_ON_L + 4 * aChannel, lData, 4);
+         return;
+      }
+
       // write register values
-      this->writeRegister(PCA9685_REG_LED0_ON_L + 4 * aChannel, lOnValue & 0xFF);
-      this->writeRegister(PCA9685_REG_LED0_ON_H + 4 * aChannel, lOnValue >> 8);
-      this->writeRegister(PCA9685_REG_LED0_OFF_L + 4 * aChannel, lOffValue & 0xFF);
-      this->writeRegister(PCA9685_REG_LED0_OFF_H + 4 * aChannel, lOffValue >> 8);
+      this->busWrite(PCA9685_REG_LED0_ON_L + 4 * aChannel, lOnValue & 0xFF);
+      this->busWrite(PCA9685_REG_LED0_ON_H + 4 * aChannel, lOnValue >> 8);
+      this->busWrite(PCA9685_REG_LED0_OFF_L + 4 * aChannel, lOffValue & 0xFF);
+      this->busWrite(PCA9685_REG_LED0_OFF_H + 4 * aChannel, lOffHigh);
+   }
+
+
+   void PCA9685::setPWMBatch(uint16_t aChannelMask, const uint16_t* apOnValues, const uint16_t* apOffValues)
+   {
+      C4T_TRACE_SPAN("driver", "PCA9685::setPWMBatch");
+
+      if(aChannelMask == 0)
+         return;
+
+      RegisterImage lTarget;
+      std::bitset<PCA9685_REG_COUNT> lMask;
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!(aChannelMask & (1u << lChannel)))
+            continue;
+
+         int lOnValue = std::min(std::max<int>(apOnValues[lChannel], 0), 4095);
+         int lOffValue = std::min(std::max<int>(apOffValues[lChannel], 0), 4095);
+         int lReg = PCA9685_REG_LED0_ON_L + 4 * lChannel;
+
+         lTarget[lReg] = static_cast<uint8_t>(lOnValue & 0xFF);
+         lTarget[lReg + 1] = static_cast<uint8_t>(lOnValue >> 8);
+         lTarget[lReg + 2] = static_cast<uint8_t>(lOffValue & 0xFF);
+         lTarget[lReg + 3] = static_cast<uint8_t>(lOffValue >> 8);
+         lMask.set(lReg).set(lReg + 1).set(lReg + 2).set(lReg + 3);
+      }
+
+      BusGuard lGuard(*this);
+      this->holdStopped(lTarget, lMask);
+
+      // unselected channels keep their values, known ones may be rewritten to bridge gaps
+      for(int lReg = PCA9685_REG_LED0_ON_L; lReg <= PCA9685_REG_LED15_OFF_H; lReg++)
+      {
+         if(lMask.test(lReg))
+            continue;
+
+         lTarget[lReg] = mShadow[lReg];
+         lMask.set(lReg, mShadowValid.test(lReg) && !mShadowDirty.test(lReg));
+      }
+
+      this->writePlanned(lTarget, lMask);
+   }
+
+
+   double PCA9685::writeImage(const RegisterImage& acrTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask)
+   {
+      C4T_TRACE_SPAN("driver", "PCA9685::writeImage");
+
+      BusGuard lGuard(*this);
+
+      if(mStopped != 0)
+      {
+         RegisterImage lTarget = acrTarget;
+         this->holdStopped(lTarget, acrMask);
+         return this->writePlanned(lTarget, acrMask);
+      }
+
+      return this->writePlanned(acrTarget, acrMask);
+   }
+
+
+   void PCA9685::setBusTiming(uint32_t aBusClock, double aOverheadUs)
+   {
+      BusGuard lGuard(*this);
+      mPlanner.setBusClock(aBusClock);
+      mPlanner.setTransactionOverhead(aOverheadUs);
+   }
+
+
+   bool PCA9685::autoIncrement() const
+   {
+      return mShadowValid.test(PCA9685_REG_MODE1) && (mShadow[PCA9685_REG_MODE1] & PCA9685_MODE1_AI);
+   }
+
+
+   const std::string& PCA9685::busName() const
+   {
+      return mBusName;
+   }
+
+
+   int PCA9685::address() const
+   {
+      return mAddress;
    }
 
 
    void PCA9685::setAllPWM(int aOnValue, int aOffValue)
    {
+      C4T_TRACE_SPAN("driver", "PCA9685::setAllPWM");
+
       // limit arguments to allowed range
       int lOnValue = fmin(fmax(aOnValue, 0), 4095);
       int lOffValue = fmin(fmax(aOffValue, 0), 4095);
 
+      BusGuard lGuard(*this);
+
+      // stopped channels need their own LEDn_OFF_H value, the planner keeps the ALL_LED writes for the rest
+      if(mStopped != 0)
+      {
+         RegisterImage lTarget;
+         std::bitset<PCA9685_REG_COUNT> lMask;
+
+         for(int lReg = PCA9685_REG_LED0_ON_L; lReg <= PCA9685_REG_LED15_OFF_H; lReg += 4)
+         {
+            lTarget[lReg] = static_cast<uint8_t>(lOnValue & 0xFF);
+            lTarget[lReg + 1] = static_cast<uint8_t>(lOnValue >> 8);
+            lTarget[lReg + 2] = static_cast<uint8_t>(lOffValue & 0xFF);
+            lTarget[lReg + 3] = static_cast<uint8_t>(lOffValue >> 8);
+            lMask.set(lReg).set(lReg + 1).set(lReg + 2).set(lReg + 3);
+         }
+
+         this->holdStopped(lTarget, lMask);
+         this->writePlanned(lTarget, lMask);
+         return;
+      }
+
       // write register values
-      this->writeRegister(PCA9685_REG_ALL_LED_ON_L, lOnValue & 0xFF);
-      this->writeRegister(PCA9685_REG_ALL_LED_ON_H, lOnValue >> 8);
-      this->writeRegister(PCA9685_REG_ALL_LED_OFF_L, lOffValue & 0xFF);
-      this->writeRegister(PCA9685_REG_ALL_LED_OFF_H, lOffValue >> 8);
+      this->busWrite(PCA9685_REG_ALL_LED_ON_L, lOnValue & 0xFF);
+      this->busWrite(PCA9685_REG_ALL_LED_ON_H, lOnValue >> 8);
+      this->busWrite(PCA9685_REG_ALL_LED_OFF_L, lOffValue & 0xFF);
+      this->busWrite(PCA9685_REG_ALL_LED_OFF_H, lOffValue >> 8);
+   }
+
+
+   void PCA9685::stopOutputs(uint16_t aChannelMask)
+   {
+      C4T_TRACE_SPAN("driver", "PCA9685::stopOutputs");
+
+      RegisterImage lTarget;
+      std::bitset<PCA9685_REG_COUNT> lMask;
+
+      BusGuard lGuard(*this);
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         int lReg = PCA9685_REG_LED0_OFF_H + 4 * lChannel;
+         if(!(aChannelMask & (1u << lChannel)))
+            continue;
+
+         // keep the commanded value, a channel stopped before keeps its own
+         if(!(mStopped & (1u << lChannel)))
+         {
+            mResumeOffHigh[lChannel] = mShadow[lReg] & PCA9685_LED_COUNT_H;
+            mStopped |= static_cast<uint16_t>(1u << lChannel);
+         }
+
+         // FULL_OFF alone, so all stopped channels share one ALL_LED_OFF_H value
+         if(mShadowValid.test(lReg) && !mShadowDirty.test(lReg) && (mShadow[lReg] & PCA9685_LED_FULL))
+            continue;
+
+         lTarget[lReg] = PCA9685_LED_FULL;
+         lMask.set(lReg);
+      }
+
+      this->writePlanned(lTarget, lMask);
+   }
+
+
+   void PCA9685::enableOutputs(uint16_t aChannelMask)
+   {
+      C4T_TRACE_SPAN("driver", "PCA9685::enableOutputs");
+
+      RegisterImage lTarget;
+      std::bitset<PCA9685_REG_COUNT> lMask;
+
+      BusGuard lGuard(*this);
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!(aChannelMask & mStopped & (1u << lChannel)))
+            continue;
+
+         int lReg = PCA9685_REG_LED0_OFF_H + 4 * lChannel;
+         lTarget[lReg] = mResumeOffHigh[lChannel];
+         lMask.set(lReg);
+      }
+
+      mStopped &= static_cast<uint16_t>(~aChannelMask);
+      this->writePlanned(lTarget, lMask);
+   }
+
+
+   void PCA9685::emergencyStop()
+   {
+      C4T_TRACE_SPAN("driver", "PCA9685::emergencyStop");
+
+      // from now on every write holds the outputs off and background checks give way
+      mPendingAccesses.fetch_add(1, std::memory_order_acq_rel);
+      mEmergencyStops.fetch_add(1, std::memory_order_acq_rel);
+      uint64_t lWrites = mWrites.load(std::memory_order_acquire);
+
+      // one byte, only the transfer on the wire is waited for
+      bool lSent = true;
+      try
+      {
+         mpI2CDevice->writeByteConcurrent(PCA9685_REG_ALL_LED_OFF_H, PCA9685_LED_FULL);
+      }
+      catch(const std::runtime_error&)
+      {
+         lSent = false;
+      }
+
+      mPendingAccesses.fetch_sub(1, std::memory_order_acq_rel);
+
+
+      // latch the stop, pending frames are written with FULL_OFF afterwards
+      BusGuard lGuard(*this);
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!(mStopped & (1u << lChannel)))
+            mResumeOffHigh[lChannel] = mShadow[PCA9685_REG_LED0_OFF_H + 4 * lChannel] & PCA9685_LED_COUNT_H;
+      }
+
+      mStopped = 0xFFFF;
+      mEmergencyStops.fetch_sub(1, std::memory_order_acq_rel);
+
+      // a write which overtook the stop byte may have switched outputs on again
+      if(lSent && mWrites.load(std::memory_order_acquire) == lWrites)
+      {
+         uint8_t lValue = PCA9685_LED_FULL;
+         this->updateShadow(PCA9685_REG_ALL_LED_OFF_H, &lValue, 1);
+         return;
+      }
+
+      this->busWrite(PCA9685_REG_ALL_LED_OFF_H, PCA9685_LED_FULL);
+   }
+
+
+   uint16_t PCA9685::stoppedOutputs()
+   {
+      BusGuard lGuard(*this);
+      return mStopped;
+   }
+
+
+   int PCA9685::readRegisterBlock(int aRegister, uint8_t* apBuffer, size_t aLength)
+   {
+      BusGuard lGuard(*this);
+      return mpI2CDevice->readBlock(aRegister, apBuffer, aLength);
+   }
+
+
+   void PCA9685::readRegisterImage(RegisterImage& arImage)
+   {
+      arImage.fill(0x00);
+
+      BusGuard lGuard(*this);
+      mpI2CDevice->readBlock(PCA9685_BLOCK_LOW_FIRST, &arImage[PCA9685_BLOCK_LOW_FIRST],
+                             PCA9685_BLOCK_LOW_LAST - PCA9685_BLOCK_LOW_FIRST + 1);
+      mpI2CDevice->readBlock(PCA9685_BLOCK_HIGH_FIRST, &arImage[PCA9685_BLOCK_HIGH_FIRST],
+                             PCA9685_BLOCK_HIGH_LAST - PCA9685_BLOCK_HIGH_FIRST + 1);
+   }
+
+
+   void PCA9685::shadowImage(RegisterImage& arImage, std::bitset<PCA9685_REG_COUNT>& arValid)
+   {
+      BusGuard lGuard(*this);
+      arImage = mShadow;
+      arValid = mShadowValid;
+   }
+
+
+   int PCA9685::scrubRegisters(int aRegister, size_t aLength, bool aRepair, std::vector<RegisterDrift>& arDrift)
+   {
+      // check window
+      if(aRegister < 0 || aLength == 0 || aRegister + aLength > PCA9685_REG_COUNT)
+      {
+         throw std::range_error("Invalid register window \"" + std::to_string(aRegister) +
+                                "\" with length \"" + std::to_string(aLength) + "\"");
+      }
+
+      // give way to the control path
+      if(mPendingAccesses.load(std::memory_order_acquire) > 0)
+      {
+         return -1;
+      }
+
+      std::unique_lock<std::mutex> lLock(mBusMutex, std::try_to_lock);
+      if(!lLock.owns_lock())
+      {
+         return -1;
+      }
+
+
+      // read back window and compare it against the last written values
+      uint8_t lActual[PCA9685_REG_COUNT];
+      mpI2CDevice->readBlock(aRegister, lActual, aLength);
+
+      int lDrifted = 0;
+      bool lConfigDrift = false;
+      int lFirstLed = -1;
+      int lLastLed = -1;
+
+      for(size_t i = 0; i < aLength; i++)
+      {
+         int lReg = aRegister + static_cast<int>(i);
+         int lMask = this->scrubMask(lReg);
+
+         if(!mShadowValid.test(lReg) || ((mShadow[lReg] ^ lActual[i]) & lMask) == 0)
+         {
+            continue;
+         }
+
+         arDrift.push_back(RegisterDrift{lReg, mShadow[lReg], lActual[i]});
+         lDrifted++;
+
+         if(lReg >= PCA9685_REG_LED0_ON_L && lReg <= PCA9685_REG_LED15_OFF_H)
+         {
+            lFirstLed = (lFirstLed < 0) ? lReg : lFirstLed;
+            lLastLed = lReg;
+         }
+         else
+         {
+            lConfigDrift = true;
+         }
+      }
+
+
+      // repair: configuration first (a brownout puts the device to sleep), then the LEDn span;
+      // the oscillator settle does not hold the bus lock
+      if(aRepair && lConfigDrift)
+      {
+         this->restoreConfiguration(&lLock);
+      }
+
+      if(aRepair && lFirstLed >= 0)
+      {
+         this->writeShadow(lFirstLed, lLastLed, mShadowValid);
+      }
+
+      return lDrifted;
+   }
+
+
+   void PCA9685::setTraceRecorder(TraceRecorder* apRecorder)
+   {
+      BusGuard lGuard(*this);
+      mpI2CDevice->setTraceRecorder(apRecorder);
+   }
+
+
+   void PCA9685::setClock(DriverClock& arClock)
+   {
+      BusGuard lGuard(*this);
+      mpClock = &arClock;
+   }
+
+
+   int PCA9685::busRead(int aRegister)
+   {
+      return mpI2CDevice->readByte(aRegister);
+   }
+
+
+   int PCA9685::busWrite(int aRegister, int aValue)
+   {
+      uint8_t lValue = static_cast<uint8_t>(this->holdOff(aRegister, aValue));
+      int lRes = 0;
+
+      // keep the commanded value of a failed write, reconnect() writes it again
+      try
+      {
+         lRes = mpI2CDevice->writeByte(aRegister, lValue);
+      }
+      catch(const std::runtime_error&)
+      {
+         mWrites.fetch_add(1, std::memory_order_acq_rel);
+         this->updateShadow(aRegister, &lValue, 1, true);
+         throw;
+      }
+
+      mWrites.fetch_add(1, std::memory_order_acq_rel);
+      this->updateShadow(aRegister, &lValue, 1);
+
+      return lRes;
+   }
+
+
+   int PCA9685::busWriteBlock(int aRegister, const uint8_t* apData, size_t aLength)
+   {
+      int lRes = 0;
+
+      // held off channels stay off whatever is written
+      uint8_t lHeld[PCA9685_REG_COUNT];
+      if(this->heldOff() != 0 && aLength <= sizeof(lHeld))
+      {
+         for(size_t i = 0; i < aLength; i++)
+            lHeld[i] = static_cast<uint8_t>(this->holdOff(aRegister + static_cast<int>(i), apData[i]));
+
+         apData = lHeld;
+      }
+
+      // keep the commanded values of a failed write, reconnect() writes them again
+      try
+      {
+         lRes = mpI2CDevice->writeBlock(aRegister, apData, aLength);
+      }
+      catch(const std::runtime_error&)
+      {
+         mWrites.fetch_add(1, std::memory_order_acq_rel);
+         this->updateShadow(aRegister, apData, aLength, true);
+         throw;
+      }
+
+      mWrites.fetch_add(1, std::memory_order_acq_rel);
+      this->updateShadow(aRegister, apData, aLength);
+
+      return lRes;
+   }
+
+
+   uint16_t PCA9685::heldOff() const
+   {
+      return (mEmergencyStops.load(std::memory_order_acquire) > 0) ? 0xFFFF : mStopped;
+   }
+
+
+   int PCA9685::holdOff(int aRegister, int aValue) const
+   {
+      uint16_t lHeld = this->heldOff();
+      if(lHeld == 0)
+         return aValue;
+
+      // ALL_LED_OFF_H reaches every channel, it is held off as soon as one channel is
+      if(aRegister == PCA9685_REG_ALL_LED_OFF_H)
+         return aValue | PCA9685_LED_FULL;
+
+      int lOffset = aRegister - PCA9685_REG_LED0_ON_L;
+      if(aRegister >= PCA9685_REG_LED0_ON_L && aRegister <= PCA9685_REG_LED15_OFF_H && lOffset % 4 == 3 &&
+         (lHeld & (1u << (lOffset / 4))))
+      {
+         return aValue | PCA9685_LED_FULL;
+      }
+
+      return aValue;
+   }
+
+
+   void PCA9685::holdStopped(RegisterImage& arTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask)
+   {
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         int lReg = PCA9685_REG_LED0_OFF_H + 4 * lChannel;
+         if(!(mStopped & (1u << lChannel)) || !acrMask.test(lReg))
+            continue;
+
+         mResumeOffHigh[lChannel] = arTarget[lReg] & PCA9685_LED_COUNT_H;
+         arTarget[lReg] = PCA9685_LED_FULL;
+      }
+   }
+
+
+   void PCA9685::updateShadow(int aRegister, const uint8_t* apData, size_t aLength, bool aFailed)
+   {
+      for(size_t i = 0; i < aLength; i++)
+      {
+         int lReg = aRegister + static_cast<int>(i);
+
+         if(lReg >= PCA9685_REG_ALL_LED_ON_L && lReg <= PCA9685_REG_ALL_LED_OFF_H)
+         {
+            // ALL_LED registers load the same byte of every LEDn register
+            int lOffset = lReg - PCA9685_REG_ALL_LED_ON_L;
+            for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            {
+               mShadow[PCA9685_REG_LED0_ON_L + 4 * lChannel + lOffset] = apData[i];
+               mShadowValid.set(PCA9685_REG_LED0_ON_L + 4 * lChannel + lOffset);
+               mShadowDirty.set(PCA9685_REG_LED0_ON_L + 4 * lChannel + lOffset, aFailed);
+            }
+         }
+         else if(lReg < PCA9685_REG_COUNT)
+         {
+            mShadow[lReg] = apData[i];
+            mShadowValid.set(lReg);
+            mShadowDirty.set(lReg, aFailed);
+         }
+      }
+   }
+
+
+   int PCA9685::scrubMask(int aRegister) const
+   {
+      switch(aRegister)
+      {
+         // RESTART is cleared by the device itself
+         case PCA9685_REG_MODE1:
+            return 0xFF & ~PCA9685_MODE1_RESTART;
+
+         // MODE2 bits 7 - 5 are reserved
+         case PCA9685_REG_MODE2:
+            return 0x1F;
+
+         case PCA9685_REG_PRE_SCALE:
+            return 0xFF;
+
+         default:
+            break;
+      }
+
+      // LEDn registers, bits 7 - 5 of the _H bytes are reserved
+      if(aRegister >= PCA9685_REG_LED0_ON_L && aRegister <= PCA9685_REG_LED15_OFF_H)
+      {
+         return ((aRegister - PCA9685_REG_LED0_ON_L) % 2 == 0) ? 0xFF : 0x1F;
+      }
+
+      // ALL_LED registers read back as zero, everything else is not written by the driver
+      return 0x00;
+   }
+
+
+   int PCA9685::prescale(float aFrequency)
+   {
+      // limit argument to allowed range
+      float lFreq = fmin(fmax(aFrequency, 24), 1526);
+
+      // calculate prescale for 25 MHz internal oscillator
+      return (int)round((25000000.0f / (4096 * lFreq)) - 1.0f);
+   }
+
+
+   void PCA9685::restoreConfiguration(std::unique_lock<std::mutex>* apLock)
+   {
+      // unknown MODE1: driver default (see reset()), the device must not be left sleeping
+      int lMode1 = mShadowValid.test(PCA9685_REG_MODE1) ? mShadow[PCA9685_REG_MODE1] & ~PCA9685_MODE1_RESTART
+                                                        : PCA9685_MODE1_ALLCALL | PCA9685_MODE1_AI;
+
+      // prescale is only writeable while sleeping
+      if(mShadowValid.test(PCA9685_REG_PRE_SCALE))
+      {
+         mpI2CDevice->writeByte(PCA9685_REG_MODE1, lMode1 | PCA9685_MODE1_SLEEP);
+         mpI2CDevice->writeByte(PCA9685_REG_PRE_SCALE, mShadow[PCA9685_REG_PRE_SCALE]);
+      }
+
+      if(mShadowValid.test(PCA9685_REG_MODE2))
+      {
+         mpI2CDevice->writeByte(PCA9685_REG_MODE2, mShadow[PCA9685_REG_MODE2]);
+      }
+
+      // wake up, wait for oscillator (at least 500us) and restart PWM
+      mShadow[PCA9685_REG_MODE1] = static_cast<uint8_t>(lMode1);
+      mShadowValid.set(PCA9685_REG_MODE1);
+      mpI2CDevice->writeByte(PCA9685_REG_MODE1, lMode1);
+      if(!apLock)
+      {
+         mpClock->sleepFor(std::chrono::microseconds(500));
+         mpI2CDevice->writeByte(PCA9685_REG_MODE1, lMode1 | PCA9685_MODE1_RESTART);
+         return;
+      }
+
+      // the control path may use the bus meanwhile, the device may be closed afterwards
+      apLock->unlock();
+      mpClock->sleepFor(std::chrono::microseconds(500));
+      apLock->lock();
+
+      if(mShadowValid.test(PCA9685_REG_MODE1))
+      {
+         lMode1 = mShadow[PCA9685_REG_MODE1] & ~PCA9685_MODE1_RESTART;
+         mpI2CDevice->writeByte(PCA9685_REG_MODE1, lMode1 | PCA9685_MODE1_RESTART);
+      }
+   }
+
+
+   void PCA9685::writeShadow(int aFirst, int aLast, const std::bitset<PCA9685_REG_COUNT>& acrSelect)
+   {
+      bool lBlock = this->autoIncrement();
+
+      // write contiguous runs of selected, known values
+      int lRunStart = -1;
+      for(int lReg = aFirst; lReg <= aLast + 1; lReg++)
+      {
+         bool lSelected = (lReg <= aLast) && acrSelect.test(lReg) && mShadowValid.test(lReg);
+         if(lSelected && lRunStart < 0)
+         {
+            lRunStart = lReg;
+         }
+         else if(!lSelected && lRunStart >= 0)
+         {
+            if(lBlock)
+            {
+               mpI2CDevice->writeBlock(lRunStart, &mShadow[lRunStart], lReg - lRunStart);
+            }
+            else
+            {
+               for(int i = lRunStart; i < lReg; i++)
+                  mpI2CDevice->writeByte(i, mShadow[i]);
+            }
+
+            mWrites.fetch_add(1, std::memory_order_acq_rel);
+            for(int i = lRunStart; i < lReg; i++)
+               mShadowDirty.reset(i);
+
+            lRunStart = -1;
+         }
+      }
+   }
+
+
+   double PCA9685::writePlanned(const RegisterImage& acrTarget, const std::bitset<PCA9685_REG_COUNT>& acrMask)
+   {
+      // ALL_LED_OFF_H would switch stopped and running channels alike while only some are stopped
+      uint16_t lHeld = this->heldOff();
+      unsigned lAllLedBytes = (lHeld == 0 || lHeld == 0xFFFF) ? 0x0F : 0x07;
+
+      // failed writes left unknown values on the device
+      WritePlan lPlan;
+      mPlanner.plan(acrTarget, acrMask, mShadow, mShadowValid & ~mShadowDirty, this->autoIncrement(), lPlan, lAllLedBytes);
+
+      for(size_t i = 0; i < lPlan.mCount; i++)
+      {
+         const WritePlan::Transaction& lcrTransaction = lPlan.mTransactions[i];
+
+         if(lcrTransaction.mLength > 1)
+            this->busWriteBlock(lcrTransaction.mRegister, &lPlan.mData[lcrTransaction.mRegister], lcrTransaction.mLength);
+         else
+            this->busWrite(lcrTransaction.mRegister, lPlan.mData[lcrTransaction.mRegister]);
+      }
+
+      return lPlan.mCostUs;
+   }
+
+
+   PCA9685::BusGuard::BusGuard(PCA9685& arDriver)
+      : mrDriver(arDriver)
+   {
+      mrDriver.mPendingAccesses.fetch_add(1, std::memory_order_acq_rel);
+
+      // time spent waiting behind other bus users
+      C4T_TRACE_SPAN("queue", "bus lock");
+      mrDriver.mBusMutex.lock();
+   }
+
+
+   PCA9685::BusGuard::~BusGuard()
+   {
+      mrDriver.mBusMutex.unlock();
+      mrDriver.mPendingAccesses.fetch_sub(1, std::memory_order_acq_rel);
    }
 
 
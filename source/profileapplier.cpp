@@ -0,0 +1,122 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file profileapplier.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class ProfileApplier at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/profileapplier.hpp"
+
+
+namespace CAR4TEGRA
+{
+   ProfileApplier::ProfileApplier(PCA9685& arDriver)
+      : mrDriver(arDriver), mPositioned(0)
+   {
+      mPositions.fill(0.0);
+   }
+
+
+   ProfileApplier::~ProfileApplier()
+   {
+   }
+
+
+   uint16_t ProfileApplier::apply(const CalibrationProfile& acrProfile)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      // the prescaler is shared by all channels, it is only written if the profile changes it
+      if(acrProfile.frequency() != 0.0f && acrProfile.frequency() != mProfile.frequency())
+      {
+         mrDriver.setPWMFrequency(acrProfile.frequency());
+      }
+
+      uint16_t lMask = 0;
+      uint16_t lOnValues[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lOffValues[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lChanged = mProfile.changedChannels(acrProfile) & mPositioned;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if((lChanged & (1 << lChannel)) && acrProfile.channel(lChannel).mUsed)
+         {
+            lOffValues[lChannel] = static_cast<uint16_t>(acrProfile.toPWM(lChannel, mPositions[lChannel]));
+            lMask |= static_cast<uint16_t>(1 << lChannel);
+         }
+      }
+
+      if(lMask != 0)
+      {
+         mrDriver.setPWMBatch(lMask, lOnValues, lOffValues);
+      }
+
+      mProfile = acrProfile;
+      return lMask;
+   }
+
+
+   void ProfileApplier::setPosition(int aChannel, double aPosition)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      if(!mProfile.channel(aChannel).mUsed)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) + "\" (not part of the profile)");
+      }
+
+      mrDriver.setPWM(aChannel, 0, mProfile.toPWM(aChannel, aPosition));
+      mPositions[aChannel] = std::min(std::max(aPosition, -1.0), 1.0);
+      mPositioned |= static_cast<uint16_t>(1 << aChannel);
+   }
+
+
+   double ProfileApplier::position(int aChannel)
+   {
+      if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) + "\" (has to be between 0 and 15)");
+      }
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mPositions[aChannel];
+   }
+
+
+   CalibrationProfile ProfileApplier::profile()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mProfile;
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,256 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file profilewatcher.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class ProfileWatcher at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/profilewatcher.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const size_t EVENT_BUFFER = 4096;     ///< Size of the inotify read buffer
+      const int THREAD_POLL_MS = 100;       ///< Poll timeout of the watcher thread (ms)
+   } // namespace
+
+
+   ProfileWatcher::ProfileWatcher()
+      : mNotify(-1), mRunning(false)
+   {
+   }
+
+
+   ProfileWatcher::~ProfileWatcher()
+   {
+      this->stop();
+      this->close();
+   }
+
+
+   void ProfileWatcher::setChangeCallback(ChangeCallback aCallback)
+   {
+      mChangeCallback = aCallback;
+   }
+
+
+   void ProfileWatcher::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void ProfileWatcher::open(const std::string& acrFileName)
+   {
+      this->close();
+
+      CalibrationProfile lProfile = CalibrationProfile::load(acrFileName);
+
+      // editors often replace the file, so the directory is watched instead of the inode
+      size_t lSlash = acrFileName.rfind('/');
+      std::string lDirectory = (lSlash == std::string::npos) ? "." : acrFileName.substr(0, (lSlash == 0) ? 1 : lSlash);
+
+      if((mNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0 ||
+         inotify_add_watch(mNotify, lDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+      {
+         int lErrno = errno;
+         this->close();
+         throw std::runtime_error("Failed to watch profile \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mFileName = acrFileName;
+      mBaseName = (lSlash == std::string::npos) ? acrFileName : acrFileName.substr(lSlash + 1);
+
+      std::lock_guard<std::mutex> lLock(mProfileMutex);
+      mProfile = lProfile;
+   }
+
+
+   void ProfileWatcher::close()
+   {
+      if(mNotify >= 0)
+      {
+         ::close(mNotify);
+         mNotify = -1;
+      }
+
+      mFileName.clear();
+      mBaseName.clear();
+   }
+
+
+   void ProfileWatcher::start()
+   {
+      this->stop();
+
+      if(mNotify < 0)
+      {
+         throw std::runtime_error("Failed to start profile watcher: no profile is open");
+      }
+
+      mRunning = true;
+      mThread = std::thread(&ProfileWatcher::run, this);
+   }
+
+
+   void ProfileWatcher::stop()
+   {
+      mRunning = false;
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+   }
+
+
+   bool ProfileWatcher::poll(int aTimeoutMs)
+   {
+      if(mNotify < 0)
+      {
+         throw std::runtime_error("Failed to watch profile: no profile is open");
+      }
+
+      struct pollfd lPoll = { mNotify, POLLIN, 0 };
+      if(::poll(&lPoll, 1, aTimeoutMs) <= 0)
+         return false;
+
+      // drain all queued events, several writes of one save give one reload
+      bool lTouched = false;
+      alignas(struct inotify_event) char lBuffer[EVENT_BUFFER];
+      ssize_t lLength;
+      while((lLength = read(mNotify, lBuffer, sizeof(lBuffer))) > 0)
+      {
+         for(ssize_t lOffset = 0; lOffset < lLength; )
+         {
+            const struct inotify_event* lpEvent = reinterpret_cast<const struct inotify_event*>(lBuffer + lOffset);
+            if(lpEvent->len > 0 && mBaseName == lpEvent->name)
+               lTouched = true;
+            lOffset += sizeof(struct inotify_event) + lpEvent->len;
+         }
+      }
+
+      if(!lTouched)
+         return false;
+
+      CalibrationProfile lProfile;
+      try
+      {
+         lProfile = CalibrationProfile::load(mFileName);
+      }
+      catch(const std::exception& e)
+      {
+         // the last valid profile stays active
+         this->report(e.what());
+         return false;
+      }
+
+      {
+         std::lock_guard<std::mutex> lLock(mProfileMutex);
+         if(mProfile.changedChannels(lProfile) == 0 && mProfile.frequency() == lProfile.frequency())
+            return false;
+         mProfile = lProfile;
+      }
+
+      if(mChangeCallback)
+      {
+         try
+         {
+            mChangeCallback(lProfile);
+         }
+         catch(const std::exception& e)
+         {
+            this->report(std::string("Failed to apply profile: ") + e.what());
+         }
+      }
+
+      return true;
+   }
+
+
+   const std::string& ProfileWatcher::fileName() const
+   {
+      return mFileName;
+   }
+
+
+   int ProfileWatcher::fd() const
+   {
+      return mNotify;
+   }
+
+
+   CalibrationProfile ProfileWatcher::profile()
+   {
+      std::lock_guard<std::mutex> lLock(mProfileMutex);
+      return mProfile;
+   }
+
+
+   void ProfileWatcher::run()
+   {
+      C4T_TRACE_THREAD("profile");
+
+      while(mRunning)
+      {
+         try
+         {
+            this->poll(THREAD_POLL_MS);
+         }
+         catch(const std::exception& e)
+         {
+            this->report(e.what());
+            std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_POLL_MS));
+         }
+      }
+   }
+
+
+   void ProfileWatcher::report(const std::string& acrMessage)
+   {
+      if(mErrorCallback)
+         mErrorCallback(acrMessage);
+   }
+} // namespace CAR4TEGRA
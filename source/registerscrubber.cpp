@@ -0,0 +1,204 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file registerscrubber.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class RegisterScrubber at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/registerscrubber.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const int BUSY_RETRIES = 100;                                     ///< Retries of a window while the control path is busy
+      const std::chrono::microseconds BUSY_BACKOFF(500);                ///< Pause between two retries
+      const std::chrono::microseconds WINDOW_PAUSE(200);                ///< Pause between two windows
+   } // namespace
+
+
+   RegisterScrubber::RegisterScrubber(PCA9685& arDriver)
+      : mrDriver(arDriver), mRunning(false), mInterval(1000), mRepair(false), mWindowLength(4)
+   {
+      mDrift.reserve(PCA9685_REG_COUNT);
+   }
+
+
+   RegisterScrubber::~RegisterScrubber()
+   {
+      this->stop();
+   }
+
+
+   void RegisterScrubber::start(std::chrono::milliseconds aInterval, bool aRepair)
+   {
+      this->stop();
+
+      mInterval = aInterval;
+      mRepair = aRepair;
+      mRunning = true;
+      mThread = std::thread(&RegisterScrubber::run, this);
+   }
+
+
+   void RegisterScrubber::stop()
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mWaitMutex);
+         mRunning = false;
+      }
+      mWaitCond.notify_all();
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+   }
+
+
+   bool RegisterScrubber::isRunning() const
+   {
+      return mRunning;
+   }
+
+
+   void RegisterScrubber::setDriftCallback(DriftCallback aCallback)
+   {
+      mDriftCallback = aCallback;
+   }
+
+
+   void RegisterScrubber::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void RegisterScrubber::setWindowLength(size_t aLength)
+   {
+      if(aLength < 1 || aLength > 16)
+      {
+         throw std::range_error("Invalid window length \"" + std::to_string(aLength) +
+                                "\" (has to be between 1 and 16)");
+      }
+
+      mWindowLength = aLength;
+   }
+
+
+   void RegisterScrubber::run()
+   {
+      C4T_TRACE_THREAD("scrubber");
+
+      // lowest scheduling class, the scrubber only runs if nothing else wants the CPU
+      struct sched_param lParam;
+      lParam.sched_priority = 0;
+      pthread_setschedparam(pthread_self(), SCHED_IDLE, &lParam);
+
+      while(mRunning)
+      {
+         // MODE and SUBADR registers
+         if(!this->checkWindow(PCA9685_REG_MODE1, PCA9685_REG_LED0_ON_L - PCA9685_REG_MODE1))
+            break;
+
+         // LEDn registers
+         bool lStopped = false;
+         for(int lReg = PCA9685_REG_LED0_ON_L; lReg <= PCA9685_BLOCK_LOW_LAST && !lStopped; lReg += mWindowLength)
+         {
+            size_t lLength = std::min<size_t>(mWindowLength, PCA9685_BLOCK_LOW_LAST - lReg + 1);
+            lStopped = !this->checkWindow(lReg, lLength) || !this->waitFor(WINDOW_PAUSE);
+         }
+         if(lStopped)
+            break;
+
+         // ALL_LED and PRE_SCALE registers
+         if(!this->checkWindow(PCA9685_BLOCK_HIGH_FIRST, PCA9685_BLOCK_HIGH_LAST - PCA9685_BLOCK_HIGH_FIRST + 1))
+            break;
+
+         if(!this->waitFor(mInterval))
+            break;
+      }
+   }
+
+
+   bool RegisterScrubber::checkWindow(int aRegister, size_t aLength)
+   {
+      for(int i = 0; i < BUSY_RETRIES; i++)
+      {
+         mDrift.clear();
+
+         int lRes = -1;
+         try
+         {
+            lRes = mrDriver.scrubRegisters(aRegister, aLength, mRepair, mDrift);
+         }
+         catch(const std::exception& e)
+         {
+            // device not open or bus error, try again with the next pass
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+            return mRunning;
+         }
+
+         if(lRes >= 0)
+         {
+            if(mDriftCallback)
+            {
+               for(const PCA9685::RegisterDrift& lDrift : mDrift)
+                  mDriftCallback(lDrift, mRepair);
+            }
+            return mRunning;
+         }
+
+         // control path is busy, back off
+         if(!this->waitFor(BUSY_BACKOFF))
+            return false;
+      }
+
+      return mRunning;
+   }
+
+
+   bool RegisterScrubber::waitFor(std::chrono::microseconds aTime)
+   {
+      std::unique_lock<std::mutex> lLock(mWaitMutex);
+      mWaitCond.wait_for(lLock, aTime, [this]() { return !mRunning; });
+      return mRunning;
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,218 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file scriptbus.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class ScriptBus at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Car4Tegra includes
+#include "include/scriptbus.hpp"
+
+
+namespace CAR4TEGRA
+{
+   ScriptBus::Awaiter::Awaiter(ScriptBus& arBus, Operation aOperation)
+      : mrBus(arBus), mOperation(std::move(aOperation)), mChannel(-1), mOnValue(0), mOffValue(0)
+   {
+   }
+
+
+   ScriptBus::Awaiter::Awaiter(ScriptBus& arBus, int aChannel, int aOnValue, int aOffValue)
+      : mrBus(arBus), mChannel(aChannel), mOnValue(aOnValue), mOffValue(aOffValue)
+   {
+   }
+
+
+   void ScriptBus::Awaiter::await_suspend(std::coroutine_handle<> aHandle)
+   {
+      mHandle = aHandle;
+      mrBus.enqueue(this);
+   }
+
+
+   void ScriptBus::Awaiter::await_resume() const
+   {
+      if(mException)
+         std::rethrow_exception(mException);
+   }
+
+
+   ScriptBus::ScriptBus(ScriptRuntime& arRuntime, PCA9685& arDriver)
+      : mrRuntime(arRuntime), mrDriver(arDriver), mStatistics{ 0, 0, 0, 0 }, mRunning(true)
+   {
+      mThread = std::thread(&ScriptBus::worker, this);
+   }
+
+
+   ScriptBus::~ScriptBus()
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mMutex);
+         mRunning = false;
+      }
+      mWake.notify_one();
+
+      if(mThread.joinable())
+         mThread.join();
+   }
+
+
+   ScriptBus::Awaiter ScriptBus::run(Operation aOperation)
+   {
+      return Awaiter(*this, std::move(aOperation));
+   }
+
+
+   ScriptBus::Awaiter ScriptBus::setPWM(int aChannel, int aOnValue, int aOffValue)
+   {
+      // checked here, the batch has one mask bit per channel
+      if(aChannel > 15 || aChannel < 0)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                                "\" (has to be between 0 and 15)");
+      }
+
+      return Awaiter(*this, aChannel, aOnValue, aOffValue);
+   }
+
+
+   ScriptBus::Statistics ScriptBus::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mStatistics;
+   }
+
+
+   void ScriptBus::enqueue(Awaiter* apAwaiter)
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mMutex);
+         mQueue.push_back(apAwaiter);
+      }
+      mWake.notify_one();
+   }
+
+
+   size_t ScriptBus::execute(size_t aFirst)
+   {
+      Awaiter* lpFirst = mBatch[aFirst];
+
+      // a driver call of its own
+      if(lpFirst->mOperation)
+      {
+         try
+         {
+            lpFirst->mOperation(mrDriver);
+         }
+         catch(...)
+         {
+            lpFirst->mException = std::current_exception();
+         }
+
+         {
+            std::lock_guard<std::mutex> lLock(mMutex);
+            mStatistics.mOperations++;
+            mStatistics.mErrors += lpFirst->mException ? 1 : 0;
+         }
+
+         mrRuntime.post(lpFirst->mHandle);
+         return aFirst + 1;
+      }
+
+      // consecutive channel updates in one batch, a later update of a channel wins
+      uint16_t lMask = 0;
+      uint16_t lOnValues[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lOffValues[PCA9685_CHANNEL_COUNT] = {};
+
+      size_t lEnd = aFirst;
+      for(; lEnd < mBatch.size() && !mBatch[lEnd]->mOperation; lEnd++)
+      {
+         const Awaiter* lpUpdate = mBatch[lEnd];
+         lMask |= static_cast<uint16_t>(1u << lpUpdate->mChannel);
+         lOnValues[lpUpdate->mChannel] = static_cast<uint16_t>(std::min(std::max(lpUpdate->mOnValue, 0), 4095));
+         lOffValues[lpUpdate->mChannel] = static_cast<uint16_t>(std::min(std::max(lpUpdate->mOffValue, 0), 4095));
+      }
+
+      std::exception_ptr lException;
+      try
+      {
+         mrDriver.setPWMBatch(lMask, lOnValues, lOffValues);
+      }
+      catch(...)
+      {
+         lException = std::current_exception();
+      }
+
+      {
+         std::lock_guard<std::mutex> lLock(mMutex);
+         mStatistics.mUpdates += lEnd - aFirst;
+         mStatistics.mBatches++;
+         mStatistics.mErrors += lException ? 1 : 0;
+      }
+
+      for(size_t i = aFirst; i < lEnd; i++)
+      {
+         mBatch[i]->mException = lException;
+         mrRuntime.post(mBatch[i]->mHandle);
+      }
+
+      return lEnd;
+   }
+
+
+   void ScriptBus::worker()
+   {
+      std::unique_lock<std::mutex> lLock(mMutex);
+
+      while(true)
+      {
+         mWake.wait(lLock, [this]() { return !mQueue.empty() || !mRunning; });
+         if(mQueue.empty())
+            break;
+
+         // take over everything queued, scripts keep queueing while the bus is busy
+         mBatch.assign(mQueue.begin(), mQueue.end());
+         mQueue.clear();
+         lLock.unlock();
+
+         for(size_t i = 0; i < mBatch.size(); )
+         {
+            i = this->execute(i);
+         }
+
+         lLock.lock();
+      }
+   }
+} // namespace CAR4TEGRA
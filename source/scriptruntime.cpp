@@ -0,0 +1,478 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file scriptruntime.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of the classes ScriptRuntime, ScriptTask and
+ *        ScriptEvent at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+// Car4Tegra includes
+#include "include/scriptruntime.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const uint64_t EVENT_TIMER = 0;  ///< epoll tag of the timerfd
+      const uint64_t EVENT_POST = 1;   ///< epoll tag of the eventfd
+   } // namespace
+
+
+   // ScriptTask
+
+   ScriptTask ScriptTask::promise_type::get_return_object() noexcept
+   {
+      return ScriptTask(std::coroutine_handle<promise_type>::from_promise(*this));
+   }
+
+
+   std::coroutine_handle<> ScriptTask::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> aHandle) noexcept
+   {
+      promise_type& lrPromise = aHandle.promise();
+
+      // a step continues its caller, a spawned script is destroyed by the runtime
+      if(lrPromise.mContinuation)
+         return lrPromise.mContinuation;
+
+      if(lrPromise.mpRuntime != nullptr)
+         lrPromise.mpRuntime->finish(aHandle);
+
+      return std::noop_coroutine();
+   }
+
+
+   ScriptTask::ScriptTask(std::coroutine_handle<promise_type> aHandle)
+      : mHandle(aHandle)
+   {
+   }
+
+
+   ScriptTask::ScriptTask(ScriptTask&& arOther) noexcept
+      : mHandle(std::exchange(arOther.mHandle, nullptr))
+   {
+   }
+
+
+   ScriptTask::~ScriptTask()
+   {
+      if(mHandle)
+         mHandle.destroy();
+   }
+
+
+   bool ScriptTask::await_ready() const noexcept
+   {
+      return !mHandle || mHandle.done();
+   }
+
+
+   std::coroutine_handle<> ScriptTask::await_suspend(std::coroutine_handle<> aParent) noexcept
+   {
+      // start the step, its final suspend continues the caller
+      mHandle.promise().mContinuation = aParent;
+      return mHandle;
+   }
+
+
+   void ScriptTask::await_resume() const
+   {
+      if(mHandle && mHandle.promise().mException)
+         std::rethrow_exception(mHandle.promise().mException);
+   }
+
+
+   // ScriptRuntime
+
+   ScriptRuntime::SleepAwaiter::SleepAwaiter(ScriptRuntime& arRuntime, Clock::time_point aDeadline)
+      : mrRuntime(arRuntime), mDeadline(aDeadline)
+   {
+   }
+
+
+   bool ScriptRuntime::SleepAwaiter::await_ready() const noexcept
+   {
+      return mDeadline <= Clock::now();
+   }
+
+
+   void ScriptRuntime::SleepAwaiter::await_suspend(std::coroutine_handle<> aHandle)
+   {
+      mrRuntime.addTimer(mDeadline, aHandle);
+   }
+
+
+   ScriptRuntime::ScriptRuntime()
+      : mEpoll(-1), mTimerFd(-1), mEventFd(-1), mArmed(), mTimerSequence(0), mStopRequested(false),
+        mStatistics{ 0, 0, 0, 0, 0, 0 }
+   {
+      // epoll over the delay timer and the post event
+      if((mEpoll = epoll_create1(EPOLL_CLOEXEC)) < 0 ||
+         (mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)) < 0 ||
+         (mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+      {
+         int lErrno = errno;
+         if(mTimerFd >= 0)
+            ::close(mTimerFd);
+         if(mEpoll >= 0)
+            ::close(mEpoll);
+
+         throw std::runtime_error("Failed to create script event loop (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      struct epoll_event lEvent;
+      memset(&lEvent, 0, sizeof(lEvent));
+      lEvent.events = EPOLLIN;
+      lEvent.data.u64 = EVENT_TIMER;
+      epoll_ctl(mEpoll, EPOLL_CTL_ADD, mTimerFd, &lEvent);
+      lEvent.data.u64 = EVENT_POST;
+      epoll_ctl(mEpoll, EPOLL_CTL_ADD, mEventFd, &lEvent);
+   }
+
+
+   ScriptRuntime::~ScriptRuntime()
+   {
+      // frames of unfinished scripts destroy their awaited steps with them
+      for(const std::pair<void* const, std::string>& lcrScript : mScripts)
+      {
+         std::coroutine_handle<ScriptTask::promise_type>::from_address(lcrScript.first).destroy();
+      }
+      mScripts.clear();
+
+      if(mEventFd >= 0)
+         ::close(mEventFd);
+      if(mTimerFd >= 0)
+         ::close(mTimerFd);
+      if(mEpoll >= 0)
+         ::close(mEpoll);
+
+      mEventFd = mTimerFd = mEpoll = -1;
+   }
+
+
+   void ScriptRuntime::spawn(ScriptTask aTask, const std::string& acrName)
+   {
+      std::coroutine_handle<ScriptTask::promise_type> lHandle = std::exchange(aTask.mHandle, nullptr);
+      if(!lHandle)
+         return;
+
+      lHandle.promise().mpRuntime = this;
+      mScripts.emplace(lHandle.address(), acrName);
+      mReady.push_back(lHandle);
+      mStatistics.mSpawned++;
+   }
+
+
+   ScriptRuntime::SleepAwaiter ScriptRuntime::sleep(Clock::duration aDuration)
+   {
+      return SleepAwaiter(*this, Clock::now() + aDuration);
+   }
+
+
+   ScriptRuntime::SleepAwaiter ScriptRuntime::sleepUntil(Clock::time_point aDeadline)
+   {
+      return SleepAwaiter(*this, aDeadline);
+   }
+
+
+   size_t ScriptRuntime::activeScripts() const
+   {
+      return mScripts.size();
+   }
+
+
+   ScriptRuntime::Statistics ScriptRuntime::statistics() const
+   {
+      return mStatistics;
+   }
+
+
+   void ScriptRuntime::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void ScriptRuntime::run()
+   {
+      mStopRequested = false;
+      while(!mStopRequested && !mScripts.empty())
+      {
+         this->poll(-1);
+      }
+   }
+
+
+   size_t ScriptRuntime::poll(int aTimeoutMs)
+   {
+      this->collectReady();
+
+      // wait only if nothing is ready, the timerfd fires with the earliest delay
+      if(mReady.empty())
+      {
+         struct epoll_event lEvents[2];
+         int lCount = epoll_wait(mEpoll, lEvents, 2, aTimeoutMs);
+
+         for(int i = 0; i < lCount; i++)
+         {
+            uint64_t lValue;
+            int lFd = (lEvents[i].data.u64 == EVENT_TIMER) ? mTimerFd : mEventFd;
+            while(read(lFd, &lValue, sizeof(lValue)) == sizeof(lValue))
+            {
+            }
+         }
+
+         mStatistics.mWakeups++;
+         this->collectReady();
+      }
+
+      // coroutines made ready while resuming run with the next pass
+      size_t lCount = mReady.size();
+      for(size_t i = 0; i < lCount; i++)
+      {
+         std::coroutine_handle<> lHandle = mReady.front();
+         mReady.pop_front();
+         lHandle.resume();
+         mStatistics.mResumes++;
+         this->destroyFinished();
+      }
+
+      this->armTimer();
+      return lCount;
+   }
+
+
+   void ScriptRuntime::stop()
+   {
+      mStopRequested = true;
+
+      uint64_t lValue = 1;
+      ssize_t lRes = write(mEventFd, &lValue, sizeof(lValue));
+      (void)lRes;
+   }
+
+
+   void ScriptRuntime::post(std::coroutine_handle<> aHandle)
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mPostMutex);
+         mPosted.push_back(aHandle);
+      }
+
+      uint64_t lValue = 1;
+      ssize_t lRes = write(mEventFd, &lValue, sizeof(lValue));
+      (void)lRes;
+   }
+
+
+   int ScriptRuntime::fd() const
+   {
+      return mEpoll;
+   }
+
+
+   void ScriptRuntime::addTimer(Clock::time_point aDeadline, std::coroutine_handle<> aHandle)
+   {
+      mTimers.push(Timer{ aDeadline, mTimerSequence++, aHandle });
+      mStatistics.mMaxTimers = std::max(mStatistics.mMaxTimers, mTimers.size());
+   }
+
+
+   void ScriptRuntime::armTimer()
+   {
+      Clock::time_point lDeadline = mTimers.empty() ? Clock::time_point() : mTimers.top().mDeadline;
+      if(lDeadline == mArmed)
+         return;
+
+      // absolute CLOCK_MONOTONIC time (steady_clock), zero disarms
+      struct itimerspec lSpec;
+      memset(&lSpec, 0, sizeof(lSpec));
+      if(!mTimers.empty())
+      {
+         int64_t lNs = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(lDeadline.time_since_epoch()).count(), 1);
+         lSpec.it_value.tv_sec = lNs / 1000000000;
+         lSpec.it_value.tv_nsec = lNs % 1000000000;
+      }
+
+      timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME, &lSpec, nullptr);
+      mArmed = lDeadline;
+   }
+
+
+   void ScriptRuntime::collectReady()
+   {
+      {
+         std::lock_guard<std::mutex> lLock(mPostMutex);
+         mTakeOver.swap(mPosted);
+      }
+
+      mReady.insert(mReady.end(), mTakeOver.begin(), mTakeOver.end());
+      mTakeOver.clear();
+
+      Clock::time_point lNow = Clock::now();
+      while(!mTimers.empty() && mTimers.top().mDeadline <= lNow)
+      {
+         mReady.push_back(mTimers.top().mHandle);
+         mTimers.pop();
+      }
+   }
+
+
+   void ScriptRuntime::finish(std::coroutine_handle<ScriptTask::promise_type> aHandle)
+   {
+      mFinished.push_back(aHandle);
+   }
+
+
+   void ScriptRuntime::destroyFinished()
+   {
+      for(std::coroutine_handle<ScriptTask::promise_type> lHandle : mFinished)
+      {
+         std::unordered_map<void*, std::string>::iterator lIt = mScripts.find(lHandle.address());
+
+         std::exception_ptr lException = lHandle.promise().mException;
+         if(!lException)
+         {
+            mStatistics.mCompleted++;
+         }
+         else
+         {
+            mStatistics.mFailed++;
+
+            std::string lMessage = "Script \"" + ((lIt != mScripts.end()) ? lIt->second : std::string()) + "\" failed: ";
+            try
+            {
+               std::rethrow_exception(lException);
+            }
+            catch(const std::exception& e)
+            {
+               lMessage += e.what();
+            }
+            catch(...)
+            {
+               lMessage += "unknown exception";
+            }
+
+            if(mErrorCallback)
+               mErrorCallback(lMessage);
+         }
+
+         if(lIt != mScripts.end())
+            mScripts.erase(lIt);
+
+         lHandle.destroy();
+      }
+
+      mFinished.clear();
+   }
+
+
+   // ScriptEvent
+
+   ScriptEvent::Awaiter::Awaiter(ScriptEvent& arEvent)
+      : mrEvent(arEvent), mValue(0)
+   {
+   }
+
+
+   bool ScriptEvent::Awaiter::await_ready()
+   {
+      std::lock_guard<std::mutex> lLock(mrEvent.mMutex);
+      mValue = mrEvent.mValue;
+      return mrEvent.mSet;
+   }
+
+
+   bool ScriptEvent::Awaiter::await_suspend(std::coroutine_handle<> aHandle)
+   {
+      // set() may have run since await_ready()
+      std::lock_guard<std::mutex> lLock(mrEvent.mMutex);
+      if(mrEvent.mSet)
+      {
+         mValue = mrEvent.mValue;
+         return false;
+      }
+
+      mrEvent.mWaiters.emplace_back(aHandle, this);
+      return true;
+   }
+
+
+   ScriptEvent::ScriptEvent(ScriptRuntime& arRuntime)
+      : mrRuntime(arRuntime), mSet(false), mValue(0)
+   {
+   }
+
+
+   void ScriptEvent::set(int aValue)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mSet = true;
+      mValue = aValue;
+
+      for(std::pair<std::coroutine_handle<>, Awaiter*>& lrWaiter : mWaiters)
+      {
+         lrWaiter.second->mValue = aValue;
+         mrRuntime.post(lrWaiter.first);
+      }
+      mWaiters.clear();
+   }
+
+
+   void ScriptEvent::reset()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mSet = false;
+   }
+
+
+   bool ScriptEvent::isSet()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mSet;
+   }
+
+
+   ScriptEvent::Awaiter ScriptEvent::operator co_await()
+   {
+      return Awaiter(*this);
+   }
+} // namespace CAR4TEGRA
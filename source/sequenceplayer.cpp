@@ -0,0 +1,614 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file sequenceplayer.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of the classes SequenceWriter and SequencePlayer
+ *        at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/sequenceplayer.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const char SEQUENCE_MAGIC[8] = { 'C', '4', 'T', 'S', 'E', 'Q', 'N', 'C' };   ///< File magic
+      const uint32_t SEQUENCE_VERSION = 1;                     ///< File format version
+      const size_t WRITE_BUFFER = 4096 * sizeof(SequenceKeyframe);   ///< Buffered keyframes of the writer (bytes)
+      const size_t RELEASE_STEP = 4 * 1024 * 1024;             ///< Played bytes before pages are released
+
+      static_assert(sizeof(SequenceKeyframe) == 48, "Keyframe has to be 48 bytes");
+      static_assert(sizeof(SequenceHeader) == 32, "Keyframe file header has to be 32 bytes");
+
+
+      /**
+       * @brief Writes a buffer completely to a file
+       *
+       * @param[in]  aFile          File descriptor
+       * @param[in]  apData         Data
+       * @param[in]  aLength        Length (bytes)
+       * @param[in]  aOffset        File offset
+       *
+       * @return `true` if written, `false` otherwise (errno is set)
+       */
+      bool writeAll(int aFile, const uint8_t* apData, size_t aLength, off_t aOffset)
+      {
+         while(aLength > 0)
+         {
+            ssize_t lWritten = pwrite(aFile, apData, aLength, aOffset);
+            if(lWritten < 0)
+            {
+               if(errno == EINTR)
+                  continue;
+               return false;
+            }
+
+            apData += lWritten;
+            aLength -= static_cast<size_t>(lWritten);
+            aOffset += lWritten;
+         }
+
+         return true;
+      }
+   } // namespace
+
+
+   SequenceWriter::SequenceWriter()
+      : mFile(-1)
+   {
+      memset(&mHeader, 0, sizeof(mHeader));
+   }
+
+
+   SequenceWriter::~SequenceWriter()
+   {
+      try
+      {
+         this->close();
+      }
+      catch(const std::exception&)
+      {
+         // nothing to do, the file stays without header
+      }
+   }
+
+
+   void SequenceWriter::open(const std::string& acrFileName)
+   {
+      this->close();
+
+      if((mFile = ::open(acrFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+      {
+         int lErrno = errno;
+         throw std::runtime_error("Failed to create keyframe file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mFileName = acrFileName;
+      memset(&mHeader, 0, sizeof(mHeader));
+      memcpy(mHeader.mMagic, SEQUENCE_MAGIC, sizeof(SEQUENCE_MAGIC));
+      mHeader.mVersion = SEQUENCE_VERSION;
+      mHeader.mKeyframeSize = sizeof(SequenceKeyframe);
+
+      mBuffer.clear();
+      mBuffer.reserve(WRITE_BUFFER);
+   }
+
+
+   void SequenceWriter::append(const SequenceKeyframe& acrKeyframe)
+   {
+      if(mFile < 0)
+      {
+         throw std::runtime_error("Keyframe file is not open");
+      }
+
+      // check keyframe
+      if(mHeader.mCount > 0 && acrKeyframe.mTimeUs < mHeader.mDurationUs)
+      {
+         throw std::range_error("Keyframe time \"" + std::to_string(acrKeyframe.mTimeUs) +
+                                "\" is earlier than the previous keyframe");
+      }
+
+      if(acrKeyframe.mInterpolation > SequencePlayer::INTERPOLATION_SMOOTH)
+      {
+         throw std::range_error("Invalid interpolation mode \"" + std::to_string(acrKeyframe.mInterpolation) + "\"");
+      }
+
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         if((acrKeyframe.mChannelMask & (1u << i)) && acrKeyframe.mValues[i] > 4095)
+         {
+            throw std::range_error("Invalid value \"" + std::to_string(acrKeyframe.mValues[i]) +
+                                   "\" for channel " + std::to_string(i) + " (has to be between 0 and 4095)");
+         }
+      }
+
+      // buffer keyframe
+      const uint8_t* lpData = reinterpret_cast<const uint8_t*>(&acrKeyframe);
+      mBuffer.insert(mBuffer.end(), lpData, lpData + sizeof(SequenceKeyframe));
+      mHeader.mChannelMask |= acrKeyframe.mChannelMask;
+      mHeader.mCount++;
+      mHeader.mDurationUs = acrKeyframe.mTimeUs;
+
+      if(mBuffer.size() >= WRITE_BUFFER && !this->flush())
+      {
+         int lErrno = errno;
+         throw std::runtime_error("Failed to write keyframe file \"" + mFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+   }
+
+
+   void SequenceWriter::close()
+   {
+      if(mFile < 0)
+         return;
+
+      // header last, a file without header is never played
+      bool lOk = this->flush() &&
+                 writeAll(mFile, reinterpret_cast<const uint8_t*>(&mHeader), sizeof(mHeader), 0);
+      int lErrno = errno;
+
+      ::close(mFile);
+      mFile = -1;
+      mBuffer.clear();
+
+      if(!lOk)
+      {
+         throw std::runtime_error("Failed to write keyframe file \"" + mFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+   }
+
+
+   bool SequenceWriter::flush()
+   {
+      off_t lOffset = static_cast<off_t>(sizeof(SequenceHeader) +
+                                         (mHeader.mCount * sizeof(SequenceKeyframe) - mBuffer.size()));
+
+      if(!mBuffer.empty() && !writeAll(mFile, mBuffer.data(), mBuffer.size(), lOffset))
+         return false;
+
+      mBuffer.clear();
+      return true;
+   }
+
+
+   SequencePlayer::SequencePlayer(PCA9685& arDriver)
+      : mrDriver(arDriver), mFile(-1), mpMap(nullptr), mMapSize(0), mpKeyframes(nullptr),
+        mCount(0), mDuration(0), mChannelMask(0), mReleased(0), mWrittenMask(0),
+        mRunning(false), mLoop(false), mTimeScale(1.0), mPosition(0), mpClock(&DriverClock::monotonic()),
+        mFrames(0), mBatches(0), mLoops(0), mLateFrames(0), mErrors(0)
+   {
+      memset(mTracks, 0, sizeof(mTracks));
+      memset(mOnValues, 0, sizeof(mOnValues));
+      memset(mOffValues, 0, sizeof(mOffValues));
+      memset(mWritten, 0, sizeof(mWritten));
+   }
+
+
+   SequencePlayer::~SequencePlayer()
+   {
+      this->close();
+   }
+
+
+   void SequencePlayer::open(const std::string& acrFileName)
+   {
+      this->close();
+
+      // try to open file
+      struct stat lStat;
+      if((mFile = ::open(acrFileName.c_str(), O_RDONLY)) < 0 || fstat(mFile, &lStat) < 0)
+      {
+         int lErrno = errno;
+         this->close();
+         throw std::runtime_error("Failed to open keyframe file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mMapSize = static_cast<size_t>(lStat.st_size);
+      if(mMapSize < sizeof(SequenceHeader))
+      {
+         this->close();
+         throw std::runtime_error("Invalid keyframe file \"" + acrFileName + "\" (too short)");
+      }
+
+      // map file, the kernel reads ahead while the cursors move forward
+      mpMap = mmap(nullptr, mMapSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+      if(mpMap == MAP_FAILED)
+      {
+         int lErrno = errno;
+         mpMap = nullptr;
+         this->close();
+         throw std::runtime_error("Failed to map keyframe file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+      madvise(mpMap, mMapSize, MADV_SEQUENTIAL);
+
+      // check header
+      const SequenceHeader* lpHeader = static_cast<const SequenceHeader*>(mpMap);
+      if(memcmp(lpHeader->mMagic, SEQUENCE_MAGIC, sizeof(SEQUENCE_MAGIC)) != 0 ||
+         lpHeader->mVersion != SEQUENCE_VERSION ||
+         lpHeader->mKeyframeSize != sizeof(SequenceKeyframe))
+      {
+         this->close();
+         throw std::runtime_error("Invalid keyframe file \"" + acrFileName + "\" (wrong header)");
+      }
+
+      // a truncated file plays up to its last complete keyframe
+      mpKeyframes = reinterpret_cast<const SequenceKeyframe*>(static_cast<const uint8_t*>(mpMap) + sizeof(SequenceHeader));
+      mCount = std::min<uint64_t>(lpHeader->mCount, (mMapSize - sizeof(SequenceHeader)) / sizeof(SequenceKeyframe));
+      mDuration = (mCount > 0) ? mpKeyframes[mCount - 1].mTimeUs : 0;
+      mChannelMask = lpHeader->mChannelMask;
+
+      mWrittenMask = 0;
+      this->rewind();
+   }
+
+
+   void SequencePlayer::close()
+   {
+      this->stop();
+
+      if(mpMap != nullptr)
+      {
+         munmap(mpMap, mMapSize);
+      }
+
+      if(mFile >= 0)
+      {
+         ::close(mFile);
+      }
+
+      mFile = -1;
+      mpMap = nullptr;
+      mMapSize = 0;
+      mpKeyframes = nullptr;
+      mCount = 0;
+      mDuration = 0;
+      mChannelMask = 0;
+      mReleased = 0;
+      memset(mTracks, 0, sizeof(mTracks));
+   }
+
+
+   void SequencePlayer::start(float aFrequency)
+   {
+      this->stop();
+
+      if(mpKeyframes == nullptr)
+      {
+         throw std::runtime_error("Keyframe file is not open");
+      }
+
+      if(aFrequency <= 0.0f)
+      {
+         throw std::range_error("Invalid frequency \"" + std::to_string(aFrequency) + "\"");
+      }
+
+      // other writers may have touched the outputs since the last run
+      mWrittenMask = 0;
+      this->rewind();
+
+      mRunning = true;
+      mThread = std::thread(&SequencePlayer::run, this, aFrequency);
+   }
+
+
+   void SequencePlayer::stop()
+   {
+      mRunning = false;
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+   }
+
+
+   bool SequencePlayer::isRunning() const
+   {
+      return mRunning;
+   }
+
+
+   void SequencePlayer::rewind()
+   {
+      // pages behind the cursors were released, they are read again from the file
+      mReleased = 0;
+      mPosition = 0;
+
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         Track& lrTrack = mTracks[i];
+         lrTrack.mHasFrom = false;
+
+         // unused channels would search the whole file
+         if(mChannelMask & (1u << i))
+         {
+            lrTrack.mCursor = 0;
+            this->advance(i);
+         }
+         else
+         {
+            lrTrack.mCursor = mCount;
+            lrTrack.mHasTo = false;
+         }
+      }
+   }
+
+
+   bool SequencePlayer::update(uint64_t aTimeUs)
+   {
+      C4T_TRACE_SPAN("driver", "SequencePlayer::update");
+
+      uint16_t lMask = 0;
+
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         Track& lrTrack = mTracks[i];
+
+         // pass all keyframes up to the frame time
+         while(lrTrack.mHasTo && lrTrack.mToTime <= aTimeUs)
+         {
+            lrTrack.mFromTime = lrTrack.mToTime;
+            lrTrack.mFromValue = lrTrack.mToValue;
+            lrTrack.mHasFrom = true;
+            this->advance(i);
+         }
+
+         // channel not yet started
+         if(!lrTrack.mHasFrom)
+            continue;
+
+         // interpolate towards the next keyframe
+         uint16_t lValue = lrTrack.mFromValue;
+         if(lrTrack.mHasTo && lrTrack.mMode != INTERPOLATION_STEP)
+         {
+            double lFraction = static_cast<double>(aTimeUs - lrTrack.mFromTime) /
+                               static_cast<double>(lrTrack.mToTime - lrTrack.mFromTime);
+            if(lrTrack.mMode == INTERPOLATION_SMOOTH)
+               lFraction = lFraction * lFraction * (3.0 - 2.0 * lFraction);
+
+            double lDelta = static_cast<double>(lrTrack.mToValue) - static_cast<double>(lrTrack.mFromValue);
+            lValue = static_cast<uint16_t>(std::lround(lrTrack.mFromValue + lDelta * lFraction));
+         }
+         lValue = std::min<uint16_t>(lValue, 4095);
+
+         // write changed channels only
+         if(!(mWrittenMask & (1u << i)) || mWritten[i] != lValue)
+         {
+            mOffValues[i] = lValue;
+            lMask |= static_cast<uint16_t>(1u << i);
+         }
+      }
+
+      mPosition = aTimeUs;
+      mFrames++;
+
+      if(mReleased + RELEASE_STEP <= mMapSize)
+      {
+         this->release();
+      }
+
+      if(lMask != 0)
+      {
+         mrDriver.setPWMBatch(lMask, mOnValues, mOffValues);
+         mBatches++;
+
+         for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+         {
+            if(lMask & (1u << i))
+               mWritten[i] = mOffValues[i];
+         }
+         mWrittenMask |= lMask;
+      }
+
+      return aTimeUs < mDuration;
+   }
+
+
+   void SequencePlayer::setLoop(bool aLoop)
+   {
+      mLoop = aLoop;
+   }
+
+
+   void SequencePlayer::setTimeScale(double aScale)
+   {
+      if(!(aScale > 0.0))
+      {
+         throw std::range_error("Invalid time scale \"" + std::to_string(aScale) + "\" (has to be positive)");
+      }
+
+      mTimeScale = aScale;
+   }
+
+
+   void SequencePlayer::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void SequencePlayer::setClock(DriverClock& arClock)
+   {
+      mpClock = &arClock;
+   }
+
+
+   uint64_t SequencePlayer::keyframes() const
+   {
+      return mCount;
+   }
+
+
+   uint64_t SequencePlayer::duration() const
+   {
+      return mDuration;
+   }
+
+
+   uint64_t SequencePlayer::position() const
+   {
+      return mPosition;
+   }
+
+
+   SequencePlayer::Statistics SequencePlayer::statistics() const
+   {
+      Statistics lStats;
+      lStats.mFrames = mFrames;
+      lStats.mBatches = mBatches;
+      lStats.mLoops = mLoops;
+      lStats.mLateFrames = mLateFrames;
+      lStats.mErrors = mErrors;
+      return lStats;
+   }
+
+
+   void SequencePlayer::advance(int aChannel)
+   {
+      Track& lrTrack = mTracks[aChannel];
+      uint16_t lBit = static_cast<uint16_t>(1u << aChannel);
+
+      // cursors only move forward, every keyframe is visited once per channel and pass
+      while(lrTrack.mCursor < mCount)
+      {
+         const SequenceKeyframe& lrKeyframe = mpKeyframes[lrTrack.mCursor++];
+         if(lrKeyframe.mChannelMask & lBit)
+         {
+            lrTrack.mToTime = lrKeyframe.mTimeUs;
+            lrTrack.mToValue = lrKeyframe.mValues[aChannel];
+            lrTrack.mMode = lrKeyframe.mInterpolation;
+            lrTrack.mHasTo = true;
+            return;
+         }
+      }
+
+      lrTrack.mHasTo = false;
+   }
+
+
+   void SequencePlayer::release()
+   {
+      // slowest cursor, everything before it is never read again in this pass
+      uint64_t lSlowest = mCount;
+      for(const Track& lrTrack : mTracks)
+      {
+         lSlowest = std::min(lSlowest, lrTrack.mCursor);
+      }
+
+      size_t lPage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      size_t lEnd = (sizeof(SequenceHeader) + lSlowest * sizeof(SequenceKeyframe)) / lPage * lPage;
+
+      if(lEnd >= mReleased + RELEASE_STEP)
+      {
+         madvise(mpMap, lEnd, MADV_DONTNEED);
+         mReleased = lEnd;
+      }
+   }
+
+
+   void SequencePlayer::run(float aFrequency)
+   {
+      C4T_TRACE_THREAD("sequence player");
+
+      const DriverClock::Duration lPeriod = std::chrono::duration_cast<DriverClock::Duration>(
+                                               std::chrono::duration<double>(1.0 / aFrequency));
+
+      DriverClock::TimePoint lLast = mpClock->now();
+      DriverClock::TimePoint lNext = lLast;
+      double lPosition = 0.0;
+
+      while(mRunning)
+      {
+         // advance the sequence time by the scaled clock time
+         DriverClock::TimePoint lNow = mpClock->now();
+         lPosition += std::chrono::duration<double, std::micro>(lNow - lLast).count() * mTimeScale;
+         lLast = lNow;
+
+         try
+         {
+            if(!this->update(static_cast<uint64_t>(lPosition)))
+            {
+               if(!mLoop || mDuration == 0)
+               {
+                  mRunning = false;
+                  break;
+               }
+
+               lPosition = std::fmod(lPosition, static_cast<double>(mDuration));
+               this->rewind();
+               this->update(static_cast<uint64_t>(lPosition));
+               mLoops++;
+            }
+         }
+         catch(const std::exception& e)
+         {
+            mErrors++;
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+         }
+
+         // pace to the PWM period, skip frames if we fell behind
+         lNext += lPeriod;
+         lNow = mpClock->now();
+         if(lNext < lNow)
+         {
+            mLateFrames++;
+            lNext = lNow;
+         }
+
+         mpClock->sleepUntil(lNext);
+      }
+   }
+} // namespace CAR4TEGRA
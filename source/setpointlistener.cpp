@@ -0,0 +1,384 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file setpointlistener.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class SetpointListener at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <arpa/inet.h>
+#include <endian.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/setpointlistener.hpp"
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const uint64_t SEQUENCE_RESET_NS = 1000000000ull;   ///< Silence after which any sequence is accepted (sender restart)
+      const int RECEIVE_BUFFER = 1 << 20;                 ///< Socket receive buffer (bytes)
+      const int THREAD_POLL_MS = 100;                     ///< Poll timeout of the listener thread (ms)
+
+      static_assert(sizeof(SetpointPacket) == SETPOINT_PACKET_SIZE, "SetpointPacket layout has changed");
+
+
+      /**
+       * @brief Returns the current CLOCK_REALTIME time
+       *
+       * @return Time (ns)
+       */
+      inline uint64_t realtimeNow()
+      {
+         struct timespec lTime;
+         clock_gettime(CLOCK_REALTIME, &lTime);
+         return static_cast<uint64_t>(lTime.tv_sec) * 1000000000ull + static_cast<uint64_t>(lTime.tv_nsec);
+      }
+   } // namespace
+
+
+   SetpointListener::SetpointListener(PCA9685& arDriver)
+      : mrDriver(arDriver), mSocket(-1), mPort(0), mMaxAgeNs(50000000ull), mHaveSequence(false),
+        mLastSequence(0), mLastAcceptNs(0), mRunning(false), mStatistics(), mLatencySumUs(0.0)
+   {
+      // message headers point to the preallocated buffers once and for all
+      memset(mMessages, 0, sizeof(mMessages));
+      for(int i = 0; i < BATCH_SIZE; i++)
+      {
+         mVectors[i].iov_base = mBuffers[i];
+         mVectors[i].iov_len = sizeof(mBuffers[i]);
+         mMessages[i].msg_hdr.msg_iov = &mVectors[i];
+         mMessages[i].msg_hdr.msg_iovlen = 1;
+         mMessages[i].msg_hdr.msg_control = mControl[i];
+      }
+   }
+
+
+   SetpointListener::~SetpointListener()
+   {
+      this->stop();
+      this->close();
+   }
+
+
+   void SetpointListener::open(uint16_t aPort, const std::string& acrAddress)
+   {
+      this->close();
+
+      struct sockaddr_in lAddress;
+      memset(&lAddress, 0, sizeof(lAddress));
+      lAddress.sin_family = AF_INET;
+      lAddress.sin_port = htons(aPort);
+      if(inet_pton(AF_INET, acrAddress.c_str(), &lAddress.sin_addr) != 1)
+      {
+         throw std::runtime_error("Invalid listen address \"" + acrAddress + "\"");
+      }
+
+      // try to open and bind socket, kernel receive timestamps for the latency measurement
+      int lOn = 1;
+      socklen_t lLength = sizeof(lAddress);
+      if((mSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)) < 0 ||
+         setsockopt(mSocket, SOL_SOCKET, SO_TIMESTAMPNS, &lOn, sizeof(lOn)) < 0 ||
+         setsockopt(mSocket, SOL_SOCKET, SO_RCVBUF, &RECEIVE_BUFFER, sizeof(RECEIVE_BUFFER)) < 0 ||
+         bind(mSocket, reinterpret_cast<struct sockaddr*>(&lAddress), sizeof(lAddress)) < 0 ||
+         getsockname(mSocket, reinterpret_cast<struct sockaddr*>(&lAddress), &lLength) < 0)
+      {
+         int lErrno = errno;
+         this->close();
+         throw std::runtime_error("Failed to open UDP port \"" + std::to_string(aPort) +
+                                  "\" on \"" + acrAddress + "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mPort = ntohs(lAddress.sin_port);
+      mHaveSequence = false;
+   }
+
+
+   void SetpointListener::close()
+   {
+      if(mSocket >= 0)
+      {
+         ::close(mSocket);
+      }
+
+      mSocket = -1;
+      mPort = 0;
+   }
+
+
+   uint16_t SetpointListener::port() const
+   {
+      return mPort;
+   }
+
+
+   void SetpointListener::setMaxAge(uint64_t aMaxAgeUs)
+   {
+      mMaxAgeNs = aMaxAgeUs * 1000ull;
+   }
+
+
+   void SetpointListener::start()
+   {
+      this->stop();
+
+      mRunning = true;
+      mThread = std::thread(&SetpointListener::run, this);
+   }
+
+
+   void SetpointListener::stop()
+   {
+      mRunning = false;
+
+      if(mThread.joinable())
+      {
+         mThread.join();
+      }
+   }
+
+
+   int SetpointListener::poll(int aTimeoutMs)
+   {
+      if(mSocket < 0)
+      {
+         throw std::runtime_error("Failed to receive setpoints: UDP socket is not open");
+      }
+
+      // wait for the first datagram, then take everything available
+      struct pollfd lPoll = { mSocket, POLLIN, 0 };
+      if(::poll(&lPoll, 1, aTimeoutMs) <= 0)
+         return 0;
+
+      for(int i = 0; i < BATCH_SIZE; i++)
+      {
+         mMessages[i].msg_hdr.msg_controllen = sizeof(mControl[i]);
+      }
+
+      int lCount = recvmmsg(mSocket, mMessages, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+      if(lCount < 0)
+      {
+         if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+         {
+            throw std::runtime_error("Failed to receive setpoints (Error " + std::to_string(errno) +
+                                     ": " + strerror(errno) + ")");
+         }
+         return 0;
+      }
+
+
+      // merge accepted packets per channel, the newest value wins
+      uint16_t lMask = 0;
+      uint16_t lOnValues[PCA9685_CHANNEL_COUNT] = { 0 };
+      uint16_t lOffValues[PCA9685_CHANNEL_COUNT] = { 0 };
+      uint64_t lFirstReceiveNs = 0;
+      int lAccepted = 0;
+      Statistics lBatch = Statistics();
+
+      for(int i = 0; i < lCount; i++)
+      {
+         // kernel receive time
+         uint64_t lReceiveNs = 0;
+         for(struct cmsghdr* lpMsg = CMSG_FIRSTHDR(&mMessages[i].msg_hdr); lpMsg != nullptr;
+             lpMsg = CMSG_NXTHDR(&mMessages[i].msg_hdr, lpMsg))
+         {
+            if(lpMsg->cmsg_level == SOL_SOCKET && lpMsg->cmsg_type == SCM_TIMESTAMPNS)
+            {
+               struct timespec lTime;
+               memcpy(&lTime, CMSG_DATA(lpMsg), sizeof(lTime));
+               lReceiveNs = static_cast<uint64_t>(lTime.tv_sec) * 1000000000ull + static_cast<uint64_t>(lTime.tv_nsec);
+            }
+         }
+         if(lReceiveNs == 0)
+            lReceiveNs = realtimeNow();
+
+         lBatch.mReceived++;
+
+         SetpointPacket lPacket;
+         DecodeResult lResult = this->decode(mBuffers[i], mMessages[i].msg_len, lReceiveNs, lPacket);
+         if(lResult != DECODE_ACCEPTED)
+         {
+            lBatch.mMalformed += (lResult == DECODE_MALFORMED) ? 1 : 0;
+            lBatch.mStale += (lResult == DECODE_STALE) ? 1 : 0;
+            lBatch.mOutOfOrder += (lResult == DECODE_OUT_OF_ORDER) ? 1 : 0;
+            continue;
+         }
+
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            if(lPacket.mChannelMask & (1u << lChannel))
+               lOffValues[lChannel] = lPacket.mValues[lChannel];
+         }
+         lMask |= lPacket.mChannelMask;
+
+         lFirstReceiveNs = (lFirstReceiveNs == 0) ? lReceiveNs : std::min(lFirstReceiveNs, lReceiveNs);
+         lAccepted++;
+      }
+
+
+      // one batched write for all packets
+      double lLatencyUs = 0.0;
+      bool lWritten = false;
+      if(lMask != 0)
+      {
+         try
+         {
+            mrDriver.setPWMBatch(lMask, lOnValues, lOffValues);
+            lWritten = true;
+            lLatencyUs = (realtimeNow() - lFirstReceiveNs) / 1000.0;
+         }
+         catch(const std::exception& e)
+         {
+            lBatch.mErrors++;
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+         }
+      }
+
+      std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+      mStatistics.mReceived += lBatch.mReceived;
+      mStatistics.mAccepted += lAccepted;
+      mStatistics.mMalformed += lBatch.mMalformed;
+      mStatistics.mStale += lBatch.mStale;
+      mStatistics.mOutOfOrder += lBatch.mOutOfOrder;
+      mStatistics.mErrors += lBatch.mErrors;
+      if(lWritten)
+      {
+         mStatistics.mBatches++;
+         mLatencySumUs += lLatencyUs;
+         mStatistics.mMaxLatencyUs = std::max(mStatistics.mMaxLatencyUs, lLatencyUs);
+         mStatistics.mMeanLatencyUs = mLatencySumUs / mStatistics.mBatches;
+      }
+
+      return lAccepted;
+   }
+
+
+   SetpointListener::Statistics SetpointListener::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mStatisticsMutex);
+      return mStatistics;
+   }
+
+
+   void SetpointListener::setErrorCallback(ErrorCallback aCallback)
+   {
+      mErrorCallback = aCallback;
+   }
+
+
+   void SetpointListener::encode(uint32_t aSequence, uint64_t aTimestampNs, uint16_t aChannelMask,
+                                 const uint16_t* apValues, uint8_t* apBuffer)
+   {
+      SetpointPacket lPacket;
+      lPacket.mMagic = htole32(SETPOINT_PACKET_MAGIC);
+      lPacket.mSequence = htole32(aSequence);
+      lPacket.mTimestampNs = htole64(aTimestampNs);
+      lPacket.mChannelMask = htole16(aChannelMask);
+      lPacket.mReserved = 0;
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         lPacket.mValues[i] = htole16((aChannelMask & (1u << i)) ? apValues[i] : 0);
+      }
+
+      memcpy(apBuffer, &lPacket, sizeof(lPacket));
+   }
+
+
+   SetpointListener::DecodeResult SetpointListener::decode(const uint8_t* apData, size_t aLength, uint64_t aReceiveNs,
+                                                           SetpointPacket& arPacket)
+   {
+      // fixed layout: size and magic first
+      if(aLength != SETPOINT_PACKET_SIZE)
+         return DECODE_MALFORMED;
+
+      memcpy(&arPacket, apData, sizeof(arPacket));
+      arPacket.mMagic = le32toh(arPacket.mMagic);
+      arPacket.mSequence = le32toh(arPacket.mSequence);
+      arPacket.mTimestampNs = le64toh(arPacket.mTimestampNs);
+      arPacket.mChannelMask = le16toh(arPacket.mChannelMask);
+      arPacket.mReserved = le16toh(arPacket.mReserved);
+
+      if(arPacket.mMagic != SETPOINT_PACKET_MAGIC || arPacket.mReserved != 0)
+         return DECODE_MALFORMED;
+
+      for(int i = 0; i < PCA9685_CHANNEL_COUNT; i++)
+      {
+         arPacket.mValues[i] = le16toh(arPacket.mValues[i]);
+         if((arPacket.mChannelMask & (1u << i)) && arPacket.mValues[i] > 4095)
+            return DECODE_MALFORMED;
+      }
+
+      // stale packet
+      if(mMaxAgeNs > 0 && aReceiveNs > arPacket.mTimestampNs && aReceiveNs - arPacket.mTimestampNs > mMaxAgeNs)
+         return DECODE_STALE;
+
+      // duplicate or out-of-order packet, unless the sender was silent long enough to have restarted
+      if(mHaveSequence && static_cast<int32_t>(arPacket.mSequence - mLastSequence) <= 0 &&
+         aReceiveNs - mLastAcceptNs < SEQUENCE_RESET_NS)
+         return DECODE_OUT_OF_ORDER;
+
+      mHaveSequence = true;
+      mLastSequence = arPacket.mSequence;
+      mLastAcceptNs = aReceiveNs;
+      return DECODE_ACCEPTED;
+   }
+
+
+   void SetpointListener::run()
+   {
+      C4T_TRACE_THREAD("udp listener");
+
+      while(mRunning)
+      {
+         try
+         {
+            this->poll(THREAD_POLL_MS);
+         }
+         catch(const std::exception& e)
+         {
+            if(mErrorCallback)
+               mErrorCallback(e.what());
+            std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_POLL_MS));
+         }
+      }
+   }
+} // namespace CAR4TEGRA
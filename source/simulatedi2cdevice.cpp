@@ -0,0 +1,340 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file simulatedi2cdevice.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class SimulatedI2cDevice at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <algorithm>
+#include <map>
+
+// Car4Tegra includes
+#include "include/simulatedi2cdevice.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const int SIMULATED_BUS_FD = 1000;      ///< File descriptor returned for the simulated bus
+      const double BITS_PER_BYTE = 9.0;       ///< 8 data bits and ACK
+      const double BITS_START_STOP = 2.0;     ///< START and STOP condition
+   } // namespace
+
+
+   /**
+    * @brief Time at which a simulated bus gets free
+    */
+   struct SimulatedI2cDevice::BusTimeline
+   {
+      std::mutex mMutex;                     ///< Protects the free time
+      DriverClock::TimePoint mFree;          ///< End of the last reserved transaction
+   };
+
+
+   SimulatedI2cDevice::SimulatedI2cDevice()
+      : mAddress(0), mErrorCount(0), mErrno(0), mStatistics(), mBusClock(0), mOverheadUs(0.0),
+        mpClock(&DriverClock::monotonic()), mpTimeline(nullptr)
+   {
+      this->powerCycle();
+   }
+
+
+   SimulatedI2cDevice::~SimulatedI2cDevice()
+   {
+      // the base class destructor can not reach the overridden bus functions anymore
+      this->closeBus();
+   }
+
+
+   void SimulatedI2cDevice::powerCycle()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      // power-on values (table 4 in NXP datasheet)
+      mRegisters.fill(0x00);
+      mRegisters[PCA9685_REG_MODE1] = PCA9685_MODE1_SLEEP | PCA9685_MODE1_ALLCALL;
+      mRegisters[PCA9685_REG_MODE2] = PCA9685_MODE2_OUTDRV;
+      mRegisters[PCA9685_REG_SUBADR1] = 0xE2;
+      mRegisters[PCA9685_REG_SUBADR2] = 0xE4;
+      mRegisters[PCA9685_REG_SUBADR3] = 0xE8;
+      mRegisters[PCA9685_REG_ALLCALLADR] = 0xE0;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         mRegisters[PCA9685_REG_LED0_OFF_H + 4 * lChannel] = 0x10;
+      }
+      mRegisters[PCA9685_REG_PRE_SCALE] = 0x1E;
+   }
+
+
+   void SimulatedI2cDevice::injectErrors(int aCount, int aErrno)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mErrorCount = aCount;
+      mErrno = aErrno;
+   }
+
+
+   void SimulatedI2cDevice::setBusTiming(uint32_t aBusClock, double aOverheadUs, DriverClock& arClock)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mBusClock = aBusClock;
+      mOverheadUs = std::max(aOverheadUs, 0.0);
+      mpClock = &arClock;
+   }
+
+
+   int SimulatedI2cDevice::peekRegister(int aRegister)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mRegisters[aRegister & 0xFF];
+   }
+
+
+   SimulatedI2cDevice::Statistics SimulatedI2cDevice::statistics()
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      return mStatistics;
+   }
+
+
+   int SimulatedI2cDevice::busOpen(const std::string& acrBusName)
+   {
+      if(acrBusName.empty())
+      {
+         errno = ENOENT;
+         return -1;
+      }
+
+      BusTimeline& lrTimeline = SimulatedI2cDevice::timeline(acrBusName);
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mpTimeline = &lrTimeline;
+      return SIMULATED_BUS_FD;
+   }
+
+
+   int SimulatedI2cDevice::busClose(int aBus)
+   {
+      if(aBus != SIMULATED_BUS_FD)
+      {
+         errno = EBADF;
+         return -1;
+      }
+
+      return 0;
+   }
+
+
+   int SimulatedI2cDevice::busSelect(int aBus, int aAddress)
+   {
+      if(aBus != SIMULATED_BUS_FD)
+      {
+         errno = EBADF;
+         return -1;
+      }
+
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mAddress = aAddress;
+      return 0;
+   }
+
+
+   int SimulatedI2cDevice::busReadByte(int aBus, int aRegister)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      // address, register, address, data
+      if(aBus != SIMULATED_BUS_FD || this->beginTransaction(4))
+         return -1;
+
+      return this->load(aRegister & 0xFF);
+   }
+
+
+   int SimulatedI2cDevice::busWriteByte(int aBus, int aRegister, int aValue)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      // address, register, data
+      if(aBus != SIMULATED_BUS_FD || this->beginTransaction(3))
+         return -1;
+
+      this->store(aRegister & 0xFF, static_cast<uint8_t>(aValue));
+      return 0;
+   }
+
+
+   int SimulatedI2cDevice::busTransfer(int aBus, struct i2c_msg* apMsgs, int aCount)
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+
+      size_t lBytes = 0;
+      for(int i = 0; i < aCount; i++)
+      {
+         lBytes += 1 + apMsgs[i].len;
+      }
+
+      if(aBus != SIMULATED_BUS_FD || this->beginTransaction(lBytes))
+         return -1;
+
+
+      // register pointer is set by the first byte of a write message
+      int lPointer = 0;
+      for(int i = 0; i < aCount; i++)
+      {
+         struct i2c_msg& lMsg = apMsgs[i];
+
+         if(lMsg.flags & I2C_M_RD)
+         {
+            for(size_t j = 0; j < lMsg.len; j++)
+            {
+               lMsg.buf[j] = this->load(lPointer);
+               lPointer = this->nextRegister(lPointer);
+            }
+         }
+         else if(lMsg.len > 0)
+         {
+            lPointer = lMsg.buf[0];
+            for(size_t j = 1; j < lMsg.len; j++)
+            {
+               this->store(lPointer, lMsg.buf[j]);
+               lPointer = this->nextRegister(lPointer);
+            }
+         }
+      }
+
+      return aCount;
+   }
+
+
+   SimulatedI2cDevice::BusTimeline& SimulatedI2cDevice::timeline(const std::string& acrBusName)
+   {
+      // timelines are never removed, devices keep a pointer to theirs
+      static std::mutex sMutex;
+      static std::map<std::string, BusTimeline> sTimelines;
+
+      std::lock_guard<std::mutex> lLock(sMutex);
+      return sTimelines[acrBusName];
+   }
+
+
+   bool SimulatedI2cDevice::beginTransaction(size_t aBytes)
+   {
+      mStatistics.mTransactions++;
+      mStatistics.mBytes += aBytes;
+
+      if(mBusClock > 0 && mpTimeline != nullptr)
+      {
+         // the transaction starts when the bus gets free, other devices of the bus queue behind it
+         double lBusyUs = mOverheadUs + (aBytes * BITS_PER_BYTE + BITS_START_STOP) * 1000000.0 / mBusClock;
+         DriverClock::TimePoint lEnd;
+         {
+            std::lock_guard<std::mutex> lLock(mpTimeline->mMutex);
+            lEnd = std::max(mpClock->now(), mpTimeline->mFree)
+                   + std::chrono::duration_cast<DriverClock::Duration>(std::chrono::duration<double, std::micro>(lBusyUs));
+            mpTimeline->mFree = lEnd;
+         }
+
+         mStatistics.mBusyUs += lBusyUs;
+         mpClock->sleepUntil(lEnd);
+      }
+
+      if(mErrorCount > 0)
+      {
+         mErrorCount--;
+         mStatistics.mErrors++;
+         errno = mErrno;
+         return true;
+      }
+
+      return false;
+   }
+
+
+   void SimulatedI2cDevice::store(int aRegister, uint8_t aValue)
+   {
+      // ALL_LED registers load the same byte of every LEDn register
+      if(aRegister >= PCA9685_REG_ALL_LED_ON_L && aRegister <= PCA9685_REG_ALL_LED_OFF_H)
+      {
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            mRegisters[PCA9685_REG_LED0_ON_L + 4 * lChannel + aRegister - PCA9685_REG_ALL_LED_ON_L] = aValue;
+         }
+         return;
+      }
+
+      switch(aRegister)
+      {
+         // RESTART clears itself, writing 0 has no effect
+         case PCA9685_REG_MODE1:
+            mRegisters[aRegister] = aValue & ~PCA9685_MODE1_RESTART;
+            break;
+
+         // prescale is only writeable while sleeping
+         case PCA9685_REG_PRE_SCALE:
+            if(mRegisters[PCA9685_REG_MODE1] & PCA9685_MODE1_SLEEP)
+               mRegisters[aRegister] = (aValue < 3) ? 3 : aValue;
+            break;
+
+         case PCA9685_REG_TESTMODE:
+            break;
+
+         default:
+            if(aRegister <= PCA9685_BLOCK_LOW_LAST)
+               mRegisters[aRegister] = aValue;
+            break;
+      }
+   }
+
+
+   uint8_t SimulatedI2cDevice::load(int aRegister) const
+   {
+      // ALL_LED registers read back as zero
+      if(aRegister >= PCA9685_REG_ALL_LED_ON_L && aRegister <= PCA9685_REG_ALL_LED_OFF_H)
+         return 0x00;
+
+      return mRegisters[aRegister];
+   }
+
+
+   int SimulatedI2cDevice::nextRegister(int aRegister) const
+   {
+      if(!(mRegisters[PCA9685_REG_MODE1] & PCA9685_MODE1_AI))
+         return aRegister;
+
+      // both windows roll over to MODE1 (datasheet 7.3, remark below table 4)
+      if(aRegister == PCA9685_BLOCK_LOW_LAST || aRegister == PCA9685_BLOCK_HIGH_LAST)
+         return PCA9685_BLOCK_LOW_FIRST;
+
+      return (aRegister + 1) & 0xFF;
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,337 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file spantracer.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class SpanTracer at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/spantracer.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      static_assert((SPAN_RING_CAPACITY & (SPAN_RING_CAPACITY - 1)) == 0, "SPAN_RING_CAPACITY has to be a power of two");
+
+      const double BITS_PER_BYTE = 9.0;      ///< 8 data bits and ACK
+      const double BITS_OVERHEAD = 2.0 + 9.0;   ///< START / STOP condition and address byte
+
+
+      /**
+       * @brief One recorded span
+       */
+      struct Span
+      {
+         const char* mpCategory;    ///< Category of the span
+         const char* mpName;        ///< Name of the span
+         uint64_t mStartNs;         ///< Start time (ns)
+         uint32_t mDurationNs;      ///< Duration (ns, saturated)
+         uint32_t mBytes;           ///< Bytes transferred on the bus
+      };
+
+
+      /**
+       * @brief Thread which wrote a part of a ring
+       */
+      struct RingOwner
+      {
+         uint64_t mFirst;                    ///< Index of the first span of the thread
+         pid_t mTid;                         ///< Kernel thread id
+         std::string mName;                  ///< Thread name
+      };
+
+
+      /**
+       * @brief Span ring buffer of one thread (written by the owning thread only)
+       *
+       * The ring of a finished thread is handed to the next new thread, the spans of former
+       * owners stay exportable until they are overwritten.
+       */
+      struct ThreadRing
+      {
+         std::vector<RingOwner> mOwners;     ///< Owners of the spans in the ring, current one last (protected by gRegistryMutex)
+         std::atomic<uint64_t> mHead;        ///< Number of spans ever written
+         std::atomic<uint64_t> mCleared;     ///< Number of spans written before the last clear()
+         Span mSpans[SPAN_RING_CAPACITY];    ///< Span slots
+      };
+
+
+      /**
+       * @brief Returns the ring of the calling thread to the free list at thread exit
+       */
+      struct RingRelease
+      {
+         ~RingRelease();
+      };
+
+
+      std::mutex gRegistryMutex;                            ///< Protects gRings, gFreeRings and the owners
+      std::vector<std::unique_ptr<ThreadRing>> gRings;      ///< Rings of all threads
+      std::vector<ThreadRing*> gFreeRings;                  ///< Rings of finished threads
+      thread_local ThreadRing* tpRing = nullptr;            ///< Ring of the calling thread
+      thread_local bool tExited = false;                    ///< Ring of the calling thread was released
+      thread_local RingRelease tRingRelease;                ///< Releases the ring at thread exit
+
+
+      /**
+       * @brief Returns the first span of a ring which is still valid
+       *
+       * @param[in]  acrRing        Ring
+       * @param[in]  aHead          Head of the ring
+       *
+       * @return Index of the oldest span neither overwritten nor cleared
+       */
+      uint64_t firstValid(const ThreadRing& acrRing, uint64_t aHead)
+      {
+         uint64_t lFirst = (aHead > SPAN_RING_CAPACITY) ? aHead - SPAN_RING_CAPACITY : 0;
+         return std::min(std::max(lFirst, acrRing.mCleared.load(std::memory_order_acquire)), aHead);
+      }
+
+
+      /**
+       * @brief Returns the ring of the calling thread, takes a free one or allocates it on first use
+       *
+       * @return Ring of the calling thread (`nullptr` while the thread exits)
+       */
+      ThreadRing* threadRing()
+      {
+         if(tpRing == nullptr && !tExited)
+         {
+            pid_t lTid = static_cast<pid_t>(syscall(SYS_gettid));
+            std::lock_guard<std::mutex> lLock(gRegistryMutex);
+
+            ThreadRing* lpRing = nullptr;
+            if(!gFreeRings.empty())
+            {
+               lpRing = gFreeRings.back();
+               gFreeRings.pop_back();
+
+               // forget former owners without spans left in the ring
+               uint64_t lHead = lpRing->mHead.load(std::memory_order_relaxed);
+               uint64_t lValid = firstValid(*lpRing, lHead);
+               std::vector<RingOwner>& lrOwners = lpRing->mOwners;
+               size_t lKeep = 0;
+               for(size_t i = 0; i < lrOwners.size(); i++)
+               {
+                  uint64_t lEnd = (i + 1 < lrOwners.size()) ? lrOwners[i + 1].mFirst : lHead;
+                  if(lEnd > lValid && lEnd > lrOwners[i].mFirst)
+                     lrOwners[lKeep++] = std::move(lrOwners[i]);
+               }
+               lrOwners.resize(lKeep);
+            }
+            else
+            {
+               std::unique_ptr<ThreadRing> lpNew(new ThreadRing());
+               lpNew->mHead.store(0, std::memory_order_relaxed);
+               lpNew->mCleared.store(0, std::memory_order_relaxed);
+               lpRing = lpNew.get();
+               gRings.push_back(std::move(lpNew));
+            }
+
+            lpRing->mOwners.push_back(RingOwner{ lpRing->mHead.load(std::memory_order_relaxed), lTid,
+                                                 "thread " + std::to_string(lTid) });
+            tpRing = lpRing;
+
+            // odr-use constructs the releasing thread_local
+            (void)&tRingRelease;
+         }
+
+         return tpRing;
+      }
+
+
+      RingRelease::~RingRelease()
+      {
+         // spans recorded by later thread_local destructors are dropped
+         tExited = true;
+         if(tpRing == nullptr)
+            return;
+
+         std::lock_guard<std::mutex> lLock(gRegistryMutex);
+         gFreeRings.push_back(tpRing);
+         tpRing = nullptr;
+      }
+
+
+      /**
+       * @brief Escapes a string for JSON
+       *
+       * @param[in]  acrText        Text to escape
+       *
+       * @return Escaped text
+       */
+      std::string escape(const std::string& acrText)
+      {
+         std::string lResult;
+         for(char lChar : acrText)
+         {
+            if(lChar == '"' || lChar == '\\')
+               lResult += '\\';
+            if(static_cast<unsigned char>(lChar) >= 0x20)
+               lResult += lChar;
+         }
+         return lResult;
+      }
+   } // namespace
+
+
+   void SpanTracer::record(const char* apCategory, const char* apName, uint64_t aStartNs, uint64_t aEndNs,
+                           uint32_t aBytes)
+   {
+      ThreadRing* lpRing = threadRing();
+      if(lpRing == nullptr)
+         return;
+
+      ThreadRing& lRing = *lpRing;
+      uint64_t lHead = lRing.mHead.load(std::memory_order_relaxed);
+      uint64_t lDuration = (aEndNs > aStartNs) ? aEndNs - aStartNs : 0;
+
+      Span& lSpan = lRing.mSpans[lHead & (SPAN_RING_CAPACITY - 1)];
+      lSpan.mpCategory = apCategory;
+      lSpan.mpName = apName;
+      lSpan.mStartNs = aStartNs;
+      lSpan.mDurationNs = static_cast<uint32_t>(std::min<uint64_t>(lDuration, UINT32_MAX));
+      lSpan.mBytes = aBytes;
+
+      // publish the slot
+      lRing.mHead.store(lHead + 1, std::memory_order_release);
+   }
+
+
+   void SpanTracer::setThreadName(const std::string& acrName)
+   {
+      ThreadRing* lpRing = threadRing();
+      if(lpRing == nullptr)
+         return;
+
+      std::lock_guard<std::mutex> lLock(gRegistryMutex);
+      lpRing->mOwners.back().mName = acrName;
+   }
+
+
+   size_t SpanTracer::exportChrome(const std::string& acrFileName, uint32_t aBusClock)
+   {
+      FILE* lpFile = fopen(acrFileName.c_str(), "w");
+      if(lpFile == nullptr)
+      {
+         throw std::runtime_error("Failed to open span trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(errno) + ": " + strerror(errno) + ")");
+      }
+
+      pid_t lPid = getpid();
+      size_t lCount = 0;
+      size_t lEvents = 0;
+      std::vector<Span> lSpans(SPAN_RING_CAPACITY);
+
+      fprintf(lpFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+      std::lock_guard<std::mutex> lLock(gRegistryMutex);
+      for(const std::unique_ptr<ThreadRing>& lpRing : gRings)
+      {
+         const std::vector<RingOwner>& lcrOwners = lpRing->mOwners;
+         for(const RingOwner& lcrOwner : lcrOwners)
+         {
+            fprintf(lpFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    (lEvents > 0) ? ",\n" : "", lPid, lcrOwner.mTid, escape(lcrOwner.mName).c_str());
+            lEvents++;
+         }
+
+         // copy the valid window, then drop the slots overwritten while copying
+         uint64_t lHead = lpRing->mHead.load(std::memory_order_acquire);
+         uint64_t lFirst = firstValid(*lpRing, lHead);
+         for(uint64_t i = lFirst; i < lHead; i++)
+         {
+            lSpans[i - lFirst] = lpRing->mSpans[i & (SPAN_RING_CAPACITY - 1)];
+         }
+
+         uint64_t lHeadAfter = lpRing->mHead.load(std::memory_order_acquire);
+         uint64_t lValid = (lHeadAfter > SPAN_RING_CAPACITY) ? std::max(lFirst, lHeadAfter - SPAN_RING_CAPACITY) : lFirst;
+
+         size_t lOwner = 0;
+         for(uint64_t i = lValid; i < lHead; i++)
+         {
+            const Span& lSpan = lSpans[i - lFirst];
+
+            // spans of former owners of a recycled ring keep their thread
+            while(lOwner + 1 < lcrOwners.size() && lcrOwners[lOwner + 1].mFirst <= i)
+               lOwner++;
+
+            fprintf(lpFile, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    (lEvents > 0) ? ",\n" : "", lSpan.mpName, lSpan.mpCategory, lPid, lcrOwners[lOwner].mTid,
+                    lSpan.mStartNs / 1000.0, lSpan.mDurationNs / 1000.0);
+
+            if(lSpan.mBytes > 0)
+            {
+               double lBusUs = (lSpan.mBytes * BITS_PER_BYTE + BITS_OVERHEAD) * 1000000.0 / aBusClock;
+               fprintf(lpFile, ",\"args\":{\"bytes\":%u,\"bus_us\":%.1f}", lSpan.mBytes, lBusUs);
+            }
+
+            fprintf(lpFile, "}");
+            lEvents++;
+            lCount++;
+         }
+      }
+
+      fprintf(lpFile, "\n]}\n");
+
+      if(fclose(lpFile) != 0)
+      {
+         throw std::runtime_error("Failed to write span trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(errno) + ": " + strerror(errno) + ")");
+      }
+
+      return lCount;
+   }
+
+
+   void SpanTracer::clear()
+   {
+      // only the owning thread writes a ring, so the rings are emptied by moving the read window
+      std::lock_guard<std::mutex> lLock(gRegistryMutex);
+      for(std::unique_ptr<ThreadRing>& lpRing : gRings)
+      {
+         lpRing->mCleared.store(lpRing->mHead.load(std::memory_order_acquire), std::memory_order_release);
+      }
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,292 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file telemetryplot.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class TelemetryPlot
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// QT includes
+#include <QPainter>
+
+// std includes
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// internal includes
+#include "include/telemetryplot.hpp"
+
+
+namespace
+{
+   const int AXIS_WIDTH = 48;             ///< Width of the axis labels (px)
+   const int MARGIN = 4;                  ///< Margin around the lanes (px)
+   const double LANE_PWM = 0.6;           ///< Height fraction of the PWM lane
+   const double LANE_LATENCY = 0.25;      ///< Height fraction of the latency lane
+   const int WINDOW_DEFAULT_MS = 10000;   ///< Default visible time span (ms)
+} // namespace
+
+
+TelemetryPlot::TelemetryPlot(QWidget* apParent)
+   : QWidget(apParent), mChannels(TELEMETRY_CHANNELS), mPaintBuffer(TELEMETRY_CHANNELS),
+     mStart(Clock::now()), mLastColumn(-1), mChanged(false)
+{
+   mVisible.fill(true);
+   mLine.reserve(TELEMETRY_COLUMNS);
+   this->setWindow(WINDOW_DEFAULT_MS);
+
+   connect(&mTimer, &QTimer::timeout, this, &TelemetryPlot::refresh);
+   mTimer.start(TELEMETRY_REFRESH_MS);
+}
+
+
+void TelemetryPlot::addSample(int aChannel, int aValue, double aLatencyUs, bool aError)
+{
+   if(aChannel < 0 || aChannel >= TELEMETRY_CHANNELS)
+   {
+      throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                             "\" (has to be between 0 and " + std::to_string(TELEMETRY_CHANNELS - 1) + ")");
+   }
+
+   uint16_t lValue = static_cast<uint16_t>(std::min(std::max(aValue, 0), 4095));
+
+   std::lock_guard<std::mutex> lLock(mMutex);
+   int64_t lIndex = this->currentColumn();
+
+   // first sample of a column replaces the column of the previous round
+   Column& lColumn = mChannels[aChannel][lIndex % TELEMETRY_COLUMNS];
+   if(lColumn.mIndex != lIndex)
+   {
+      lColumn = Column{ lIndex, lValue, lValue, lValue, 0, 0.0f };
+   }
+
+   lColumn.mMin = std::min(lColumn.mMin, lValue);
+   lColumn.mMax = std::max(lColumn.mMax, lValue);
+   lColumn.mLast = lValue;
+   lColumn.mMaxLatencyUs = std::max(lColumn.mMaxLatencyUs, static_cast<float>(aLatencyUs));
+   if(aError && lColumn.mErrors < UINT16_MAX)
+      lColumn.mErrors++;
+
+   mLastColumn = std::max(mLastColumn, lIndex);
+   mChanged = true;
+}
+
+
+void TelemetryPlot::setWindow(int aWindowMs)
+{
+   std::lock_guard<std::mutex> lLock(mMutex);
+
+   mColumnDuration = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::milliseconds(std::max(aWindowMs, 1))) / TELEMETRY_COLUMNS;
+   mColumnDuration = std::max(mColumnDuration, Clock::duration(1));
+   mStart = Clock::now();
+   mLastColumn = -1;
+
+   for(ColumnRing& lRing : mChannels)
+   {
+      lRing.fill(Column{ -1, 0, 0, 0, 0, 0.0f });
+   }
+   mChanged = true;
+}
+
+
+void TelemetryPlot::setChannelVisible(int aChannel, bool aVisible)
+{
+   if(aChannel < 0 || aChannel >= TELEMETRY_CHANNELS)
+   {
+      throw std::range_error("Invalid channel \"" + std::to_string(aChannel) +
+                             "\" (has to be between 0 and " + std::to_string(TELEMETRY_CHANNELS - 1) + ")");
+   }
+
+   std::lock_guard<std::mutex> lLock(mMutex);
+   mVisible[aChannel] = aVisible;
+   mChanged = true;
+}
+
+
+void TelemetryPlot::clear()
+{
+   std::lock_guard<std::mutex> lLock(mMutex);
+
+   for(ColumnRing& lRing : mChannels)
+   {
+      lRing.fill(Column{ -1, 0, 0, 0, 0, 0.0f });
+   }
+   mLastColumn = -1;
+   mChanged = true;
+}
+
+
+void TelemetryPlot::paintEvent(QPaintEvent* apEvent)
+{
+   (void)apEvent;
+
+   // take a copy of the columns, producers are not blocked while drawing
+   std::array<bool, TELEMETRY_CHANNELS> lVisible;
+   int64_t lNow = 0;
+   double lWindowS = 0.0;
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      mPaintBuffer = mChannels;
+      lVisible = mVisible;
+      lNow = this->currentColumn();
+      lWindowS = std::chrono::duration<double>(mColumnDuration * TELEMETRY_COLUMNS).count();
+   }
+   int64_t lFirst = lNow - TELEMETRY_COLUMNS + 1;
+
+
+   // value ranges of the visible history
+   int lPwmMin = 4095;
+   int lPwmMax = 0;
+   float lLatencyMax = 1.0f;
+   for(int lChannel = 0; lChannel < TELEMETRY_CHANNELS; lChannel++)
+   {
+      if(!lVisible[lChannel])
+         continue;
+
+      for(const Column& lColumn : mPaintBuffer[lChannel])
+      {
+         if(lColumn.mIndex < lFirst || lColumn.mIndex > lNow)
+            continue;
+
+         lPwmMin = std::min<int>(lPwmMin, lColumn.mMin);
+         lPwmMax = std::max<int>(lPwmMax, lColumn.mMax);
+         lLatencyMax = std::max(lLatencyMax, lColumn.mMaxLatencyUs);
+      }
+   }
+
+   if(lPwmMin > lPwmMax)
+   {
+      lPwmMin = 0;
+      lPwmMax = 4095;
+   }
+   int lPad = std::max((lPwmMax - lPwmMin) / 10, 5);
+   lPwmMin = std::max(lPwmMin - lPad, 0);
+   lPwmMax = std::min(lPwmMax + lPad, 4095);
+
+
+   // lanes: PWM on top, latency in the middle, errors at the bottom
+   QRectF lArea = QRectF(this->rect()).adjusted(AXIS_WIDTH, MARGIN, -MARGIN, -MARGIN);
+   QRectF lPwmLane(lArea.left(), lArea.top(), lArea.width(), lArea.height() * LANE_PWM - MARGIN);
+   QRectF lLatencyLane(lArea.left(), lArea.top() + lArea.height() * LANE_PWM, lArea.width(),
+                       lArea.height() * LANE_LATENCY - MARGIN);
+   QRectF lErrorLane(lArea.left(), lLatencyLane.bottom() + MARGIN, lArea.width(),
+                     lArea.bottom() - lLatencyLane.bottom() - MARGIN);
+
+   QPainter lPainter(this);
+   lPainter.fillRect(this->rect(), this->palette().base());
+   lPainter.setPen(this->palette().mid().color());
+   lPainter.drawRect(lPwmLane);
+   lPainter.drawRect(lLatencyLane);
+   lPainter.drawRect(lErrorLane);
+
+   lPainter.setPen(this->palette().text().color());
+   lPainter.drawText(QRectF(0, lPwmLane.top(), AXIS_WIDTH - MARGIN, 16), Qt::AlignRight, QString::number(lPwmMax));
+   lPainter.drawText(QRectF(0, lPwmLane.bottom() - 16, AXIS_WIDTH - MARGIN, 16), Qt::AlignRight, QString::number(lPwmMin));
+   lPainter.drawText(QRectF(0, lLatencyLane.top(), AXIS_WIDTH - MARGIN, 16), Qt::AlignRight,
+                     QString("%1us").arg(lLatencyMax, 0, 'f', 0));
+   lPainter.drawText(QRectF(0, lErrorLane.top(), AXIS_WIDTH - MARGIN, lErrorLane.height()),
+                     Qt::AlignRight | Qt::AlignVCenter, "err");
+   lPainter.drawText(lPwmLane.adjusted(MARGIN, 0, -MARGIN, 0), Qt::AlignLeft | Qt::AlignTop,
+                     QString("-%1 s").arg(lWindowS, 0, 'f', 1));
+
+   double lColumnWidth = lArea.width() / TELEMETRY_COLUMNS;
+   double lPwmScale = lPwmLane.height() / std::max(lPwmMax - lPwmMin, 1);
+   double lLatencyScale = lLatencyLane.height() / lLatencyMax;
+
+
+   // channels: min / max bar and last value line per column
+   for(int lChannel = 0; lChannel < TELEMETRY_CHANNELS; lChannel++)
+   {
+      if(!lVisible[lChannel])
+         continue;
+
+      QColor lColor = QColor::fromHsv(lChannel * 360 / TELEMETRY_CHANNELS, 200, 200);
+      lPainter.setPen(lColor);
+      mLine.resize(0);
+
+      for(int i = 0; i < TELEMETRY_COLUMNS; i++)
+      {
+         int64_t lIndex = lFirst + i;
+         const Column& lColumn = mPaintBuffer[lChannel][((lIndex % TELEMETRY_COLUMNS) + TELEMETRY_COLUMNS) % TELEMETRY_COLUMNS];
+
+         if(lIndex < 0 || lColumn.mIndex != lIndex)
+         {
+            // gap without samples ends the line
+            lPainter.drawPolyline(mLine);
+            mLine.resize(0);
+            continue;
+         }
+
+         double lX = lArea.left() + (i + 0.5) * lColumnWidth;
+
+         if(lColumn.mMin != lColumn.mMax)
+         {
+            lPainter.drawLine(QPointF(lX, lPwmLane.bottom() - (lColumn.mMin - lPwmMin) * lPwmScale),
+                              QPointF(lX, lPwmLane.bottom() - (lColumn.mMax - lPwmMin) * lPwmScale));
+         }
+         mLine.append(QPointF(lX, lPwmLane.bottom() - (lColumn.mLast - lPwmMin) * lPwmScale));
+
+         lPainter.drawLine(QPointF(lX, lLatencyLane.bottom()),
+                           QPointF(lX, lLatencyLane.bottom() - lColumn.mMaxLatencyUs * lLatencyScale));
+
+         if(lColumn.mErrors > 0)
+         {
+            lPainter.fillRect(QRectF(lX - lColumnWidth / 2, lErrorLane.top(), std::max(lColumnWidth, 1.0),
+                                     lErrorLane.height()), Qt::red);
+         }
+      }
+
+      lPainter.drawPolyline(mLine);
+   }
+}
+
+
+void TelemetryPlot::refresh()
+{
+   bool lChanged = mChanged.exchange(false);
+
+   // keep scrolling while samples are in the visible window
+   bool lVisibleHistory = false;
+   {
+      std::lock_guard<std::mutex> lLock(mMutex);
+      lVisibleHistory = (mLastColumn >= 0) && (mLastColumn > this->currentColumn() - TELEMETRY_COLUMNS);
+   }
+
+   if(lChanged || lVisibleHistory)
+   {
+      this->update();
+   }
+}
+
+
+int64_t TelemetryPlot::currentColumn() const
+{
+   return (Clock::now() - mStart) / mColumnDuration;
+}
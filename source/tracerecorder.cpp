@@ -0,0 +1,395 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file tracerecorder.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of the classes TraceRecorder and TraceReader
+ *        at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <exception>
+#include <new>
+#include <stdexcept>
+
+// Car4Tegra includes
+#include "include/tracerecorder.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const char TRACE_MAGIC[8] = { 'C', '4', 'T', 'T', 'R', 'A', 'C', 'E' };  ///< File magic
+      const uint32_t TRACE_VERSION = 1;                  ///< File format version
+      const size_t SLOT_SIZE = 32;                       ///< Size of one slot (bytes)
+      const size_t FIRST_PAYLOAD = sizeof(TraceRecord::mPayload);  ///< Payload bytes in the record slot
+
+      static_assert(sizeof(TraceRecord) == SLOT_SIZE, "TraceRecord has to fill exactly one slot");
+      static_assert(sizeof(TraceRecorder::Header) == 64, "Trace file header has to be 64 bytes");
+      static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Trace file counters have to be lock-free");
+
+
+      /**
+       * @brief Returns the number of slots of a transaction
+       *
+       * @param[in]  aLength        Payload length
+       *
+       * @return Number of slots
+       */
+      inline uint64_t slotCount(size_t aLength)
+      {
+         return 1 + ((aLength > FIRST_PAYLOAD) ? (aLength - FIRST_PAYLOAD + SLOT_SIZE - 1) / SLOT_SIZE : 0);
+      }
+
+
+      /**
+       * @brief Returns the current time of a clock
+       *
+       * @param[in]  aClock         Clock id
+       *
+       * @return Time (ns)
+       */
+      inline uint64_t now(clockid_t aClock)
+      {
+         struct timespec lTime;
+         clock_gettime(aClock, &lTime);
+         return static_cast<uint64_t>(lTime.tv_sec) * 1000000000ull + static_cast<uint64_t>(lTime.tv_nsec);
+      }
+   } // namespace
+
+
+   TraceRecorder::TraceRecorder()
+      : mFile(-1), mpMap(nullptr), mMapSize(0), mpHeader(nullptr), mpSlots(nullptr)
+   {
+      // nothing to do
+   }
+
+
+   TraceRecorder::~TraceRecorder()
+   {
+      this->close();
+   }
+
+
+   void TraceRecorder::open(const std::string& acrFileName, size_t aCapacity)
+   {
+      this->close();
+
+      // check capacity
+      if(aCapacity < sizeof(Header) + SLOT_SIZE)
+      {
+         throw std::range_error("Invalid trace capacity \"" + std::to_string(aCapacity) + "\"");
+      }
+
+      // try to create and preallocate file
+      uint64_t lSlots = (aCapacity - sizeof(Header)) / SLOT_SIZE;
+      mMapSize = sizeof(Header) + lSlots * SLOT_SIZE;
+
+      if((mFile = ::open(acrFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0 ||
+         ftruncate(mFile, static_cast<off_t>(mMapSize)) < 0)
+      {
+         int lErrno = errno;
+         this->close();
+         throw std::runtime_error("Failed to create trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      // map file, prefault pages so recording never waits for a page fault
+      mpMap = mmap(nullptr, mMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFile, 0);
+      if(mpMap == MAP_FAILED)
+      {
+         int lErrno = errno;
+         mpMap = nullptr;
+         this->close();
+         throw std::runtime_error("Failed to map trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mpHeader = new (mpMap) Header();
+      memcpy(mpHeader->mMagic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+      mpHeader->mVersion = TRACE_VERSION;
+      mpHeader->mSlotSize = SLOT_SIZE;
+      mpHeader->mCapacity = lSlots;
+      mpHeader->mNext.store(0);
+      mpHeader->mDropped.store(0);
+      mpHeader->mStartMonotonicNs = now(CLOCK_MONOTONIC);
+      mpHeader->mStartRealtimeNs = now(CLOCK_REALTIME);
+      mpHeader->mReserved = 0;
+
+      mpSlots = static_cast<uint8_t*>(mpMap) + sizeof(Header);
+   }
+
+
+   void TraceRecorder::close()
+   {
+      size_t lUsed = 0;
+
+      if(mpMap != nullptr)
+      {
+         lUsed = sizeof(Header) + this->slots() * SLOT_SIZE;
+         munmap(mpMap, mMapSize);
+      }
+
+      if(mFile >= 0)
+      {
+         // cut unused capacity
+         if(lUsed > 0 && ftruncate(mFile, static_cast<off_t>(lUsed)) < 0)
+         {
+            // keep the preallocated size, the reader ignores empty slots
+         }
+         ::close(mFile);
+      }
+
+      mFile = -1;
+      mpMap = nullptr;
+      mMapSize = 0;
+      mpHeader = nullptr;
+      mpSlots = nullptr;
+   }
+
+
+   bool TraceRecorder::isOpen() const
+   {
+      return mpHeader != nullptr;
+   }
+
+
+   void TraceRecorder::record(int aBus, int aAddress, int aRegister, int aOperation,
+                              const uint8_t* apData, size_t aLength, int aResult, int aErrno)
+   {
+      if(mpHeader == nullptr)
+         return;
+
+      // reserve slots
+      uint64_t lCount = slotCount(aLength);
+      uint64_t lFirst = mpHeader->mNext.fetch_add(lCount, std::memory_order_relaxed);
+      if(lFirst + lCount > mpHeader->mCapacity)
+      {
+         mpHeader->mDropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      uint8_t* lpSlot = mpSlots + lFirst * SLOT_SIZE;
+      size_t lFirstPayload = (aLength < FIRST_PAYLOAD) ? aLength : FIRST_PAYLOAD;
+
+      // continuation slots first, a record slot is only complete with its payload
+      if(aLength > FIRST_PAYLOAD)
+      {
+         memcpy(lpSlot + SLOT_SIZE, apData + FIRST_PAYLOAD, aLength - FIRST_PAYLOAD);
+      }
+
+      TraceRecord* lpRecord = reinterpret_cast<TraceRecord*>(lpSlot);
+      lpRecord->mTimestampNs = now(CLOCK_MONOTONIC);
+      lpRecord->mSequence = static_cast<uint32_t>(lFirst);
+      lpRecord->mBus = static_cast<uint8_t>(aBus);
+      lpRecord->mAddress = static_cast<uint8_t>(aAddress);
+      lpRecord->mRegister = static_cast<uint8_t>(aRegister);
+      lpRecord->mResult = static_cast<int16_t>(aResult);
+      lpRecord->mErrno = static_cast<int16_t>(aErrno);
+      lpRecord->mLength = static_cast<uint16_t>(aLength);
+      if(lFirstPayload > 0)
+      {
+         memcpy(lpRecord->mPayload, apData, lFirstPayload);
+      }
+
+      // operation last, marks the record as valid
+      __atomic_store_n(&lpRecord->mOperation, static_cast<uint8_t>(aOperation), __ATOMIC_RELEASE);
+   }
+
+
+   uint64_t TraceRecorder::slots() const
+   {
+      if(mpHeader == nullptr)
+         return 0;
+
+      uint64_t lNext = mpHeader->mNext.load();
+      return (lNext < mpHeader->mCapacity) ? lNext : mpHeader->mCapacity;
+   }
+
+
+   uint64_t TraceRecorder::dropped() const
+   {
+      return (mpHeader != nullptr) ? mpHeader->mDropped.load() : 0;
+   }
+
+
+   TraceReader::TraceReader()
+      : mFile(-1), mpMap(nullptr), mMapSize(0), mpHeader(nullptr), mpSlots(nullptr), mSlots(0), mPosition(0)
+   {
+      // nothing to do
+   }
+
+
+   TraceReader::~TraceReader()
+   {
+      this->close();
+   }
+
+
+   void TraceReader::open(const std::string& acrFileName)
+   {
+      this->close();
+
+      // try to open and map file
+      struct stat lStat;
+      if((mFile = ::open(acrFileName.c_str(), O_RDONLY)) < 0 || fstat(mFile, &lStat) < 0)
+      {
+         int lErrno = errno;
+         this->close();
+         throw std::runtime_error("Failed to open trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      mMapSize = static_cast<size_t>(lStat.st_size);
+      if(mMapSize < sizeof(TraceRecorder::Header))
+      {
+         this->close();
+         throw std::runtime_error("Invalid trace file \"" + acrFileName + "\" (file too short)");
+      }
+
+      mpMap = mmap(nullptr, mMapSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+      if(mpMap == MAP_FAILED)
+      {
+         int lErrno = errno;
+         mpMap = nullptr;
+         this->close();
+         throw std::runtime_error("Failed to map trace file \"" + acrFileName +
+                                  "\" (Error " + std::to_string(lErrno) +
+                                  ": " + strerror(lErrno) + ")");
+      }
+
+      // sequential access only
+      madvise(mpMap, mMapSize, MADV_SEQUENTIAL);
+
+      // check header
+      mpHeader = static_cast<const TraceRecorder::Header*>(mpMap);
+      if(memcmp(mpHeader->mMagic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+         mpHeader->mVersion != TRACE_VERSION || mpHeader->mSlotSize != SLOT_SIZE)
+      {
+         this->close();
+         throw std::runtime_error("Invalid trace file \"" + acrFileName + "\" (wrong format or version)");
+      }
+
+      mpSlots = static_cast<const uint8_t*>(mpMap) + sizeof(TraceRecorder::Header);
+      mSlots = (mMapSize - sizeof(TraceRecorder::Header)) / SLOT_SIZE;
+      if(mpHeader->mNext.load() < mSlots)
+      {
+         mSlots = mpHeader->mNext.load();
+      }
+      mPosition = 0;
+   }
+
+
+   void TraceReader::close()
+   {
+      if(mpMap != nullptr)
+      {
+         munmap(mpMap, mMapSize);
+      }
+
+      if(mFile >= 0)
+      {
+         ::close(mFile);
+      }
+
+      mFile = -1;
+      mpMap = nullptr;
+      mMapSize = 0;
+      mpHeader = nullptr;
+      mpSlots = nullptr;
+      mSlots = 0;
+      mPosition = 0;
+   }
+
+
+   bool TraceReader::next(TraceRecord& arRecord, uint8_t* apPayload)
+   {
+      while(mPosition < mSlots)
+      {
+         memcpy(&arRecord, mpSlots + mPosition * SLOT_SIZE, sizeof(TraceRecord));
+         uint64_t lCount = slotCount(arRecord.mLength);
+
+         // a record slot carries its own slot index, anything else (reserved but never written
+         // slot, payload continuation) is not a record start: step one slot
+         if(arRecord.mSequence != static_cast<uint32_t>(mPosition))
+         {
+            mPosition++;
+            continue;
+         }
+
+         // incomplete record (recorder stopped while writing): skip it with its payload slots
+         if(arRecord.mOperation < TraceRecorder::OP_READ_BYTE || arRecord.mOperation > TraceRecorder::OP_WRITE_BLOCK ||
+            mPosition + lCount > mSlots)
+         {
+            mPosition += (mPosition + lCount > mSlots) ? 1 : lCount;
+            continue;
+         }
+
+         size_t lFirstPayload = (arRecord.mLength < FIRST_PAYLOAD) ? arRecord.mLength : FIRST_PAYLOAD;
+         memcpy(apPayload, arRecord.mPayload, lFirstPayload);
+         if(arRecord.mLength > FIRST_PAYLOAD)
+         {
+            memcpy(apPayload + FIRST_PAYLOAD, mpSlots + (mPosition + 1) * SLOT_SIZE, arRecord.mLength - FIRST_PAYLOAD);
+         }
+
+         mPosition += lCount;
+         return true;
+      }
+
+      return false;
+   }
+
+
+   void TraceReader::rewind()
+   {
+      mPosition = 0;
+   }
+
+
+   uint64_t TraceReader::startTime() const
+   {
+      return (mpHeader != nullptr) ? mpHeader->mStartMonotonicNs : 0;
+   }
+
+
+   uint64_t TraceReader::dropped() const
+   {
+      return (mpHeader != nullptr) ? mpHeader->mDropped.load() : 0;
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,496 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file waveformengine.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class WaveformEngine at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/waveformengine.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const int64_t NEVER = std::numeric_limits<int64_t>::max();    ///< Tick of an event which did not happen
+
+
+      /**
+       * @brief Decodes the LEDn registers of an output into its toggle points
+       *
+       * The output takes the inverted base level at the first toggle and the base level at the
+       * second one. Constant levels (FULL_ON, FULL_OFF) have both toggles at WAVEFORM_CYCLE_TICKS.
+       *
+       * @param[in]  apLed          LEDn_ON_L, LEDn_ON_H, LEDn_OFF_L, LEDn_OFF_H
+       * @param[out] arBase         Level before the first toggle (`-1`: high)
+       * @param[out] arFirst        First toggle
+       * @param[out] arSecond       Second toggle
+       * @param[out] arWidth        Pulse width (ticks, WAVEFORM_CYCLE_TICKS: always high)
+       */
+      void decode(const uint8_t* apLed, int32_t& arBase, int32_t& arFirst, int32_t& arSecond, int32_t& arWidth)
+      {
+         int32_t lOn = apLed[0] | ((apLed[1] & 0x0F) << 8);
+         int32_t lOff = apLed[2] | ((apLed[3] & 0x0F) << 8);
+
+         arFirst = WAVEFORM_CYCLE_TICKS;
+         arSecond = WAVEFORM_CYCLE_TICKS;
+
+         // FULL_OFF wins over FULL_ON, equal ON and OFF values keep the output low
+         if((apLed[3] & PCA9685_LED_FULL) || (!(apLed[1] & PCA9685_LED_FULL) && lOn == lOff))
+         {
+            arBase = 0;
+            arWidth = 0;
+         }
+         else if(apLed[1] & PCA9685_LED_FULL)
+         {
+            arBase = -1;
+            arWidth = WAVEFORM_CYCLE_TICKS;
+         }
+         else if(lOn < lOff)
+         {
+            arBase = 0;
+            arFirst = lOn;
+            arSecond = lOff;
+            arWidth = lOff - lOn;
+         }
+         else
+         {
+            // pulse wraps around the cycle end
+            arBase = -1;
+            arFirst = lOff;
+            arSecond = lOn;
+            arWidth = WAVEFORM_CYCLE_TICKS - lOn + lOff;
+         }
+      }
+   } // namespace
+
+
+   WaveformEngine::WaveformEngine(int aPrescale, LatchMode aLatch, uint64_t aStartNs)
+      : mTickNs(0), mLatch(aLatch), mStartNs(0), mTransientTicks(0)
+   {
+      if(aPrescale < 3 || aPrescale > 255)
+      {
+         throw std::range_error("Invalid prescale \"" + std::to_string(aPrescale) + "\" (has to be between 3 and 255)");
+      }
+
+      mTickNs = static_cast<uint64_t>(aPrescale + 1) * (1000000000 / WAVEFORM_OSCILLATOR_HZ);
+      this->setTransientWindow(500.0);
+      this->reset(aStartNs);
+   }
+
+
+   WaveformEngine::~WaveformEngine()
+   {
+   }
+
+
+   void WaveformEngine::reset(uint64_t aStartNs)
+   {
+      mStartNs = aStartNs;
+
+      // power-on values: all outputs full off
+      mRegisters.fill(0x00);
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         mRegisters[PCA9685_REG_LED0_OFF_H + 4 * lChannel] = PCA9685_LED_FULL;
+      }
+
+      Output lOutput = {};
+      lOutput.mActiveReplaced = NEVER;
+      lOutput.mActiveServed = true;
+      lOutput.mLastRise = -1;
+      lOutput.mWidthMin = NEVER;
+      lOutput.mPeriodMin = NEVER;
+      mOutputs.fill(lOutput);
+
+      mBase = ChannelLanes{};
+      mFirst = ChannelLanes{} + WAVEFORM_CYCLE_TICKS;
+      mSecond = ChannelLanes{} + WAVEFORM_CYCLE_TICKS;
+      mLevel = ChannelLanes{};
+      mNextBase = mBase;
+      mNextFirst = mFirst;
+      mNextSecond = mSecond;
+
+      mNextSerial = 1;
+      mPending = 0;
+      mTick = 0;
+      mCycles = 0;
+      mCycleChanged = false;
+      mSteadyCycles = 0;
+   }
+
+
+   void WaveformEngine::setTransientWindow(double aWindowUs)
+   {
+      mTransientTicks = static_cast<int64_t>(std::max(aWindowUs, 0.0) * 1000.0 / mTickNs);
+   }
+
+
+   void WaveformEngine::setEdgeCallback(EdgeCallback aCallback)
+   {
+      mEdgeCallback = aCallback;
+   }
+
+
+   void WaveformEngine::write(uint64_t aTimeNs, int aRegister, const uint8_t* apData, size_t aLength)
+   {
+      this->advance(aTimeNs);
+
+      // registers with auto-increment, both windows roll over to MODE1
+      uint16_t lTouched = 0;
+      int lRegister = aRegister & 0xFF;
+      for(size_t i = 0; i < aLength; i++)
+      {
+         if(lRegister >= PCA9685_REG_ALL_LED_ON_L && lRegister <= PCA9685_REG_ALL_LED_OFF_H)
+         {
+            for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            {
+               mRegisters[PCA9685_REG_LED0_ON_L + 4 * lChannel + lRegister - PCA9685_REG_ALL_LED_ON_L] = apData[i];
+            }
+            lTouched = 0xFFFF;
+         }
+         else
+         {
+            mRegisters[lRegister] = apData[i];
+            if(lRegister >= PCA9685_REG_LED0_ON_L && lRegister <= PCA9685_BLOCK_LOW_LAST)
+               lTouched |= static_cast<uint16_t>(1 << ((lRegister - PCA9685_REG_LED0_ON_L) / 4));
+         }
+
+         lRegister = (lRegister == PCA9685_BLOCK_LOW_LAST || lRegister == PCA9685_BLOCK_HIGH_LAST) ? PCA9685_BLOCK_LOW_FIRST
+                                                                                                  : (lRegister + 1) & 0xFF;
+      }
+
+      // new register settings become visible at the STOP condition
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!(lTouched & (1 << lChannel)))
+            continue;
+
+         int32_t lBase, lFirst, lSecond, lWidth;
+         decode(&mRegisters[PCA9685_REG_LED0_ON_L + 4 * lChannel], lBase, lFirst, lSecond, lWidth);
+         if(lBase == mNextBase[lChannel] && lFirst == mNextFirst[lChannel] && lSecond == mNextSecond[lChannel])
+            continue;
+
+         Output& lrOutput = mOutputs[lChannel];
+         if(lrOutput.mActiveSerial == lrOutput.mSerial)
+            lrOutput.mActiveReplaced = mTick;
+
+         lrOutput.mSerial = mNextSerial++;
+         lrOutput.mWidth = lWidth;
+         lrOutput.mCreated = mTick;
+         lrOutput.mUpdates++;
+         mNextBase[lChannel] = lBase;
+         mNextFirst[lChannel] = lFirst;
+         mNextSecond[lChannel] = lSecond;
+         mPending |= static_cast<uint16_t>(1 << lChannel);
+      }
+
+      if(mLatch == LATCH_IMMEDIATE)
+      {
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            if(mPending & (1 << lChannel))
+               this->latch(lChannel);
+         }
+      }
+   }
+
+
+   void WaveformEngine::advance(uint64_t aTimeNs)
+   {
+      // the counters compare from the first complete tick after the given time
+      int64_t lTick = (aTimeNs <= mStartNs) ? 0 : static_cast<int64_t>((aTimeNs - mStartNs + mTickNs - 1) / mTickNs);
+      this->synthesize(lTick);
+   }
+
+
+   uint64_t WaveformEngine::tickNs() const
+   {
+      return mTickNs;
+   }
+
+
+   uint64_t WaveformEngine::cycles() const
+   {
+      return mCycles;
+   }
+
+
+   uint16_t WaveformEngine::levels() const
+   {
+      uint16_t lLevels = 0;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(mLevel[lChannel])
+            lLevels |= static_cast<uint16_t>(1 << lChannel);
+      }
+      return lLevels;
+   }
+
+
+   WaveformEngine::ChannelAnalysis WaveformEngine::analysis(int aChannel) const
+   {
+      if(aChannel < 0 || aChannel >= PCA9685_CHANNEL_COUNT)
+      {
+         throw std::range_error("Invalid channel \"" + std::to_string(aChannel) + "\" (has to be between 0 and 15)");
+      }
+
+      const Output& lcrOutput = mOutputs[aChannel];
+      double lTickUs = mTickNs / 1000.0;
+
+      ChannelAnalysis lAnalysis = {};
+      lAnalysis.mPulses = lcrOutput.mPulses;
+      lAnalysis.mUpdates = lcrOutput.mUpdates;
+      lAnalysis.mRunts = lcrOutput.mRunts;
+      lAnalysis.mGlitches = lcrOutput.mGlitches;
+      lAnalysis.mDoublePulses = lcrOutput.mDoublePulses;
+
+      if(lcrOutput.mPeriods > 0)
+      {
+         lAnalysis.mPeriodMinUs = lcrOutput.mPeriodMin * lTickUs;
+         lAnalysis.mPeriodMaxUs = lcrOutput.mPeriodMax * lTickUs;
+         lAnalysis.mPeriodMeanUs = static_cast<double>(lcrOutput.mPeriodTicks) / lcrOutput.mPeriods * lTickUs;
+      }
+      if(lcrOutput.mPulses > 0 && lcrOutput.mWidthMin != NEVER)
+      {
+         lAnalysis.mDutyMin = static_cast<double>(lcrOutput.mWidthMin) / WAVEFORM_CYCLE_TICKS;
+         lAnalysis.mDutyMax = static_cast<double>(lcrOutput.mWidthMax) / WAVEFORM_CYCLE_TICKS;
+         lAnalysis.mDutyMean = static_cast<double>(lcrOutput.mHighTicks) / lcrOutput.mPulses / WAVEFORM_CYCLE_TICKS;
+      }
+      if(lcrOutput.mLatencies > 0)
+      {
+         lAnalysis.mLatencyMeanUs = static_cast<double>(lcrOutput.mLatencyTicks) / lcrOutput.mLatencies * lTickUs;
+         lAnalysis.mLatencyMaxUs = lcrOutput.mLatencyMax * lTickUs;
+      }
+
+      return lAnalysis;
+   }
+
+
+   void WaveformEngine::synthesize(int64_t aTick)
+   {
+      while(mTick < aTick)
+      {
+         int64_t lCycleStart = mTick - mTick % WAVEFORM_CYCLE_TICKS;
+         int32_t lFrom = static_cast<int32_t>(mTick - lCycleStart);
+
+         if(lFrom == 0)
+         {
+            if(mLatch == LATCH_CYCLE && mPending != 0)
+            {
+               for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+               {
+                  if(mPending & (1 << lChannel))
+                     this->latch(lChannel);
+               }
+            }
+
+            // after two unchanged cycles every further cycle repeats the last one
+            int64_t lRepeat = (aTick - mTick) / WAVEFORM_CYCLE_TICKS;
+            if(!mEdgeCallback && mSteadyCycles >= 2 && !mCycleChanged && lRepeat > 0)
+            {
+               this->repeatCycles(lRepeat);
+               mTick += lRepeat * WAVEFORM_CYCLE_TICKS;
+               continue;
+            }
+
+            this->beginCycle();
+         }
+
+         int64_t lEnd = std::min(aTick, lCycleStart + WAVEFORM_CYCLE_TICKS);
+         this->evaluate(lCycleStart, lFrom, static_cast<int32_t>(lEnd - lCycleStart));
+         mTick = lEnd;
+
+         if(mTick == lCycleStart + WAVEFORM_CYCLE_TICKS)
+            this->endCycle();
+      }
+   }
+
+
+   void WaveformEngine::evaluate(int64_t aCycleStart, int32_t aFrom, int32_t aTo)
+   {
+      // the outputs toggle at the counter matches, FULL_ON and FULL_OFF force the level
+      ChannelLanes lFrom = ChannelLanes{} + aFrom;
+      ChannelLanes lTo = ChannelLanes{} + aTo;
+      ChannelLanes lToggles = mFirst != mSecond;
+      ChannelLanes lFirstHit = (mFirst >= lFrom) & (mFirst < lTo) & lToggles;
+      ChannelLanes lSecondHit = (mSecond >= lFrom) & (mSecond < lTo) & lToggles;
+
+      ChannelLanes lStartLevel = (lToggles & mLevel) | (~lToggles & mBase);
+      ChannelLanes lFirstLevel = (lFirstHit & ~mBase) | (~lFirstHit & lStartLevel);
+      ChannelLanes lSecondLevel = (lSecondHit & mBase) | (~lSecondHit & lFirstLevel);
+
+      ChannelLanes lStartEdge = lStartLevel != mLevel;
+      ChannelLanes lFirstEdge = lFirstLevel != lStartLevel;
+      ChannelLanes lSecondEdge = lSecondLevel != lFirstLevel;
+      ChannelLanes lAny = lStartEdge | lFirstEdge | lSecondEdge;
+      mLevel = lSecondLevel;
+
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!lAny[lChannel])
+            continue;
+
+         if(lStartEdge[lChannel])
+            this->edge(lChannel, aCycleStart + aFrom, lStartLevel[lChannel] != 0);
+         if(lFirstEdge[lChannel])
+            this->edge(lChannel, aCycleStart + mFirst[lChannel], lFirstLevel[lChannel] != 0);
+         if(lSecondEdge[lChannel])
+            this->edge(lChannel, aCycleStart + mSecond[lChannel], lSecondLevel[lChannel] != 0);
+      }
+   }
+
+
+   void WaveformEngine::repeatCycles(int64_t aCycles)
+   {
+      uint64_t lCycles = static_cast<uint64_t>(aCycles);
+      for(Output& lrOutput : mOutputs)
+      {
+         lrOutput.mPulses += lCycles * lrOutput.mStepPulses;
+         lrOutput.mHighTicks += lCycles * lrOutput.mStepHighTicks;
+         lrOutput.mPeriods += lCycles * lrOutput.mStepPeriods;
+         lrOutput.mPeriodTicks += lCycles * lrOutput.mStepPeriods * WAVEFORM_CYCLE_TICKS;
+         if(lrOutput.mLastRise >= 0)
+            lrOutput.mLastRise += aCycles * WAVEFORM_CYCLE_TICKS;
+      }
+
+      mCycles += lCycles;
+      mSteadyCycles += lCycles;
+   }
+
+
+   void WaveformEngine::latch(int aChannel)
+   {
+      mBase[aChannel] = mNextBase[aChannel];
+      mFirst[aChannel] = mNextFirst[aChannel];
+      mSecond[aChannel] = mNextSecond[aChannel];
+
+      Output& lrOutput = mOutputs[aChannel];
+      lrOutput.mActiveSerial = lrOutput.mSerial;
+      lrOutput.mActiveWidth = lrOutput.mWidth;
+      lrOutput.mActiveCreated = lrOutput.mCreated;
+      lrOutput.mActiveReplaced = NEVER;
+      lrOutput.mActiveServed = false;
+
+      mPending &= static_cast<uint16_t>(~(1 << aChannel));
+      mCycleChanged = true;
+   }
+
+
+   void WaveformEngine::edge(int aChannel, int64_t aTick, bool aRising)
+   {
+      Output& lrOutput = mOutputs[aChannel];
+
+      if(mEdgeCallback)
+         mEdgeCallback(aChannel, aTick, aRising);
+
+      if(!lrOutput.mActiveServed)
+      {
+         int64_t lLatency = aTick - lrOutput.mActiveCreated;
+         lrOutput.mLatencies++;
+         lrOutput.mLatencyTicks += lLatency;
+         lrOutput.mLatencyMax = std::max(lrOutput.mLatencyMax, lLatency);
+         lrOutput.mActiveServed = true;
+      }
+
+      if(aRising)
+      {
+         if(lrOutput.mLastRise >= 0)
+         {
+            int64_t lPeriod = aTick - lrOutput.mLastRise;
+            lrOutput.mPeriods++;
+            lrOutput.mPeriodTicks += lPeriod;
+            lrOutput.mPeriodMin = std::min(lrOutput.mPeriodMin, lPeriod);
+            lrOutput.mPeriodMax = std::max(lrOutput.mPeriodMax, lPeriod);
+            if(aTick / WAVEFORM_CYCLE_TICKS == lrOutput.mLastRise / WAVEFORM_CYCLE_TICKS)
+               lrOutput.mDoublePulses++;
+         }
+
+         lrOutput.mOpen = true;
+         lrOutput.mLastRise = aTick;
+         lrOutput.mRiseSerial = lrOutput.mActiveSerial;
+         lrOutput.mRiseWidth = lrOutput.mActiveWidth;
+      }
+      else if(lrOutput.mOpen)
+      {
+         int64_t lWidth = aTick - lrOutput.mLastRise;
+         lrOutput.mOpen = false;
+         lrOutput.mPulses++;
+         lrOutput.mHighTicks += lWidth;
+
+         // pulses of FULL_ON settings last several cycles and are not classified
+         if(lrOutput.mRiseWidth == WAVEFORM_CYCLE_TICKS || lrOutput.mActiveWidth == WAVEFORM_CYCLE_TICKS)
+            return;
+
+         lrOutput.mWidthMin = std::min(lrOutput.mWidthMin, lWidth);
+         lrOutput.mWidthMax = std::max(lrOutput.mWidthMax, lWidth);
+
+         bool lMatch = (lWidth == lrOutput.mRiseWidth || lWidth == lrOutput.mActiveWidth);
+         bool lTransient = (lrOutput.mRiseSerial == lrOutput.mActiveSerial && lrOutput.mActiveReplaced != NEVER &&
+                            lrOutput.mActiveReplaced - lrOutput.mActiveCreated < mTransientTicks);
+         if(!lMatch && lWidth < std::min(lrOutput.mRiseWidth, lrOutput.mActiveWidth))
+            lrOutput.mRunts++;
+         else if(!lMatch || lTransient)
+            lrOutput.mGlitches++;
+      }
+   }
+
+
+   void WaveformEngine::beginCycle()
+   {
+      for(Output& lrOutput : mOutputs)
+      {
+         lrOutput.mCyclePulses = lrOutput.mPulses;
+         lrOutput.mCycleHighTicks = lrOutput.mHighTicks;
+         lrOutput.mCyclePeriods = lrOutput.mPeriods;
+      }
+   }
+
+
+   void WaveformEngine::endCycle()
+   {
+      for(Output& lrOutput : mOutputs)
+      {
+         lrOutput.mStepPulses = lrOutput.mPulses - lrOutput.mCyclePulses;
+         lrOutput.mStepHighTicks = lrOutput.mHighTicks - lrOutput.mCycleHighTicks;
+         lrOutput.mStepPeriods = lrOutput.mPeriods - lrOutput.mCyclePeriods;
+      }
+
+      mCycles++;
+      mSteadyCycles = mCycleChanged ? 0 : mSteadyCycles + 1;
+      mCycleChanged = false;
+   }
+} // namespace CAR4TEGRA
@@ -0,0 +1,293 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file writeplanner.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the definition of class WritePlanner at namespace CAR4TEGRA
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+// Car4Tegra includes
+#include "include/writeplanner.hpp"
+
+
+namespace CAR4TEGRA
+{
+   namespace
+   {
+      const double BITS_PER_BYTE = 9.0;            ///< 8 data bits and ACK
+      const double BITS_START_STOP = 2.0;          ///< START and STOP condition
+      const size_t HEADER_BYTES = 2;               ///< Slave address and register byte
+      const int LED_REGISTERS = 4 * PCA9685_CHANNEL_COUNT;   ///< Number of LEDn registers
+
+
+      /**
+       * @brief LEDn registers of a planning problem
+       */
+      struct LedState
+      {
+         uint8_t mTarget[LED_REGISTERS];   ///< Target values
+         uint8_t mDevice[LED_REGISTERS];   ///< Last known device values
+         bool mWritable[LED_REGISTERS];    ///< Register has a target value
+         bool mKnown[LED_REGISTERS];       ///< Device value is known
+      };
+
+
+      /**
+       * @brief Returns the common target value of one byte of all LEDn registers
+       *
+       * @param[in]  apTarget       Target values of the LEDn registers
+       * @param[in]  aByte          Byte of the LEDn registers (0 - 3)
+       * @param[out] arValue        Common value
+       *
+       * @return `true` if all channels have the same target value
+       */
+      bool commonValue(const uint8_t* apTarget, int aByte, uint8_t& arValue)
+      {
+         arValue = apTarget[aByte];
+
+         for(int i = 1; i < PCA9685_CHANNEL_COUNT; i++)
+         {
+            if(apTarget[4 * i + aByte] != arValue)
+               return false;
+         }
+
+         return true;
+      }
+
+
+      /**
+       * @brief Finds the write runs of the LEDn registers, optionally after an ALL_LED write
+       *
+       * @param[in]  acrState       LEDn registers
+       * @param[in]  apAllLed       ALL_LED byte values (`nullptr`: no ALL_LED write)
+       * @param[in]  aFirstByte     First ALL_LED byte written (0 - 3)
+       * @param[in]  aLastByte      Last ALL_LED byte written (0 - 3)
+       * @param[in]  aMaxGap        Longest run of unchanged registers bridged (`-1`: no block writes)
+       * @param[in]  aEmit          Called with first register and length of every run
+       */
+      template<typename Emit>
+      void scanRuns(const LedState& acrState, const uint8_t* apAllLed, int aFirstByte, int aLastByte,
+                    int aMaxGap, Emit aEmit)
+      {
+         int lRunStart = -1;
+         int lRunEnd = -1;
+
+         for(int i = 0; i < LED_REGISTERS; i++)
+         {
+            // registers without target must not be touched
+            if(!acrState.mWritable[i])
+            {
+               if(lRunStart >= 0)
+                  aEmit(PCA9685_REG_LED0_ON_L + lRunStart, lRunEnd - lRunStart + 1);
+               lRunStart = -1;
+               continue;
+            }
+
+            // device value after the ALL_LED write
+            int lByte = i % 4;
+            bool lLoaded = (apAllLed != nullptr) && lByte >= aFirstByte && lByte <= aLastByte;
+            if((lLoaded || acrState.mKnown[i]) && (lLoaded ? apAllLed[lByte] : acrState.mDevice[i]) == acrState.mTarget[i])
+               continue;
+
+            // dirty register: extend the run or start a new one
+            if(lRunStart >= 0 && i - lRunEnd - 1 <= aMaxGap)
+            {
+               lRunEnd = i;
+            }
+            else
+            {
+               if(lRunStart >= 0)
+                  aEmit(PCA9685_REG_LED0_ON_L + lRunStart, lRunEnd - lRunStart + 1);
+               lRunStart = i;
+               lRunEnd = i;
+            }
+         }
+
+         if(lRunStart >= 0)
+            aEmit(PCA9685_REG_LED0_ON_L + lRunStart, lRunEnd - lRunStart + 1);
+      }
+   } // namespace
+
+
+   WritePlanner::WritePlanner(uint32_t aBusClock, double aOverheadUs)
+      : mBusClock(1), mOverheadUs(0.0)
+   {
+      this->setBusClock(aBusClock);
+      this->setTransactionOverhead(aOverheadUs);
+   }
+
+
+   void WritePlanner::setBusClock(uint32_t aBusClock)
+   {
+      if(aBusClock == 0)
+      {
+         throw std::range_error("Invalid bus clock \"0\"");
+      }
+
+      mBusClock = aBusClock;
+   }
+
+
+   void WritePlanner::setTransactionOverhead(double aOverheadUs)
+   {
+      if(aOverheadUs < 0.0)
+      {
+         throw std::range_error("Invalid transaction overhead \"" + std::to_string(aOverheadUs) + "\"");
+      }
+
+      mOverheadUs = aOverheadUs;
+   }
+
+
+   double WritePlanner::transactionCost(size_t aDataBytes) const
+   {
+      double lBits = (aDataBytes + HEADER_BYTES) * BITS_PER_BYTE + BITS_START_STOP;
+      return mOverheadUs + lBits * 1000000.0 / mBusClock;
+   }
+
+
+   void WritePlanner::plan(const RegisterImage& acrTarget, const RegisterMask& acrTargetMask,
+                           const RegisterImage& acrDevice, const RegisterMask& acrKnown,
+                           bool aAutoIncrement, WritePlan& arPlan, unsigned aAllLedBytes) const
+   {
+      // LEDn registers packed for the scans
+      LedState lState;
+      for(int i = 0; i < LED_REGISTERS; i++)
+      {
+         int lReg = PCA9685_REG_LED0_ON_L + i;
+         lState.mTarget[i] = acrTarget[lReg];
+         lState.mDevice[i] = acrDevice[lReg];
+         lState.mWritable[i] = acrTargetMask[lReg];
+         lState.mKnown[i] = acrKnown[lReg];
+      }
+
+      // unchanged bytes between two runs are written if that is cheaper than another header
+      double lByteCost = BITS_PER_BYTE * 1000000.0 / mBusClock;
+      double lHeaderCost = this->transactionCost(0);
+      int lMaxGap = aAutoIncrement ? static_cast<int>(lHeaderCost / lByteCost) : -1;
+
+      // LEDn registers only
+      size_t lTransactions = 0;
+      size_t lBytes = 0;
+      auto lCount = [&lTransactions, &lBytes](int aRegister, int aLength)
+      {
+         (void)aRegister;
+         lTransactions++;
+         lBytes += static_cast<size_t>(aLength);
+      };
+
+      scanRuns(lState, nullptr, 0, 0, lMaxGap, lCount);
+      double lBestCost = lTransactions * lHeaderCost + lBytes * lByteCost;
+      int lBestFirst = -1;
+      int lBestLast = -1;
+
+      // ALL_LED bytes are only usable if every channel has the same target for them
+      bool lTargeted[4];
+      uint8_t lAllLed[4];
+      for(int lByte = 0; lByte < 4; lByte++)
+      {
+         lTargeted[lByte] = (aAllLedBytes & (1u << lByte)) != 0;
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            lTargeted[lByte] = lTargeted[lByte] && lState.mWritable[4 * lChannel + lByte];
+         }
+         lTargeted[lByte] = commonValue(lState.mTarget, lByte, lAllLed[lByte]) && lTargeted[lByte];
+      }
+
+      // ALL_LED write of every contiguous byte range that leaves no LEDn register to fix up,
+      // the outputs latch on every STOP and a fixed up channel would run one PWM cycle wrong
+      for(int lFirst = 0; lFirst < 4; lFirst++)
+      {
+         for(int lLast = lFirst; lLast < 4 && lTargeted[lLast]; lLast++)
+         {
+            int lLength = lLast - lFirst + 1;
+            lTransactions = aAutoIncrement ? 1 : static_cast<size_t>(lLength);
+            lBytes = static_cast<size_t>(lLength);
+
+            // the ALL_LED write alone is already too expensive
+            if(lTransactions * lHeaderCost + lBytes * lByteCost >= lBestCost)
+               continue;
+
+            size_t lFixups = 0;
+            scanRuns(lState, lAllLed, lFirst, lLast, lMaxGap,
+                     [&lFixups](int aRegister, int aLength) { (void)aRegister; (void)aLength; lFixups++; });
+            if(lFixups > 0)
+               continue;
+
+            double lCost = lTransactions * lHeaderCost + lBytes * lByteCost;
+            if(lCost < lBestCost)
+            {
+               lBestCost = lCost;
+               lBestFirst = lFirst;
+               lBestLast = lLast;
+            }
+         }
+      }
+
+
+      // build the cheapest plan
+      arPlan.mCount = 0;
+      arPlan.mCostUs = 0.0;
+      arPlan.mAllLed = (lBestFirst >= 0);
+
+      if(arPlan.mAllLed)
+      {
+         for(int lByte = lBestFirst; lByte <= lBestLast; lByte++)
+         {
+            arPlan.mData[PCA9685_REG_ALL_LED_ON_L + lByte] = lAllLed[lByte];
+            if(!aAutoIncrement)
+               this->append(arPlan, PCA9685_REG_ALL_LED_ON_L + lByte, 1);
+         }
+
+         if(aAutoIncrement)
+            this->append(arPlan, PCA9685_REG_ALL_LED_ON_L + lBestFirst, lBestLast - lBestFirst + 1);
+      }
+
+      for(int i = 0; i < LED_REGISTERS; i++)
+      {
+         arPlan.mData[PCA9685_REG_LED0_ON_L + i] = lState.mTarget[i];
+      }
+
+      scanRuns(lState, arPlan.mAllLed ? lAllLed : nullptr, lBestFirst, lBestLast, lMaxGap,
+               [this, &arPlan](int aRegister, int aLength) { this->append(arPlan, aRegister, aLength); });
+   }
+
+
+   void WritePlanner::append(WritePlan& arPlan, int aRegister, int aLength) const
+   {
+      WritePlan::Transaction& lrTransaction = arPlan.mTransactions[arPlan.mCount++];
+      lrTransaction.mRegister = static_cast<uint8_t>(aRegister);
+      lrTransaction.mLength = static_cast<uint8_t>(aLength);
+      arPlan.mCostUs += this->transactionCost(static_cast<size_t>(aLength));
+   }
+} // namespace CAR4TEGRA
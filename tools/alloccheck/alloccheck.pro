@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Steady-state allocation check tool
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = alloccheck
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+# replace the aligned operator new too
+QMAKE_CXXFLAGS += -faligned-new
+
+include(../../lib/c4tdriver.pri)
+
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,491 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the allocation check tool
+ *
+ * @details
+ * The tool replaces `operator new` (including the aligned versions), `malloc` and the aligned
+ * C allocation functions with counting versions and runs sustained steady-state channel updates
+ * through the driver paths against simulated devices. Each path is warmed up first, then every
+ * heap allocation during the measured run is counted. Paths which can drop updates (e.g. stale
+ * setpoint packets) also have to show every counted update as taken effect. The tool exits with
+ * `1` if any path allocated or dropped updates.
+ *
+ * Usage: alloccheck [--iterations N]
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/busexecutor.hpp"
+#include "include/busscheduler.hpp"
+#include "include/c4tdriver.h"
+#include "include/outputmixer.hpp"
+#include "include/pca9685.hpp"
+#include "include/setpointlistener.hpp"
+#include "include/simulatedi2cdevice.hpp"
+#include "include/tracerecorder.hpp"
+
+
+extern "C"
+{
+   void* __libc_malloc(size_t aSize);
+   void* __libc_calloc(size_t aCount, size_t aSize);
+   void* __libc_realloc(void* apPtr, size_t aSize);
+   void* __libc_memalign(size_t aAlignment, size_t aSize);
+   void __libc_free(void* apPtr);
+}
+
+
+namespace
+{
+   std::atomic<bool> gArmed(false);             ///< Count allocations
+   std::atomic<uint64_t> gAllocations(0);       ///< Allocations while armed
+
+
+   /**
+    * @brief Counts an allocation if armed
+    */
+   inline void countAllocation()
+   {
+      if(gArmed.load(std::memory_order_relaxed))
+         gAllocations.fetch_add(1, std::memory_order_relaxed);
+   }
+
+
+   /**
+    * @brief Allocates for operator new, throws std::bad_alloc on failure
+    *
+    * @param[in]  aSize          Size (bytes)
+    *
+    * @return Allocated memory
+    */
+   void* allocate(size_t aSize)
+   {
+      countAllocation();
+
+      void* lpPtr = __libc_malloc(aSize == 0 ? 1 : aSize);
+      if(lpPtr == nullptr)
+         throw std::bad_alloc();
+
+      return lpPtr;
+   }
+
+
+   /**
+    * @brief Allocates aligned memory for operator new, throws std::bad_alloc on failure
+    *
+    * @param[in]  aSize          Size (bytes)
+    * @param[in]  aAlignment     Alignment (power of two)
+    *
+    * @return Allocated memory
+    */
+   void* allocateAligned(size_t aSize, size_t aAlignment)
+   {
+      countAllocation();
+
+      void* lpPtr = __libc_memalign(aAlignment, aSize == 0 ? 1 : aSize);
+      if(lpPtr == nullptr)
+         throw std::bad_alloc();
+
+      return lpPtr;
+   }
+} // namespace
+
+
+/** @{ @name Counting allocation functions */
+
+extern "C" void* malloc(size_t aSize)
+{
+   countAllocation();
+   return __libc_malloc(aSize);
+}
+
+extern "C" void* calloc(size_t aCount, size_t aSize)
+{
+   countAllocation();
+   return __libc_calloc(aCount, aSize);
+}
+
+extern "C" void* realloc(void* apPtr, size_t aSize)
+{
+   countAllocation();
+   return __libc_realloc(apPtr, aSize);
+}
+
+extern "C" void* aligned_alloc(size_t aAlignment, size_t aSize)
+{
+   countAllocation();
+   return __libc_memalign(aAlignment, aSize);
+}
+
+extern "C" void* memalign(size_t aAlignment, size_t aSize)
+{
+   countAllocation();
+   return __libc_memalign(aAlignment, aSize);
+}
+
+extern "C" int posix_memalign(void** appPtr, size_t aAlignment, size_t aSize)
+{
+   countAllocation();
+   if(aAlignment % sizeof(void*) != 0 || (aAlignment & (aAlignment - 1)) != 0)
+      return EINVAL;
+
+   void* lpPtr = __libc_memalign(aAlignment, aSize);
+   if(lpPtr == nullptr)
+      return ENOMEM;
+
+   *appPtr = lpPtr;
+   return 0;
+}
+
+extern "C" void free(void* apPtr)
+{
+   __libc_free(apPtr);
+}
+
+void* operator new(size_t aSize)                                  { return allocate(aSize); }
+void* operator new[](size_t aSize)                                { return allocate(aSize); }
+void* operator new(size_t aSize, const std::nothrow_t&) noexcept
+{
+   countAllocation();
+   return __libc_malloc(aSize == 0 ? 1 : aSize);
+}
+void* operator new[](size_t aSize, const std::nothrow_t&) noexcept
+{
+   countAllocation();
+   return __libc_malloc(aSize == 0 ? 1 : aSize);
+}
+void operator delete(void* apPtr) noexcept                        { __libc_free(apPtr); }
+void operator delete[](void* apPtr) noexcept                      { __libc_free(apPtr); }
+void operator delete(void* apPtr, size_t) noexcept                { __libc_free(apPtr); }
+void operator delete[](void* apPtr, size_t) noexcept              { __libc_free(apPtr); }
+
+#ifdef __cpp_aligned_new
+void* operator new(size_t aSize, std::align_val_t aAlignment)     { return allocateAligned(aSize, static_cast<size_t>(aAlignment)); }
+void* operator new[](size_t aSize, std::align_val_t aAlignment)   { return allocateAligned(aSize, static_cast<size_t>(aAlignment)); }
+void* operator new(size_t aSize, std::align_val_t aAlignment, const std::nothrow_t&) noexcept
+{
+   countAllocation();
+   return __libc_memalign(static_cast<size_t>(aAlignment), aSize == 0 ? 1 : aSize);
+}
+void* operator new[](size_t aSize, std::align_val_t aAlignment, const std::nothrow_t&) noexcept
+{
+   countAllocation();
+   return __libc_memalign(static_cast<size_t>(aAlignment), aSize == 0 ? 1 : aSize);
+}
+void operator delete(void* apPtr, std::align_val_t) noexcept              { __libc_free(apPtr); }
+void operator delete[](void* apPtr, std::align_val_t) noexcept            { __libc_free(apPtr); }
+void operator delete(void* apPtr, size_t, std::align_val_t) noexcept      { __libc_free(apPtr); }
+void operator delete[](void* apPtr, size_t, std::align_val_t) noexcept    { __libc_free(apPtr); }
+#endif
+
+/** @} */
+
+
+namespace
+{
+   const int WARMUP_ITERATIONS = 1000;          ///< Iterations before counting
+   const int ITERATIONS_DEFAULT = 100000;       ///< Counted iterations per path
+   const char* TRACE_FILE = "/tmp/alloccheck.trace";   ///< Trace file of the traced path
+
+
+   /**
+    * @brief Steady-state update path under test
+    */
+   struct Path
+   {
+      const char* mpName;                       ///< Name of the path
+      std::function<void(int aIteration)> mStep;   ///< One update of the path
+      std::function<uint64_t()> mTaken = nullptr;   ///< Number of updates which took effect so far (empty: not checked)
+   };
+
+
+   /**
+    * @brief Returns the current CLOCK_REALTIME time (setpoint packet timestamps)
+    *
+    * @return Time (ns)
+    */
+   uint64_t realtimeNow()
+   {
+      struct timespec lTime;
+      clock_gettime(CLOCK_REALTIME, &lTime);
+      return static_cast<uint64_t>(lTime.tv_sec) * 1000000000ull + static_cast<uint64_t>(lTime.tv_nsec);
+   }
+
+
+   /**
+    * @brief Creates a driver on a simulated device, connected and configured
+    *
+    * @param[in]  acrBusName     Bus name of the simulated device
+    *
+    * @return Driver
+    */
+   std::unique_ptr<CAR4TEGRA::PCA9685> createDriver(const std::string& acrBusName)
+   {
+      std::unique_ptr<CAR4TEGRA::PCA9685> lpDriver(
+         new CAR4TEGRA::PCA9685(std::unique_ptr<CAR4TEGRA::I2cDevice>(new CAR4TEGRA::SimulatedI2cDevice())));
+      lpDriver->openDevice(acrBusName, 0x80);
+      lpDriver->fastConnect(60.0f);
+      return lpDriver;
+   }
+
+
+   /**
+    * @brief Runs a path and counts its allocations
+    *
+    * @param[in]  acrPath        Path to run
+    * @param[in]  aIterations    Counted iterations
+    *
+    * @return `true` if the path did not allocate and no update was dropped
+    */
+   bool runPath(const Path& acrPath, int aIterations)
+   {
+      for(int i = 0; i < WARMUP_ITERATIONS; i++)
+      {
+         acrPath.mStep(i);
+      }
+
+      uint64_t lTaken = acrPath.mTaken ? acrPath.mTaken() : 0;
+      gAllocations = 0;
+      std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+      gArmed = true;
+
+      for(int i = 0; i < aIterations; i++)
+      {
+         acrPath.mStep(i);
+      }
+
+      gArmed = false;
+      double lNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - lStart).count();
+      uint64_t lAllocations = gAllocations;
+
+      // a path dropping its updates would pass without doing the work
+      lTaken = acrPath.mTaken ? acrPath.mTaken() - lTaken : static_cast<uint64_t>(aIterations);
+      bool lPassed = (lAllocations == 0 && lTaken >= static_cast<uint64_t>(aIterations));
+
+      std::cout << (lPassed ? "[ OK ] " : "[FAIL] ") << acrPath.mpName << ": "
+                << lAllocations << " allocations in " << aIterations << " updates, "
+                << lNs / aIterations << " ns per update";
+      if(lTaken < static_cast<uint64_t>(aIterations))
+         std::cout << ", only " << lTaken << " updates took effect";
+      std::cout << std::endl;
+
+      return lPassed;
+   }
+} // namespace
+
+
+/**
+ * @brief Main function of the allocation check tool
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if no path allocated or dropped updates, `1` otherwise, `2` on errors
+ */
+int main(int aArgc, char* apArgv[])
+{
+   int lIterations = ITERATIONS_DEFAULT;
+   for(int i = 1; i < aArgc; i++)
+   {
+      if(strcmp(apArgv[i], "--iterations") == 0 && i + 1 < aArgc)
+      {
+         lIterations = std::max(atoi(apArgv[++i]), 1);
+      }
+      else
+      {
+         std::cerr << "Usage: alloccheck [--iterations N]" << std::endl;
+         return 2;
+      }
+   }
+
+   try
+   {
+      // single device paths
+      std::unique_ptr<CAR4TEGRA::PCA9685> lpDriver = createDriver("/dev/i2c-1");
+      uint16_t lOn[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lOff[PCA9685_CHANNEL_COUNT] = {};
+
+      // traced device
+      std::unique_ptr<CAR4TEGRA::PCA9685> lpTraced = createDriver("/dev/i2c-1");
+      CAR4TEGRA::TraceRecorder lRecorder;
+      lRecorder.open(TRACE_FILE, 16 * 1024 * 1024);
+      lpTraced->setTraceRecorder(&lRecorder);
+
+      // read back without drift
+      std::vector<CAR4TEGRA::PCA9685::RegisterDrift> lDrift;
+      lDrift.reserve(PCA9685_REG_COUNT);
+
+      // two buses with two devices each
+      std::vector<std::unique_ptr<CAR4TEGRA::PCA9685>> lBoards;
+      CAR4TEGRA::BusExecutor lExecutor;
+      for(int i = 0; i < 4; i++)
+      {
+         lBoards.push_back(createDriver("/dev/i2c-" + std::to_string(i % 2)));
+         lExecutor.addDevice(*lBoards.back());
+      }
+      lExecutor.start();
+
+      CAR4TEGRA::BusScheduler lScheduler(400000, 60.0f);
+      lScheduler.addDevice(*lBoards[0]);
+      lScheduler.setUtilization(1.0);
+
+      // mixer with all inputs on the four channel blocks of the executor
+      CAR4TEGRA::OutputMixer lMixer(MIXER_INPUTS_MAX, 4 * PCA9685_CHANNEL_COUNT);
+      for(int lOutput = 0; lOutput < lMixer.outputs(); lOutput++)
+      {
+         lMixer.setWeight(lOutput, lOutput % MIXER_INPUTS_MAX, 0.5f);
+         lMixer.setWeight(lOutput, (lOutput + 1) % MIXER_INPUTS_MAX, -0.5f);
+         lMixer.setCalibration(lOutput, 205, 410);
+      }
+      float lCommands[MIXER_INPUTS_MAX] = {};
+      uint16_t lMixed[4 * PCA9685_CHANNEL_COUNT] = {};
+
+      // UDP setpoints over loopback
+      CAR4TEGRA::SetpointListener lListener(*lpDriver);
+      lListener.open(0);
+
+      int lSender = socket(AF_INET, SOCK_DGRAM, 0);
+      struct sockaddr_in lTarget;
+      memset(&lTarget, 0, sizeof(lTarget));
+      lTarget.sin_family = AF_INET;
+      lTarget.sin_port = htons(lListener.port());
+      lTarget.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      uint8_t lPacket[SETPOINT_PACKET_SIZE];
+      uint32_t lSequence = 0;
+
+      // C API handle
+      c4t_device* lpHandle = nullptr;
+      if(c4t_open_simulated("/dev/i2c-1", 0x80, &lpHandle) != C4T_OK || c4t_connect(lpHandle, 60.0f, nullptr) != C4T_OK)
+      {
+         throw std::runtime_error(std::string("Failed to open C API device: ") + c4t_last_error());
+      }
+
+
+      std::vector<Path> lPaths;
+      lPaths.push_back(Path{ "PCA9685::setPWM", [&](int aIteration)
+      {
+         lpDriver->setPWM(aIteration % PCA9685_CHANNEL_COUNT, 0, aIteration % 4096);
+      }});
+      lPaths.push_back(Path{ "PCA9685::setPWMBatch", [&](int aIteration)
+      {
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            lOff[lChannel] = static_cast<uint16_t>((aIteration + lChannel) % 4096);
+         lpDriver->setPWMBatch(0xFFFF, lOn, lOff);
+      }});
+      lPaths.push_back(Path{ "PCA9685::setPWM (traced)", [&](int aIteration)
+      {
+         lpTraced->setPWM(aIteration % PCA9685_CHANNEL_COUNT, 0, aIteration % 4096);
+      }});
+      lPaths.push_back(Path{ "PCA9685::scrubRegisters", [&](int aIteration)
+      {
+         lDrift.clear();
+         lpDriver->scrubRegisters(PCA9685_REG_LED0_ON_L + 4 * (aIteration % PCA9685_CHANNEL_COUNT), 4, true, lDrift);
+      }});
+      lPaths.push_back(Path{ "BusExecutor::runFrame", [&](int aIteration)
+      {
+         for(int lChannel = 0; lChannel < 4 * PCA9685_CHANNEL_COUNT; lChannel++)
+            lExecutor.set(lChannel, 0, (aIteration + lChannel) % 4096);
+         lExecutor.runFrame();
+      }});
+      lPaths.push_back(Path{ "OutputMixer::mixToPwm + BusExecutor::runFrame", [&](int aIteration)
+      {
+         lCommands[aIteration % MIXER_INPUTS_MAX] = static_cast<float>(aIteration % 200) / 100.0f - 1.0f;
+         lMixer.mixToPwm(lCommands, lMixed);
+         for(int lChannel = 0; lChannel < 4 * PCA9685_CHANNEL_COUNT; lChannel++)
+            lExecutor.set(lChannel, 0, lMixed[lChannel]);
+         lExecutor.runFrame();
+      }});
+      lPaths.push_back(Path{ "BusScheduler::runFrame", [&](int aIteration)
+      {
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            lScheduler.submit(lChannel, 0, (aIteration + lChannel) % 4096);
+         lScheduler.runFrame();
+      }});
+      lPaths.push_back(Path{ "SetpointListener::poll", [&](int aIteration)
+      {
+         lOff[aIteration % PCA9685_CHANNEL_COUNT] = static_cast<uint16_t>(aIteration % 4096);
+         CAR4TEGRA::SetpointListener::encode(++lSequence, realtimeNow(), 0xFFFF, lOff, lPacket);
+         sendto(lSender, lPacket, sizeof(lPacket), 0, reinterpret_cast<struct sockaddr*>(&lTarget), sizeof(lTarget));
+         lListener.poll(0);
+      },
+      [&]()
+      {
+         return lListener.statistics().mAccepted;
+      }});
+      lPaths.push_back(Path{ "c4t_set_pwm_batch", [&](int aIteration)
+      {
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            lOff[lChannel] = static_cast<uint16_t>((aIteration + lChannel) % 4096);
+         c4t_set_pwm_batch(lpHandle, 0xFFFF, lOn, lOff);
+      }});
+
+
+      int lFailed = 0;
+      for(const Path& lPath : lPaths)
+      {
+         lFailed += runPath(lPath, lIterations) ? 0 : 1;
+      }
+
+      lExecutor.stop();
+      c4t_close(lpHandle);
+      close(lSender);
+      lpTraced->setTraceRecorder(nullptr);
+      lRecorder.close();
+      unlink(TRACE_FILE);
+
+      return (lFailed == 0) ? 0 : 1;
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 2;
+   }
+}
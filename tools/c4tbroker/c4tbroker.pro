@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Bus broker daemon
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = c4tbroker
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+include(../../lib/c4tdriver.pri)
+
+
+SOURCES += \
+    main.cpp
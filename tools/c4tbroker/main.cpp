@@ -0,0 +1,247 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the bus broker daemon
+ *
+ * @details
+ * The daemon opens the PCA9685 devices exclusively and serves them to local clients
+ * (BrokerClient) over a Unix-domain socket until SIGINT / SIGTERM. All outputs are switched
+ * off on exit.
+ *
+ * Usage: c4tbroker [--device /dev/i2c-N:HEX]... [--simulated N] [--socket PATH] [--rate HZ]
+ *                  [--freq HZ] [--keep] [--stats S]
+ *
+ * Every `--device` adds a device (bus and address in 8 bit format), `--simulated` adds
+ * simulated devices. With `--keep` the channels of disconnected clients keep their values.
+ * With `--stats` the broker statistics are printed every S seconds.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <signal.h>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/busbroker.hpp"
+#include "include/pca9685.hpp"
+#include "include/simulatedi2cdevice.hpp"
+
+
+namespace
+{
+   volatile sig_atomic_t gStop = 0;    ///< Set by SIGINT / SIGTERM
+
+
+   /**
+    * @brief Broker settings
+    */
+   struct Settings
+   {
+      std::vector<std::pair<std::string, int>> mDevices;    ///< Bus and address (8 bit format) of the devices
+      int mSimulated;               ///< Number of simulated devices
+      std::string mSocket;          ///< Socket path
+      float mRate;                  ///< Frame rate (Hz)
+      float mFrequency;             ///< PWM frequency (Hz)
+      bool mKeep;                   ///< Keep the values of disconnected clients
+      int mStatsS;                  ///< Statistics interval (s, `0`: off)
+   };
+
+
+   /**
+    * @brief Signal handler for SIGINT / SIGTERM
+    *
+    * @param[in]  aSignal  Signal number
+    */
+   void onStopSignal(int aSignal)
+   {
+      (void)aSignal;
+      gStop = 1;
+   }
+
+
+   /**
+    * @brief Prints the usage of the tool
+    */
+   void printUsage()
+   {
+      std::cerr << "Usage: c4tbroker [--device /dev/i2c-N:HEX]... [--simulated N] [--socket PATH] [--rate HZ]"
+                   " [--freq HZ] [--keep] [--stats S]" << std::endl;
+   }
+
+
+   /**
+    * @brief Parses the command line
+    *
+    * @param[in]  aArgc    Number of arguments
+    * @param[in]  apArgv   Value of arguments
+    * @param[out] arSettings  Broker settings
+    *
+    * @return `true` if the command line is valid
+    */
+   bool parseArguments(int aArgc, char* apArgv[], Settings& arSettings)
+   {
+      arSettings = Settings{ {}, 0, BROKER_SOCKET_DEFAULT, BROKER_FRAME_RATE_DEFAULT, 50.0f, false, 0 };
+
+      for(int i = 1; i < aArgc; i++)
+      {
+         std::string lArg(apArgv[i]);
+
+         if(lArg == "--device" && i + 1 < aArgc)
+         {
+            std::string lDevice(apArgv[++i]);
+            size_t lColon = lDevice.rfind(':');
+            if(lColon == std::string::npos || lColon == 0)
+               return false;
+            arSettings.mDevices.push_back(std::make_pair(lDevice.substr(0, lColon),
+                                                         static_cast<int>(strtol(lDevice.c_str() + lColon + 1, nullptr, 16))));
+         }
+         else if(lArg == "--simulated" && i + 1 < aArgc)
+            arSettings.mSimulated = atoi(apArgv[++i]);
+         else if(lArg == "--socket" && i + 1 < aArgc)
+            arSettings.mSocket = apArgv[++i];
+         else if(lArg == "--rate" && i + 1 < aArgc)
+            arSettings.mRate = static_cast<float>(atof(apArgv[++i]));
+         else if(lArg == "--freq" && i + 1 < aArgc)
+            arSettings.mFrequency = static_cast<float>(atof(apArgv[++i]));
+         else if(lArg == "--keep")
+            arSettings.mKeep = true;
+         else if(lArg == "--stats" && i + 1 < aArgc)
+            arSettings.mStatsS = atoi(apArgv[++i]);
+         else
+            return false;
+      }
+
+      return !arSettings.mDevices.empty() || arSettings.mSimulated > 0;
+   }
+
+
+   /**
+    * @brief Prints the broker statistics
+    *
+    * @param[in]  acrStats       Statistics
+    */
+   void printStatistics(const CAR4TEGRA::BusBroker::Statistics& acrStats)
+   {
+      std::cout << "Clients " << acrStats.mClients << " (" << acrStats.mConnections << " connections), messages "
+                << acrStats.mMessages << ", malformed " << acrStats.mMalformed << ", rejected " << acrStats.mRejected
+                << ", preemptions " << acrStats.mPreemptions << ", frames " << acrStats.mFrames << ", channels "
+                << acrStats.mWritten << std::endl;
+   }
+} // namespace
+
+
+/**
+ * @brief Main function
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if the broker worked fine, `non zero` otherwise
+ */
+int main(int aArgc, char* apArgv[])
+{
+   Settings lSettings;
+   if(!parseArguments(aArgc, apArgv, lSettings))
+   {
+      printUsage();
+      return 2;
+   }
+
+   try
+   {
+      // the broker is the only process opening the devices
+      std::vector<std::unique_ptr<CAR4TEGRA::PCA9685>> lDrivers;
+      for(const std::pair<std::string, int>& lcrDevice : lSettings.mDevices)
+      {
+         lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>());
+         lDrivers.back()->openDevice(lcrDevice.first, lcrDevice.second);
+      }
+      for(int i = 0; i < lSettings.mSimulated; i++)
+      {
+         lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>(std::make_unique<CAR4TEGRA::SimulatedI2cDevice>()));
+         lDrivers.back()->openDevice("/dev/i2c-sim", 0x80 + 2 * i);
+      }
+
+      CAR4TEGRA::BusBroker lBroker;
+      lBroker.setErrorCallback([](const std::string& acrMessage) { std::cerr << acrMessage << std::endl; });
+      lBroker.setFrameRate(lSettings.mRate);
+      lBroker.setReleaseStop(!lSettings.mKeep);
+
+      for(std::unique_ptr<CAR4TEGRA::PCA9685>& lpDriver : lDrivers)
+      {
+         lpDriver->fastConnect(lSettings.mFrequency);
+         int lDevice = lBroker.addDevice(*lpDriver);
+         std::cout << "Device " << lDevice << ": " << lpDriver->busName() << " address "
+                   << std::hex << lpDriver->address() << std::dec << std::endl;
+      }
+
+      lBroker.open(lSettings.mSocket);
+      lBroker.start();
+      std::cout << "Broker listening on " << lBroker.path() << " at " << lSettings.mRate << " frames/s" << std::endl;
+
+      signal(SIGINT, onStopSignal);
+      signal(SIGTERM, onStopSignal);
+
+      std::chrono::steady_clock::time_point lNextStats = std::chrono::steady_clock::now() +
+                                                         std::chrono::seconds(lSettings.mStatsS);
+      while(!gStop)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+         if(lSettings.mStatsS > 0 && std::chrono::steady_clock::now() >= lNextStats)
+         {
+            printStatistics(lBroker.statistics());
+            lNextStats += std::chrono::seconds(lSettings.mStatsS);
+         }
+      }
+
+      lBroker.stop();
+      printStatistics(lBroker.statistics());
+      lBroker.close();
+
+      for(std::unique_ptr<CAR4TEGRA::PCA9685>& lpDriver : lDrivers)
+      {
+         lpDriver->stopOutputs(0xFFFF);
+      }
+
+      return 0;
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Calibration script runner
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = calibscript
+TEMPLATE = app
+
+CONFIG += console c++2a
+CONFIG -= app_bundle qt
+
+include(../../lib/c4tscript.pri)
+
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,334 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the calibration script runner
+ *
+ * @details
+ * The tool runs one calibration procedure per channel as a coroutine on a ScriptRuntime:
+ * ESC arming at the neutral value, operator confirmation, a sweep over the full range and the
+ * return to neutral. All procedures share one runtime thread and one bus worker per device.
+ *
+ * Usage: calibscript [--bus /dev/i2c-N] [--address HEX] [--devices N] [--freq HZ]
+ *                    [--arming MS] [--travel MS] [--steps N] [--confirm]
+ *
+ * Without `--bus` the procedures run against `--devices` simulated devices (16 channels each).
+ * With `--confirm` the sweeps start after Enter was pressed.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+#include "include/scriptbus.hpp"
+#include "include/scriptruntime.hpp"
+#include "include/simulatedi2cdevice.hpp"
+
+
+namespace
+{
+   const int PWM_NEUTRAL = 307;     ///< Neutral value (1.5 ms at 50 Hz)
+   const int PWM_MIN = 205;         ///< Lower end of the sweep (1.0 ms at 50 Hz)
+   const int PWM_MAX = 410;         ///< Upper end of the sweep (2.0 ms at 50 Hz)
+
+
+   /**
+    * @brief Runner settings
+    */
+   struct Settings
+   {
+      std::string mBusName;         ///< Bus of the device (empty: simulated devices)
+      int mAddress;                 ///< Device address (8 bit format)
+      int mDevices;                 ///< Number of simulated devices
+      float mFrequency;             ///< PWM frequency (Hz)
+      int mArmingMs;                ///< ESC arming time at neutral (ms)
+      int mTravelMs;                ///< Servo travel time per sweep step (ms)
+      int mSteps;                   ///< Steps per sweep
+      bool mConfirm;                ///< Wait for the operator before sweeping
+   };
+
+
+   /**
+    * @brief Prints the usage of the tool
+    */
+   void printUsage()
+   {
+      std::cerr << "Usage: calibscript [--bus /dev/i2c-N] [--address HEX] [--devices N] [--freq HZ]"
+                   " [--arming MS] [--travel MS] [--steps N] [--confirm]" << std::endl;
+   }
+
+
+   /**
+    * @brief Parses the command line
+    *
+    * @param[in]  aArgc    Number of arguments
+    * @param[in]  apArgv   Value of arguments
+    * @param[out] arSettings  Runner settings
+    *
+    * @return `true` if the command line is valid
+    */
+   bool parseArguments(int aArgc, char* apArgv[], Settings& arSettings)
+   {
+      arSettings = Settings{ "", 0x80, 16, 50.0f, 2000, 20, 50, false };
+
+      for(int i = 1; i < aArgc; i++)
+      {
+         std::string lArg(apArgv[i]);
+
+         if(lArg == "--bus" && i + 1 < aArgc)
+            arSettings.mBusName = apArgv[++i];
+         else if(lArg == "--address" && i + 1 < aArgc)
+            arSettings.mAddress = static_cast<int>(strtol(apArgv[++i], nullptr, 16));
+         else if(lArg == "--devices" && i + 1 < aArgc)
+            arSettings.mDevices = atoi(apArgv[++i]);
+         else if(lArg == "--freq" && i + 1 < aArgc)
+            arSettings.mFrequency = static_cast<float>(atof(apArgv[++i]));
+         else if(lArg == "--arming" && i + 1 < aArgc)
+            arSettings.mArmingMs = atoi(apArgv[++i]);
+         else if(lArg == "--travel" && i + 1 < aArgc)
+            arSettings.mTravelMs = atoi(apArgv[++i]);
+         else if(lArg == "--steps" && i + 1 < aArgc)
+            arSettings.mSteps = atoi(apArgv[++i]);
+         else if(lArg == "--confirm")
+            arSettings.mConfirm = true;
+         else
+            return false;
+      }
+
+      return arSettings.mDevices > 0 && arSettings.mSteps > 0 && arSettings.mArmingMs >= 0 && arSettings.mTravelMs >= 0;
+   }
+
+
+   /**
+    * @brief Returns the number of threads of the process
+    *
+    * @return Number of threads (`0` if unknown)
+    */
+   int threadCount()
+   {
+      std::ifstream lStatus("/proc/self/status");
+      std::string lKey;
+      while(lStatus >> lKey)
+      {
+         if(lKey == "Threads:")
+         {
+            int lThreads = 0;
+            lStatus >> lThreads;
+            return lThreads;
+         }
+      }
+
+      return 0;
+   }
+
+
+   /**
+    * @brief Moves a channel from one value to another in equal steps
+    *
+    * @param[in]  arRuntime      Script runtime
+    * @param[in]  arBus          Bus of the channel
+    * @param[in]  aChannel       Channel number
+    * @param[in]  aFrom          Start value
+    * @param[in]  aTo            End value
+    * @param[in]  acrSettings    Runner settings
+    */
+   CAR4TEGRA::ScriptTask sweep(CAR4TEGRA::ScriptRuntime& arRuntime, CAR4TEGRA::ScriptBus& arBus, int aChannel,
+                               int aFrom, int aTo, const Settings& acrSettings)
+   {
+      for(int lStep = 1; lStep <= acrSettings.mSteps; lStep++)
+      {
+         co_await arBus.setPWM(aChannel, 0, aFrom + (aTo - aFrom) * lStep / acrSettings.mSteps);
+         co_await arRuntime.sleep(std::chrono::milliseconds(acrSettings.mTravelMs));
+      }
+   }
+
+
+   /**
+    * @brief Calibration procedure of one channel
+    *
+    * @param[in]  arRuntime      Script runtime
+    * @param[in]  arBus          Bus of the channel
+    * @param[in]  arConfirm      Operator confirmation
+    * @param[in]  aChannel       Channel number
+    * @param[in]  acrSettings    Runner settings
+    */
+   CAR4TEGRA::ScriptTask procedure(CAR4TEGRA::ScriptRuntime& arRuntime, CAR4TEGRA::ScriptBus& arBus,
+                                   CAR4TEGRA::ScriptEvent& arConfirm, int aChannel, const Settings& acrSettings)
+   {
+      // ESC arming: neutral until the controller accepts it
+      co_await arBus.setPWM(aChannel, 0, PWM_NEUTRAL);
+      co_await arRuntime.sleep(std::chrono::milliseconds(acrSettings.mArmingMs));
+
+      co_await arConfirm;
+
+      co_await sweep(arRuntime, arBus, aChannel, PWM_NEUTRAL, PWM_MAX, acrSettings);
+      co_await sweep(arRuntime, arBus, aChannel, PWM_MAX, PWM_MIN, acrSettings);
+      co_await sweep(arRuntime, arBus, aChannel, PWM_MIN, PWM_NEUTRAL, acrSettings);
+   }
+
+
+   /**
+    * @brief Samples the thread count of the process while procedures are running
+    *
+    * @param[in]  arRuntime      Script runtime
+    * @param[out] arMaxThreads   Maximum thread count
+    */
+   CAR4TEGRA::ScriptTask monitor(CAR4TEGRA::ScriptRuntime& arRuntime, int& arMaxThreads)
+   {
+      while(arRuntime.activeScripts() > 1)
+      {
+         arMaxThreads = std::max(arMaxThreads, threadCount());
+         co_await arRuntime.sleep(std::chrono::milliseconds(100));
+      }
+   }
+} // namespace
+
+
+/**
+ * @brief Main function
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if all procedures finished, `non zero` otherwise
+ */
+int main(int aArgc, char* apArgv[])
+{
+   Settings lSettings;
+   if(!parseArguments(aArgc, apArgv, lSettings))
+   {
+      printUsage();
+      return 2;
+   }
+
+   try
+   {
+      // open simulated or real devices
+      std::vector<std::unique_ptr<CAR4TEGRA::PCA9685>> lDrivers;
+      int lDevices = lSettings.mBusName.empty() ? lSettings.mDevices : 1;
+      for(int i = 0; i < lDevices; i++)
+      {
+         if(lSettings.mBusName.empty())
+         {
+            lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>(std::make_unique<CAR4TEGRA::SimulatedI2cDevice>()));
+            lDrivers.back()->openDevice("simulated", lSettings.mAddress);
+         }
+         else
+         {
+            lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>());
+            lDrivers.back()->openDevice(lSettings.mBusName, lSettings.mAddress);
+         }
+
+         lDrivers.back()->fastConnect(lSettings.mFrequency);
+      }
+
+
+      // one runtime thread, one bus worker per device (buses are destroyed before the runtime)
+      CAR4TEGRA::ScriptRuntime lRuntime;
+      lRuntime.setErrorCallback([](const std::string& acrMessage) { std::cerr << acrMessage << std::endl; });
+
+      CAR4TEGRA::ScriptEvent lConfirm(lRuntime);
+      std::vector<std::unique_ptr<CAR4TEGRA::ScriptBus>> lBuses;
+      for(std::unique_ptr<CAR4TEGRA::PCA9685>& lpDriver : lDrivers)
+      {
+         lBuses.push_back(std::make_unique<CAR4TEGRA::ScriptBus>(lRuntime, *lpDriver));
+
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+         {
+            lRuntime.spawn(procedure(lRuntime, *lBuses.back(), lConfirm, lChannel, lSettings),
+                           "channel " + std::to_string(lBuses.size() - 1) + "/" + std::to_string(lChannel));
+         }
+      }
+
+      int lMaxThreads = 0;
+      lRuntime.spawn(monitor(lRuntime, lMaxThreads), "monitor");
+
+
+      // operator confirmation from the terminal (the reader thread is left behind on exit)
+      if(lSettings.mConfirm)
+      {
+         std::cout << "Arming, press Enter to start the sweeps" << std::endl;
+         std::thread([&lConfirm]()
+         {
+            std::string lLine;
+            std::getline(std::cin, lLine);
+            lConfirm.set();
+         }).detach();
+      }
+      else
+      {
+         lConfirm.set();
+      }
+
+      std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+      lRuntime.run();
+      double lSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+
+      // report
+      CAR4TEGRA::ScriptRuntime::Statistics lStats = lRuntime.statistics();
+      uint64_t lUpdates = 0;
+      uint64_t lBatches = 0;
+      uint64_t lErrors = 0;
+      for(std::unique_ptr<CAR4TEGRA::ScriptBus>& lpBus : lBuses)
+      {
+         CAR4TEGRA::ScriptBus::Statistics lBusStats = lpBus->statistics();
+         lUpdates += lBusStats.mUpdates;
+         lBatches += lBusStats.mBatches;
+         lErrors += lBusStats.mErrors;
+      }
+
+      std::cout << "Procedures " << (lStats.mSpawned - 1) << " on " << lDrivers.size() << " devices finished in "
+                << lSeconds << " s, failed " << lStats.mFailed << ", threads " << lMaxThreads << std::endl;
+      std::cout << "Resumes " << lStats.mResumes << ", wakeups " << lStats.mWakeups << ", max delays "
+                << lStats.mMaxTimers << ", channel updates " << lUpdates << " in " << lBatches
+                << " batches, bus errors " << lErrors << std::endl;
+
+      for(std::unique_ptr<CAR4TEGRA::PCA9685>& lpDriver : lDrivers)
+      {
+         lpDriver->stopOutputs(0xFFFF);
+      }
+
+      return (lStats.mFailed == 0 && lErrors == 0) ? 0 : 1;
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# Load generator and soak tool
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = loadgen
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+include(../../lib/c4tdriver.pri)
+
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,818 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the load generator and soak tool
+ *
+ * @details
+ * The tool drives a configurable PWM update workload through the PCA9685 driver for a set
+ * duration and reports the achieved update rate, the update latency percentiles, dropped and
+ * deferred updates, read-back mismatches and errors. It is used to size bus topologies and
+ * to find regressions under sustained load.
+ *
+ * Usage: loadgen [--bus /dev/i2c-N]... [--buses N] [--boards N] [--channels N] [--rate HZ]
+ *                [--change P] [--delta small|large] [--verify R] [--duration S]
+ *                [--path direct|executor|scheduler] [--bus-clock HZ] [--overhead US] [--seed N] [--virtual]
+ *
+ * Every bus carries `--boards` devices (addresses 0x80, 0x82, ...). Without `--bus` the given
+ * number of simulated buses is used, their transactions take the time of a real bus at
+ * `--bus-clock`. Per frame every channel changes with probability `--change` by a small step
+ * or to a random value, `--verify` is the probability that a board is read back after a write.
+ *
+ * With `--virtual` the simulated buses run in virtual time: every bus has its own VirtualClock
+ * for its devices, drivers and scheduler, the frames are paced on the latest bus time and a frame
+ * start moves idle buses forward to it. A run of hours takes as long as the driver code needs,
+ * rates, latencies and utilization refer to the virtual time. The schedulers do not run their own
+ * threads in virtual time, their frames are run after the updates of each frame were submitted.
+ *
+ * Paths:
+ * - `direct`: one thread per bus writes its boards with PCA9685::setPWMBatch()
+ * - `executor`: the frames are written by BusExecutor (one worker per bus, frame barrier)
+ * - `scheduler`: the updates are submitted to one BusScheduler per bus (latency: maximum only)
+ *
+ * An update is dropped if a newer value replaces it before it is written and deferred if it
+ * is written after the end of its frame.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <signal.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/busexecutor.hpp"
+#include "include/busscheduler.hpp"
+#include "include/driverclock.hpp"
+#include "include/pca9685.hpp"
+#include "include/simulatedi2cdevice.hpp"
+
+
+namespace
+{
+   typedef std::chrono::steady_clock Clock;    ///< Time base of pacing and latencies (read through DriverClock)
+
+   const int64_t LATENCY_BUCKET_NS = 10000;     ///< Resolution of the latency histogram (10 us)
+   const size_t LATENCY_BUCKETS = 100000;       ///< Number of histogram buckets (1 s, slower updates count as 1 s)
+   const float PWM_FREQUENCY = 50.0f;           ///< PWM frequency of the boards (Hz)
+   const int SMALL_STEP_MAX = 32;               ///< Largest value change of a small step
+
+   volatile sig_atomic_t gStop = 0;             ///< Set by SIGINT / SIGTERM
+
+
+   /**
+    * @brief Write path under test
+    */
+   enum class Path
+   {
+      DIRECT,                       ///< PCA9685::setPWMBatch() from one thread per bus
+      EXECUTOR,                     ///< BusExecutor frames
+      SCHEDULER                     ///< BusScheduler submits
+   };
+
+
+   /**
+    * @brief Load settings
+    */
+   struct Settings
+   {
+      std::vector<std::string> mBuses;    ///< Real buses (empty: simulated buses)
+      int mSimulatedBuses;          ///< Number of simulated buses
+      int mBoards;                  ///< Number of boards per bus
+      int mChannels;                ///< Number of channels per board
+      double mRate;                 ///< Frame rate (Hz)
+      double mChange;               ///< Probability that a channel changes in a frame
+      bool mLargeSteps;             ///< Changes jump to random values instead of small steps
+      double mVerify;               ///< Probability that a board is read back after a write
+      double mDurationS;            ///< Duration of the run (s)
+      Path mPath;                   ///< Write path
+      uint32_t mBusClock;           ///< I2C bus clock (Hz)
+      double mOverheadUs;           ///< Fixed cost of one transaction (us)
+      unsigned mSeed;               ///< Seed of the workload generator
+      bool mVirtual;                ///< Simulated buses run in virtual time
+   };
+
+
+   /**
+    * @brief Workload state of one board
+    */
+   struct Board
+   {
+      CAR4TEGRA::PCA9685* mpDriver; ///< Device driver
+      int mDevice;                  ///< Device index on its bus
+      uint16_t mOn[PCA9685_CHANNEL_COUNT];      ///< Current values for PWM ON
+      uint16_t mOff[PCA9685_CHANNEL_COUNT];     ///< Current values for PWM OFF
+      Clock::time_point mDue[PCA9685_CHANNEL_COUNT];  ///< Frame time of the pending values
+      uint16_t mPending;            ///< Channels changed since the last write
+   };
+
+
+   /**
+    * @brief Counters and latency histogram of a load thread
+    */
+   struct Result
+   {
+      std::vector<uint64_t> mHistogram;   ///< Latency histogram (LATENCY_BUCKET_NS per bucket)
+      int64_t mMaxNs;               ///< Worst latency (ns)
+      uint64_t mGenerated;          ///< Number of generated updates
+      uint64_t mWritten;            ///< Number of written updates
+      uint64_t mDropped;            ///< Number of updates replaced before they were written
+      uint64_t mDeferred;           ///< Number of updates written after the end of their frame
+      uint64_t mReads;              ///< Number of read-backs
+      uint64_t mMismatches;         ///< Number of registers differing from the written values
+      uint64_t mErrors;             ///< Number of failed transfers
+   };
+
+
+   /**
+    * @brief Signal handler for SIGINT / SIGTERM
+    *
+    * @param[in]  aSignal  Signal number
+    */
+   void onStopSignal(int aSignal)
+   {
+      (void)aSignal;
+      gStop = 1;
+   }
+
+
+   /**
+    * @brief Prints the usage of the tool
+    */
+   void printUsage()
+   {
+      std::cerr << "Usage: loadgen [--bus /dev/i2c-N]... [--buses N] [--boards N] [--channels N] [--rate HZ]"
+                   " [--change P] [--delta small|large] [--verify R] [--duration S]"
+                   " [--path direct|executor|scheduler] [--bus-clock HZ] [--overhead US] [--seed N] [--virtual]" << std::endl;
+   }
+
+
+   /**
+    * @brief Parses the command line
+    *
+    * @param[in]  aArgc    Number of arguments
+    * @param[in]  apArgv   Value of arguments
+    * @param[out] arSettings  Load settings
+    *
+    * @return `true` if the command line is valid
+    */
+   bool parseArguments(int aArgc, char* apArgv[], Settings& arSettings)
+   {
+      arSettings = Settings{ {}, 1, 1, PCA9685_CHANNEL_COUNT, 100.0, 1.0, false, 0.0, 10.0, Path::DIRECT, 400000, 30.0, 1, false };
+
+      for(int i = 1; i < aArgc; i++)
+      {
+         std::string lArg(apArgv[i]);
+
+         if(lArg == "--bus" && i + 1 < aArgc)
+            arSettings.mBuses.push_back(apArgv[++i]);
+         else if(lArg == "--buses" && i + 1 < aArgc)
+            arSettings.mSimulatedBuses = atoi(apArgv[++i]);
+         else if(lArg == "--boards" && i + 1 < aArgc)
+            arSettings.mBoards = atoi(apArgv[++i]);
+         else if(lArg == "--channels" && i + 1 < aArgc)
+            arSettings.mChannels = atoi(apArgv[++i]);
+         else if(lArg == "--rate" && i + 1 < aArgc)
+            arSettings.mRate = atof(apArgv[++i]);
+         else if(lArg == "--change" && i + 1 < aArgc)
+            arSettings.mChange = atof(apArgv[++i]);
+         else if(lArg == "--delta" && i + 1 < aArgc)
+         {
+            std::string lDelta(apArgv[++i]);
+            if(lDelta != "small" && lDelta != "large")
+               return false;
+            arSettings.mLargeSteps = (lDelta == "large");
+         }
+         else if(lArg == "--verify" && i + 1 < aArgc)
+            arSettings.mVerify = atof(apArgv[++i]);
+         else if(lArg == "--duration" && i + 1 < aArgc)
+            arSettings.mDurationS = atof(apArgv[++i]);
+         else if(lArg == "--path" && i + 1 < aArgc)
+         {
+            std::string lPath(apArgv[++i]);
+            if(lPath == "direct")
+               arSettings.mPath = Path::DIRECT;
+            else if(lPath == "executor")
+               arSettings.mPath = Path::EXECUTOR;
+            else if(lPath == "scheduler")
+               arSettings.mPath = Path::SCHEDULER;
+            else
+               return false;
+         }
+         else if(lArg == "--bus-clock" && i + 1 < aArgc)
+            arSettings.mBusClock = static_cast<uint32_t>(strtoul(apArgv[++i], nullptr, 10));
+         else if(lArg == "--overhead" && i + 1 < aArgc)
+            arSettings.mOverheadUs = atof(apArgv[++i]);
+         else if(lArg == "--seed" && i + 1 < aArgc)
+            arSettings.mSeed = static_cast<unsigned>(strtoul(apArgv[++i], nullptr, 10));
+         else if(lArg == "--virtual")
+            arSettings.mVirtual = true;
+         else
+            return false;
+      }
+
+      // real buses cannot run in virtual time
+      if(arSettings.mVirtual && !arSettings.mBuses.empty())
+         return false;
+
+      // 48 addresses from 0x80 to 0xDE, below ALL_CALL (0xE0)
+      return arSettings.mSimulatedBuses > 0 && arSettings.mBoards > 0 && arSettings.mBoards <= 48
+             && arSettings.mChannels > 0 && arSettings.mChannels <= PCA9685_CHANNEL_COUNT
+             && arSettings.mRate > 0.0 && arSettings.mChange >= 0.0 && arSettings.mChange <= 1.0
+             && arSettings.mVerify >= 0.0 && arSettings.mVerify <= 1.0 && arSettings.mDurationS > 0.0
+             && arSettings.mBusClock > 0;
+   }
+
+
+   /**
+    * @brief Creates an empty result
+    *
+    * @return Result
+    */
+   Result createResult()
+   {
+      Result lResult = { std::vector<uint64_t>(LATENCY_BUCKETS, 0), 0, 0, 0, 0, 0, 0, 0, 0 };
+      return lResult;
+   }
+
+
+   /**
+    * @brief Adds the counters and the histogram of a result to another one
+    *
+    * @param[in,out] arTotal    Sum of the results
+    * @param[in]  acrResult     Result to add
+    */
+   void mergeResult(Result& arTotal, const Result& acrResult)
+   {
+      for(size_t i = 0; i < LATENCY_BUCKETS; i++)
+      {
+         arTotal.mHistogram[i] += acrResult.mHistogram[i];
+      }
+      arTotal.mMaxNs = std::max(arTotal.mMaxNs, acrResult.mMaxNs);
+      arTotal.mGenerated += acrResult.mGenerated;
+      arTotal.mWritten += acrResult.mWritten;
+      arTotal.mDropped += acrResult.mDropped;
+      arTotal.mDeferred += acrResult.mDeferred;
+      arTotal.mReads += acrResult.mReads;
+      arTotal.mMismatches += acrResult.mMismatches;
+      arTotal.mErrors += acrResult.mErrors;
+   }
+
+
+   /**
+    * @brief Returns a latency percentile (upper bucket border)
+    *
+    * @param[in]  acrResult     Result
+    * @param[in]  aFraction     Percentile as fraction (e.g. 0.99)
+    *
+    * @return Latency (us)
+    */
+   double percentileUs(const Result& acrResult, double aFraction)
+   {
+      uint64_t lCount = 0;
+      for(uint64_t lBucket : acrResult.mHistogram)
+      {
+         lCount += lBucket;
+      }
+      if(lCount == 0)
+         return 0.0;
+
+      uint64_t lRank = std::max<uint64_t>(1, static_cast<uint64_t>(aFraction * lCount + 0.5));
+      uint64_t lSum = 0;
+      for(size_t i = 0; i < LATENCY_BUCKETS; i++)
+      {
+         lSum += acrResult.mHistogram[i];
+         if(lSum >= lRank)
+            return std::min<int64_t>((i + 1) * LATENCY_BUCKET_NS, acrResult.mMaxNs) / 1000.0;
+      }
+
+      return acrResult.mMaxNs / 1000.0;
+   }
+
+
+   /**
+    * @brief Changes the channels of a board for one frame
+    *
+    * @param[in]  acrSettings   Load settings
+    * @param[in]  aDue          Start of the frame
+    * @param[in,out] arBoard    Board
+    * @param[in,out] arRandom   Random generator
+    * @param[in,out] arResult   Result of the load thread
+    */
+   void generateFrame(const Settings& acrSettings, Clock::time_point aDue, Board& arBoard, std::mt19937& arRandom,
+                      Result& arResult)
+   {
+      std::uniform_real_distribution<double> lChance(0.0, 1.0);
+      std::uniform_int_distribution<int> lValue(0, 4095);
+      std::uniform_int_distribution<int> lStep(-SMALL_STEP_MAX, SMALL_STEP_MAX);
+
+      for(int lChannel = 0; lChannel < acrSettings.mChannels; lChannel++)
+      {
+         if(lChance(arRandom) >= acrSettings.mChange)
+            continue;
+
+         int lOff = acrSettings.mLargeSteps ? lValue(arRandom) : arBoard.mOff[lChannel] + lStep(arRandom);
+         arBoard.mOff[lChannel] = static_cast<uint16_t>(std::min(std::max(lOff, 0), 4095));
+
+         if(arBoard.mPending & (1 << lChannel))
+            arResult.mDropped++;
+         arBoard.mPending |= static_cast<uint16_t>(1 << lChannel);
+         arBoard.mDue[lChannel] = aDue;
+         arResult.mGenerated++;
+      }
+   }
+
+
+   /**
+    * @brief Records the latencies of the pending channels of a board after they were written
+    *
+    * @param[in]  aWritten      Time the channels were written
+    * @param[in]  aPeriod       Frame period
+    * @param[in,out] arBoard    Board, the pending channels are cleared
+    * @param[in,out] arResult   Result of the load thread
+    */
+   void recordWrite(Clock::time_point aWritten, Clock::duration aPeriod, Board& arBoard, Result& arResult)
+   {
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         if(!(arBoard.mPending & (1 << lChannel)))
+            continue;
+
+         int64_t lLatencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(aWritten - arBoard.mDue[lChannel]).count();
+         lLatencyNs = std::max<int64_t>(lLatencyNs, 0);
+
+         arResult.mHistogram[std::min<size_t>(lLatencyNs / LATENCY_BUCKET_NS, LATENCY_BUCKETS - 1)]++;
+         arResult.mMaxNs = std::max(arResult.mMaxNs, lLatencyNs);
+         arResult.mWritten++;
+         if(aWritten - arBoard.mDue[lChannel] > aPeriod)
+            arResult.mDeferred++;
+      }
+      arBoard.mPending = 0;
+   }
+
+
+   /**
+    * @brief Reads the LEDn registers of a board back with the given probability
+    *
+    * @param[in]  acrSettings   Load settings
+    * @param[in]  arBoard       Board
+    * @param[in,out] arRandom   Random generator
+    * @param[in,out] arDrift    Buffer for the drifted registers
+    * @param[in,out] arResult   Result of the load thread
+    */
+   void verifyBoard(const Settings& acrSettings, Board& arBoard, std::mt19937& arRandom,
+                    std::vector<CAR4TEGRA::PCA9685::RegisterDrift>& arDrift, Result& arResult)
+   {
+      std::uniform_real_distribution<double> lChance(0.0, 1.0);
+      if(acrSettings.mVerify <= 0.0 || lChance(arRandom) >= acrSettings.mVerify)
+         return;
+
+      try
+      {
+         arDrift.clear();
+         int lDrift = arBoard.mpDriver->scrubRegisters(PCA9685_REG_LED0_ON_L, 4 * acrSettings.mChannels, false, arDrift);
+         arResult.mReads++;
+         if(lDrift > 0)
+            arResult.mMismatches += lDrift;
+      }
+      catch(const std::exception&)
+      {
+         arResult.mErrors++;
+      }
+   }
+
+
+   /**
+    * @brief Returns the time of a load thread, the latest time of the clocks of its buses
+    *
+    * @param[in]  acrClocks     Clocks of the buses (real buses share the monotonic clock)
+    *
+    * @return Current time
+    */
+   Clock::time_point frameNow(const std::vector<CAR4TEGRA::DriverClock*>& acrClocks)
+   {
+      Clock::time_point lNow = acrClocks.front()->now();
+      for(CAR4TEGRA::DriverClock* lpClock : acrClocks)
+      {
+         lNow = std::max(lNow, lpClock->now());
+      }
+      return lNow;
+   }
+
+
+   /**
+    * @brief Waits on the clocks of the buses until a point in time (moves idle virtual buses forward)
+    *
+    * @param[in]  acrClocks     Clocks of the buses
+    * @param[in]  aTime         Point in time
+    */
+   void frameSleepUntil(const std::vector<CAR4TEGRA::DriverClock*>& acrClocks, Clock::time_point aTime)
+   {
+      for(CAR4TEGRA::DriverClock* lpClock : acrClocks)
+      {
+         lpClock->sleepUntil(aTime);
+      }
+   }
+
+
+   /**
+    * @brief Runs the frames of the workload until the end time or a stop signal
+    *
+    * Frames missed because the previous write took too long are generated as well, their
+    * values replace the pending ones (dropped updates).
+    *
+    * @param[in]  acrSettings   Load settings
+    * @param[in]  acrClocks     Clocks of the buses of the boards
+    * @param[in]  aEnd          End of the run
+    * @param[in,out] arBoards   Boards of the workload
+    * @param[in,out] arRandom   Random generator
+    * @param[in,out] arResult   Result of the load thread
+    * @param[in]  aWrite        Writes the pending channels of all boards
+    */
+   template<typename WriteFunction>
+   void runFrames(const Settings& acrSettings, const std::vector<CAR4TEGRA::DriverClock*>& acrClocks, Clock::time_point aEnd,
+                  std::vector<Board*>& arBoards, std::mt19937& arRandom, Result& arResult, WriteFunction aWrite)
+   {
+      Clock::duration lPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / acrSettings.mRate));
+      Clock::time_point lNext = frameNow(acrClocks);
+
+      while(lNext < aEnd && !gStop)
+      {
+         frameSleepUntil(acrClocks, lNext);
+
+         Clock::time_point lNow = frameNow(acrClocks);
+         do
+         {
+            for(Board* lpBoard : arBoards)
+            {
+               generateFrame(acrSettings, lNext, *lpBoard, arRandom, arResult);
+            }
+            lNext += lPeriod;
+         } while(lNext <= lNow && lNext < aEnd);
+
+         aWrite(lPeriod);
+      }
+   }
+
+
+   /**
+    * @brief Prints the result of the run
+    *
+    * @param[in]  acrResult     Result of all load threads
+    * @param[in]  aElapsedS     Duration of the run (s)
+    * @param[in]  aLatency      Latency percentiles are available
+    */
+   void printResult(const Result& acrResult, double aElapsedS, bool aLatency)
+   {
+      std::cout << std::fixed << std::setprecision(0)
+                << "Updates:    generated " << acrResult.mGenerated / aElapsedS << "/s, written "
+                << acrResult.mWritten / aElapsedS << "/s (" << acrResult.mWritten << " in "
+                << std::setprecision(2) << aElapsedS << " s)" << std::endl;
+
+      std::cout << std::setprecision(0);
+      if(aLatency)
+      {
+         std::cout << "Latency:    p50 " << percentileUs(acrResult, 0.5) << " us, p90 " << percentileUs(acrResult, 0.9)
+                   << " us, p99 " << percentileUs(acrResult, 0.99) << " us, p99.9 " << percentileUs(acrResult, 0.999)
+                   << " us, max " << acrResult.mMaxNs / 1000.0 << " us" << std::endl;
+      }
+      else
+      {
+         std::cout << "Latency:    max " << acrResult.mMaxNs / 1000.0 << " us" << std::endl;
+      }
+
+      std::cout << "Dropped:    " << acrResult.mDropped << ", deferred " << acrResult.mDeferred << std::endl;
+      std::cout << "Read-backs: " << acrResult.mReads << ", mismatching registers " << acrResult.mMismatches << std::endl;
+      std::cout << "Errors:     " << acrResult.mErrors << std::endl;
+   }
+} // namespace
+
+
+/**
+ * @brief Main function
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if the run finished without errors, `1` on errors, `2` on invalid arguments
+ */
+int main(int aArgc, char* apArgv[])
+{
+   Settings lSettings;
+   if(!parseArguments(aArgc, apArgv, lSettings))
+   {
+      printUsage();
+      return 2;
+   }
+
+   signal(SIGINT, onStopSignal);
+   signal(SIGTERM, onStopSignal);
+
+   try
+   {
+      // boards are addressed 0x80, 0x82, ... on every bus, simulated buses model the bus time
+      bool lSimulated = lSettings.mBuses.empty();
+      if(lSimulated)
+      {
+         for(int i = 0; i < lSettings.mSimulatedBuses; i++)
+            lSettings.mBuses.push_back("/dev/i2c-sim" + std::to_string(i));
+      }
+
+      // one timeline per bus in virtual time, the monotonic clock otherwise
+      std::vector<std::unique_ptr<CAR4TEGRA::VirtualClock>> lVirtualClocks;
+      std::vector<CAR4TEGRA::DriverClock*> lClocks;
+      for(size_t lBus = 0; lBus < lSettings.mBuses.size(); lBus++)
+      {
+         if(lSettings.mVirtual)
+         {
+            lVirtualClocks.push_back(std::make_unique<CAR4TEGRA::VirtualClock>());
+            lClocks.push_back(lVirtualClocks.back().get());
+         }
+         else
+         {
+            lClocks.push_back(&CAR4TEGRA::DriverClock::monotonic());
+         }
+      }
+      std::vector<CAR4TEGRA::DriverClock*> lAllClocks(lSettings.mVirtual ? lClocks
+                                                      : std::vector<CAR4TEGRA::DriverClock*>(1, lClocks.front()));
+
+      std::vector<std::unique_ptr<CAR4TEGRA::PCA9685>> lDrivers;
+      std::vector<CAR4TEGRA::SimulatedI2cDevice*> lSimulatedDevices;
+      std::vector<std::vector<Board>> lBoards(lSettings.mBuses.size());
+      for(size_t lBus = 0; lBus < lSettings.mBuses.size(); lBus++)
+      {
+         for(int i = 0; i < lSettings.mBoards; i++)
+         {
+            if(lSimulated)
+            {
+               std::unique_ptr<CAR4TEGRA::SimulatedI2cDevice> lpDevice = std::make_unique<CAR4TEGRA::SimulatedI2cDevice>();
+               lpDevice->setBusTiming(lSettings.mBusClock, lSettings.mOverheadUs, *lClocks[lBus]);
+               lSimulatedDevices.push_back(lpDevice.get());
+               lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>(std::move(lpDevice)));
+            }
+            else
+            {
+               lDrivers.push_back(std::make_unique<CAR4TEGRA::PCA9685>());
+            }
+
+            CAR4TEGRA::PCA9685& lrDriver = *lDrivers.back();
+            lrDriver.setClock(*lClocks[lBus]);
+            lrDriver.openDevice(lSettings.mBuses[lBus], 0x80 + 2 * i);
+            lrDriver.setBusTiming(lSettings.mBusClock, lSettings.mOverheadUs);
+            lrDriver.fastConnect(PWM_FREQUENCY);
+
+            Board lBoard = {};
+            lBoard.mpDriver = &lrDriver;
+            lBoard.mDevice = i;
+            lBoards[lBus].push_back(lBoard);
+         }
+      }
+
+      const char* lPathNames[] = { "direct", "executor", "scheduler" };
+      std::cout << lSettings.mBuses.size() << (lSimulated ? " simulated" : "") << " bus(es) x " << lSettings.mBoards
+                << " board(s) x " << lSettings.mChannels << " channel(s) at " << lSettings.mBusClock / 1000 << " kHz, "
+                << lSettings.mRate << " Hz, change " << lSettings.mChange << (lSettings.mLargeSteps ? " (large)" : " (small)")
+                << ", verify " << lSettings.mVerify << ", path " << lPathNames[static_cast<int>(lSettings.mPath)]
+                << ", " << lSettings.mDurationS << (lSettings.mVirtual ? " s virtual time" : " s") << std::endl;
+
+
+      Result lTotal = createResult();
+      std::vector<CAR4TEGRA::PCA9685::RegisterDrift> lDrift;
+      std::chrono::steady_clock::time_point lWallStart = std::chrono::steady_clock::now();
+      Clock::time_point lStart = frameNow(lAllClocks);
+      Clock::time_point lEnd = lStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(lSettings.mDurationS));
+
+      if(lSettings.mPath == Path::DIRECT)
+      {
+         // one load thread per bus, the buses run independently
+         std::vector<Result> lResults(lBoards.size(), createResult());
+         std::vector<std::thread> lThreads;
+         for(size_t lBus = 0; lBus < lBoards.size(); lBus++)
+         {
+            lThreads.emplace_back([&lSettings, &lBoards, &lResults, &lClocks, lBus, lEnd]()
+            {
+               std::vector<CAR4TEGRA::DriverClock*> lBusClock(1, lClocks[lBus]);
+               std::mt19937 lRandom(lSettings.mSeed + static_cast<unsigned>(lBus));
+               std::vector<CAR4TEGRA::PCA9685::RegisterDrift> lThreadDrift;
+               std::vector<Board*> lBusBoards;
+               for(Board& lrBoard : lBoards[lBus])
+                  lBusBoards.push_back(&lrBoard);
+
+               Result& lrResult = lResults[lBus];
+               runFrames(lSettings, lBusClock, lEnd, lBusBoards, lRandom, lrResult, [&](Clock::duration aPeriod)
+               {
+                  for(Board* lpBoard : lBusBoards)
+                  {
+                     if(lpBoard->mPending == 0)
+                        continue;
+
+                     try
+                     {
+                        lpBoard->mpDriver->setPWMBatch(lpBoard->mPending, lpBoard->mOn, lpBoard->mOff);
+                        recordWrite(frameNow(lBusClock), aPeriod, *lpBoard, lrResult);
+                     }
+                     catch(const std::exception&)
+                     {
+                        // the values stay pending and are written with the next frame
+                        lrResult.mErrors++;
+                     }
+
+                     verifyBoard(lSettings, *lpBoard, lRandom, lThreadDrift, lrResult);
+                  }
+               });
+            });
+         }
+
+         for(std::thread& lrThread : lThreads)
+            lrThread.join();
+         for(const Result& lcrResult : lResults)
+            mergeResult(lTotal, lcrResult);
+      }
+      else if(lSettings.mPath == Path::EXECUTOR)
+      {
+         CAR4TEGRA::BusExecutor lExecutor;
+         std::atomic<uint64_t> lErrors(0);
+         lExecutor.setErrorCallback([&lErrors](int aDevice, const std::string& acrMessage)
+         {
+            (void)aDevice;
+            (void)acrMessage;
+            lErrors++;
+         });
+
+         std::vector<Board*> lAllBoards;
+         std::vector<int> lFirstChannel;
+         for(std::vector<Board>& lrBusBoards : lBoards)
+         {
+            for(Board& lrBoard : lrBusBoards)
+            {
+               lAllBoards.push_back(&lrBoard);
+               lFirstChannel.push_back(lExecutor.addDevice(*lrBoard.mpDriver) * PCA9685_CHANNEL_COUNT);
+            }
+         }
+         lExecutor.start();
+
+         std::mt19937 lRandom(lSettings.mSeed);
+         runFrames(lSettings, lAllClocks, lEnd, lAllBoards, lRandom, lTotal, [&](Clock::duration aPeriod)
+         {
+            for(size_t i = 0; i < lAllBoards.size(); i++)
+            {
+               for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+               {
+                  if(lAllBoards[i]->mPending & (1 << lChannel))
+                     lExecutor.set(lFirstChannel[i] + lChannel, lAllBoards[i]->mOn[lChannel], lAllBoards[i]->mOff[lChannel]);
+               }
+            }
+
+            lExecutor.runFrame();
+            Clock::time_point lWritten = frameNow(lAllClocks);
+            for(Board* lpBoard : lAllBoards)
+            {
+               recordWrite(lWritten, aPeriod, *lpBoard, lTotal);
+               verifyBoard(lSettings, *lpBoard, lRandom, lDrift, lTotal);
+            }
+         });
+
+         lExecutor.stop();
+         lTotal.mErrors += lErrors;
+      }
+      else
+      {
+         // the schedulers pace their frames themselves, the generator only submits
+         std::vector<std::unique_ptr<CAR4TEGRA::BusScheduler>> lSchedulers;
+         std::atomic<uint64_t> lErrors(0);
+         std::vector<Board*> lAllBoards;
+         std::vector<CAR4TEGRA::BusScheduler*> lBoardScheduler;
+         for(std::vector<Board>& lrBusBoards : lBoards)
+         {
+            lSchedulers.push_back(std::make_unique<CAR4TEGRA::BusScheduler>(lSettings.mBusClock, static_cast<float>(lSettings.mRate)));
+            CAR4TEGRA::BusScheduler& lrScheduler = *lSchedulers.back();
+            lrScheduler.setClock(*lClocks[lSchedulers.size() - 1]);
+            lrScheduler.setTransactionOverhead(lSettings.mOverheadUs);
+            lrScheduler.setErrorCallback([&lErrors](int aChannel, const std::string& acrMessage)
+            {
+               (void)aChannel;
+               (void)acrMessage;
+               lErrors++;
+            });
+
+            for(Board& lrBoard : lrBusBoards)
+            {
+               lrBoard.mDevice = lrScheduler.addDevice(*lrBoard.mpDriver);
+               lAllBoards.push_back(&lrBoard);
+               lBoardScheduler.push_back(&lrScheduler);
+            }
+
+            // in virtual time the frames run in the load thread, one timeline per bus
+            if(!lSettings.mVirtual)
+               lrScheduler.start();
+         }
+
+         std::mt19937 lRandom(lSettings.mSeed);
+         runFrames(lSettings, lAllClocks, lEnd, lAllBoards, lRandom, lTotal, [&](Clock::duration aPeriod)
+         {
+            (void)aPeriod;
+            for(size_t i = 0; i < lAllBoards.size(); i++)
+            {
+               Board& lrBoard = *lAllBoards[i];
+               for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+               {
+                  if(lrBoard.mPending & (1 << lChannel))
+                     lBoardScheduler[i]->submit(lrBoard.mDevice * PCA9685_CHANNEL_COUNT + lChannel, lrBoard.mOn[lChannel], lrBoard.mOff[lChannel]);
+               }
+               lrBoard.mPending = 0;
+               verifyBoard(lSettings, lrBoard, lRandom, lDrift, lTotal);
+            }
+
+            if(lSettings.mVirtual)
+            {
+               for(std::unique_ptr<CAR4TEGRA::BusScheduler>& lpScheduler : lSchedulers)
+                  lpScheduler->runFrame();
+            }
+         });
+
+         // coalesced updates and deferrals are counted by the schedulers
+         for(size_t i = 0; i < lAllBoards.size(); i++)
+         {
+            lBoardScheduler[i]->stop();
+            for(int lChannel = 0; lChannel < lSettings.mChannels; lChannel++)
+            {
+               double lLatencyUs = lBoardScheduler[i]->maxLatency(lAllBoards[i]->mDevice * PCA9685_CHANNEL_COUNT + lChannel);
+               lTotal.mMaxNs = std::max(lTotal.mMaxNs, static_cast<int64_t>(lLatencyUs * 1000.0));
+            }
+         }
+         for(std::unique_ptr<CAR4TEGRA::BusScheduler>& lpScheduler : lSchedulers)
+         {
+            CAR4TEGRA::BusScheduler::Statistics lStats = lpScheduler->statistics();
+            lTotal.mWritten += lStats.mWritten;
+            lTotal.mDropped += lStats.mCoalesced;
+            lTotal.mDeferred += lStats.mDeferred;
+         }
+         lTotal.mErrors += lErrors;
+      }
+
+      double lElapsedS = std::chrono::duration<double>(frameNow(lAllClocks) - lStart).count();
+      printResult(lTotal, lElapsedS, lSettings.mPath != Path::SCHEDULER);
+      if(lSettings.mVirtual)
+      {
+         std::cout << "Wall time:  " << std::setprecision(2)
+                   << std::chrono::duration<double>(std::chrono::steady_clock::now() - lWallStart).count()
+                   << " s for " << lElapsedS << " s virtual time" << std::endl;
+      }
+
+      if(lSimulated)
+      {
+         // bus time of all devices of a bus, in order of the buses
+         for(size_t lBus = 0; lBus < lSettings.mBuses.size(); lBus++)
+         {
+            double lBusyUs = 0.0;
+            for(int i = 0; i < lSettings.mBoards; i++)
+               lBusyUs += lSimulatedDevices[lBus * lSettings.mBoards + i]->statistics().mBusyUs;
+            std::cout << "Bus " << lSettings.mBuses[lBus] << ": utilization " << std::setprecision(1)
+                      << 100.0 * lBusyUs / (lElapsedS * 1000000.0) << " %" << std::endl;
+         }
+      }
+
+      return (lTotal.mErrors > 0) ? 1 : 0;
+   }
+   catch(const std::exception& acrException)
+   {
+      std::cerr << acrException.what() << std::endl;
+      return 1;
+   }
+}
@@ -0,0 +1,259 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the I2C trace replay tool
+ *
+ * @details
+ * The tool feeds a trace recorded by TraceRecorder back through the PCA9685 driver, either
+ * against a simulated device or against a real bus, in real time or as fast as possible.
+ *
+ * Usage: tracereplay <trace file> [--bus /dev/i2c-N] [--address HEX] [--fast] [--speed FACTOR]
+ *                    [--verify]
+ *
+ * Without `--bus` the trace is replayed against a simulated device. With `--verify` read
+ * transactions are compared against the recorded values.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Car4Tegra includes
+#include "include/pca9685.hpp"
+#include "include/simulatedi2cdevice.hpp"
+#include "include/tracerecorder.hpp"
+
+
+namespace
+{
+   /**
+    * @brief Replay settings
+    */
+   struct Settings
+   {
+      std::string mTraceFile;       ///< Trace file to replay
+      std::string mBusName;         ///< Bus to replay on (empty: simulated device)
+      int mAddress;                 ///< Device address (8 bit format, `0`: recorded address)
+      bool mFast;                   ///< Replay as fast as possible
+      double mSpeed;                ///< Time scaling factor for real-time replay
+      bool mVerify;                 ///< Compare read values against the recording
+   };
+
+
+   /**
+    * @brief Prints the usage of the tool
+    */
+   void printUsage()
+   {
+      std::cerr << "Usage: tracereplay <trace file> [--bus /dev/i2c-N] [--address HEX] [--fast]"
+                   " [--speed FACTOR] [--verify]" << std::endl;
+   }
+
+
+   /**
+    * @brief Parses the command line
+    *
+    * @param[in]  aArgc    Number of arguments
+    * @param[in]  apArgv   Value of arguments
+    * @param[out] arSettings  Replay settings
+    *
+    * @return `true` if the command line is valid
+    */
+   bool parseArguments(int aArgc, char* apArgv[], Settings& arSettings)
+   {
+      arSettings = Settings{ "", "", 0, false, 1.0, false };
+
+      for(int i = 1; i < aArgc; i++)
+      {
+         std::string lArg(apArgv[i]);
+
+         if(lArg == "--bus" && i + 1 < aArgc)
+            arSettings.mBusName = apArgv[++i];
+         else if(lArg == "--address" && i + 1 < aArgc)
+            arSettings.mAddress = static_cast<int>(strtol(apArgv[++i], nullptr, 16));
+         else if(lArg == "--fast")
+            arSettings.mFast = true;
+         else if(lArg == "--speed" && i + 1 < aArgc)
+            arSettings.mSpeed = atof(apArgv[++i]);
+         else if(lArg == "--verify")
+            arSettings.mVerify = true;
+         else if(lArg[0] != '-' && arSettings.mTraceFile.empty())
+            arSettings.mTraceFile = lArg;
+         else
+            return false;
+      }
+
+      return !arSettings.mTraceFile.empty() && arSettings.mSpeed > 0.0;
+   }
+} // namespace
+
+
+/**
+ * @brief Main function
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if the replay worked fine, `non zero` otherwise
+ */
+int main(int aArgc, char* apArgv[])
+{
+   Settings lSettings;
+   if(!parseArguments(aArgc, apArgv, lSettings))
+   {
+      printUsage();
+      return 2;
+   }
+
+   try
+   {
+      CAR4TEGRA::TraceReader lReader;
+      lReader.open(lSettings.mTraceFile);
+
+      CAR4TEGRA::TraceRecord lRecord;
+      uint8_t lPayload[CAR4TEGRA::I2cDevice::BLOCK_SIZE_MAX];
+      uint8_t lRead[CAR4TEGRA::I2cDevice::BLOCK_SIZE_MAX];
+
+      // recorded address is used if none is given
+      if(lSettings.mAddress == 0 && lReader.next(lRecord, lPayload))
+      {
+         lSettings.mAddress = lRecord.mAddress;
+      }
+      lReader.rewind();
+
+
+      // open simulated or real device
+      std::unique_ptr<CAR4TEGRA::PCA9685> lpDriver;
+      if(lSettings.mBusName.empty())
+      {
+         lpDriver = std::make_unique<CAR4TEGRA::PCA9685>(std::make_unique<CAR4TEGRA::SimulatedI2cDevice>());
+         lpDriver->openDevice("simulated", lSettings.mAddress);
+      }
+      else
+      {
+         lpDriver = std::make_unique<CAR4TEGRA::PCA9685>();
+         lpDriver->openDevice(lSettings.mBusName, lSettings.mAddress);
+      }
+
+
+      // replay
+      uint64_t lTransactions = 0;
+      uint64_t lSkipped = 0;
+      uint64_t lMismatches = 0;
+      uint64_t lErrors = 0;
+      uint64_t lFirstTimestamp = 0;
+      std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+
+      while(lReader.next(lRecord, lPayload))
+      {
+         // failed transactions are not replayed
+         if(lRecord.mErrno != 0)
+         {
+            lSkipped++;
+            continue;
+         }
+
+         // pace to the recorded timestamps
+         if(lTransactions == 0)
+         {
+            lFirstTimestamp = lRecord.mTimestampNs;
+         }
+         else if(!lSettings.mFast)
+         {
+            std::chrono::nanoseconds lOffset(static_cast<int64_t>((lRecord.mTimestampNs - lFirstTimestamp) / lSettings.mSpeed));
+            std::this_thread::sleep_until(lStart + lOffset);
+         }
+
+         try
+         {
+            switch(lRecord.mOperation)
+            {
+               case CAR4TEGRA::TraceRecorder::OP_WRITE_BYTE:
+                  lpDriver->writeRegister(lRecord.mRegister, lPayload[0]);
+                  break;
+
+               case CAR4TEGRA::TraceRecorder::OP_WRITE_BLOCK:
+                  lpDriver->writeRegisterBlock(lRecord.mRegister, lPayload, lRecord.mLength);
+                  break;
+
+               case CAR4TEGRA::TraceRecorder::OP_READ_BYTE:
+                  lRead[0] = static_cast<uint8_t>(lpDriver->readRegister(lRecord.mRegister));
+                  if(lSettings.mVerify && lRead[0] != lPayload[0])
+                     lMismatches++;
+                  break;
+
+               case CAR4TEGRA::TraceRecorder::OP_READ_BLOCK:
+                  lpDriver->readRegisterBlock(lRecord.mRegister, lRead, lRecord.mLength);
+                  if(lSettings.mVerify && memcmp(lRead, lPayload, lRecord.mLength) != 0)
+                     lMismatches++;
+                  break;
+
+               default:
+                  break;
+            }
+         }
+         catch(const std::exception& e)
+         {
+            std::cerr << "Transaction " << lRecord.mSequence << ": " << e.what() << std::endl;
+            lErrors++;
+         }
+
+         lTransactions++;
+      }
+
+      double lSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+
+      // summary
+      std::cout << "Replayed transactions:   " << lTransactions << std::endl;
+      std::cout << "Skipped (failed in rec): " << lSkipped << std::endl;
+      std::cout << "Dropped while recording: " << lReader.dropped() << std::endl;
+      std::cout << "Replay errors:           " << lErrors << std::endl;
+      if(lSettings.mVerify)
+         std::cout << "Read mismatches:         " << lMismatches << std::endl;
+      std::cout << "Duration:                " << lSeconds << " s";
+      if(lSeconds > 0.0)
+         std::cout << " (" << lTransactions / lSeconds << " transactions/s)";
+      std::cout << std::endl;
+
+      return (lErrors == 0 && lMismatches == 0) ? 0 : 1;
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+}
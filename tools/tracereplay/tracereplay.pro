@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# I2C trace replay tool
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = tracereplay
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+include(../../lib/c4tdriver.pri)
+
+
+SOURCES += \
+    main.cpp
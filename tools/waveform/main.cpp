@@ -0,0 +1,585 @@
+/**
+ * @copyright
+ * MIT License
+ *
+ * Copyright (c) 2017 Car4Tegra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file main.cpp
+ * @date 19.10.2026
+ *
+ * @brief This file contains the main function of the PWM waveform analyzer
+ *
+ * @details
+ * The tool synthesizes the 16 PWM outputs of a PCA9685 from register writes with
+ * WaveformEngine and reports period, duty, runts, glitches, double pulses and the latency
+ * from a write to its first edge per channel. The writes come from a TraceRecorder trace or
+ * from a simulation of a driver write strategy on a simulated device in virtual time.
+ *
+ * Usage: waveform [<trace file>] [--address HEX] [--prescale N] [--latch cycle|immediate]
+ *                 [--window US] [--vcd FILE] [--strategy bytes|block|batch] [--channels N]
+ *                 [--rate HZ] [--cycles N] [--frequency HZ] [--bus-clock HZ] [--overhead US]
+ *                 [--seed N]
+ *
+ * With a trace file the writes to `--address` (default: address of the first record) are
+ * analyzed. The prescale is taken from the last PRE_SCALE write of the trace if `--prescale`
+ * is not given. Without a trace file `--channels` servos get a random position at `--rate`
+ * for `--cycles` PWM cycles, written with the given strategy:
+ * - `bytes`: PCA9685::setPWM() with auto-increment off (four single register writes)
+ * - `block`: PCA9685::setPWM() with auto-increment (one block write per channel)
+ * - `batch`: PCA9685::setPWMBatch() (one block write per frame)
+ *
+ * `--vcd` writes all edges to a value change dump, which disables the accounting of steady
+ * cycle runs (slow for long runs). The exit code is `1` if a runt, glitch or double pulse
+ * was found.
+ *
+ * @version 0.1 - 19.10.2026 - File created
+ */
+
+
+// std includes
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Car4Tegra includes
+#include "include/driverclock.hpp"
+#include "include/pca9685.hpp"
+#include "include/simulatedi2cdevice.hpp"
+#include "include/tracerecorder.hpp"
+#include "include/waveformengine.hpp"
+
+
+namespace
+{
+   const uint16_t SERVO_MIN = 205;              ///< PWM OFF value of a 1 ms pulse at 50 Hz
+   const uint16_t SERVO_MAX = 410;              ///< PWM OFF value of a 2 ms pulse at 50 Hz
+
+
+   /**
+    * @brief Write strategy under test
+    */
+   enum class Strategy
+   {
+      BYTES,                        ///< Single register writes
+      BLOCK,                        ///< One block write per channel
+      BATCH                         ///< One block write per frame
+   };
+
+
+   /**
+    * @brief Analyzer settings
+    */
+   struct Settings
+   {
+      std::string mTraceFile;       ///< Trace file to analyze (empty: simulation)
+      int mAddress;                 ///< Device address (8 bit format, `0`: first recorded address)
+      int mPrescale;                ///< Prescale (`0`: from the trace)
+      CAR4TEGRA::WaveformEngine::LatchMode mLatch;    ///< Latch mode of the outputs
+      double mWindowUs;             ///< Transient window (us)
+      std::string mVcdFile;         ///< Value change dump (empty: none)
+      Strategy mStrategy;           ///< Simulated write strategy
+      int mChannels;                ///< Number of simulated servos
+      double mRate;                 ///< Simulated update rate (Hz)
+      uint64_t mCycles;             ///< Simulated PWM cycles
+      float mFrequency;             ///< Simulated PWM frequency (Hz)
+      uint32_t mBusClock;           ///< I2C bus clock (Hz)
+      double mOverheadUs;           ///< Fixed cost of one transaction (us)
+      unsigned mSeed;               ///< Seed of the simulated positions
+   };
+
+
+   /**
+    * @class WaveformDevice
+    * @brief Simulated device which forwards the successful writes to a waveform engine
+    */
+   class WaveformDevice : public CAR4TEGRA::SimulatedI2cDevice
+   {
+   public:
+      /**
+       * @brief Constructor
+       *
+       * @param[in]  arClock        Clock of the bus timing and the writes
+       */
+      explicit WaveformDevice(CAR4TEGRA::DriverClock& arClock)
+         : mrClock(arClock), mpEngine(nullptr)
+      {
+      }
+
+
+      /**
+       * @brief Sets the engine which receives the writes from now on
+       *
+       * @param[in]  apEngine       Waveform engine (`nullptr`: none)
+       */
+      void setEngine(CAR4TEGRA::WaveformEngine* apEngine)
+      {
+         mpEngine = apEngine;
+      }
+
+
+      /**
+       * @brief Returns the time of the clock used by the engine
+       *
+       * @return Time (ns)
+       */
+      uint64_t nowNs()
+      {
+         return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(mrClock.now().time_since_epoch()).count());
+      }
+
+
+   protected:
+      int busWriteByte(int aBus, int aRegister, int aValue) override
+      {
+         int lResult = SimulatedI2cDevice::busWriteByte(aBus, aRegister, aValue);
+         if(lResult >= 0 && mpEngine)
+         {
+            uint8_t lValue = static_cast<uint8_t>(aValue);
+            mpEngine->write(this->nowNs(), aRegister, &lValue, 1);
+         }
+         return lResult;
+      }
+
+
+      int busTransfer(int aBus, struct i2c_msg* apMsgs, int aCount) override
+      {
+         int lResult = SimulatedI2cDevice::busTransfer(aBus, apMsgs, aCount);
+
+         // plain write transactions only, the bus time has passed at return
+         if(lResult >= 0 && mpEngine && aCount == 1 && !(apMsgs[0].flags & I2C_M_RD) && apMsgs[0].len > 1)
+            mpEngine->write(this->nowNs(), apMsgs[0].buf[0], apMsgs[0].buf + 1, apMsgs[0].len - 1u);
+         return lResult;
+      }
+
+
+   private:
+      CAR4TEGRA::DriverClock& mrClock;        ///< Clock of the writes
+      CAR4TEGRA::WaveformEngine* mpEngine;    ///< Receiver of the writes
+   }; // class WaveformDevice
+
+
+   /**
+    * @brief Value change dump of the synthesized edges
+    *
+    * The engine reports the edges of a synthesized segment per channel, they are collected and
+    * written in time order after every engine call.
+    */
+   class VcdWriter
+   {
+   public:
+      /**
+       * @brief Opens the dump and writes its header
+       *
+       * @param[in]  acrFileName    File name
+       */
+      explicit VcdWriter(const std::string& acrFileName)
+         : mFile(acrFileName)
+      {
+         if(!mFile)
+         {
+            throw std::runtime_error("Could not open VCD file \"" + acrFileName + "\"");
+         }
+
+         mFile << "$timescale 1ns $end\n$scope module pca9685 $end\n";
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            mFile << "$var wire 1 " << static_cast<char>('A' + lChannel) << " led" << lChannel << " $end\n";
+         mFile << "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n";
+         for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+            mFile << '0' << static_cast<char>('A' + lChannel) << '\n';
+         mFile << "$end\n";
+      }
+
+
+      /**
+       * @brief Collects an edge
+       */
+      void add(int aChannel, int64_t aTick, bool aRising)
+      {
+         mEdges.push_back(Edge{ aTick, aChannel, aRising });
+      }
+
+
+      /**
+       * @brief Writes the collected edges
+       *
+       * @param[in]  aTickNs        Duration of one counter tick (ns)
+       */
+      void flush(uint64_t aTickNs)
+      {
+         std::stable_sort(mEdges.begin(), mEdges.end(), [](const Edge& acrA, const Edge& acrB) { return acrA.mTick < acrB.mTick; });
+
+         for(const Edge& lcrEdge : mEdges)
+         {
+            if(lcrEdge.mTick != mLastTick)
+            {
+               mFile << '#' << static_cast<uint64_t>(lcrEdge.mTick) * aTickNs << '\n';
+               mLastTick = lcrEdge.mTick;
+            }
+            mFile << (lcrEdge.mRising ? '1' : '0') << static_cast<char>('A' + lcrEdge.mChannel) << '\n';
+         }
+         mEdges.clear();
+      }
+
+
+   private:
+      /**
+       * @brief Edge of an output
+       */
+      struct Edge
+      {
+         int64_t mTick;             ///< Counter tick
+         int mChannel;              ///< Channel
+         bool mRising;              ///< Rising or falling edge
+      };
+
+      std::ofstream mFile;          ///< Dump file
+      std::vector<Edge> mEdges;     ///< Edges not yet written
+      int64_t mLastTick = 0;        ///< Tick of the last written edge
+   }; // class VcdWriter
+
+
+   /**
+    * @brief Prints the usage of the tool
+    */
+   void printUsage()
+   {
+      std::cerr << "Usage: waveform [<trace file>] [--address HEX] [--prescale N] [--latch cycle|immediate]"
+                   " [--window US] [--vcd FILE] [--strategy bytes|block|batch] [--channels N] [--rate HZ]"
+                   " [--cycles N] [--frequency HZ] [--bus-clock HZ] [--overhead US] [--seed N]" << std::endl;
+   }
+
+
+   /**
+    * @brief Parses the command line
+    *
+    * @param[in]  aArgc    Number of arguments
+    * @param[in]  apArgv   Value of arguments
+    * @param[out] arSettings  Analyzer settings
+    *
+    * @return `true` if the command line is valid
+    */
+   bool parseArguments(int aArgc, char* apArgv[], Settings& arSettings)
+   {
+      arSettings = Settings{ "", 0, 0, CAR4TEGRA::WaveformEngine::LATCH_CYCLE, 500.0, "", Strategy::BATCH,
+                             PCA9685_CHANNEL_COUNT, 60.0, 100000, 50.0f, 400000, 30.0, 1 };
+
+      for(int i = 1; i < aArgc; i++)
+      {
+         std::string lArg(apArgv[i]);
+
+         if(lArg == "--address" && i + 1 < aArgc)
+            arSettings.mAddress = static_cast<int>(strtol(apArgv[++i], nullptr, 16));
+         else if(lArg == "--prescale" && i + 1 < aArgc)
+            arSettings.mPrescale = atoi(apArgv[++i]);
+         else if(lArg == "--latch" && i + 1 < aArgc)
+         {
+            std::string lLatch(apArgv[++i]);
+            if(lLatch == "cycle")
+               arSettings.mLatch = CAR4TEGRA::WaveformEngine::LATCH_CYCLE;
+            else if(lLatch == "immediate")
+               arSettings.mLatch = CAR4TEGRA::WaveformEngine::LATCH_IMMEDIATE;
+            else
+               return false;
+         }
+         else if(lArg == "--window" && i + 1 < aArgc)
+            arSettings.mWindowUs = atof(apArgv[++i]);
+         else if(lArg == "--vcd" && i + 1 < aArgc)
+            arSettings.mVcdFile = apArgv[++i];
+         else if(lArg == "--strategy" && i + 1 < aArgc)
+         {
+            std::string lStrategy(apArgv[++i]);
+            if(lStrategy == "bytes")
+               arSettings.mStrategy = Strategy::BYTES;
+            else if(lStrategy == "block")
+               arSettings.mStrategy = Strategy::BLOCK;
+            else if(lStrategy == "batch")
+               arSettings.mStrategy = Strategy::BATCH;
+            else
+               return false;
+         }
+         else if(lArg == "--channels" && i + 1 < aArgc)
+            arSettings.mChannels = atoi(apArgv[++i]);
+         else if(lArg == "--rate" && i + 1 < aArgc)
+            arSettings.mRate = atof(apArgv[++i]);
+         else if(lArg == "--cycles" && i + 1 < aArgc)
+            arSettings.mCycles = strtoull(apArgv[++i], nullptr, 10);
+         else if(lArg == "--frequency" && i + 1 < aArgc)
+            arSettings.mFrequency = static_cast<float>(atof(apArgv[++i]));
+         else if(lArg == "--bus-clock" && i + 1 < aArgc)
+            arSettings.mBusClock = static_cast<uint32_t>(strtoul(apArgv[++i], nullptr, 10));
+         else if(lArg == "--overhead" && i + 1 < aArgc)
+            arSettings.mOverheadUs = atof(apArgv[++i]);
+         else if(lArg == "--seed" && i + 1 < aArgc)
+            arSettings.mSeed = static_cast<unsigned>(strtoul(apArgv[++i], nullptr, 10));
+         else if(lArg[0] != '-' && arSettings.mTraceFile.empty())
+            arSettings.mTraceFile = lArg;
+         else
+            return false;
+      }
+
+      return arSettings.mChannels >= 1 && arSettings.mChannels <= PCA9685_CHANNEL_COUNT && arSettings.mRate > 0.0 &&
+             arSettings.mCycles > 0 && arSettings.mFrequency > 0.0f && arSettings.mBusClock > 0 &&
+             (arSettings.mPrescale == 0 || (arSettings.mPrescale >= 3 && arSettings.mPrescale <= 255));
+   }
+
+
+   /**
+    * @brief Returns a time stamp in the trace format
+    *
+    * @return CLOCK_MONOTONIC time (ns)
+    */
+   uint64_t toNs(CAR4TEGRA::DriverClock::TimePoint aTime)
+   {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(aTime.time_since_epoch()).count());
+   }
+
+
+   /**
+    * @brief Feeds the writes of a trace to the engine
+    *
+    * @param[in]  acrSettings    Analyzer settings
+    * @param[in]  apVcd          Value change dump (`nullptr`: none)
+    * @param[out] arpEngine      Engine with the synthesized outputs
+    */
+   void analyzeTrace(const Settings& acrSettings, VcdWriter* apVcd, std::unique_ptr<CAR4TEGRA::WaveformEngine>& arpEngine)
+   {
+      CAR4TEGRA::TraceReader lReader;
+      lReader.open(acrSettings.mTraceFile);
+
+      CAR4TEGRA::TraceRecord lRecord;
+      uint8_t lPayload[CAR4TEGRA::I2cDevice::BLOCK_SIZE_MAX];
+
+
+      // address, prescale and start time from the trace
+      int lAddress = acrSettings.mAddress;
+      int lPrescale = acrSettings.mPrescale;
+      uint64_t lStartNs = 0;
+      bool lFound = false;
+      while(lReader.next(lRecord, lPayload))
+      {
+         if(lAddress == 0)
+            lAddress = lRecord.mAddress;
+         if(lRecord.mAddress != lAddress || lRecord.mErrno != 0)
+            continue;
+
+         if(!lFound)
+         {
+            lStartNs = lRecord.mTimestampNs;
+            lFound = true;
+         }
+         if(acrSettings.mPrescale == 0 && lRecord.mOperation == CAR4TEGRA::TraceRecorder::OP_WRITE_BYTE &&
+            lRecord.mRegister == PCA9685_REG_PRE_SCALE)
+         {
+            lPrescale = lPayload[0];
+         }
+      }
+      lReader.rewind();
+
+      if(!lFound)
+      {
+         std::ostringstream lMessage;
+         lMessage << "No transactions of address 0x" << std::hex << lAddress << " in trace";
+         throw std::runtime_error(lMessage.str());
+      }
+
+      arpEngine = std::make_unique<CAR4TEGRA::WaveformEngine>(lPrescale != 0 ? lPrescale : 0x1E, acrSettings.mLatch, lStartNs);
+      arpEngine->setTransientWindow(acrSettings.mWindowUs);
+      if(apVcd)
+         arpEngine->setEdgeCallback([apVcd](int aChannel, int64_t aTick, bool aRising) { apVcd->add(aChannel, aTick, aRising); });
+
+
+      // writes in record order, time stamps of concurrent recorders are not ordered
+      uint64_t lLastNs = lStartNs;
+      uint64_t lWrites = 0;
+      while(lReader.next(lRecord, lPayload))
+      {
+         if(lRecord.mAddress != lAddress || lRecord.mErrno != 0 ||
+            (lRecord.mOperation != CAR4TEGRA::TraceRecorder::OP_WRITE_BYTE && lRecord.mOperation != CAR4TEGRA::TraceRecorder::OP_WRITE_BLOCK))
+         {
+            continue;
+         }
+
+         lLastNs = std::max(lLastNs, lRecord.mTimestampNs);
+         arpEngine->write(lLastNs, lRecord.mRegister, lPayload, lRecord.mLength);
+         lWrites++;
+
+         if(apVcd)
+            apVcd->flush(arpEngine->tickNs());
+      }
+
+      // one more cycle shows the effect of the last write
+      arpEngine->advance(lLastNs + 2 * WAVEFORM_CYCLE_TICKS * arpEngine->tickNs());
+      if(apVcd)
+         apVcd->flush(arpEngine->tickNs());
+
+      std::cout << "Trace:                   " << acrSettings.mTraceFile << " (address 0x" << std::hex << lAddress << std::dec
+                << ", " << lWrites << " writes, " << lReader.dropped() << " dropped while recording)" << std::endl;
+   }
+
+
+   /**
+    * @brief Simulates a write strategy and feeds its writes to the engine
+    *
+    * @param[in]  acrSettings    Analyzer settings
+    * @param[in]  apVcd          Value change dump (`nullptr`: none)
+    * @param[out] arpEngine      Engine with the synthesized outputs
+    */
+   void simulateStrategy(const Settings& acrSettings, VcdWriter* apVcd, std::unique_ptr<CAR4TEGRA::WaveformEngine>& arpEngine)
+   {
+      CAR4TEGRA::VirtualClock lClock;
+      std::unique_ptr<WaveformDevice> lpOwnedDevice = std::make_unique<WaveformDevice>(lClock);
+      WaveformDevice* lpDevice = lpOwnedDevice.get();
+      lpDevice->setBusTiming(acrSettings.mBusClock, acrSettings.mOverheadUs, lClock);
+
+      CAR4TEGRA::PCA9685 lDriver(std::move(lpOwnedDevice));
+      lDriver.setClock(lClock);
+      lDriver.openDevice("simulated", 0x80);
+      lDriver.fastConnect(acrSettings.mFrequency);
+      if(acrSettings.mStrategy == Strategy::BYTES)
+         lDriver.writeRegister(PCA9685_REG_MODE1, lDriver.readRegister(PCA9685_REG_MODE1) & ~PCA9685_MODE1_AI);
+
+      arpEngine = std::make_unique<CAR4TEGRA::WaveformEngine>(lDriver.readRegister(PCA9685_REG_PRE_SCALE), acrSettings.mLatch,
+                                                              lpDevice->nowNs());
+      arpEngine->setTransientWindow(acrSettings.mWindowUs);
+      if(apVcd)
+         arpEngine->setEdgeCallback([apVcd](int aChannel, int64_t aTick, bool aRising) { apVcd->add(aChannel, aTick, aRising); });
+      lpDevice->setEngine(arpEngine.get());
+
+
+      // random servo positions at the update rate, the writes take their bus time
+      std::mt19937 lRandom(acrSettings.mSeed);
+      std::uniform_int_distribution<int> lPosition(SERVO_MIN, SERVO_MAX);
+      uint16_t lOn[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lOff[PCA9685_CHANNEL_COUNT] = {};
+      uint16_t lMask = static_cast<uint16_t>((1u << acrSettings.mChannels) - 1);
+
+      CAR4TEGRA::DriverClock::TimePoint lStart = lClock.now();
+      std::chrono::nanoseconds lFramePeriod(static_cast<int64_t>(1e9 / acrSettings.mRate));
+      uint64_t lEndNs = lpDevice->nowNs() + acrSettings.mCycles * WAVEFORM_CYCLE_TICKS * arpEngine->tickNs();
+      uint64_t lFrames = 0;
+
+      for(CAR4TEGRA::DriverClock::TimePoint lFrame = lStart; toNs(lFrame) < lEndNs; lFrame += lFramePeriod)
+      {
+         lClock.sleepUntil(lFrame);
+
+         for(int lChannel = 0; lChannel < acrSettings.mChannels; lChannel++)
+            lOff[lChannel] = static_cast<uint16_t>(lPosition(lRandom));
+
+         if(acrSettings.mStrategy == Strategy::BATCH)
+         {
+            lDriver.setPWMBatch(lMask, lOn, lOff);
+         }
+         else
+         {
+            for(int lChannel = 0; lChannel < acrSettings.mChannels; lChannel++)
+               lDriver.setPWM(lChannel, lOn[lChannel], lOff[lChannel]);
+         }
+         lFrames++;
+
+         if(apVcd)
+            apVcd->flush(arpEngine->tickNs());
+      }
+
+      arpEngine->advance(lEndNs);
+      if(apVcd)
+         apVcd->flush(arpEngine->tickNs());
+      lpDevice->setEngine(nullptr);
+
+      const char* lStrategyNames[] = { "bytes", "block", "batch" };
+      CAR4TEGRA::SimulatedI2cDevice::Statistics lStatistics = lpDevice->statistics();
+      std::cout << "Strategy:                " << lStrategyNames[static_cast<int>(acrSettings.mStrategy)] << " (" << lFrames
+                << " frames, " << lStatistics.mTransactions << " transactions, bus busy "
+                << std::fixed << std::setprecision(1) << lStatistics.mBusyUs / 1000.0 << " ms)" << std::defaultfloat << std::endl;
+   }
+} // namespace
+
+
+/**
+ * @brief Main function
+ *
+ * @param[in]  aArgc    Number of arguments
+ * @param[in]  apArgv   Value of arguments
+ *
+ * @return `0` if all pulses were clean, `1` on runts, glitches, double pulses or errors, `2` on usage errors
+ */
+int main(int aArgc, char* apArgv[])
+{
+   Settings lSettings;
+   if(!parseArguments(aArgc, apArgv, lSettings))
+   {
+      printUsage();
+      return 2;
+   }
+
+   try
+   {
+      std::unique_ptr<VcdWriter> lpVcd;
+      if(!lSettings.mVcdFile.empty())
+         lpVcd = std::make_unique<VcdWriter>(lSettings.mVcdFile);
+
+      std::unique_ptr<CAR4TEGRA::WaveformEngine> lpEngine;
+      std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+      if(lSettings.mTraceFile.empty())
+         simulateStrategy(lSettings, lpVcd.get(), lpEngine);
+      else
+         analyzeTrace(lSettings, lpVcd.get(), lpEngine);
+      double lSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+
+      // per channel analysis
+      std::cout << "Synthesized cycles:      " << lpEngine->cycles() << " (tick " << lpEngine->tickNs() << " ns, "
+                << lSeconds << " s)" << std::endl << std::endl;
+      std::cout << "Ch   Pulses  Updates    Runts  Glitches  Doubles  Period us  Duty min  Duty max  Latency us (mean/max)" << std::endl;
+
+      uint64_t lFaults = 0;
+      std::cout << std::fixed;
+      for(int lChannel = 0; lChannel < PCA9685_CHANNEL_COUNT; lChannel++)
+      {
+         CAR4TEGRA::WaveformEngine::ChannelAnalysis lAnalysis = lpEngine->analysis(lChannel);
+         if(lAnalysis.mUpdates == 0)
+            continue;
+
+         lFaults += lAnalysis.mRunts + lAnalysis.mGlitches + lAnalysis.mDoublePulses;
+         std::cout << std::setw(2) << lChannel << std::setw(9) << lAnalysis.mPulses << std::setw(9) << lAnalysis.mUpdates
+                   << std::setw(9) << lAnalysis.mRunts << std::setw(10) << lAnalysis.mGlitches << std::setw(9) << lAnalysis.mDoublePulses
+                   << std::setprecision(1) << std::setw(11) << lAnalysis.mPeriodMeanUs
+                   << std::setprecision(4) << std::setw(10) << lAnalysis.mDutyMin << std::setw(10) << lAnalysis.mDutyMax
+                   << std::setprecision(1) << std::setw(12) << lAnalysis.mLatencyMeanUs << " / " << lAnalysis.mLatencyMaxUs << std::endl;
+      }
+
+      std::cout << std::endl << "Runts, glitches, doubles: " << lFaults << std::endl;
+      return (lFaults == 0) ? 0 : 1;
+   }
+   catch(const std::exception& e)
+   {
+      std::cerr << e.what() << std::endl;
+      return 1;
+   }
+}
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# PWM waveform analyzer
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = waveform
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle qt
+
+include(../../lib/c4tdriver.pri)
+
+
+SOURCES += \
+    main.cpp